@@ -1,27 +1,36 @@
 #ifndef _TIMER_H
 #define _TIMER_H
 
-#include <ctime>
-
+#include <chrono>
+
+/** Wall clock timer based on a monotonic high-resolution clock.
+ *
+ * clock() measures the processor time of the whole process with a coarse
+ * resolution which is not suitable to measure single calls and also counts
+ * the time spent in other threads.
+ */
 struct TimerInfo {
+  typedef std::chrono::steady_clock Clock;
+
   /// time stamp when timer_start() gets called
-  clock_t clock_start_value;
+  Clock::time_point clock_start_value;
 
   /// time stamp when the timer was stopped
-  clock_t clock_end_value;
+  Clock::time_point clock_end_value;
 
   /// duration between clock_start_value and clock_end_value in seconds
   double duration_sec;
 };
 
 inline void timer_start (TimerInfo *timer) {
-  timer->clock_start_value = clock();
+  timer->clock_start_value = TimerInfo::Clock::now();
 }
 
 inline double timer_stop (TimerInfo *timer) {
-  timer->clock_end_value = clock();
+  timer->clock_end_value = TimerInfo::Clock::now();
 
-  timer->duration_sec = static_cast<double>(timer->clock_end_value - timer->clock_start_value) * 1 / CLOCKS_PER_SEC;
+  timer->duration_sec = std::chrono::duration<double> (
+      timer->clock_end_value - timer->clock_start_value).count();
 
   return timer->duration_sec;
 }
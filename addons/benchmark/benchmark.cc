@@ -1,6 +1,8 @@
 #include <iostream>
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <string>
 #include <vector>
 #include <cstdlib>
@@ -29,6 +31,22 @@ bool urdf_floating_base = false;
 bool have_urdfreader = false;
 #endif
 
+#ifdef __GLIBC__
+// Counts all heap allocations of the process, including the ones performed
+// inside of RBDL and Eigen, by wrapping the allocator of the C library.
+extern "C" void *__libc_malloc (size_t size);
+std::atomic<unsigned long> malloc_count (0);
+
+extern "C" void *malloc (size_t size) noexcept {
+  malloc_count++;
+  return __libc_malloc (size);
+}
+bool have_malloc_count = true;
+#else
+std::atomic<unsigned long> malloc_count (0);
+bool have_malloc_count = false;
+#endif
+
 using namespace std;
 using namespace RigidBodyDynamics;
 using namespace RigidBodyDynamics::Math;
@@ -37,21 +55,32 @@ int benchmark_sample_count = 1000;
 int benchmark_model_max_depth = 5;
 
 bool benchmark_run_fd_aba = true;
+bool benchmark_run_fd_batch = true;
+bool benchmark_run_fd_unrolled = true;
 bool benchmark_run_fd_lagrangian = true;
 bool benchmark_run_id_rnea = true;
 bool benchmark_run_crba = true;
 bool benchmark_run_nle = true;
 bool benchmark_run_calc_minv_times_tau = true;
+bool benchmark_run_centroidal = true;
 bool benchmark_run_contacts = true;
 bool benchmark_run_ik = true;
 
 bool json_output = false;
+bool print_histograms = false;
+bool cold_cache = false;
+
+vector<unsigned int> benchmark_thread_counts;
+
+string baseline_filename;
+double regression_threshold = 10.;
 
 string model_name;
 
 enum ContactsMethod {
     ConstraintsMethodDirect = 0,
     ConstraintsMethodRangeSpaceSparse,
+    ConstraintsMethodRangeSpaceSparseLTL,
     ConstraintsMethodNullSpace,
     ConstraintsMethodKokkevis
 };
@@ -62,10 +91,24 @@ struct BenchmarkRun {
     string benchmark;
     int sample_count;
 
+    int threads;
+    string cache;
+
+    /// only duration and avg are measured, e.g. for batched calls that do
+    /// not have a duration per sample
+    bool throughput_only;
+
     double duration;
     double avg;
     double min;
     double max;
+
+    double p50;
+    double p99;
+    double p999;
+
+    /// number of calls with a duration in [2^i, 2^(i+1)) nanoseconds
+    vector<unsigned int> histogram;
 };
 
 vector<BenchmarkRun> benchmark_runs;
@@ -76,30 +119,155 @@ void report_section (const char* section_name) {
   }
 }
 
-void register_run(const Model &model, const SampleData &data, const char *run_name) {
+/** Evicts the data of the previous calls from the caches by writing a
+ * buffer that is larger than the last level cache. */
+void flush_caches () {
+  static vector<char> buffer (64 * 1024 * 1024);
+  static char value = 0;
+
+  value++;
+  for (size_t i = 0; i < buffer.size(); i += 64) {
+    buffer[i] = value;
+  }
+}
+
+/** Starts the timer of a single sample. In cold cache mode the caches are
+ * flushed before so that the call has to fetch the model from memory. */
+void sample_timer_start (TimerInfo *tinfo) {
+  if (cold_cache) {
+    flush_caches();
+  }
+  timer_start (tinfo);
+}
+
+/** Returns the percentile p (0 < p <= 1) of the sorted values using the
+ * nearest rank method. */
+double percentile (const vector<double> &sorted_values, double p) {
+  size_t rank = static_cast<size_t>(ceil (p * sorted_values.size()));
+  if (rank < 1) {
+    rank = 1;
+  }
+  return sorted_values[min (rank, sorted_values.size()) - 1];
+}
+
+void register_run(const Model &model, const SampleData &data, const char *run_name,
+    int thread_count = 1) {
   BenchmarkRun run;
   run.benchmark = run_name;
   run.model_name = model_name;
   run.model_dof = model.dof_count;
   run.sample_count = data.count;
+  run.threads = thread_count;
+  run.cache = cold_cache ? "cold" : "warm";
+  run.throughput_only = false;
 
   run.duration = data.durations.sum();
   run.avg = data.durations.mean();
   run.min = data.durations.minCoeff();
   run.max = data.durations.maxCoeff();
 
+  vector<double> sorted_durations (data.durations.data(),
+      data.durations.data() + data.durations.size());
+  sort (sorted_durations.begin(), sorted_durations.end());
+
+  run.p50 = percentile (sorted_durations, 0.5);
+  run.p99 = percentile (sorted_durations, 0.99);
+  run.p999 = percentile (sorted_durations, 0.999);
+
+  for (size_t i = 0; i < sorted_durations.size(); i++) {
+    double duration_ns = sorted_durations[i] * 1.0e9;
+    size_t bucket = 0;
+    while (duration_ns >= 2. && bucket < 63) {
+      duration_ns *= 0.5;
+      bucket++;
+    }
+    if (run.histogram.size() <= bucket) {
+      run.histogram.resize (bucket + 1, 0);
+    }
+    run.histogram[bucket]++;
+  }
+
   benchmark_runs.push_back(run);
 }
 
+/** Registers a run of which only the total duration of all samples is
+ * known. It is excluded from the percentiles, histograms and the baseline
+ * comparison. */
+void register_throughput_run(const Model &model, double duration,
+    int sample_count, const char *run_name, int thread_count = 1) {
+  BenchmarkRun run;
+  run.benchmark = run_name;
+  run.model_name = model_name;
+  run.model_dof = model.dof_count;
+  run.sample_count = sample_count;
+  run.threads = thread_count;
+  run.cache = cold_cache ? "cold" : "warm";
+  run.throughput_only = true;
+
+  run.duration = duration;
+  run.avg = duration / sample_count;
+  run.min = 0.;
+  run.max = 0.;
+  run.p50 = 0.;
+  run.p99 = 0.;
+  run.p999 = 0.;
+
+  benchmark_runs.push_back(run);
+}
+
+void print_histogram (const BenchmarkRun &run) {
+  unsigned int max_count = *max_element (run.histogram.begin(),
+      run.histogram.end());
+
+  size_t first = 0;
+  while (run.histogram[first] == 0) {
+    first++;
+  }
+
+  for (size_t i = first; i < run.histogram.size(); i++) {
+    cout << "  >= " << setw(10) << (1ull << i) << "ns: " << setw(8)
+      << run.histogram[i] << " "
+      << string ((run.histogram[i] * 50 + max_count - 1) / max_count, '#')
+      << endl;
+  }
+}
+
 void report_run(const Model &model, const SampleData &data,
-        const char *run_name) {
-  register_run(model, data, run_name);
+        const char *run_name, int thread_count = 1) {
+  register_run(model, data, run_name, thread_count);
 
   if (!json_output) {
-    cout << "#DOF: " << setw(3) << model.dof_count
-         << " #samples: " << data.count
+    const BenchmarkRun &run = benchmark_runs.back();
+    cout << "#DOF: " << setw(3) << model.dof_count;
+    if (thread_count != 1) {
+      cout << " #threads: " << setw(2) << thread_count;
+    }
+    cout << " #samples: " << data.count
          << " duration = " << setw(10) << data.durations.sum() << "(s)"
-         << " (~" << setw(10) << data.durations.mean() << "(s) per call)" << endl;
+         << " (~" << setw(10) << data.durations.mean() << "(s) per call)"
+         << " p50 = " << setw(10) << run.p50 << "(s)"
+         << " p99 = " << setw(10) << run.p99 << "(s)" << endl;
+
+    if (print_histograms) {
+      print_histogram (run);
+    }
+  }
+}
+
+void report_throughput_run(const Model &model, double duration,
+    int sample_count, const char *run_name, int thread_count = 1) {
+  register_throughput_run(model, duration, sample_count, run_name,
+      thread_count);
+
+  if (!json_output) {
+    cout << "#DOF: " << setw(3) << model.dof_count;
+    if (thread_count != 1) {
+      cout << " #threads: " << setw(2) << thread_count;
+    }
+    cout << " #samples: " << sample_count
+         << " duration = " << setw(10) << duration << "(s)"
+         << " (~" << setw(10) << duration / sample_count
+         << "(s) per sample, throughput only)" << endl;
   }
 }
 
@@ -108,9 +276,16 @@ void report_constraints_run(const Model &model, const SampleData &data,
   register_run(model, data, run_name);
 
   if (!json_output) {
+    const BenchmarkRun &run = benchmark_runs.back();
     cout << model_name << ": "
          << " duration = " << setw(10) << data.durations.sum() << "(s)"
-         << " (~" << setw(10) << data.durations.mean() << "(s) per call)" << endl;
+         << " (~" << setw(10) << data.durations.mean() << "(s) per call)"
+         << " p50 = " << setw(10) << run.p50 << "(s)"
+         << " p99 = " << setw(10) << run.p99 << "(s)" << endl;
+
+    if (print_histograms) {
+      print_histogram (run);
+    }
   }
 }
 
@@ -153,7 +328,136 @@ double run_forward_dynamics_ABA_benchmark (Model *model, int sample_count) {
   TimerInfo tinfo;
 
   for (int i = 0; i < sample_count; i++) {
-    timer_start (&tinfo);
+    sample_timer_start (&tinfo);
+    ForwardDynamics (*model,
+        sample_data.q[i],
+        sample_data.qdot[i],
+        sample_data.tau[i],
+        sample_data.qddot[i]);
+    sample_data.durations[i] = timer_stop (&tinfo);
+  }
+
+  report_run(*model, sample_data, "ForwardDynamics");
+
+  return sample_data.durations.sum();
+}
+
+double run_forward_dynamics_batch_benchmark (Model *model, int sample_count) {
+  SampleData sample_data;
+  sample_data.fillRandom(model->dof_count, sample_count);
+
+  MatrixNd Q (model->q_size, sample_count);
+  MatrixNd QDot (model->qdot_size, sample_count);
+  MatrixNd Tau (model->qdot_size, sample_count);
+  MatrixNd QDDot (model->qdot_size, sample_count);
+
+  for (int i = 0; i < sample_count; i++) {
+    Q.col(i) = sample_data.q[i];
+    QDot.col(i) = sample_data.qdot[i];
+    Tau.col(i) = sample_data.tau[i];
+  }
+
+  TimerInfo tinfo;
+
+  // reference: one call to ForwardDynamics per sample
+  for (int i = 0; i < sample_count; i++) {
+    sample_timer_start (&tinfo);
+    ForwardDynamics (*model,
+        sample_data.q[i],
+        sample_data.qdot[i],
+        sample_data.tau[i],
+        sample_data.qddot[i]);
+    sample_data.durations[i] = timer_stop (&tinfo);
+  }
+
+  report_run(*model, sample_data, "ForwardDynamicsLoop");
+
+  // all samples are evaluated by a single call
+  sample_timer_start (&tinfo);
+  ForwardDynamicsBatch (*model, Q, QDot, Tau, QDDot);
+  double duration_batch = timer_stop (&tinfo);
+
+  report_throughput_run(*model, duration_batch, sample_count,
+      "ForwardDynamicsBatch");
+
+  return duration_batch;
+}
+
+/** Evaluates ForwardDynamics() with a BatchExecutor for every thread count
+ * of benchmark_thread_counts. All samples are evaluated by a single call
+ * such that only the throughput is reported. */
+double run_forward_dynamics_threads_benchmark (Model *model, int sample_count) {
+  SampleData sample_data;
+  sample_data.fillRandom(model->dof_count, sample_count);
+
+  MatrixNd Q (model->q_size, sample_count);
+  MatrixNd QDot (model->qdot_size, sample_count);
+  MatrixNd Tau (model->qdot_size, sample_count);
+  MatrixNd QDDot (model->qdot_size, sample_count);
+
+  for (int i = 0; i < sample_count; i++) {
+    Q.col(i) = sample_data.q[i];
+    QDot.col(i) = sample_data.qdot[i];
+    Tau.col(i) = sample_data.tau[i];
+  }
+
+  TimerInfo tinfo;
+  double duration = 0.;
+
+  for (size_t ti = 0; ti < benchmark_thread_counts.size(); ti++) {
+    BatchExecutor executor (*model, benchmark_thread_counts[ti]);
+
+    sample_timer_start (&tinfo);
+    executor.ForwardDynamics (Q, QDot, Tau, QDDot);
+    duration = timer_stop (&tinfo);
+
+    report_throughput_run(*model, duration, sample_count,
+        "ForwardDynamicsBatchExecutor", executor.GetThreadCount());
+  }
+
+  return duration;
+}
+
+/// Joint types of the model created by generate_human36model()
+typedef UnrolledJoints<
+  // pelvis (emulated floating base)
+  JointTypePrismatic, JointTypePrismatic, JointTypePrismatic,
+  JointTypeRevoluteY, JointTypeRevoluteZ, JointTypeRevoluteX,
+  // right leg
+  JointTypeRevoluteY, JointTypeRevoluteX, JointTypeRevoluteZ,
+  JointTypeRevoluteY, JointTypeRevoluteY, JointTypeRevoluteZ,
+  // left leg
+  JointTypeRevoluteY, JointTypeRevoluteX, JointTypeRevoluteZ,
+  JointTypeRevoluteY, JointTypeRevoluteY, JointTypeRevoluteZ,
+  // middle trunk
+  JointTypeRevoluteY, JointTypeRevoluteX, JointTypeRevoluteZ,
+  // right arm
+  JointTypeRevoluteY, JointTypeRevoluteX, JointTypeRevoluteZ,
+  JointTypeRevoluteY, JointTypeRevoluteY, JointTypeRevoluteZ,
+  // left arm
+  JointTypeRevoluteY, JointTypeRevoluteX, JointTypeRevoluteZ,
+  JointTypeRevoluteY, JointTypeRevoluteY, JointTypeRevoluteZ,
+  // head
+  JointTypeRevoluteY, JointTypeRevoluteX, JointTypeRevoluteZ
+  > Human36Joints;
+
+double run_forward_dynamics_unrolled_benchmark (int sample_count) {
+  Model *model = new Model();
+  generate_human36model(model);
+  model_name = "Human36";
+
+  if (!Human36Joints::Matches (*model)) {
+    cerr << "Joint types of the Human36 model do not match Human36Joints!" << endl;
+    abort();
+  }
+
+  SampleData sample_data;
+  sample_data.fillRandom(model->dof_count, sample_count);
+
+  TimerInfo tinfo;
+
+  for (int i = 0; i < sample_count; i++) {
+    sample_timer_start (&tinfo);
     ForwardDynamics (*model,
         sample_data.q[i],
         sample_data.qdot[i],
@@ -164,6 +468,20 @@ double run_forward_dynamics_ABA_benchmark (Model *model, int sample_count) {
 
   report_run(*model, sample_data, "ForwardDynamics");
 
+  for (int i = 0; i < sample_count; i++) {
+    sample_timer_start (&tinfo);
+    ForwardDynamicsUnrolled<Human36Joints> (*model,
+        sample_data.q[i],
+        sample_data.qdot[i],
+        sample_data.tau[i],
+        sample_data.qddot[i]);
+    sample_data.durations[i] = timer_stop (&tinfo);
+  }
+
+  report_run(*model, sample_data, "ForwardDynamicsUnrolled");
+
+  delete model;
+
   return sample_data.durations.sum();
 }
 
@@ -177,7 +495,7 @@ double run_forward_dynamics_lagrangian_benchmark (Model *model, int sample_count
   VectorNd C (VectorNd::Zero(model->dof_count));
 
   for (int i = 0; i < sample_count; i++) {
-    timer_start (&tinfo);
+    sample_timer_start (&tinfo);
     ForwardDynamicsLagrangian (*model,
         sample_data.q[i],
         sample_data.qdot[i],
@@ -193,6 +511,23 @@ double run_forward_dynamics_lagrangian_benchmark (Model *model, int sample_count
 
   report_run(*model, sample_data, "ForwardDynamicsLagrangian_PivLU");
 
+  for (int i = 0; i < sample_count; i++) {
+    sample_timer_start (&tinfo);
+    ForwardDynamicsLagrangian (*model,
+        sample_data.q[i],
+        sample_data.qdot[i],
+        sample_data.tau[i],
+        sample_data.qddot[i],
+        Math::LinearSolverSparseLTL,
+        NULL,
+        &H,
+        &C
+        );
+    sample_data.durations[i] = timer_stop (&tinfo);
+  }
+
+  report_run(*model, sample_data, "ForwardDynamicsLagrangian_SparseLTL");
+
   return sample_data.durations.sum();
 }
 
@@ -201,10 +536,9 @@ double run_inverse_dynamics_RNEA_benchmark (Model *model, int sample_count) {
   sample_data.fillRandom(model->dof_count, sample_count);
 
   TimerInfo tinfo;
-  timer_start (&tinfo);
 
   for (int i = 0; i < sample_count; i++) {
-    timer_start (&tinfo);
+    sample_timer_start (&tinfo);
     InverseDynamics (*model,
         sample_data.q[i],
         sample_data.qdot[i],
@@ -230,7 +564,7 @@ double run_CRBA_benchmark (Model *model, int sample_count) {
   TimerInfo tinfo;
 
   for (int i = 0; i < sample_count; i++) {
-    timer_start (&tinfo);
+    sample_timer_start (&tinfo);
     CompositeRigidBodyAlgorithm (*model, sample_data.q[i], H, true);
     sample_data.durations[i] = timer_stop (&tinfo);
   }
@@ -247,7 +581,7 @@ double run_nle_benchmark (Model *model, int sample_count) {
   TimerInfo tinfo;
 
   for (int i = 0; i < sample_count; i++) {
-    timer_start (&tinfo);
+    sample_timer_start (&tinfo);
     NonlinearEffects (*model,
         sample_data.q[i],
         sample_data.qdot[i],
@@ -270,12 +604,79 @@ double run_calc_minv_times_tau_benchmark (Model *model, int sample_count) {
   TimerInfo tinfo;
 
   for (int i = 0; i < sample_count; i++) {
-    timer_start (&tinfo);
+    sample_timer_start (&tinfo);
     CalcMInvTimesTau (*model, sample_data.q[i], sample_data.tau[i], sample_data.qddot[i]);
     sample_data.durations[i] = timer_stop (&tinfo);
   }
 
-  report_run(*model, sample_data, "NonlinearEffects");
+  report_run(*model, sample_data, "CalcMInvTimesTau");
+
+  return sample_data.durations.sum();
+}
+
+double run_centroidal_momentum_matrix_benchmark (Model *model, int sample_count) {
+  SampleData sample_data;
+  sample_data.fillRandom(model->dof_count, sample_count);
+
+  Math::MatrixNd A_G = Math::MatrixNd::Zero(6, model->qdot_size);
+  Math::SpatialVector A_G_dot_qdot;
+
+  TimerInfo tinfo;
+
+  for (int i = 0; i < sample_count; i++) {
+    sample_timer_start (&tinfo);
+    Utils::CalcCentroidalMomentumBias (*model,
+        sample_data.q[i],
+        sample_data.qdot[i],
+        A_G_dot_qdot,
+        &A_G
+        );
+    sample_data.durations[i] = timer_stop (&tinfo);
+  }
+
+  report_run(*model, sample_data, "CalcCentroidalMomentumBias");
+
+  return sample_data.durations.sum();
+}
+
+/** Computes A_G and the bias term column by column with
+ * Utils::CalcCenterOfMass(), i.e. one momentum evaluation for every degree
+ * of freedom. */
+double run_centroidal_momentum_matrix_columns_benchmark (Model *model, int sample_count) {
+  SampleData sample_data;
+  sample_data.fillRandom(model->dof_count, sample_count);
+
+  Math::MatrixNd A_G = Math::MatrixNd::Zero(6, model->qdot_size);
+  Math::SpatialVector A_G_dot_qdot;
+  Math::VectorNd qdot_unit = Math::VectorNd::Zero(model->qdot_size);
+  Math::VectorNd qddot_zero = Math::VectorNd::Zero(model->qdot_size);
+
+  double mass;
+  Math::Vector3d com, com_velocity, angular_momentum;
+  Math::Vector3d com_acceleration, change_of_angular_momentum;
+
+  TimerInfo tinfo;
+
+  for (int i = 0; i < sample_count; i++) {
+    sample_timer_start (&tinfo);
+    for (unsigned int j = 0; j < model->qdot_size; j++) {
+      qdot_unit[j] = 1.;
+      Utils::CalcCenterOfMass (*model, sample_data.q[i], qdot_unit, NULL,
+          mass, com, &com_velocity, NULL, &angular_momentum);
+      qdot_unit[j] = 0.;
+
+      A_G.block<3,1>(0, j) = angular_momentum;
+      A_G.block<3,1>(3, j) = mass * com_velocity;
+    }
+
+    Utils::CalcCenterOfMass (*model, sample_data.q[i], sample_data.qdot[i],
+        &qddot_zero, mass, com, NULL, &com_acceleration, NULL,
+        &change_of_angular_momentum);
+    A_G_dot_qdot << change_of_angular_momentum, mass * com_acceleration;
+    sample_data.durations[i] = timer_stop (&tinfo);
+  }
+
+  report_run(*model, sample_data, "CentroidalMomentumMatrixColumns");
 
   return sample_data.durations.sum();
 }
@@ -305,7 +706,7 @@ double run_contacts_lagrangian_benchmark (Model *model, ConstraintSet *constrain
   TimerInfo tinfo;
 
   for (int i = 0; i < sample_count; i++) {
-    timer_start (&tinfo);
+    sample_timer_start (&tinfo);
     ForwardDynamicsConstraintsDirect (*model, sample_data.q[i], sample_data.qdot[i], sample_data.tau[i], *constraint_set, sample_data.qddot[i]);
     sample_data.durations[i] = timer_stop (&tinfo);
   }
@@ -322,7 +723,7 @@ double run_contacts_lagrangian_sparse_benchmark (Model *model, ConstraintSet *co
   TimerInfo tinfo;
 
   for (int i = 0; i < sample_count; i++) {
-    timer_start (&tinfo);
+    sample_timer_start (&tinfo);
     ForwardDynamicsConstraintsRangeSpaceSparse (*model, sample_data.q[i], sample_data.qdot[i], sample_data.tau[i], *constraint_set, sample_data.qddot[i]);
     sample_data.durations[i] = timer_stop (&tinfo);
   }
@@ -332,6 +733,28 @@ double run_contacts_lagrangian_sparse_benchmark (Model *model, ConstraintSet *co
   return sample_data.durations.sum();
 }
 
+double run_contacts_lagrangian_sparse_ltl_benchmark (Model *model, ConstraintSet *constraint_set, int sample_count) {
+  SampleData sample_data;
+  sample_data.fillRandom(model->dof_count, sample_count);
+
+  LinearSolver linear_solver = constraint_set->linear_solver;
+  constraint_set->SetSolver (LinearSolverSparseLTL);
+
+  TimerInfo tinfo;
+
+  for (int i = 0; i < sample_count; i++) {
+    sample_timer_start (&tinfo);
+    ForwardDynamicsConstraintsRangeSpaceSparse (*model, sample_data.q[i], sample_data.qdot[i], sample_data.tau[i], *constraint_set, sample_data.qddot[i]);
+    sample_data.durations[i] = timer_stop (&tinfo);
+  }
+
+  constraint_set->SetSolver (linear_solver);
+
+  report_constraints_run(*model, sample_data, "ForwardDynamicsConstraintsRangeSpaceSparseLTL");
+
+  return sample_data.durations.sum();
+}
+
 double run_contacts_null_space (Model *model, ConstraintSet *constraint_set, int sample_count) {
   SampleData sample_data;
   sample_data.fillRandom(model->dof_count, sample_count);
@@ -339,7 +762,7 @@ double run_contacts_null_space (Model *model, ConstraintSet *constraint_set, int
   TimerInfo tinfo;
 
   for (int i = 0; i < sample_count; i++) {
-    timer_start (&tinfo);
+    sample_timer_start (&tinfo);
     ForwardDynamicsConstraintsNullSpace (*model, sample_data.q[i], sample_data.qdot[i], sample_data.tau[i], *constraint_set, sample_data.qddot[i]);
     sample_data.durations[i] = timer_stop (&tinfo);
   }
@@ -356,7 +779,7 @@ double run_contacts_kokkevis_benchmark (Model *model, ConstraintSet *constraint_
   TimerInfo tinfo;
 
   for (int i = 0; i < sample_count; i++) {
-    timer_start (&tinfo);
+    sample_timer_start (&tinfo);
     ForwardDynamicsContactsKokkevis(*model, sample_data.q[i], sample_data.qdot[i], sample_data.tau[i], *constraint_set, sample_data.qddot[i]);
     sample_data.durations[i] = timer_stop (&tinfo);
   }
@@ -478,6 +901,8 @@ void contacts_benchmark (int sample_count, ContactsMethod contacts_method) {
     run_contacts_lagrangian_benchmark (model, &one_body_one_constraint, sample_count);
   } else if (contacts_method == ConstraintsMethodRangeSpaceSparse) {
     run_contacts_lagrangian_sparse_benchmark (model, &one_body_one_constraint, sample_count);
+  } else if (contacts_method == ConstraintsMethodRangeSpaceSparseLTL) {
+    run_contacts_lagrangian_sparse_ltl_benchmark (model, &one_body_one_constraint, sample_count);
   } else if (contacts_method == ConstraintsMethodNullSpace) {
     run_contacts_null_space (model, &one_body_one_constraint, sample_count);
   } else {
@@ -490,6 +915,8 @@ void contacts_benchmark (int sample_count, ContactsMethod contacts_method) {
     run_contacts_lagrangian_benchmark (model, &two_bodies_one_constraint, sample_count);
   } else if (contacts_method == ConstraintsMethodRangeSpaceSparse) {
     run_contacts_lagrangian_sparse_benchmark (model, &two_bodies_one_constraint, sample_count);
+  } else if (contacts_method == ConstraintsMethodRangeSpaceSparseLTL) {
+    run_contacts_lagrangian_sparse_ltl_benchmark (model, &two_bodies_one_constraint, sample_count);
   } else if (contacts_method == ConstraintsMethodNullSpace) {
     run_contacts_null_space (model, &two_bodies_one_constraint, sample_count);
   } else {
@@ -502,6 +929,8 @@ void contacts_benchmark (int sample_count, ContactsMethod contacts_method) {
     run_contacts_lagrangian_benchmark (model, &four_bodies_one_constraint, sample_count);
   } else if (contacts_method == ConstraintsMethodRangeSpaceSparse) {
     run_contacts_lagrangian_sparse_benchmark (model, &four_bodies_one_constraint, sample_count);
+  } else if (contacts_method == ConstraintsMethodRangeSpaceSparseLTL) {
+    run_contacts_lagrangian_sparse_ltl_benchmark (model, &four_bodies_one_constraint, sample_count);
   } else if (contacts_method == ConstraintsMethodNullSpace) {
     run_contacts_null_space (model, &four_bodies_one_constraint, sample_count);
   } else {
@@ -514,6 +943,8 @@ void contacts_benchmark (int sample_count, ContactsMethod contacts_method) {
     run_contacts_lagrangian_benchmark (model, &one_body_four_constraints, sample_count);
   } else if (contacts_method == ConstraintsMethodRangeSpaceSparse) {
     run_contacts_lagrangian_sparse_benchmark (model, &one_body_four_constraints, sample_count);
+  } else if (contacts_method == ConstraintsMethodRangeSpaceSparseLTL) {
+    run_contacts_lagrangian_sparse_ltl_benchmark (model, &one_body_four_constraints, sample_count);
   } else if (contacts_method == ConstraintsMethodNullSpace) {
     run_contacts_null_space (model, &one_body_four_constraints, sample_count);
   } else {
@@ -526,6 +957,8 @@ void contacts_benchmark (int sample_count, ContactsMethod contacts_method) {
     run_contacts_lagrangian_benchmark (model, &two_bodies_four_constraints, sample_count);
   } else if (contacts_method == ConstraintsMethodRangeSpaceSparse) {
     run_contacts_lagrangian_sparse_benchmark (model, &two_bodies_four_constraints, sample_count);
+  } else if (contacts_method == ConstraintsMethodRangeSpaceSparseLTL) {
+    run_contacts_lagrangian_sparse_ltl_benchmark (model, &two_bodies_four_constraints, sample_count);
   } else if (contacts_method == ConstraintsMethodNullSpace) {
     run_contacts_null_space (model, &two_bodies_four_constraints, sample_count);
   } else {
@@ -538,6 +971,8 @@ void contacts_benchmark (int sample_count, ContactsMethod contacts_method) {
     run_contacts_lagrangian_benchmark (model, &four_bodies_four_constraints, sample_count);
   } else if (contacts_method == ConstraintsMethodRangeSpaceSparse) {
     run_contacts_lagrangian_sparse_benchmark (model, &four_bodies_four_constraints, sample_count);
+  } else if (contacts_method == ConstraintsMethodRangeSpaceSparseLTL) {
+    run_contacts_lagrangian_sparse_ltl_benchmark (model, &four_bodies_four_constraints, sample_count);
   } else if (contacts_method == ConstraintsMethodNullSpace) {
     run_contacts_null_space (model, &four_bodies_four_constraints, sample_count);
   } else {
@@ -547,22 +982,57 @@ void contacts_benchmark (int sample_count, ContactsMethod contacts_method) {
   delete model;
 }
 
-double run_single_inverse_kinematics_benchmark(Model *model, std::vector<InverseKinematicsConstraintSet> &CS, int sample_count){
+/** Compares ForwardDynamicsContactsKokkevis with
+ * ForwardDynamicsConstraintsDirect on the closed-chain models of the loop
+ * constraint tests. */
+void loop_constraints_benchmark (int sample_count) {
+  Model *model = new Model();
+  ConstraintSet constraint_set;
+  generate_four_bar_linkage (model, &constraint_set);
+
+  model_name = "FourBarLinkage_Direct";
+  run_contacts_lagrangian_benchmark (model, &constraint_set, sample_count);
+  model_name = "FourBarLinkage_Kokkevis";
+  run_contacts_kokkevis_benchmark (model, &constraint_set, sample_count);
+
+  delete model;
+
+  model = new Model();
+  constraint_set = ConstraintSet();
+  generate_slider_crank_3d (model, &constraint_set);
+
+  model_name = "SliderCrank3D_Direct";
+  run_contacts_lagrangian_benchmark (model, &constraint_set, sample_count);
+  model_name = "SliderCrank3D_Kokkevis";
+  run_contacts_kokkevis_benchmark (model, &constraint_set, sample_count);
+
+  delete model;
+}
+
+double run_single_inverse_kinematics_benchmark(Model *model, std::vector<InverseKinematicsConstraintSet> &CS, int sample_count, const char *run_name){
   TimerInfo tinfo;
-  timer_start (&tinfo);
   VectorNd qinit = VectorNd::Zero(model->dof_count);
   VectorNd qres = VectorNd::Zero(model->dof_count);
-  VectorNd failures = VectorNd::Zero(model->dof_count);
+  VectorNd failures = VectorNd::Zero(sample_count);
+
+  SampleData sample_data;
+  sample_data.count = sample_count;
+  sample_data.durations = VectorNd::Zero(sample_count);
 
   for (int i = 0; i < sample_count; i++) {
+    sample_timer_start (&tinfo);
     if (!InverseKinematics(*model, qinit, CS[i], qres)){
       failures[i] = 1;
     }
+    sample_data.durations[i] = timer_stop (&tinfo);
   }
-  double duration = timer_stop (&tinfo);
-  std::cout << "Success Rate: " << (1-failures.mean())*100 << "%  for: ";
-  return duration;
-  
+
+  if (!json_output) {
+    std::cout << "Success Rate: " << (1-failures.mean())*100 << "%  for: " << run_name << endl;
+  }
+  report_run(*model, sample_data, run_name);
+
+  return sample_data.durations.sum();
 }
 
 double run_all_inverse_kinematics_benchmark (int sample_count){
@@ -650,37 +1120,129 @@ double run_all_inverse_kinematics_benchmark (int sample_count){
     cs_five_full.push_back(five_full);
   }
   
-  cout << "= #DOF: " << setw(3) << model->dof_count << endl;
-  cout << "= #samples: " << sample_count << endl;
+  model_name = "Human36";
+  if (!json_output) {
+    cout << "= #DOF: " << setw(3) << model->dof_count << endl;
+    cout << "= #samples: " << sample_count << endl;
+  }
   double duration;
-  
-  duration = run_single_inverse_kinematics_benchmark(model, cs_one_point, sample_count);
-  cout << "Constraints: 1 Body:   1 Point                      : "
-  << " duration = " << setw(10) << duration << "(s)"
-  << " (~" << setw(10) << duration / sample_count << "(s) per call)" << endl;
-  
-  duration = run_single_inverse_kinematics_benchmark(model, cs_two_point_one_orientation, sample_count);
-  cout << "Constraints: 3 Bodies: 2 Points 1 Orienation        : "
-  << " duration = " << setw(10) << duration << "(s)"
-  << " (~" << setw(10) << duration / sample_count << "(s) per call)" << endl;
-  
-  duration = run_single_inverse_kinematics_benchmark(model, cs_two_full_one_point, sample_count);
-  cout << "Constraints: 3 Bodies: 2 Full 1 Point               : "
-  << " duration = " << setw(10) << duration << "(s)"
-  << " (~" << setw(10) << duration / sample_count << "(s) per call)" << endl;
-  
-  duration = run_single_inverse_kinematics_benchmark(model, cs_two_full_two_point_one_orientation, sample_count);  
-  cout << "Constraints: 5 Bodies: 2 Full 2 Points 1 Orienation : "
-  << " duration = " << setw(10) << duration << "(s)"
-  << " (~" << setw(10) << duration / sample_count << "(s) per call)" << endl;
-  
-  duration = run_single_inverse_kinematics_benchmark(model, cs_five_full, sample_count);  
-  cout << "Constraints: 5 Bodies: 5 Full                       : "
-  << " duration = " << setw(10) << duration << "(s)"
-  << " (~" << setw(10) << duration / sample_count << "(s) per call)" << endl;
+
+  duration = run_single_inverse_kinematics_benchmark(model, cs_one_point, sample_count,
+      "InverseKinematics_1Bodies_1Points");
+  duration = run_single_inverse_kinematics_benchmark(model, cs_two_point_one_orientation, sample_count,
+      "InverseKinematics_3Bodies_2Points_1Orientations");
+  duration = run_single_inverse_kinematics_benchmark(model, cs_two_full_one_point, sample_count,
+      "InverseKinematics_3Bodies_2Full_1Points");
+  duration = run_single_inverse_kinematics_benchmark(model, cs_two_full_two_point_one_orientation, sample_count,
+      "InverseKinematics_5Bodies_2Full_2Points_1Orientations");
+  duration = run_single_inverse_kinematics_benchmark(model, cs_five_full, sample_count,
+      "InverseKinematics_5Bodies_5Full");
+
+  delete model;
+
   return duration;
 }
 
+double run_point_inverse_kinematics_benchmark (int sample_count) {
+  Model *model = new Model();
+  generate_human36model(model);
+
+  std::vector<unsigned int> body_ids;
+  body_ids.push_back (model->GetBodyId ("foot_r"));
+  body_ids.push_back (model->GetBodyId ("foot_l"));
+  body_ids.push_back (model->GetBodyId ("hand_r"));
+  body_ids.push_back (model->GetBodyId ("hand_l"));
+  body_ids.push_back (model->GetBodyId ("head"));
+
+  std::vector<Vector3d> body_points;
+  body_points.push_back (Vector3d (1., 0., 0.));
+  body_points.push_back (Vector3d (-1., 0., 0.));
+  body_points.push_back (Vector3d (0., 1., 0.));
+  body_points.push_back (Vector3d (1., 0., 1.));
+  body_points.push_back (Vector3d (0., 0., -1.));
+
+  SampleData sample_data;
+  sample_data.fillRandom(model->dof_count, sample_count);
+
+  std::vector<std::vector<Vector3d> > target_pos (sample_count);
+  for (int i = 0; i < sample_count; i++) {
+    for (unsigned int k = 0; k < body_ids.size(); k++) {
+      target_pos[i].push_back (CalcBodyToBaseCoordinates (*model,
+            sample_data.q[i], body_ids[k], body_points[k]));
+    }
+  }
+
+  VectorNd qinit = VectorNd::Zero(model->q_size);
+  VectorNd qres = VectorNd::Zero(model->q_size);
+
+  model_name = "Human36";
+  if (!json_output) {
+    cout << "= #DOF: " << setw(3) << model->dof_count << endl;
+    cout << "= #samples: " << sample_count << endl;
+  }
+
+  TimerInfo tinfo;
+  unsigned long malloc_count_start = malloc_count;
+  for (int i = 0; i < sample_count; i++) {
+    sample_timer_start (&tinfo);
+    InverseKinematics (*model, qinit, body_ids, body_points, target_pos[i],
+        qres, 1.0e-12, 0.01, 55);
+    sample_data.durations[i] = timer_stop (&tinfo);
+  }
+  unsigned long malloc_count_default = malloc_count - malloc_count_start;
+
+  if (!json_output) {
+    cout << "Points: 5 Bodies: 5 Points";
+    if (have_malloc_count) {
+      cout << " allocations per call: "
+        << static_cast<double>(malloc_count_default) / sample_count;
+    }
+    cout << endl;
+  }
+  report_run(*model, sample_data, "InverseKinematicsPoints");
+
+  ModelData data (*model);
+  InverseKinematicsWorkspace workspace (*model, body_ids.size());
+
+  malloc_count_start = malloc_count;
+  for (int i = 0; i < sample_count; i++) {
+    sample_timer_start (&tinfo);
+    InverseKinematics (*model, data, qinit, body_ids, body_points,
+        target_pos[i], qres, workspace, 1.0e-12, 0.01, 55);
+    sample_data.durations[i] = timer_stop (&tinfo);
+  }
+  unsigned long malloc_count_workspace = malloc_count - malloc_count_start;
+
+  if (!json_output) {
+    cout << "Points: 5 Bodies: 5 Points (workspace)";
+    if (have_malloc_count) {
+      cout << " allocations per call: "
+        << static_cast<double>(malloc_count_workspace) / sample_count;
+    }
+    cout << endl;
+  }
+  report_run(*model, sample_data, "InverseKinematicsPointsWorkspace");
+
+  delete model;
+
+  return sample_data.durations.sum();
+}
+
+/** Creates the branched planar test model of the given depth and sets the
+ * model name that is reported for the runs. */
+Model* create_planar_model (int depth) {
+  ostringstream model_name_stream;
+  model_name_stream << "planar_model_depth_" << depth;
+  model_name = model_name_stream.str();
+
+  Model *model = new Model();
+  model->gravity = Vector3d (0., -9.81, 0.);
+
+  generate_planar_tree (model, depth);
+
+  return model;
+}
+
 void print_usage () {
 #if defined (RBDL_BUILD_ADDON_LUAMODEL) || defined (RBDL_BUILD_ADDON_URDFREADER)
   cout << "Usage: benchmark [--count|-c <sample_count>] [--depth|-d <depth>] <model.lua>" << endl;
@@ -696,11 +1258,27 @@ void print_usage () {
   cout << "  --floating-base | -f        : the specified URDF model is a floating base model." << endl;
 #endif
   cout << "  --json                      : prints output in json format." << endl;
+  cout << "  --histogram                 : prints the latency histogram of every run." << endl;
+  cout << "  --cold-cache                : flushes the caches before every timed call" << endl;
+  cout << "                                (default: warm caches)." << endl;
+  cout << "  --threads <n1,n2,...>       : runs forward dynamics with a BatchExecutor" << endl;
+  cout << "                                for every given thread count (0: number of" << endl;
+  cout << "                                hardware threads)." << endl;
+  cout << "  --baseline <results.json>   : compares the median call time of every run" << endl;
+  cout << "                                with the same run of a previous --json output" << endl;
+  cout << "                                and exits with 1 if any run is slower than" << endl;
+  cout << "                                the threshold." << endl;
+  cout << "  --threshold <percent>       : allowed slowdown for --baseline (default: 10)." << endl;
   cout << "  --no-fd                     : disables benchmarking of forward dynamics." << endl;
   cout << "  --no-fd-aba                 : disables benchmark for forwards dynamics using" << endl;
   cout << "                                the Articulated Body Algorithm" << endl;
+  cout << "  --no-fd-batch               : disables benchmark for batched forward" << endl;
+  cout << "                                dynamics compared to single calls." << endl;
+  cout << "  --no-fd-unrolled            : disables benchmark for forward dynamics" << endl;
+  cout << "                                unrolled for the joints of a fixed model." << endl;
   cout << "  --no-fd-lagrangian          : disables benchmark for forward dynamics via" << endl;
-  cout << "                                solving the lagrangian equation." << endl;
+  cout << "                                solving the lagrangian equation (dense and" << endl;
+  cout << "                                sparse LTL)." << endl;
   cout << "  --no-id-rnea                : disables benchmark for inverse dynamics using" << endl;
   cout << "                                the recursive newton euler algorithm." << endl;
   cout << "  --no-crba                   : disables benchmark for joint space inertia" << endl;
@@ -708,6 +1286,9 @@ void print_usage () {
   cout << "                                body algorithm." << endl;
   cout << "  --no-nle                    : disables benchmark for the nonlinear effects." << endl;
   cout << "  --no-calc-minv              : disables benchmark M^-1 * tau benchmark." << endl;
+  cout << "  --no-centroidal             : disables benchmark for the centroidal" << endl;
+  cout << "                                momentum matrix compared to computing it" << endl;
+  cout << "                                column by column." << endl;
   cout << "  --only-contacts | -C        : only runs contact model benchmarks." << endl;
   cout << "  --only-ik                   : only runs inverse kinematics benchmarks." << endl;
   cout << "  --help | -h                 : prints this help." << endl;
@@ -715,12 +1296,17 @@ void print_usage () {
 
 void disable_all_benchmarks () {
   benchmark_run_fd_aba = false;
+  benchmark_run_fd_batch = false;
+  benchmark_run_fd_unrolled = false;
   benchmark_run_fd_lagrangian = false;
   benchmark_run_id_rnea = false;
   benchmark_run_crba = false;
   benchmark_run_nle = false;
   benchmark_run_calc_minv_times_tau = false;
+  benchmark_run_centroidal = false;
   benchmark_run_contacts = false;
+  benchmark_run_ik = false;
+  benchmark_thread_counts.clear();
 }
 
 void parse_args (int argc, char* argv[]) {
@@ -762,11 +1348,59 @@ void parse_args (int argc, char* argv[]) {
 #endif
     } else if (arg == "--json") {
       json_output = true;
+    } else if (arg == "--histogram") {
+      print_histograms = true;
+    } else if (arg == "--cold-cache") {
+      cold_cache = true;
+    } else if (arg == "--threads") {
+      if (argi == argc - 1) {
+        print_usage();
+
+        cerr << "Error: missing list of thread counts!" << endl;
+        exit (1);
+      }
+
+      argi++;
+      stringstream threads_stream (argv[argi]);
+      string thread_count;
+
+      benchmark_thread_counts.clear();
+      while (getline (threads_stream, thread_count, ',')) {
+        benchmark_thread_counts.push_back (atoi (thread_count.c_str()));
+      }
+    } else if (arg == "--baseline") {
+      if (argi == argc - 1) {
+        print_usage();
+
+        cerr << "Error: missing baseline file!" << endl;
+        exit (1);
+      }
+
+      argi++;
+      baseline_filename = argv[argi];
+    } else if (arg == "--threshold") {
+      if (argi == argc - 1) {
+        print_usage();
+
+        cerr << "Error: missing regression threshold!" << endl;
+        exit (1);
+      }
+
+      argi++;
+      stringstream threshold_stream (argv[argi]);
+
+      threshold_stream >> regression_threshold;
     } else if (arg == "--no-fd" ) {
       benchmark_run_fd_aba = false;
+      benchmark_run_fd_batch = false;
+      benchmark_run_fd_unrolled = false;
       benchmark_run_fd_lagrangian = false;
     } else if (arg == "--no-fd-aba" ) {
       benchmark_run_fd_aba = false;
+    } else if (arg == "--no-fd-batch" ) {
+      benchmark_run_fd_batch = false;
+    } else if (arg == "--no-fd-unrolled" ) {
+      benchmark_run_fd_unrolled = false;
     } else if (arg == "--no-fd-lagrangian" ) {
       benchmark_run_fd_lagrangian = false;
     } else if (arg == "--no-id-rnea" ) {
@@ -777,6 +1411,8 @@ void parse_args (int argc, char* argv[]) {
       benchmark_run_nle = false;
     } else if (arg == "--no-calc-minv" ) {
       benchmark_run_calc_minv_times_tau = false;
+    } else if (arg == "--no-centroidal" ) {
+      benchmark_run_centroidal = false;
     } else if (arg == "--only-contacts" || arg == "-C") {
       disable_all_benchmarks();
       benchmark_run_contacts = true;
@@ -796,9 +1432,228 @@ void parse_args (int argc, char* argv[]) {
   }
 }
 
+void print_json_results () {
+  cout.precision(15);
+  cout << "{" << endl;
+
+  cout << "    \"rbdl_info\" : {" << endl;
+  int compile_version = rbdl_get_api_version();
+  int compile_major = (compile_version & 0xff0000) >> 16;
+  int compile_minor = (compile_version & 0x00ff00) >> 8;
+  int compile_patch = (compile_version & 0x0000ff);
+
+  std::ostringstream compile_version_string("");
+  compile_version_string << compile_major << "." << compile_minor << "." << compile_patch;
+
+  cout << "        \"version_str\" : \"" << compile_version_string.str() << "\"," << endl;
+  cout << "        \"major\" : " << compile_major << "," << endl;
+  cout << "        \"minor\" : " << compile_minor << "," << endl;
+  cout << "        \"patch\" : " << compile_patch << "," << endl;
+  cout << "        \"build_type\" : \"" << RBDL_BUILD_TYPE << "\"," << endl;
+  cout << "        \"commit\" : \"" << RBDL_BUILD_COMMIT << "\"," << endl;
+  cout << "        \"branch\" : \"" << RBDL_BUILD_BRANCH << "\"," << endl;
+  cout << "        \"compiler_id\" : \"" << RBDL_BUILD_COMPILER_ID << "\"," << endl;
+  cout << "        \"compiler_version\" : \"" << RBDL_BUILD_COMPILER_VERSION << "\"" << endl;
+
+  cout << "    }," << endl;
+
+  cout << "    \"host_info\" : {" << endl;
+  cout << "        \"cpu_model_name\" : \"" << get_cpu_model_name() << "\"," << endl;
+  cout << "        \"time_utc\" : " << "\"" << get_utc_time_string() << "\"" << endl;
+  cout << "    }," << endl;
+
+  cout << "    \"runs\" : ";
+  cout << "[" << endl;
+
+  for (size_t i = 0; i < benchmark_runs.size(); i++) {
+    const BenchmarkRun& run = benchmark_runs[i];
+
+    const char* indent = "            ";
+
+    cout << "        " << "{" << endl;
+    cout << indent << "\"model\" : \"" << run.model_name << "\"," << endl;
+    cout << indent << "\"dof\" : " << run.model_dof << "," << endl;
+    cout << indent << "\"benchmark\" : \"" << run.benchmark << "\"," << endl;
+    cout << indent << "\"threads\" : " << run.threads << "," << endl;
+    cout << indent << "\"cache\" : \"" << run.cache << "\"," << endl;
+    cout << indent << "\"duration\" : " << run.duration << "," << endl;
+    cout << indent << "\"sample_count\" : " << run.sample_count << "," << endl;
+    cout << indent << "\"avg\" : " << run.avg << "," << endl;
+    if (run.throughput_only) {
+      // batched runs have no durations of single samples
+      cout << indent << "\"throughput_only\" : true" << endl;
+    } else {
+      cout << indent << "\"min\" : " << run.min << "," << endl;
+      cout << indent << "\"max\" : " << run.max << "," << endl;
+      cout << indent << "\"p50\" : " << run.p50 << "," << endl;
+      cout << indent << "\"p99\" : " << run.p99 << "," << endl;
+      cout << indent << "\"p999\" : " << run.p999 << "," << endl;
+      cout << indent << "\"histogram_log2_ns\" : [";
+      for (size_t j = 0; j < run.histogram.size(); j++) {
+        cout << (j == 0 ? "" : ", ") << run.histogram[j];
+      }
+      cout << "]" << endl;
+    }
+    cout << "        " << "}";
+
+    if (i != benchmark_runs.size() - 1) {
+      cout << ",";
+    }
+    cout << endl;
+  }
+
+  cout << "    ]" << endl;
+
+  cout << "}" << endl;
+}
+
+/** Returns the value of the given key of a flat JSON object as string. */
+string get_json_value (const string &object, const string &key) {
+  size_t pos = object.find ("\"" + key + "\"");
+  if (pos == string::npos) {
+    return "";
+  }
+
+  pos = object.find_first_not_of (" \t\n", object.find (':', pos) + 1);
+  if (object[pos] == '"') {
+    return object.substr (pos + 1, object.find ('"', pos + 1) - pos - 1);
+  }
+
+  return object.substr (pos, object.find_first_of (",}\n", pos) - pos);
+}
+
+/** Reads the runs of a file that was written with --json. */
+bool load_baseline_runs (const string &filename, vector<BenchmarkRun> &runs) {
+  ifstream baseline_file (filename.c_str(), ios_base::in);
+  if (!baseline_file) {
+    return false;
+  }
+  ostringstream content;
+  content << baseline_file.rdbuf();
+  string content_str = content.str();
+
+  size_t pos = content_str.find ("\"runs\"");
+  if (pos == string::npos) {
+    return false;
+  }
+
+  // the run objects are the only objects after "runs" and do not contain
+  // nested objects
+  while ((pos = content_str.find ('{', pos)) != string::npos) {
+    size_t end = content_str.find ('}', pos);
+    string object = content_str.substr (pos, end - pos + 1);
+    pos = end;
+
+    BenchmarkRun run;
+    run.model_name = get_json_value (object, "model");
+    run.benchmark = get_json_value (object, "benchmark");
+    run.model_dof = atoi (get_json_value (object, "dof").c_str());
+    run.sample_count = atoi (get_json_value (object, "sample_count").c_str());
+    run.avg = atof (get_json_value (object, "avg").c_str());
+
+    // files of older versions only contain the average and warm runs
+    string threads = get_json_value (object, "threads");
+    run.threads = threads == "" ? 1 : atoi (threads.c_str());
+    run.cache = get_json_value (object, "cache");
+    if (run.cache == "") {
+      run.cache = "warm";
+    }
+    string p50 = get_json_value (object, "p50");
+    run.p50 = p50 == "" ? run.avg : atof (p50.c_str());
+    run.throughput_only = get_json_value (object, "throughput_only") == "true";
+
+    runs.push_back (run);
+  }
+
+  return true;
+}
+
+/** Compares the median call time of the runs with the baseline and returns
+ * the number of runs that are slower than regression_threshold. */
+int compare_with_baseline () {
+  vector<BenchmarkRun> baseline_runs;
+  if (!load_baseline_runs (baseline_filename, baseline_runs)) {
+    cerr << "Error: could not read baseline file '" << baseline_filename
+      << "'." << endl;
+    exit (1);
+  }
+
+  // keeps stdout valid json
+  ostream &out = json_output ? cerr : cout;
+  out << "= Comparison with baseline " << baseline_filename << " (threshold: "
+    << regression_threshold << "%) =" << endl;
+
+  int regression_count = 0;
+  for (size_t i = 0; i < benchmark_runs.size(); i++) {
+    const BenchmarkRun &run = benchmark_runs[i];
+
+    const BenchmarkRun *baseline = NULL;
+    for (size_t j = 0; j < baseline_runs.size(); j++) {
+      if (baseline_runs[j].model_name == run.model_name
+          && baseline_runs[j].benchmark == run.benchmark
+          && baseline_runs[j].threads == run.threads
+          && baseline_runs[j].cache == run.cache) {
+        baseline = &baseline_runs[j];
+        break;
+      }
+    }
+
+    if (baseline == NULL) {
+      out << "  new        " << run.model_name << " " << run.benchmark
+        << " #threads: " << run.threads << " cache: " << run.cache << endl;
+      continue;
+    }
+
+    // there is no median call time of batched runs
+    if (run.throughput_only || baseline->throughput_only) {
+      out << "  skipped    " << run.model_name << " " << run.benchmark
+        << " #threads: " << run.threads << " cache: " << run.cache
+        << " (throughput only)" << endl;
+      continue;
+    }
+
+    double change = (run.p50 / baseline->p50 - 1.) * 100.;
+    bool regression = change > regression_threshold;
+    if (regression) {
+      regression_count++;
+    }
+
+    out << (regression ? "  REGRESSION " : "  ok         ")
+      << run.model_name << " " << run.benchmark
+      << " #threads: " << run.threads << " cache: " << run.cache
+      << " p50: " << baseline->p50 << "(s) -> " << run.p50 << "(s) ("
+      << showpos << setprecision(3) << change << noshowpos
+      << setprecision(6) << "%)" << endl;
+  }
+
+  out << regression_count << " of " << benchmark_runs.size()
+    << " runs exceed the regression threshold." << endl;
+
+  return regression_count;
+}
+
+/** Prints the json output and compares with the baseline. Returns the exit
+ * code of the benchmark. */
+int report_results () {
+  if (json_output) {
+    print_json_results();
+  }
+
+  if (baseline_filename != "" && compare_with_baseline() > 0) {
+    return 1;
+  }
+
+  return 0;
+}
+
 int main (int argc, char *argv[]) {
   parse_args (argc, argv);
 
+  if (cold_cache) {
+    // allocates the flush buffer before any allocations are counted
+    flush_caches();
+  }
+
   Model *model = NULL;
 
   model = new Model();
@@ -826,8 +1681,13 @@ int main (int argc, char *argv[]) {
       run_forward_dynamics_ABA_benchmark (model, benchmark_sample_count);
     }
 
+    if (benchmark_run_fd_batch) {
+      report_section("Forward Dynamics: ABA batch");
+      run_forward_dynamics_batch_benchmark (model, benchmark_sample_count);
+    }
+
     if (benchmark_run_fd_lagrangian) {
-      report_section("Forward Dynamics: Lagrangian (Piv. LU decomposition)");
+      report_section("Forward Dynamics: Lagrangian (Piv. LU / sparse LTL decomposition)");
       run_forward_dynamics_lagrangian_benchmark (model, benchmark_sample_count);
     }
 
@@ -846,9 +1706,14 @@ int main (int argc, char *argv[]) {
       run_nle_benchmark (model, benchmark_sample_count);
     }
 
+    if (!benchmark_thread_counts.empty()) {
+      report_section("Forward Dynamics: ABA thread sweep");
+      run_forward_dynamics_threads_benchmark (model, benchmark_sample_count);
+    }
+
     delete model;
 
-    return 0;
+    return report_results();
   }
 
   if (!json_output) {
@@ -859,28 +1724,45 @@ int main (int argc, char *argv[]) {
   if (benchmark_run_fd_aba) {
     report_section("Forward Dynamics: ABA");
     for (int depth = 1; depth <= benchmark_model_max_depth; depth++) {
-      ostringstream model_name_stream;
-      model_name_stream << "planar_model_depth_" << depth;
-      model_name = model_name_stream.str();
+      model = create_planar_model (depth);
 
-      model = new Model();
-      model->gravity = Vector3d (0., -9.81, 0.);
+      run_forward_dynamics_ABA_benchmark (model, benchmark_sample_count);
 
-      generate_planar_tree (model, depth);
+      delete model;
+    }
+  }
 
-      run_forward_dynamics_ABA_benchmark (model, benchmark_sample_count);
+  if (benchmark_run_fd_batch) {
+    report_section("Forward Dynamics: ABA batch");
+    for (int depth = 1; depth <= benchmark_model_max_depth; depth++) {
+      model = create_planar_model (depth);
+
+      run_forward_dynamics_batch_benchmark (model, benchmark_sample_count);
 
       delete model;
     }
   }
 
-  if (benchmark_run_fd_lagrangian) {
-    report_section("Forward Dynamics: Lagrangian (Piv. LU decomposition)");
+  if (!benchmark_thread_counts.empty()) {
+    report_section("Forward Dynamics: ABA thread sweep");
     for (int depth = 1; depth <= benchmark_model_max_depth; depth++) {
-      model = new Model();
-      model->gravity = Vector3d (0., -9.81, 0.);
+      model = create_planar_model (depth);
 
-      generate_planar_tree (model, depth);
+      run_forward_dynamics_threads_benchmark (model, benchmark_sample_count);
+
+      delete model;
+    }
+  }
+
+  if (benchmark_run_fd_unrolled) {
+    report_section("Forward Dynamics: ABA unrolled");
+    run_forward_dynamics_unrolled_benchmark (benchmark_sample_count);
+  }
+
+  if (benchmark_run_fd_lagrangian) {
+    report_section("Forward Dynamics: Lagrangian (Piv. LU / sparse LTL decomposition)");
+    for (int depth = 1; depth <= benchmark_model_max_depth; depth++) {
+      model = create_planar_model (depth);
 
       run_forward_dynamics_lagrangian_benchmark (model, benchmark_sample_count);
 
@@ -891,10 +1773,7 @@ int main (int argc, char *argv[]) {
   if (benchmark_run_id_rnea) {
     report_section("Inverse Dynamics: RNEA");
     for (int depth = 1; depth <= benchmark_model_max_depth; depth++) {
-      model = new Model();
-      model->gravity = Vector3d (0., -9.81, 0.);
-
-      generate_planar_tree (model, depth);
+      model = create_planar_model (depth);
 
       run_inverse_dynamics_RNEA_benchmark (model, benchmark_sample_count);
 
@@ -905,10 +1784,7 @@ int main (int argc, char *argv[]) {
   if (benchmark_run_crba) {
     report_section("Joint Space Inertia Matrix: CRBA");
     for (int depth = 1; depth <= benchmark_model_max_depth; depth++) {
-      model = new Model();
-      model->gravity = Vector3d (0., -9.81, 0.);
-
-      generate_planar_tree (model, depth);
+      model = create_planar_model (depth);
 
       run_CRBA_benchmark (model, benchmark_sample_count);
 
@@ -919,10 +1795,7 @@ int main (int argc, char *argv[]) {
   if (benchmark_run_nle) {
     report_section("Nonlinear Effects");
     for (int depth = 1; depth <= benchmark_model_max_depth; depth++) {
-      model = new Model();
-      model->gravity = Vector3d (0., -9.81, 0.);
-
-      generate_planar_tree (model, depth);
+      model = create_planar_model (depth);
 
       run_nle_benchmark (model, benchmark_sample_count);
 
@@ -933,10 +1806,7 @@ int main (int argc, char *argv[]) {
   if (benchmark_run_calc_minv_times_tau) {
     report_section("CalcMInvTimesTau");
     for (int depth = 1; depth <= benchmark_model_max_depth; depth++) {
-      model = new Model();
-      model->gravity = Vector3d (0., -9.81, 0.);
-
-      generate_planar_tree (model, depth);
+      model = create_planar_model (depth);
 
       run_calc_minv_times_tau_benchmark (model, benchmark_sample_count);
 
@@ -944,6 +1814,26 @@ int main (int argc, char *argv[]) {
     }
   }
 
+  if (benchmark_run_centroidal) {
+    report_section("Centroidal Momentum Matrix: O(n) vs. column by column");
+    for (int depth = 1; depth <= benchmark_model_max_depth; depth++) {
+      model = create_planar_model (depth);
+
+      run_centroidal_momentum_matrix_benchmark (model, benchmark_sample_count);
+      run_centroidal_momentum_matrix_columns_benchmark (model, benchmark_sample_count);
+
+      delete model;
+    }
+
+    model = new Model();
+    generate_human36model (model);
+
+    run_centroidal_momentum_matrix_benchmark (model, benchmark_sample_count);
+    run_centroidal_momentum_matrix_columns_benchmark (model, benchmark_sample_count);
+
+    delete model;
+  }
+
   if (benchmark_run_contacts) {
     report_section("Contacts: ForwardDynamicsConstraintsDirect");
     contacts_benchmark (benchmark_sample_count, ConstraintsMethodDirect);
@@ -951,77 +1841,24 @@ int main (int argc, char *argv[]) {
     report_section("Contacts: ForwardDynamicsConstraintsRangeSpaceSparse");
     contacts_benchmark (benchmark_sample_count, ConstraintsMethodRangeSpaceSparse);
 
+    report_section("Contacts: ForwardDynamicsConstraintsRangeSpaceSparse (LinearSolverSparseLTL)");
+    contacts_benchmark (benchmark_sample_count, ConstraintsMethodRangeSpaceSparseLTL);
+
     report_section("Contacts: ForwardDynamicsConstraintsNullSpace");
     contacts_benchmark (benchmark_sample_count, ConstraintsMethodNullSpace);
 
     report_section("Contacts: ForwardDynamicsContactsKokkevis");
     contacts_benchmark (benchmark_sample_count, ConstraintsMethodKokkevis);
+
+    report_section("Loop Constraints: ForwardDynamicsConstraintsDirect vs. ForwardDynamicsContactsKokkevis");
+    loop_constraints_benchmark (benchmark_sample_count);
   }
 
   if (benchmark_run_ik) {
     report_section("Inverse Kinematics");
+    run_point_inverse_kinematics_benchmark(benchmark_sample_count);
     run_all_inverse_kinematics_benchmark(benchmark_sample_count);
   }
 
-  if (json_output) {
-    cout.precision(15);
-    cout << "{" << endl;
-
-    cout << "    \"rbdl_info\" : {" << endl;
-    int compile_version = rbdl_get_api_version();
-    int compile_major = (compile_version & 0xff0000) >> 16;
-    int compile_minor = (compile_version & 0x00ff00) >> 8;
-    int compile_patch = (compile_version & 0x0000ff);
-
-    std::ostringstream compile_version_string("");
-    compile_version_string << compile_major << "." << compile_minor << "." << compile_patch;
-
-    cout << "        \"version_str\" : \"" << compile_version_string.str() << "\"," << endl;
-    cout << "        \"major\" : " << compile_major << "," << endl;
-    cout << "        \"minor\" : " << compile_minor << "," << endl;
-    cout << "        \"patch\" : " << compile_patch << "," << endl;
-    cout << "        \"build_type\" : \"" << RBDL_BUILD_TYPE << "\"," << endl;
-    cout << "        \"commit\" : \"" << RBDL_BUILD_COMMIT << "\"," << endl;
-    cout << "        \"branch\" : \"" << RBDL_BUILD_BRANCH << "\"," << endl;
-    cout << "        \"compiler_id\" : \"" << RBDL_BUILD_COMPILER_ID << "\"," << endl;
-    cout << "        \"compiler_version\" : \"" << RBDL_BUILD_COMPILER_VERSION << "\"" << endl;
-
-    cout << "    }," << endl;
-
-    cout << "    \"host_info\" : {" << endl;
-    cout << "        \"cpu_model_name\" : \"" << get_cpu_model_name() << "\"," << endl;
-    cout << "        \"time_utc\" : " << "\"" << get_utc_time_string() << "\"" << endl;
-    cout << "    }," << endl;
-
-    cout << "    \"runs\" : ";
-    cout << "[" << endl;
-
-    for (int i; i < benchmark_runs.size(); i++) {
-      const BenchmarkRun& run = benchmark_runs[i];
-
-      const char* indent = "            ";
-
-      cout << "        " << "{" << endl;
-      cout << indent << "\"model\" : \"" << run.model_name << "\"," << endl;
-      cout << indent << "\"dof\" : " << run.model_dof << "," << endl;
-      cout << indent << "\"benchmark\" : \"" << run.benchmark << "\"," << endl;
-      cout << indent << "\"duration\" : " << run.duration << "," << endl;
-      cout << indent << "\"sample_count\" : " << run.sample_count << "," << endl;
-      cout << indent << "\"avg\" : " << run.avg << "," << endl;
-      cout << indent << "\"min\" : " << run.min << "," << endl;
-      cout << indent << "\"max\" : " << run.max << endl;
-      cout << "        " << "}";
-
-      if (i != benchmark_runs.size() - 1) {
-        cout << ",";
-      }
-      cout << endl;
-    }
-
-    cout << "    ]" << endl;
-
-    cout << "}" << endl;
-  }
-
-  return 0;
+  return report_results();
 }
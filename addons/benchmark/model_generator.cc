@@ -52,3 +52,89 @@ void generate_planar_tree (Model *model, int depth) {
       length * 0.4);
 }
 
+
+void generate_four_bar_linkage (Model *model, ConstraintSet *constraint_set) {
+  double length = 2.;
+  double mass = 2.;
+
+  Body link (mass, Vector3d (0.5 * length, 0., 0.),
+      Vector3d (0., 0., mass * length * length / 3.));
+  Body virtual_body (0., Vector3d (0., 0., 0.), Vector3d (0., 0., 0.));
+  Joint joint_rev_z (JointTypeRevoluteZ);
+
+  unsigned int body_1 = model->AddBody (0, Xtrans (Vector3d (0., 0., 0.)),
+      joint_rev_z, link);
+  unsigned int body_2 = model->AddBody (body_1,
+      Xtrans (Vector3d (length, 0., 0.)), joint_rev_z, link);
+  unsigned int body_3 = model->AddBody (0, Xtrans (Vector3d (0., 0., 0.)),
+      joint_rev_z, link);
+  unsigned int body_4 = model->AddBody (body_3,
+      Xtrans (Vector3d (length, 0., 0.)), joint_rev_z, link);
+  unsigned int body_5 = model->AddBody (body_4,
+      Xtrans (Vector3d (length, 0., 0.)), joint_rev_z, virtual_body);
+
+  SpatialTransform X_p = Xtrans (Vector3d (length, 0., 0.));
+  SpatialTransform X_s = Xtrans (Vector3d (0., 0., 0.));
+
+  constraint_set->AddLoopConstraint (body_2, body_5, X_p, X_s,
+      SpatialVector (0., 0., 0., 1., 0., 0.), true, 0.1, "LoopXY_Rz");
+  constraint_set->AddLoopConstraint (body_2, body_5, X_p, X_s,
+      SpatialVector (0., 0., 0., 0., 1., 0.));
+  constraint_set->AddLoopConstraint (body_2, body_5, X_p, X_s,
+      SpatialVector (0., 0., 1., 0., 0., 0.));
+
+  constraint_set->Bind (*model);
+}
+
+void generate_slider_crank_3d (Model *model, ConstraintSet *constraint_set) {
+  double slider_mass = 5.;
+  double slider_height = 0.1;
+  double crank_link1_mass = 3.;
+  double crank_link1_length = 1.;
+  double crank_link2_mass = 1.;
+  double crank_link2_radius = 0.2;
+  double crank_link2_length = 3.;
+  double crank_link1_height = crank_link2_length - crank_link1_length
+    + slider_height;
+
+  Body slider (slider_mass, Vector3d (0., 0., 0.), Vector3d (1., 1., 1.));
+  Body crank_link1 (crank_link1_mass,
+      Vector3d (0.5 * crank_link1_length, 0., 0.),
+      Vector3d (0., 0.,
+        crank_link1_mass * crank_link1_length * crank_link1_length / 3.));
+  double crank_link2_inertia = crank_link2_mass
+    * (3. * crank_link2_radius * crank_link2_radius
+        + crank_link2_length * crank_link2_length) / 12.;
+  Body crank_link2 (crank_link2_mass,
+      Vector3d (0.5 * crank_link2_length, 0., 0.),
+      Vector3d (crank_link2_mass * crank_link2_radius * crank_link2_radius
+        / 2., crank_link2_inertia, crank_link2_inertia));
+
+  Joint joint_rev_z (JointTypeRevoluteZ);
+  Joint joint_euler_zyx (JointTypeEulerZYX);
+  Joint joint_prs_x (SpatialVector (0., 0., 0., 1., 0., 0.));
+
+  unsigned int id_p = model->AddBody (0, SpatialTransform(), joint_prs_x,
+      slider);
+  unsigned int id_b1 = model->AddBody (0, Xroty (-0.5 * M_PI)
+      * Xtrans (Vector3d (0., 0., crank_link1_height)), joint_rev_z,
+      crank_link1);
+  unsigned int id_s = model->AddBody (id_b1, Xroty (M_PI)
+      * Xtrans (Vector3d (crank_link1_length, 0., 0.)), joint_euler_zyx,
+      crank_link2);
+
+  SpatialTransform X_p = Xtrans (Vector3d (0., 0., slider_height));
+  SpatialTransform X_s (roty (-0.5 * M_PI),
+      Vector3d (crank_link2_length, 0., 0.));
+
+  constraint_set->AddLoopConstraint (id_p, id_s, X_p, X_s,
+      SpatialVector (0., 0., 0., 1., 0., 0.), true, 0.1, "LoopXYZ_Rz");
+  constraint_set->AddLoopConstraint (id_p, id_s, X_p, X_s,
+      SpatialVector (0., 0., 0., 0., 1., 0.));
+  constraint_set->AddLoopConstraint (id_p, id_s, X_p, X_s,
+      SpatialVector (0., 0., 0., 0., 0., 1.));
+  constraint_set->AddLoopConstraint (id_p, id_s, X_p, X_s,
+      SpatialVector (0., 0., 1., 0., 0., 0.));
+
+  constraint_set->Bind (*model);
+}
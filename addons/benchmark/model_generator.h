@@ -3,9 +3,20 @@
 
 namespace RigidBodyDynamics {
 class Model;
+struct ConstraintSet;
 }
 
 void generate_planar_tree (RigidBodyDynamics::Model *model, int depth);
 
+/** Planar four-bar linkage of two chains of two links that are closed with
+ * a loop constraint (FourBarLinkage of LoopConstraintsTests.cc). */
+void generate_four_bar_linkage (RigidBodyDynamics::Model *model,
+    RigidBodyDynamics::ConstraintSet *constraint_set);
+
+/** Slider-crank mechanism with a three dof joint that is closed with a loop
+ * constraint (SliderCrank3D of LoopConstraintsTests.cc). */
+void generate_slider_crank_3d (RigidBodyDynamics::Model *model,
+    RigidBodyDynamics::ConstraintSet *constraint_set);
+
 /* _MODEL_GENERATOR_H */
 #endif
@@ -556,6 +556,42 @@ bool LuaModelWriteConstraintSetPhaseHeaderEntries(const char* header_file_name,
                          const std::vector< unsigned int > &constraint_phases,
                          bool append);
 
+/**
+  Generates a standalone C++ source file with the functions
+  ForwardDynamics, InverseDynamics, CompositeRigidBodyAlgorithm and
+  CalcPointJacobian that are specialised to the topology of the given model.
+  The joint axes, joint frame transformations, inertias and gravity of the
+  model are folded into the generated code such that all multiplications
+  with zero entries are eliminated. The generated functions contain no
+  loops over bodies, perform no allocations and only depend on <cmath>.
+
+  The generated functions operate on arrays of doubles:
+  \code
+    void ForwardDynamics (const double *q, const double *qdot,
+                          const double *tau, double *qddot);
+    void InverseDynamics (const double *q, const double *qdot,
+                          const double *qddot, double *tau);
+    void CompositeRigidBodyAlgorithm (const double *q, double *H);
+    bool CalcPointJacobian (const double *q, unsigned int body_id,
+                            const double *point, double *G);
+  \endcode
+  H (DoFCount x DoFCount) and G (3 x DoFCount) are stored column-major and
+  fully overwritten. CalcPointJacobian returns false for unknown body ids.
+  External forces are not supported.
+
+  Only models that consist of 1-DoF revolute and prismatic joints (including
+  multi-DoF joints that are specified by their axes) and fixed joints are
+  supported, for other models an Errors::RBDLError is thrown.
+
+  @param source_file_name the name of the generated source file
+  @param model a reference to the populated model.
+  @param name_space the namespace of the generated functions
+*/
+RBDL_ADDON_DLLAPI
+bool LuaModelWriteDynamicsSource(const char* source_file_name,
+                                 const RigidBodyDynamics::Model &model,
+                                 const char* name_space);
+
 #ifdef RBDL_BUILD_ADDON_MUSCLE
 /**
   Generates an enum and a structure so that each Millard2016TorqueMuscle can
@@ -0,0 +1,1065 @@
+/*
+ * RBDL - Rigid Body Dynamics Library: Addon : luamodel
+ * Copyright (c) 2011-2018 Martin Felis <martin@fysx.org>
+ *
+ * Licensed under the zlib license. See LICENSE for more details.
+ */
+
+#include "rbdl/rbdl.h"
+#include "rbdl/rbdl_errors.h"
+#include "luamodel.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace RigidBodyDynamics;
+using namespace RigidBodyDynamics::Math;
+
+namespace RigidBodyDynamics
+{
+
+namespace Addons
+{
+
+namespace
+{
+
+//==============================================================================
+// Symbolic values of the generated code
+//==============================================================================
+
+/// A scalar of the generated code: either a constant that is known at
+/// generation time or the name of a variable of the generated code.
+struct CodeValue {
+  CodeValue (double value = 0.) :
+    constant (true), value (value) {}
+  explicit CodeValue (const std::string &name) :
+    constant (false), value (0.), name (name) {}
+
+  bool constant;
+  double value;
+  std::string name;
+};
+
+struct CodeVector6 {
+  CodeValue v[6];
+};
+
+struct CodeMatrix6 {
+  CodeValue m[6][6];
+};
+
+/// Spatial transformation X = (E, r) with the same layout as
+/// Math::SpatialTransform.
+struct CodeTransform {
+  CodeValue E[3][3];
+  CodeValue r[3];
+};
+
+std::string FormatConstant (double value)
+{
+  std::ostringstream stream;
+  stream << std::setprecision (17) << value;
+  std::string result = stream.str();
+  if (result.find_first_of (".e") == std::string::npos) {
+    result += ".";
+  }
+  return result;
+}
+
+/// Sum of products of CodeValues where all constant parts are folded and
+/// products with zero are dropped.
+class CodeSum
+{
+public:
+  CodeSum () : mConstant (0.) {}
+
+  CodeSum& add (const CodeValue &a, double sign = 1.)
+  {
+    if (a.constant) {
+      mConstant += sign * a.value;
+    } else {
+      mTerms.push_back (std::make_pair (sign, a.name));
+    }
+    return *this;
+  }
+
+  CodeSum& add (const CodeValue &a, const CodeValue &b, double sign = 1.)
+  {
+    if (a.constant && b.constant) {
+      mConstant += sign * a.value * b.value;
+    } else if (a.constant) {
+      if (a.value != 0.) {
+        mTerms.push_back (std::make_pair (sign * a.value, b.name));
+      }
+    } else if (b.constant) {
+      if (b.value != 0.) {
+        mTerms.push_back (std::make_pair (sign * b.value, a.name));
+      }
+    } else {
+      mTerms.push_back (std::make_pair (sign, a.name + " * " + b.name));
+    }
+    return *this;
+  }
+
+  /// Returns whether the sum is a single variable that needs no temporary
+  bool isVariable () const
+  {
+    return mConstant == 0. && mTerms.size() == 1 && mTerms[0].first == 1.
+      && mTerms[0].second.find (' ') == std::string::npos;
+  }
+
+  std::string toString () const
+  {
+    std::ostringstream stream;
+    bool first = true;
+
+    if (mConstant != 0. || mTerms.size() == 0) {
+      stream << FormatConstant (mConstant);
+      first = false;
+    }
+
+    for (unsigned int i = 0; i < mTerms.size(); i++) {
+      double coefficient = mTerms[i].first;
+
+      if (coefficient < 0.) {
+        stream << (first ? "-" : " - ");
+        coefficient = -coefficient;
+      } else if (!first) {
+        stream << " + ";
+      }
+
+      if (coefficient != 1.) {
+        stream << FormatConstant (coefficient) << " * ";
+      }
+      stream << mTerms[i].second;
+      first = false;
+    }
+
+    return stream.str();
+  }
+
+  double mConstant;
+  std::vector<std::pair<double, std::string> > mTerms;
+};
+
+bool IsIdentifierChar (char c)
+{
+  return isalnum (static_cast<unsigned char>(c)) || c == '_';
+}
+
+/// Collects the statements of a generated function. Temporaries that are
+/// not used by any output are dropped by flush().
+class CodeWriter
+{
+public:
+  CodeWriter (std::ostream &stream, const std::string &indent) :
+    mStream (stream), mIndent (indent) {}
+
+  /// Returns the value of sum and emits a temporary if it is not trivial
+  CodeValue assign (const CodeSum &sum)
+  {
+    if (sum.mTerms.size() == 0) {
+      return CodeValue (sum.mConstant);
+    }
+
+    if (sum.isVariable()) {
+      return CodeValue (sum.mTerms[0].second);
+    }
+
+    return assign (sum.toString());
+  }
+
+  /// Emits a temporary for an arbitrary expression
+  CodeValue assign (const std::string &expression)
+  {
+    std::ostringstream name;
+    name << "t" << mStatements.size();
+    mStatements.push_back (std::make_pair (true, expression));
+    return CodeValue (name.str());
+  }
+
+  void line (const std::string &text)
+  {
+    mStatements.push_back (std::make_pair (false, text));
+  }
+
+  /// Writes all lines and the temporaries they depend on
+  void flush ()
+  {
+    std::vector<bool> live (mStatements.size(), false);
+
+    for (unsigned int i = mStatements.size(); i > 0; i--) {
+      const std::string &text = mStatements[i - 1].second;
+      if (mStatements[i - 1].first && !live[i - 1]) {
+        continue;
+      }
+      live[i - 1] = true;
+
+      // mark all temporaries tN that are referenced by the statement,
+      // comments may contain arbitrary body names and are skipped
+      std::string::size_type end = text.find ("//");
+      if (end == std::string::npos) {
+        end = text.size();
+      }
+
+      for (std::string::size_type k = 0; k < end; k++) {
+        if (text[k] != 't'
+            || (k > 0 && IsIdentifierChar (text[k - 1]))) {
+          continue;
+        }
+
+        std::string::size_type digits_end = k + 1;
+        unsigned int index = 0;
+        while (digits_end < end && isdigit (static_cast<unsigned char>(text[digits_end]))) {
+          index = index * 10 + (text[digits_end] - '0');
+          digits_end++;
+        }
+
+        // only whole identifiers tN that refer to an earlier temporary
+        if (digits_end == k + 1
+            || (digits_end < end && IsIdentifierChar (text[digits_end]))
+            || digits_end - k - 1 > 9
+            || index >= i - 1
+            || !mStatements[index].first) {
+          continue;
+        }
+        live[index] = true;
+      }
+    }
+
+    for (unsigned int i = 0; i < mStatements.size(); i++) {
+      if (!live[i]) {
+        continue;
+      }
+      if (mStatements[i].first) {
+        mStream << mIndent << "const double t" << i << " = "
+          << mStatements[i].second << ";" << std::endl;
+      } else {
+        mStream << mIndent << mStatements[i].second << std::endl;
+      }
+    }
+    mStatements.clear();
+  }
+
+private:
+  std::ostream &mStream;
+  std::string mIndent;
+  /// (is temporary, expression or line)
+  std::vector<std::pair<bool, std::string> > mStatements;
+};
+
+std::string ValueString (const CodeValue &a)
+{
+  if (a.constant) {
+    return FormatConstant (a.value);
+  }
+  return a.name;
+}
+
+CodeValue Divide (CodeWriter &w, const CodeValue &a, const CodeValue &b)
+{
+  if (a.constant && b.constant) {
+    return CodeValue (a.value / b.value);
+  }
+
+  if (a.constant && a.value == 0.) {
+    return CodeValue (0.);
+  }
+
+  return w.assign (ValueString (a) + " / " + ValueString (b));
+}
+
+std::string IndexString (const std::string &array, unsigned int index)
+{
+  std::ostringstream stream;
+  stream << array << "[" << index << "]";
+  return stream.str();
+}
+
+//==============================================================================
+// Spatial algebra on CodeValues, see SpatialAlgebraOperators.h
+//==============================================================================
+
+CodeVector6 Constant (const SpatialVector &v)
+{
+  CodeVector6 result;
+  for (unsigned int i = 0; i < 6; i++) {
+    result.v[i] = CodeValue (v[i]);
+  }
+  return result;
+}
+
+CodeMatrix6 Constant (const SpatialRigidBodyInertia &I)
+{
+  SpatialMatrix mat (SpatialMatrix::Zero());
+  I.setSpatialMatrix (mat);
+
+  CodeMatrix6 result;
+  for (unsigned int i = 0; i < 6; i++) {
+    for (unsigned int j = 0; j < 6; j++) {
+      result.m[i][j] = CodeValue (mat(i,j));
+    }
+  }
+  return result;
+}
+
+CodeVector6 Scale (CodeWriter &w, const CodeVector6 &v, const CodeValue &s)
+{
+  CodeVector6 result;
+  for (unsigned int i = 0; i < 6; i++) {
+    result.v[i] = w.assign (CodeSum().add (v.v[i], s));
+  }
+  return result;
+}
+
+CodeVector6 Add (CodeWriter &w, const CodeVector6 &a, const CodeVector6 &b)
+{
+  CodeVector6 result;
+  for (unsigned int i = 0; i < 6; i++) {
+    result.v[i] = w.assign (CodeSum().add (a.v[i]).add (b.v[i]));
+  }
+  return result;
+}
+
+CodeValue Dot (CodeWriter &w, const CodeVector6 &a, const CodeVector6 &b)
+{
+  CodeSum sum;
+  for (unsigned int i = 0; i < 6; i++) {
+    sum.add (a.v[i], b.v[i]);
+  }
+  return w.assign (sum);
+}
+
+CodeVector6 Multiply (CodeWriter &w, const CodeMatrix6 &M,
+                      const CodeVector6 &v)
+{
+  CodeVector6 result;
+  for (unsigned int i = 0; i < 6; i++) {
+    CodeSum sum;
+    for (unsigned int j = 0; j < 6; j++) {
+      sum.add (M.m[i][j], v.v[j]);
+    }
+    result.v[i] = w.assign (sum);
+  }
+  return result;
+}
+
+/// Computes A + sign * a * b^T, only the upper triangle is evaluated as the
+/// result is symmetric for all uses in the generated algorithms.
+CodeMatrix6 AddSymmetricProduct (CodeWriter &w, const CodeMatrix6 &A,
+    const CodeVector6 &a, const CodeVector6 &b, double sign)
+{
+  CodeMatrix6 result;
+  for (unsigned int i = 0; i < 6; i++) {
+    for (unsigned int j = i; j < 6; j++) {
+      result.m[i][j] = w.assign (CodeSum().add (A.m[i][j])
+                                 .add (a.v[i], b.v[j], sign));
+      result.m[j][i] = result.m[i][j];
+    }
+  }
+  return result;
+}
+
+/// X.apply (v)
+CodeVector6 Apply (CodeWriter &w, const CodeTransform &X, const CodeVector6 &v)
+{
+  CodeValue v_rxw[3];
+  v_rxw[0] = w.assign (CodeSum().add (v.v[3]).add (X.r[1], v.v[2], -1.)
+                       .add (X.r[2], v.v[1]));
+  v_rxw[1] = w.assign (CodeSum().add (v.v[4]).add (X.r[2], v.v[0], -1.)
+                       .add (X.r[0], v.v[2]));
+  v_rxw[2] = w.assign (CodeSum().add (v.v[5]).add (X.r[0], v.v[1], -1.)
+                       .add (X.r[1], v.v[0]));
+
+  CodeVector6 result;
+  for (unsigned int i = 0; i < 3; i++) {
+    CodeSum upper, lower;
+    for (unsigned int j = 0; j < 3; j++) {
+      upper.add (X.E[i][j], v.v[j]);
+      lower.add (X.E[i][j], v_rxw[j]);
+    }
+    result.v[i] = w.assign (upper);
+    result.v[i + 3] = w.assign (lower);
+  }
+  return result;
+}
+
+/// X.applyTranspose (f)
+CodeVector6 ApplyTranspose (CodeWriter &w, const CodeTransform &X,
+                            const CodeVector6 &f)
+{
+  CodeValue E_T_n[3], E_T_f[3];
+  for (unsigned int i = 0; i < 3; i++) {
+    CodeSum upper, lower;
+    for (unsigned int j = 0; j < 3; j++) {
+      upper.add (X.E[j][i], f.v[j]);
+      lower.add (X.E[j][i], f.v[j + 3]);
+    }
+    E_T_n[i] = w.assign (upper);
+    E_T_f[i] = w.assign (lower);
+  }
+
+  CodeVector6 result;
+  result.v[0] = w.assign (CodeSum().add (E_T_n[0]).add (X.r[2], E_T_f[1], -1.)
+                          .add (X.r[1], E_T_f[2]));
+  result.v[1] = w.assign (CodeSum().add (E_T_n[1]).add (X.r[2], E_T_f[0])
+                          .add (X.r[0], E_T_f[2], -1.));
+  result.v[2] = w.assign (CodeSum().add (E_T_n[2]).add (X.r[1], E_T_f[0], -1.)
+                          .add (X.r[0], E_T_f[1]));
+  result.v[3] = E_T_f[0];
+  result.v[4] = E_T_f[1];
+  result.v[5] = E_T_f[2];
+  return result;
+}
+
+CodeVector6 CrossM (CodeWriter &w, const CodeVector6 &a, const CodeVector6 &b)
+{
+  const CodeValue *v1 = a.v;
+  const CodeValue *v2 = b.v;
+
+  CodeVector6 result;
+  result.v[0] = w.assign (CodeSum().add (v1[2], v2[1], -1.).add (v1[1], v2[2]));
+  result.v[1] = w.assign (CodeSum().add (v1[2], v2[0]).add (v1[0], v2[2], -1.));
+  result.v[2] = w.assign (CodeSum().add (v1[1], v2[0], -1.).add (v1[0], v2[1]));
+  result.v[3] = w.assign (CodeSum().add (v1[5], v2[1], -1.).add (v1[4], v2[2])
+                          .add (v1[2], v2[4], -1.).add (v1[1], v2[5]));
+  result.v[4] = w.assign (CodeSum().add (v1[5], v2[0]).add (v1[3], v2[2], -1.)
+                          .add (v1[2], v2[3]).add (v1[0], v2[5], -1.));
+  result.v[5] = w.assign (CodeSum().add (v1[4], v2[0], -1.).add (v1[3], v2[1])
+                          .add (v1[1], v2[3], -1.).add (v1[0], v2[4]));
+  return result;
+}
+
+CodeVector6 CrossF (CodeWriter &w, const CodeVector6 &a, const CodeVector6 &b)
+{
+  const CodeValue *v1 = a.v;
+  const CodeValue *v2 = b.v;
+
+  CodeVector6 result;
+  result.v[0] = w.assign (CodeSum().add (v1[2], v2[1], -1.).add (v1[1], v2[2])
+                          .add (v1[5], v2[4], -1.).add (v1[4], v2[5]));
+  result.v[1] = w.assign (CodeSum().add (v1[2], v2[0]).add (v1[0], v2[2], -1.)
+                          .add (v1[5], v2[3]).add (v1[3], v2[5], -1.));
+  result.v[2] = w.assign (CodeSum().add (v1[1], v2[0], -1.).add (v1[0], v2[1])
+                          .add (v1[4], v2[3], -1.).add (v1[3], v2[4]));
+  result.v[3] = w.assign (CodeSum().add (v1[2], v2[4], -1.).add (v1[1], v2[5]));
+  result.v[4] = w.assign (CodeSum().add (v1[2], v2[3]).add (v1[0], v2[5], -1.));
+  result.v[5] = w.assign (CodeSum().add (v1[1], v2[3], -1.).add (v1[0], v2[4]));
+  return result;
+}
+
+/// Computes X^T * M * X for a symmetric M using the 6x6 matrix of X where
+/// all known zero blocks are skipped by the constant folding.
+CodeMatrix6 TransformInertia (CodeWriter &w, const CodeTransform &X,
+                              const CodeMatrix6 &M)
+{
+  // X = [E 0; -E rx E]
+  CodeMatrix6 X_mat;
+  for (unsigned int i = 0; i < 3; i++) {
+    for (unsigned int j = 0; j < 3; j++) {
+      X_mat.m[i][j] = X.E[i][j];
+      X_mat.m[i + 3][j + 3] = X.E[i][j];
+      X_mat.m[i][j + 3] = CodeValue (0.);
+    }
+  }
+
+  // lower left block -E rx
+  for (unsigned int i = 0; i < 3; i++) {
+    const CodeValue *E_i = X.E[i];
+    X_mat.m[i + 3][0] = w.assign (CodeSum().add (E_i[1], X.r[2], -1.)
+                                  .add (E_i[2], X.r[1]));
+    X_mat.m[i + 3][1] = w.assign (CodeSum().add (E_i[2], X.r[0], -1.)
+                                  .add (E_i[0], X.r[2]));
+    X_mat.m[i + 3][2] = w.assign (CodeSum().add (E_i[0], X.r[1], -1.)
+                                  .add (E_i[1], X.r[0]));
+  }
+
+  CodeMatrix6 MX;
+  for (unsigned int i = 0; i < 6; i++) {
+    for (unsigned int j = 0; j < 6; j++) {
+      CodeSum sum;
+      for (unsigned int k = 0; k < 6; k++) {
+        sum.add (M.m[i][k], X_mat.m[k][j]);
+      }
+      MX.m[i][j] = w.assign (sum);
+    }
+  }
+
+  CodeMatrix6 result;
+  for (unsigned int i = 0; i < 6; i++) {
+    for (unsigned int j = i; j < 6; j++) {
+      CodeSum sum;
+      for (unsigned int k = 0; k < 6; k++) {
+        sum.add (X_mat.m[k][i], MX.m[k][j]);
+      }
+      result.m[i][j] = w.assign (sum);
+      result.m[j][i] = result.m[i][j];
+    }
+  }
+
+  return result;
+}
+
+CodeMatrix6 AddSymmetric (CodeWriter &w, const CodeMatrix6 &A,
+                          const CodeMatrix6 &B)
+{
+  CodeMatrix6 result;
+  for (unsigned int i = 0; i < 6; i++) {
+    for (unsigned int j = i; j < 6; j++) {
+      result.m[i][j] = w.assign (CodeSum().add (A.m[i][j]).add (B.m[i][j]));
+      result.m[j][i] = result.m[i][j];
+    }
+  }
+  return result;
+}
+
+/// Returns X_lambda of body i, i.e. X_J * X_T with the constant joint axis
+/// and the constant X_T folded in. The generated code reads q.
+CodeTransform JointTransform (CodeWriter &w, const Model &model,
+                              unsigned int i)
+{
+  const Joint &joint = model.mJoints[i];
+  const SpatialVector &S = model.S[i];
+  const SpatialTransform &X_T = model.X_T[i];
+  const CodeValue q (IndexString ("q", joint.q_index));
+
+  CodeValue E_J[3][3];
+  CodeValue r_J[3];
+  for (unsigned int j = 0; j < 3; j++) {
+    for (unsigned int k = 0; k < 3; k++) {
+      E_J[j][k] = CodeValue (j == k ? 1. : 0.);
+    }
+    r_J[j] = CodeValue (0.);
+  }
+
+  if (joint.mJointType == JointTypePrismatic) {
+    for (unsigned int j = 0; j < 3; j++) {
+      r_J[j] = w.assign (CodeSum().add (CodeValue (S[j + 3]), q));
+    }
+  } else {
+    const CodeValue s = w.assign ("std::sin (" + q.name + ")");
+    const CodeValue c = w.assign ("std::cos (" + q.name + ")");
+
+    int coordinate_axis = -1;
+    for (unsigned int j = 0; j < 3; j++) {
+      if (fabs (S[j]) == 1. && S[(j + 1) % 3] == 0. && S[(j + 2) % 3] == 0.) {
+        coordinate_axis = j;
+      }
+    }
+
+    if (coordinate_axis >= 0) {
+      // rotation about a coordinate axis, see Xrotx(), Xroty(), Xrotz()
+      const unsigned int a = (coordinate_axis + 1) % 3;
+      const unsigned int b = (coordinate_axis + 2) % 3;
+      const double sign = S[coordinate_axis];
+      const CodeValue minus_s = w.assign (CodeSum().add (s, -1.));
+
+      E_J[a][a] = c;
+      E_J[b][b] = c;
+      E_J[a][b] = sign > 0. ? s : minus_s;
+      E_J[b][a] = sign > 0. ? minus_s : s;
+    } else {
+      // rotation about an arbitrary axis, see Xrot()
+      const CodeValue omc = w.assign (CodeSum().add (CodeValue (1.))
+                                      .add (c, -1.));
+      const CodeValue axis[3] = { CodeValue (S[0]), CodeValue (S[1]),
+                                  CodeValue (S[2]) };
+
+      for (unsigned int j = 0; j < 3; j++) {
+        for (unsigned int k = 0; k < 3; k++) {
+          CodeSum sum;
+          sum.add (CodeValue (S[j] * S[k]), omc);
+          if (j == k) {
+            sum.add (c);
+          } else {
+            // E_J(j,k) = a_j a_k (1 - c) +/- a_l s
+            const unsigned int l = 3 - j - k;
+            const double sign = ((k + 3 - j) % 3 == 1) ? 1. : -1.;
+            sum.add (axis[l], s, sign);
+          }
+          E_J[j][k] = w.assign (sum);
+        }
+      }
+    }
+  }
+
+  // X_J * X_T = (E_J * E_T, r_T + E_T^T * r_J)
+  CodeTransform result;
+  for (unsigned int j = 0; j < 3; j++) {
+    for (unsigned int k = 0; k < 3; k++) {
+      CodeSum sum;
+      for (unsigned int l = 0; l < 3; l++) {
+        sum.add (E_J[j][l], CodeValue (X_T.E(l,k)));
+      }
+      result.E[j][k] = w.assign (sum);
+    }
+
+    CodeSum sum;
+    sum.add (CodeValue (X_T.r[j]));
+    for (unsigned int l = 0; l < 3; l++) {
+      sum.add (CodeValue (X_T.E(l,j)), r_J[l]);
+    }
+    result.r[j] = w.assign (sum);
+  }
+
+  return result;
+}
+
+/// X_lambda * X_parent = (E_lambda * E_parent, r_parent + E_parent^T r_lambda)
+CodeTransform Compose (CodeWriter &w, const CodeTransform &X_lambda,
+                       const CodeTransform &X_parent)
+{
+  CodeTransform result;
+  for (unsigned int j = 0; j < 3; j++) {
+    for (unsigned int k = 0; k < 3; k++) {
+      CodeSum sum;
+      for (unsigned int l = 0; l < 3; l++) {
+        sum.add (X_lambda.E[j][l], X_parent.E[l][k]);
+      }
+      result.E[j][k] = w.assign (sum);
+    }
+
+    CodeSum sum;
+    sum.add (X_parent.r[j]);
+    for (unsigned int l = 0; l < 3; l++) {
+      sum.add (X_parent.E[l][j], X_lambda.r[l]);
+    }
+    result.r[j] = w.assign (sum);
+  }
+  return result;
+}
+
+std::string BodyComment (const Model &model, unsigned int body_id)
+{
+  std::ostringstream stream;
+  stream << "// body " << body_id;
+  if (model.GetBodyName (body_id) != "") {
+    stream << " (" << model.GetBodyName (body_id) << ")";
+  }
+  return stream.str();
+}
+
+CodeVector6 JointVelocity (CodeWriter &w, const Model &model, unsigned int i)
+{
+  return Scale (w, Constant (model.S[i]),
+                CodeValue (IndexString ("qdot", model.mJoints[i].q_index)));
+}
+
+CodeVector6 SpatialGravity (const Model &model)
+{
+  return Constant (SpatialVector (0., 0., 0., -model.gravity[0],
+                                  -model.gravity[1], -model.gravity[2]));
+}
+
+//==============================================================================
+// Generated functions
+//==============================================================================
+
+void CheckModelSupported (const Model &model)
+{
+  if (model.mCustomJoints.size() > 0) {
+    throw Errors::RBDLError("Error: code generation does not support "
+                            "custom joints!\n");
+  }
+
+  for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+    JointType type = model.mJoints[i].mJointType;
+
+    if (type != JointTypeRevolute
+        && type != JointTypeRevoluteX
+        && type != JointTypeRevoluteY
+        && type != JointTypeRevoluteZ
+        && type != JointTypePrismatic) {
+      std::ostringstream errormsg;
+      errormsg << "Error: code generation does not support the joint of "
+               << "body " << model.GetBodyName (i) << " (id " << i << "). "
+               << "Only 1-DoF revolute and prismatic joints are supported."
+               << std::endl;
+      throw Errors::RBDLError(errormsg.str());
+    }
+  }
+}
+
+void WriteForwardDynamics (std::ostream &stream, const Model &model)
+{
+  const unsigned int n = model.mBodies.size();
+
+  stream << "inline void ForwardDynamics (" << std::endl
+         << "    const double *q," << std::endl
+         << "    const double *qdot," << std::endl
+         << "    const double *tau," << std::endl
+         << "    double *qddot) {" << std::endl;
+
+  CodeWriter w (stream, "  ");
+
+  std::vector<CodeTransform> X (n);
+  std::vector<CodeVector6> v (n), c (n), pA (n), U (n), a (n);
+  std::vector<CodeMatrix6> IA (n);
+  std::vector<CodeValue> d (n), u (n);
+
+  for (unsigned int i = 1; i < n; i++) {
+    const unsigned int lambda = model.lambda[i];
+
+    w.line (BodyComment (model, i));
+    X[i] = JointTransform (w, model, i);
+    CodeVector6 v_J = JointVelocity (w, model, i);
+
+    if (lambda != 0) {
+      v[i] = Add (w, Apply (w, X[i], v[lambda]), v_J);
+    } else {
+      v[i] = v_J;
+    }
+
+    c[i] = CrossM (w, v[i], v_J);
+    IA[i] = Constant (model.I[i]);
+    pA[i] = CrossF (w, v[i], Multiply (w, IA[i], v[i]));
+  }
+
+  for (unsigned int i = n - 1; i > 0; i--) {
+    const unsigned int lambda = model.lambda[i];
+    const CodeVector6 S = Constant (model.S[i]);
+    const CodeValue tau (IndexString ("tau", model.mJoints[i].q_index));
+
+    U[i] = Multiply (w, IA[i], S);
+    d[i] = Dot (w, S, U[i]);
+    u[i] = w.assign (CodeSum().add (tau).add (Dot (w, S, pA[i]), -1.));
+
+    if (lambda != 0) {
+      CodeValue d_inv = Divide (w, CodeValue (1.), d[i]);
+      CodeVector6 U_d_inv = Scale (w, U[i], d_inv);
+
+      CodeMatrix6 Ia = AddSymmetricProduct (w, IA[i], U[i], U_d_inv, -1.);
+      CodeVector6 pa = Add (w, Add (w, pA[i], Multiply (w, Ia, c[i])),
+                            Scale (w, U_d_inv, u[i]));
+
+      IA[lambda] = AddSymmetric (w, IA[lambda],
+                                 TransformInertia (w, X[i], Ia));
+      pA[lambda] = Add (w, pA[lambda], ApplyTranspose (w, X[i], pa));
+    }
+  }
+
+  const CodeVector6 a_0 = SpatialGravity (model);
+
+  for (unsigned int i = 1; i < n; i++) {
+    const unsigned int lambda = model.lambda[i];
+    const std::string qddot = IndexString ("qddot", model.mJoints[i].q_index);
+
+    a[i] = Add (w, Apply (w, X[i], lambda != 0 ? a[lambda] : a_0), c[i]);
+
+    CodeValue qdd = Divide (w, w.assign (CodeSum().add (u[i])
+                                         .add (Dot (w, U[i], a[i]), -1.)),
+                            d[i]);
+    w.line (qddot + " = " + ValueString (qdd) + ";");
+
+    a[i] = Add (w, a[i], Scale (w, Constant (model.S[i]), qdd));
+  }
+
+  w.flush();
+  stream << "}" << std::endl << std::endl;
+}
+
+void WriteInverseDynamics (std::ostream &stream, const Model &model)
+{
+  const unsigned int n = model.mBodies.size();
+
+  stream << "inline void InverseDynamics (" << std::endl
+         << "    const double *q," << std::endl
+         << "    const double *qdot," << std::endl
+         << "    const double *qddot," << std::endl
+         << "    double *tau) {" << std::endl;
+
+  CodeWriter w (stream, "  ");
+
+  std::vector<CodeTransform> X (n);
+  std::vector<CodeVector6> v (n), a (n), f (n);
+  const CodeVector6 a_0 = SpatialGravity (model);
+
+  for (unsigned int i = 1; i < n; i++) {
+    const unsigned int lambda = model.lambda[i];
+    const CodeValue qddot (IndexString ("qddot", model.mJoints[i].q_index));
+
+    w.line (BodyComment (model, i));
+    X[i] = JointTransform (w, model, i);
+    CodeVector6 v_J = JointVelocity (w, model, i);
+
+    if (lambda != 0) {
+      v[i] = Add (w, Apply (w, X[i], v[lambda]), v_J);
+    } else {
+      v[i] = v_J;
+    }
+
+    CodeVector6 c = CrossM (w, v[i], v_J);
+    a[i] = Add (w, Add (w, Apply (w, X[i], lambda != 0 ? a[lambda] : a_0), c),
+                Scale (w, Constant (model.S[i]), qddot));
+
+    CodeMatrix6 I = Constant (model.I[i]);
+    f[i] = Add (w, Multiply (w, I, a[i]),
+                CrossF (w, v[i], Multiply (w, I, v[i])));
+  }
+
+  for (unsigned int i = n - 1; i > 0; i--) {
+    const unsigned int lambda = model.lambda[i];
+    const std::string tau = IndexString ("tau", model.mJoints[i].q_index);
+
+    w.line (tau + " = "
+            + ValueString (Dot (w, Constant (model.S[i]), f[i])) + ";");
+
+    if (lambda != 0) {
+      f[lambda] = Add (w, f[lambda], ApplyTranspose (w, X[i], f[i]));
+    }
+  }
+
+  w.flush();
+  stream << "}" << std::endl << std::endl;
+}
+
+void WriteCompositeRigidBodyAlgorithm (std::ostream &stream,
+                                       const Model &model)
+{
+  const unsigned int n = model.mBodies.size();
+  const unsigned int dof = model.qdot_size;
+
+  stream << "inline void CompositeRigidBodyAlgorithm (" << std::endl
+         << "    const double *q," << std::endl
+         << "    double *H) {" << std::endl;
+
+  CodeWriter w (stream, "  ");
+
+  std::vector<CodeTransform> X (n);
+  std::vector<CodeMatrix6> Ic (n);
+
+  for (unsigned int i = 1; i < n; i++) {
+    w.line (BodyComment (model, i));
+    X[i] = JointTransform (w, model, i);
+    Ic[i] = Constant (model.I[i]);
+  }
+
+  for (unsigned int i = n - 1; i > 0; i--) {
+    const unsigned int lambda = model.lambda[i];
+    if (lambda != 0) {
+      Ic[lambda] = AddSymmetric (w, Ic[lambda],
+                                 TransformInertia (w, X[i], Ic[i]));
+    }
+  }
+
+  std::vector<bool> written (dof * dof, false);
+
+  for (unsigned int i = 1; i < n; i++) {
+    const unsigned int dof_i = model.mJoints[i].q_index;
+    CodeVector6 F = Multiply (w, Ic[i], Constant (model.S[i]));
+
+    unsigned int j = i;
+    while (j != 0) {
+      const unsigned int dof_j = model.mJoints[j].q_index;
+      const std::string value
+        = ValueString (Dot (w, Constant (model.S[j]), F));
+
+      w.line (IndexString ("H", dof_i * dof + dof_j) + " = " + value + ";");
+      written[dof_i * dof + dof_j] = true;
+      if (dof_i != dof_j) {
+        w.line (IndexString ("H", dof_j * dof + dof_i) + " = " + value + ";");
+        written[dof_j * dof + dof_i] = true;
+      }
+
+      if (model.lambda[j] != 0) {
+        F = ApplyTranspose (w, X[j], F);
+      }
+      j = model.lambda[j];
+    }
+  }
+
+  for (unsigned int k = 0; k < dof * dof; k++) {
+    if (!written[k]) {
+      w.line (IndexString ("H", k) + " = 0.;");
+    }
+  }
+
+  w.flush();
+  stream << "}" << std::endl << std::endl;
+}
+
+void WritePointJacobianCase (std::ostream &stream, const Model &model,
+                             unsigned int body_id)
+{
+  unsigned int movable_id = body_id;
+  SpatialTransform fixed_transform;
+
+  if (model.IsFixedBodyId (body_id)) {
+    const FixedBody &fixed_body
+      = model.mFixedBodies[body_id - model.fixed_body_discriminator];
+    movable_id = fixed_body.mMovableParent;
+    fixed_transform = fixed_body.mParentTransform;
+  }
+
+  stream << "    case " << body_id << ": {" << std::endl;
+
+  CodeWriter w (stream, "      ");
+  w.line (BodyComment (model, body_id));
+
+  std::vector<unsigned int> chain;
+  for (unsigned int j = movable_id; j != 0; j = model.lambda[j]) {
+    chain.insert (chain.begin(), j);
+  }
+
+  std::vector<CodeTransform> X_base (model.mBodies.size());
+  for (unsigned int k = 0; k < chain.size(); k++) {
+    const unsigned int j = chain[k];
+    CodeTransform X_lambda = JointTransform (w, model, j);
+
+    if (k == 0) {
+      X_base[j] = X_lambda;
+    } else {
+      X_base[j] = Compose (w, X_lambda, X_base[model.lambda[j]]);
+    }
+  }
+
+  // point in coordinates of the movable body
+  CodeValue point_body[3];
+  for (unsigned int k = 0; k < 3; k++) {
+    CodeSum sum;
+    sum.add (CodeValue (fixed_transform.r[k]));
+    for (unsigned int l = 0; l < 3; l++) {
+      sum.add (CodeValue (fixed_transform.E(l,k)),
+               CodeValue (IndexString ("point", l)));
+    }
+    point_body[k] = w.assign (sum);
+  }
+
+  // point in base coordinates
+  const CodeTransform &X_body = X_base[movable_id];
+  CodeValue point_base[3];
+  for (unsigned int k = 0; k < 3; k++) {
+    CodeSum sum;
+    sum.add (X_body.r[k]);
+    for (unsigned int l = 0; l < 3; l++) {
+      sum.add (X_body.E[l][k], point_body[l]);
+    }
+    point_base[k] = w.assign (sum);
+  }
+
+  const unsigned int dof = model.qdot_size;
+  std::vector<bool> written (dof, false);
+
+  for (unsigned int k = 0; k < chain.size(); k++) {
+    const unsigned int j = chain[k];
+    const unsigned int column = model.mJoints[j].q_index;
+    const SpatialVector &S = model.S[j];
+    const CodeTransform &X = X_base[j];
+
+    // angular and linear part of S_j in base coordinates, the linear part
+    // is evaluated at the point
+    CodeValue omega[3], lever[3];
+    for (unsigned int l = 0; l < 3; l++) {
+      CodeSum sum;
+      for (unsigned int m = 0; m < 3; m++) {
+        sum.add (X.E[m][l], CodeValue (S[m]));
+      }
+      omega[l] = w.assign (sum);
+      lever[l] = w.assign (CodeSum().add (point_base[l]).add (X.r[l], -1.));
+    }
+
+    for (unsigned int l = 0; l < 3; l++) {
+      const unsigned int l1 = (l + 1) % 3;
+      const unsigned int l2 = (l + 2) % 3;
+
+      CodeSum sum;
+      for (unsigned int m = 0; m < 3; m++) {
+        sum.add (X.E[m][l], CodeValue (S[m + 3]));
+      }
+      sum.add (omega[l1], lever[l2]);
+      sum.add (omega[l2], lever[l1], -1.);
+
+      w.line (IndexString ("G", column * 3 + l) + " = "
+              + ValueString (w.assign (sum)) + ";");
+    }
+    written[column] = true;
+  }
+
+  for (unsigned int column = 0; column < dof; column++) {
+    if (!written[column]) {
+      for (unsigned int l = 0; l < 3; l++) {
+        w.line (IndexString ("G", column * 3 + l) + " = 0.;");
+      }
+    }
+  }
+
+  w.line ("return true;");
+  w.flush();
+  stream << "    }" << std::endl;
+}
+
+void WritePointJacobian (std::ostream &stream, const Model &model)
+{
+  stream << "inline bool CalcPointJacobian (" << std::endl
+         << "    const double *q," << std::endl
+         << "    unsigned int body_id," << std::endl
+         << "    const double *point," << std::endl
+         << "    double *G) {" << std::endl
+         << "  switch (body_id) {" << std::endl;
+
+  for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+    WritePointJacobianCase (stream, model, i);
+  }
+
+  for (unsigned int i = 0; i < model.mFixedBodies.size(); i++) {
+    WritePointJacobianCase (stream, model,
+                            i + model.fixed_body_discriminator);
+  }
+
+  stream << "  }" << std::endl
+         << "  return false;" << std::endl
+         << "}" << std::endl << std::endl;
+}
+
+}
+
+//==============================================================================
+RBDL_ADDON_DLLAPI
+bool LuaModelWriteDynamicsSource(const char* source_file_name,
+                                 const RigidBodyDynamics::Model &model,
+                                 const char* name_space)
+{
+  CheckModelSupported (model);
+
+  std::ofstream sourceFile (source_file_name, std::ofstream::out);
+  if (!sourceFile) {
+    return false;
+  }
+
+  sourceFile << "// Generated by LuaModelWriteDynamicsSource(). Do not edit."
+             << std::endl
+             << "//" << std::endl
+             << "// Arrays q, qdot, qddot, tau have DoFCount entries, H is "
+             << "DoFCount x DoFCount" << std::endl
+             << "// and G is 3 x DoFCount, both stored column-major."
+             << std::endl << std::endl
+             << "#include <cmath>" << std::endl << std::endl
+             << "namespace " << name_space << " {" << std::endl << std::endl
+             << "static const unsigned int DoFCount = " << model.qdot_size
+             << ";" << std::endl << std::endl;
+
+  WriteForwardDynamics (sourceFile, model);
+  WriteInverseDynamics (sourceFile, model);
+  WriteCompositeRigidBodyAlgorithm (sourceFile, model);
+  WritePointJacobian (sourceFile, model);
+
+  sourceFile << "}" << std::endl;
+
+  sourceFile.flush();
+  sourceFile.close();
+
+  return true;
+}
+
+}
+
+}
@@ -11,13 +11,15 @@ using namespace std;
 using namespace RigidBodyDynamics::Math;
 
 void usage (const char* argv_0) {
-  cerr << "Usage: " << argv_0 << "[-v] [-m] [-d] <model.lua>" << endl;
+  cerr << "Usage: " << argv_0 << "[-v] [-m] [-d] [-g <source.h>] <model.lua>" << endl;
   cerr << "  -v | --verbose            enable additional output" << endl;
   cerr << "  -d | --dof-overview       print an overview of the degress of freedom" << endl;
   cerr << "  -m | --model-hierarchy    print the hierarchy of the model" << endl;
   cerr << "  -o | --body-origins       print the origins of all bodies that have names" << endl;
   cerr << "  -c | --center_of_mass     print center of mass for bodies and full model" << endl;
   cerr << "  -s | --constraint_sets    print all constraint sets defined in the model file" << endl;
+  cerr << "  -g | --generate-dynamics <source.h>" << endl
+       << "                            write dynamics functions specialised to the model" << endl;
   cerr << "  -h | --help               print this help" << endl;
   exit (1);
 }
@@ -35,6 +37,7 @@ int main (int argc, char *argv[]) {
   bool body_origins = false;
   bool center_of_mass = false;
   bool constraint_sets = false;
+  string dynamics_source;
 
   string filename = argv[1];
 
@@ -51,6 +54,9 @@ int main (int argc, char *argv[]) {
       center_of_mass = true;
     else if (string(argv[i]) == "-s" || string (argv[i]) == "--constraint-sets")
       constraint_sets = true;
+    else if ((string(argv[i]) == "-g" || string (argv[i]) == "--generate-dynamics")
+        && i + 1 < argc)
+      dynamics_source = argv[++i];
     else if (string(argv[i]) == "-h" || string (argv[i]) == "--help")
       usage(argv[0]);
     else
@@ -120,5 +126,14 @@ int main (int argc, char *argv[]) {
     cout << setw(14) << "Model mass: " << mass << endl;
   }
 
+  if (dynamics_source != "") {
+    if (!RigidBodyDynamics::Addons::LuaModelWriteDynamicsSource(
+          dynamics_source.c_str(), model, "ModelDynamics")) {
+      cerr << "Could not write " << dynamics_source << "!" << endl;
+      return -1;
+    }
+    cout << "Dynamics source written to " << dynamics_source << endl;
+  }
+
   return 0;
 }
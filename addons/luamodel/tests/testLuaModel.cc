@@ -18,6 +18,11 @@
 
 #include "rbdl_tests.h"
 
+#ifdef RBDL_LUAMODEL_GENERATED_DYNAMICS
+// generated from samplemodel.lua at build time, see CMakeLists.txt
+#include "samplemodel_generated_dynamics.h"
+#endif
+
 #ifdef RBDL_BUILD_ADDON_MUSCLE
 #include "../muscle/Millard2016TorqueMuscle.h"
 #endif
@@ -31,6 +36,7 @@ using namespace std;
 const double TEST_PREC = 1.0e-11;
 
 std::string rbdlSourcePath = RBDL_LUAMODEL_SOURCE_DIR;
+std::string rbdlBinaryPath = RBDL_LUAMODEL_BINARY_DIR;
    
 TEST_CASE(__FILE__"_LoadLuaModel", "")
 {
@@ -924,3 +930,69 @@ TEST_CASE(__FILE__"_ModelHeaderGeneration", "")
   CHECK(headerGuardsAdded);
 
 }
+
+TEST_CASE(__FILE__"_DynamicsSourceGeneration", "")
+{
+  Model model;
+  std::string modelFile = rbdlSourcePath;
+  modelFile.append("/samplemodel.lua");
+  bool modelLoaded = LuaModelReadFromFile(modelFile.c_str(), &model, false);
+  REQUIRE(modelLoaded);
+
+  std::string sourceFile = rbdlBinaryPath;
+  sourceFile.append("/samplemodel_dynamics.h");
+  bool sourceGenerated =
+      LuaModelWriteDynamicsSource(sourceFile.c_str(), model, "SampleModel");
+  CHECK(sourceGenerated);
+
+  //Spherical joints use quaternions and are not supported
+  Model sphericalModel;
+  sphericalModel.AddBody(0, SpatialTransform(),
+                         Joint(JointTypeSpherical),
+                         Body(1., Vector3d(0., 0., 0.), Vector3d(1., 1., 1.)));
+  std::string sphericalFile = rbdlBinaryPath;
+  sphericalFile.append("/spherical_dynamics.h");
+  CHECK_THROWS_AS(LuaModelWriteDynamicsSource(sphericalFile.c_str(),
+                                              sphericalModel, "Spherical"),
+                  Errors::RBDLError);
+}
+
+#ifdef RBDL_LUAMODEL_GENERATED_DYNAMICS
+TEST_CASE(__FILE__"_GeneratedDynamicsMatchRBDL", "")
+{
+  Model model;
+  std::string modelFile = rbdlSourcePath;
+  modelFile.append("/samplemodel.lua");
+  bool modelLoaded = LuaModelReadFromFile(modelFile.c_str(), &model, false);
+  REQUIRE(modelLoaded);
+  REQUIRE(ModelDynamics::DoFCount == model.qdot_size);
+
+  VectorNd q (model.q_size);
+  VectorNd qdot (model.qdot_size);
+  VectorNd tau (model.qdot_size);
+  VectorNd qddot (VectorNd::Zero (model.qdot_size));
+  VectorNd qddot_generated (VectorNd::Zero (model.qdot_size));
+  VectorNd tau_id (VectorNd::Zero (model.qdot_size));
+  VectorNd tau_generated (VectorNd::Zero (model.qdot_size));
+
+  for (unsigned int sample = 0; sample < 5; sample++) {
+    for (unsigned int i = 0; i < model.qdot_size; i++) {
+      q[i] = 0.7 * sin (1.3 * i + 0.9 * sample);
+      qdot[i] = 1.1 * cos (0.7 * i + 1.7 * sample);
+      tau[i] = 2.0 * sin (0.4 * i - 1.2 * sample);
+    }
+
+    ForwardDynamics (model, q, qdot, tau, qddot);
+    ModelDynamics::ForwardDynamics (q.data(), qdot.data(), tau.data(),
+                                    qddot_generated.data());
+    CHECK_THAT (qddot,
+                AllCloseVector(qddot_generated, TEST_PREC, TEST_PREC));
+
+    InverseDynamics (model, q, qdot, qddot, tau_id);
+    ModelDynamics::InverseDynamics (q.data(), qdot.data(), qddot.data(),
+                                    tau_generated.data());
+    CHECK_THAT (tau_id,
+                AllCloseVector(tau_generated, TEST_PREC, TEST_PREC));
+  }
+}
+#endif
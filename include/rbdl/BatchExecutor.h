@@ -0,0 +1,216 @@
+/*
+ * RBDL - Rigid Body Dynamics Library
+ * Copyright (c) 2011-2018 Martin Felis <martin@fysx.org>
+ *
+ * Licensed under the zlib license. See LICENSE for more details.
+ */
+
+#ifndef RBDL_BATCH_EXECUTOR_H
+#define RBDL_BATCH_EXECUTOR_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "rbdl/rbdl_math.h"
+#include "rbdl/Model.h"
+#include "rbdl/Integrators.h"
+
+#ifndef RBDL_USE_CASADI_MATH
+
+namespace RigidBodyDynamics {
+
+/** \page batch_executor_page Batch Evaluation
+ *
+ * The BatchExecutor evaluates the dynamics functions for many states
+ * (e.g. all knot points of a trajectory) on a pool of threads.
+ *
+ * Every thread owns a ModelData workspace that was created from the
+ * Model when the executor was constructed. The samples are split into
+ * chunks that are distributed evenly over the threads and threads that run
+ * out of work steal chunks from the others. The result of sample i is
+ * always written to column i (or entry i) of the output, therefore the
+ * output does not depend on the number of threads or the scheduling.
+ *
+ * \code
+ *   BatchExecutor executor (model, 4);
+ *
+ *   // every column of Q, QDot, Tau is one sample
+ *   executor.ForwardDynamics (Q, QDot, Tau, QDDot);
+ * \endcode
+ *
+ * \note The Model must not be modified while it is used by an executor.
+ * Models with custom joints are not supported as custom joints can only be
+ * evaluated using the workspace of the Model itself.
+ */
+
+/** \brief Thread pool that evaluates dynamics functions for many samples
+ *
+ * See \ref batch_executor_page for more information.
+ */
+class RBDL_DLLAPI BatchExecutor {
+public:
+  /** \brief Signature of the functions that are evaluated by Run()
+   *
+   * The function is called with the index of the sample and the workspace
+   * of the thread that evaluates the sample.
+   */
+  typedef std::function<void (unsigned int sample_index, ModelData &data)>
+    SampleFunction;
+
+  /** \brief Creates the thread pool
+   *
+   * \param model        model that is evaluated by the executor
+   * \param thread_count number of threads that evaluate samples including
+   *                     the calling thread. 0 uses the number of hardware
+   *                     threads.
+   */
+  explicit BatchExecutor (const Model &model, unsigned int thread_count = 0);
+  ~BatchExecutor ();
+
+  /// \brief Number of threads (including the calling thread)
+  unsigned int GetThreadCount () const {
+    return mWorkers.size();
+  }
+
+  /** \brief Calls function for every sample index in [0, sample_count)
+   *
+   * Returns once all samples have been evaluated. If function throws an
+   * exception the remaining samples are still evaluated and the first
+   * exception is rethrown afterwards.
+   *
+   * \note Run() must not be called concurrently on the same executor.
+   */
+  void Run (unsigned int sample_count, const SampleFunction &function);
+
+  /** \brief Evaluates ForwardDynamics() for every column of Q, QDot, Tau
+   *
+   * QDDot is resized to qdot_size x N.
+   */
+  void ForwardDynamics (
+      const Math::MatrixNd &Q,
+      const Math::MatrixNd &QDot,
+      const Math::MatrixNd &Tau,
+      Math::MatrixNd &QDDot
+      );
+
+  /** \brief Evaluates InverseDynamics() for every column of Q, QDot, QDDot
+   *
+   * Tau is resized to qdot_size x N.
+   */
+  void InverseDynamics (
+      const Math::MatrixNd &Q,
+      const Math::MatrixNd &QDot,
+      const Math::MatrixNd &QDDot,
+      Math::MatrixNd &Tau
+      );
+
+  /** \brief Evaluates NonlinearEffects() for every column of Q, QDot
+   *
+   * Tau is resized to qdot_size x N.
+   */
+  void NonlinearEffects (
+      const Math::MatrixNd &Q,
+      const Math::MatrixNd &QDot,
+      Math::MatrixNd &Tau
+      );
+
+  /** \brief Evaluates CompositeRigidBodyAlgorithm() for every column of Q
+   *
+   * H is resized to N matrices of size qdot_size x qdot_size.
+   */
+  void CompositeRigidBodyAlgorithm (
+      const Math::MatrixNd &Q,
+      std::vector<Math::MatrixNd> &H
+      );
+
+  /** \brief Advances every column of Q, QDot by step_count steps of dt
+   *
+   * Every column is an independent system that is integrated with an
+   * Integrator of the given method (see \ref integrators_page) and the
+   * constant actuations of the same column of Tau. Q and QDot are updated
+   * in place.
+   */
+  void Integrate (
+      IntegratorMethod method,
+      double dt,
+      unsigned int step_count,
+      Math::MatrixNd &Q,
+      Math::MatrixNd &QDot,
+      const Math::MatrixNd &Tau
+      );
+
+private:
+  BatchExecutor (const BatchExecutor&);
+  BatchExecutor& operator= (const BatchExecutor&);
+
+  struct Worker {
+    Worker (const Model &model) :
+      data (model),
+      q (Math::VectorNd::Zero (model.q_size)),
+      qdot (Math::VectorNd::Zero (model.qdot_size)),
+      u (Math::VectorNd::Zero (model.qdot_size)),
+      result (Math::VectorNd::Zero (model.qdot_size)),
+      integrator (model)
+    {}
+
+    /// workspace of the thread
+    ModelData data;
+    /// temporaries for the columns of the current sample
+    Math::VectorNd q;
+    Math::VectorNd qdot;
+    Math::VectorNd u;
+    Math::VectorNd result;
+    /// workspace for Integrate()
+    Integrator integrator;
+
+    /// protects chunks, other workers steal from the back
+    std::mutex mutex;
+    /// first sample indices of the chunks assigned to this worker
+    std::deque<unsigned int> chunks;
+  };
+
+  typedef std::function<void (unsigned int sample_index, Worker &worker)>
+    WorkerFunction;
+
+  void RunWorkers (unsigned int sample_count, const WorkerFunction &function);
+  /// Stops and joins all started threads and releases the workers
+  void Shutdown ();
+  void WorkerLoop (unsigned int worker_index);
+  void ProcessChunks (unsigned int worker_index);
+  bool PopChunk (unsigned int worker_index, unsigned int &chunk_begin);
+
+  void CheckColumns (const Math::MatrixNd &M, unsigned int rows,
+      unsigned int cols) const;
+
+  const Model &mModel;
+  std::vector<Worker*> mWorkers;
+  std::vector<std::thread> mThreads;
+
+  std::mutex mMutex;
+  std::condition_variable mStartCondition;
+  std::condition_variable mDoneCondition;
+  /// incremented for every call to Run() to wake up the threads
+  unsigned long mGeneration;
+  /// number of pool threads that did not yet finish the current job
+  unsigned int mPendingThreads;
+  bool mStop;
+
+  /// job of the current call to Run()
+  const WorkerFunction *mFunction;
+  unsigned int mSampleCount;
+  unsigned int mChunkSize;
+  std::exception_ptr mException;
+};
+
+}
+
+/* RBDL_USE_CASADI_MATH */
+#endif
+
+/* RBDL_BATCH_EXECUTOR_H */
+#endif
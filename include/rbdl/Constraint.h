@@ -8,6 +8,7 @@
 #ifndef RBDL_CONSTRAINT_H
 #define RBDL_CONSTRAINT_H
 
+#include <vector>
 #include <rbdl/rbdl_math.h>
 #include <rbdl/rbdl_mathutils.h>
 #include <assert.h>
@@ -22,6 +23,72 @@ enum ConstraintType {
   ConstraintTypeLast,
 };
 
+/**
+  Kinematic quantities of a body that are shared by the constraints of a
+  ConstraintSet, see ConstraintCache::beginPointCache(). All quantities are
+  evaluated at the origin of the body and resolved in base coordinates.
+*/
+struct RBDL_DLLAPI ConstraintBodyKinematics {
+  ConstraintBodyKinematics() :
+    bodyId (0),
+    hasFrame (false),
+    hasJacobian (false),
+    hasVelocity (false),
+    hasBiasAcceleration (false),
+    position (Math::Vector3d::Zero()),
+    orientation (Math::Matrix3d::Identity()),
+    velocity6D (Math::SpatialVector::Zero()),
+    biasAcceleration6D (Math::SpatialVector::Zero())
+  {}
+
+  unsigned int bodyId;
+  bool hasFrame, hasJacobian, hasVelocity, hasBiasAcceleration;
+  ///Position of the body origin
+  Math::Vector3d position;
+  ///Orientation of the body, see CalcBodyWorldOrientation
+  Math::Matrix3d orientation;
+  ///6 x N Jacobian of the body origin, see CalcPointJacobian6D
+  Math::MatrixNd jacobian6D;
+  ///Spatial velocity of the body origin, see CalcPointVelocity6D
+  Math::SpatialVector velocity6D;
+  ///Spatial acceleration of the body origin for zero QDDot, see
+  ///CalcPointAcceleration6D
+  Math::SpatialVector biasAcceleration6D;
+};
+
+/**
+  Kinematic quantities of a point on a body that are shared by the
+  constraints of a ConstraintSet. They are obtained from the
+  ConstraintBodyKinematics of the body by shifting them to the point.
+*/
+struct RBDL_DLLAPI ConstraintPointKinematics {
+  ConstraintPointKinematics() :
+    bodyIndex (0),
+    bodyPoint (Math::Vector3d::Zero()),
+    hasPosition (false),
+    hasJacobian (false),
+    hasVelocity (false),
+    hasBiasAcceleration (false),
+    offset (Math::Vector3d::Zero()),
+    position (Math::Vector3d::Zero()),
+    velocity6D (Math::SpatialVector::Zero()),
+    biasAcceleration6D (Math::SpatialVector::Zero())
+  {}
+
+  ///Index of the body in ConstraintCache::bodyKinematics
+  unsigned int bodyIndex;
+  ///Point in the coordinates of the body
+  Math::Vector3d bodyPoint;
+  bool hasPosition, hasJacobian, hasVelocity, hasBiasAcceleration;
+  ///Vector from the body origin to the point in base coordinates
+  Math::Vector3d offset;
+  ///Position of the point in base coordinates
+  Math::Vector3d position;
+  Math::MatrixNd jacobian6D;
+  Math::SpatialVector velocity6D;
+  Math::SpatialVector biasAcceleration6D;
+};
+
 /**
   This struct contains a working memory that can be used by extensions to
   the Constraint interface. The intent by passing in a ConstraintCache variable
@@ -31,7 +98,7 @@ enum ConstraintType {
   the memory requirements of the contact constraints and loop constraint 
   classes.
 */
-struct ConstraintCache {
+struct RBDL_DLLAPI ConstraintCache {
 
   ///Here N is taken to mean the number of elements in QDot.
   Math::VectorNd vecNZeros;
@@ -59,7 +126,93 @@ struct ConstraintCache {
   ///Working SpatialTransforms
   Math::SpatialTransform stA, stB, stC, stD;
 
-  ConstraintCache(){}
+  /**
+    @name Body point kinematics
+
+    Several constraints often act on the same body (e.g. the contact points
+    of a foot) or even on the same point. The get functions below evaluate
+    the kinematics of each body at most once while the cache is active and
+    only shift them to the requested points. The ConstraintSet activates
+    the cache for the duration of CalcConstrainedSystemVariables,
+    CalcConstraintsJacobian, CalcConstraintsPositionError and
+    CalcConstraintsVelocityError, i.e. while Q and QDot do not change.
+    Outside of these functions the get functions simply compute the
+    requested quantity.
+
+    The returned references are only valid until the next call of one of
+    the get functions.
+  */
+  ///@{
+  std::vector<ConstraintBodyKinematics> bodyKinematics;
+  std::vector<ConstraintPointKinematics> pointKinematics;
+  ///Number of entries of bodyKinematics and pointKinematics in use
+  unsigned int bodyKinematicsCount;
+  unsigned int pointKinematicsCount;
+  ///Whether the entries are shared between calls of the get functions
+  bool pointCacheActive;
+  ///Highest level of the model kinematics that has already been updated
+  ///while the cache is active (0: none, 1: positions, 2: velocities,
+  ///3: accelerations for zero QDDot)
+  unsigned int kinematicsLevel;
+
+  ///Clears and activates the cache. The model state must not change until
+  ///endPointCache() is called.
+  void beginPointCache();
+  ///Deactivates the cache.
+  void endPointCache();
+
+  const Math::Vector3d& getPointPosition(Model &model,
+                                         const Math::VectorNd &Q,
+                                         unsigned int bodyId,
+                                         const Math::Vector3d &bodyPoint,
+                                         bool updateKinematics);
+
+  const Math::Matrix3d& getBodyWorldOrientation(Model &model,
+                                               const Math::VectorNd &Q,
+                                               unsigned int bodyId,
+                                               bool updateKinematics);
+
+  ///6 x N Jacobian of the point, see CalcPointJacobian6D
+  const Math::MatrixNd& getPointJacobian6D(Model &model,
+                                           const Math::VectorNd &Q,
+                                           unsigned int bodyId,
+                                           const Math::Vector3d &bodyPoint,
+                                           bool updateKinematics);
+
+  ///Spatial velocity of the point, see CalcPointVelocity6D
+  const Math::SpatialVector& getPointVelocity6D(Model &model,
+                                          const Math::VectorNd &Q,
+                                          const Math::VectorNd &QDot,
+                                          unsigned int bodyId,
+                                          const Math::Vector3d &bodyPoint,
+                                          bool updateKinematics);
+
+  ///Spatial acceleration of the point for zero QDDot, see
+  ///CalcPointAcceleration6D
+  const Math::SpatialVector& getPointBiasAcceleration6D(Model &model,
+                                          const Math::VectorNd &Q,
+                                          const Math::VectorNd &QDot,
+                                          unsigned int bodyId,
+                                          const Math::Vector3d &bodyPoint,
+                                          bool updateKinematics);
+  ///@}
+
+  ConstraintCache():
+    bodyKinematicsCount(0),
+    pointKinematicsCount(0),
+    pointCacheActive(false),
+    kinematicsLevel(0){}
+
+private:
+  unsigned int findBodyKinematics(unsigned int bodyId);
+  unsigned int findPointKinematics(unsigned int bodyId,
+                                   const Math::Vector3d &bodyPoint);
+  bool updateKinematicsTo(bool updateKinematics, unsigned int level);
+  void calcBodyFrame(Model &model, const Math::VectorNd &Q,
+                     ConstraintBodyKinematics &body, bool updateKinematics);
+  void calcPointOffset(Model &model, const Math::VectorNd &Q,
+                       ConstraintPointKinematics &point,
+                       bool updateKinematics);
 };
 
 
@@ -81,6 +234,10 @@ struct ConstraintCache {
   - calcVelocityError
   - calcConstraintForces
 
+  Implementing the optional method calcSpatialTestForces allows
+  ForwardDynamicsContactsKokkevis to apply the test forces of the constraint
+  directly to its bodies.
+
   Please see the doxygen for each of these functions in the Constraint
   interface for details. In addition, please have a look at Constraint_Contact
   (and ContactsTests.cc) and Constraint_Loop (and LoopConstraintsTests.cc) for
@@ -358,6 +515,64 @@ class RBDL_DLLAPI Constraint {
                  bool resolveAllInRootFrame = false,
                  bool updateKinematics=false) = 0;
 
+    /**
+      @brief Optional: resolves a unit Lagrange multiplier of a single row of
+      this constraint into the spatial forces that it applies to the bodies
+      of the constraint. ForwardDynamicsContactsKokkevis uses these forces
+      as test forces to evaluate the effect of the row on the accelerations
+      of the system with the Articulated Body Algorithm.
+
+      The generalized force of the returned spatial forces has to be equal
+      to the transposed row of the constraint Jacobian, i.e. the forces
+      are the ones that a multiplier of 1 of ConstraintSet::force applies
+      to the system.
+
+      The default implementation returns false. In this case the row of the
+      constraint Jacobian is used as a generalized test force, which gives
+      the same result but has to propagate the test force through all
+      bodies of the model.
+
+      @param model: a reference to the multibody model.
+
+      @param time: the time which is included so that rheonomic
+      constraints might be included (in the future).
+
+      @param Q: the vector of generalized positions.
+
+      @param rowIndex: the row of this constraint, i.e. a value between 0
+      and sizeOfConstraint - 1.
+
+      @param constraintBodiesOutput the ids of the bodies to which the
+          forces in constraintForcesOutput are applied (resize as needed).
+
+      @param constraintForcesOutput the spatial forces that are applied to
+          the bodies listed in constraintBodiesOutput, expressed in base
+          coordinates and w.r.t. the origin of the base frame, i.e. in the
+          same way as the external forces of ForwardDynamics.
+
+      @param cache: a ConstraintCache object which contains ample pre-allocated
+          memory that can be used to reduce the memory footprint of each
+          Constraint implementation.
+
+      @param updateKinematics: setting this flag to true will cause all
+          calls to kinematic dependent functions to be updated using the
+          generalized coordinates passed into this function.
+
+      @return true if the spatial forces were computed.
+    */
+    virtual bool calcSpatialTestForces(
+                 Model &/*model*/,
+                 const double /*time*/,
+                 const Math::VectorNd &/*Q*/,
+                 unsigned int /*rowIndex*/,
+                 std::vector< unsigned int > &/*constraintBodiesOutput*/,
+                 std::vector< Math::SpatialVector > &/*constraintForcesOutput*/,
+                 ConstraintCache &/*cache*/,
+                 bool /*updateKinematics*/=false)
+    {
+      return false;
+    }
+
 
 //==============================================================================
 // DO NOT TOUCH!!!
@@ -182,6 +182,16 @@ public:
         bool resolveAllInRootFrame = false,
         bool updateKinematics=false) override;
 
+  bool calcSpatialTestForces(
+        Model &model,
+        const double time,
+        const Math::VectorNd &Q,
+        unsigned int rowIndex,
+        std::vector< unsigned int > &constraintBodiesUpd,
+        std::vector< Math::SpatialVector > &constraintForcesUpd,
+        ConstraintCache &cache,
+        bool updateKinematics=false) override;
+
 
 
   /**
@@ -201,6 +211,24 @@ public:
   void appendNormalVector(const Math::Vector3d &normal,
                           bool velocityLevelConstraint=true);
 
+  /**
+    @param frictionCoefficient the Coulomb friction coefficient that is used
+            by ForwardDynamicsContactsPGS. The first normal vector of this
+            constraint is treated as the unilateral contact normal and all
+            further normal vectors as its friction directions. Defaults to
+            infinity, i.e. the contact sticks as long as it is closed.
+  */
+  void setFrictionCoefficient(double frictionCoefficient){
+    this->frictionCoefficient = frictionCoefficient;
+  }
+
+  /**
+    @return the Coulomb friction coefficient of this contact.
+  */
+  double getFrictionCoefficient() const {
+    return frictionCoefficient;
+  }
+
   /*** @brief Added to support ForwardDynamicsKokkevis
 
     @param model: the multibody model
@@ -270,6 +298,8 @@ private:
   Math::Vector3d groundPoint;
   ///A working double 
   double dblA;
+  ///The Coulomb friction coefficient used by ForwardDynamicsContactsPGS
+  double frictionCoefficient;
 
 };
 
@@ -206,6 +206,16 @@ public:
         bool resolveAllInRootFrame = false,
         bool updateKinematics=false) override;
 
+  bool calcSpatialTestForces(
+        Model &model,
+        const double time,
+        const Math::VectorNd &Q,
+        unsigned int rowIndex,
+        std::vector< unsigned int > &constraintBodiesUpd,
+        std::vector< Math::SpatialVector > &constraintForcesUpd,
+        ConstraintCache &cache,
+        bool updateKinematics=false) override;
+
 
 
   /**
@@ -281,7 +281,15 @@ struct Model;
 struct RBDL_DLLAPI ConstraintSet {
   ConstraintSet() :
     linear_solver (Math::LinearSolverColPivHouseholderQR),
-    bound (false) {}
+    bound (false),
+#ifndef RBDL_USE_CASADI_MATH
+    assembly_warm_start (false),
+    assembly_factorization_valid (false),
+    assembly_factorization_count (0),
+#endif
+    pgs_max_iterations (100),
+    pgs_tolerance (1.0e-10),
+    pgs_iterations (0) {}
 
 
 
@@ -691,6 +699,20 @@ struct RBDL_DLLAPI ConstraintSet {
                                 baumgartePositionVelocityCoefficientsOutput);
   }
 
+  /**
+     @brief Sets the Coulomb friction coefficient of a contact constraint
+            that is used by ForwardDynamicsContactsPGS.
+
+     @param groupIndex: the index number of this constraint (see getGroupIndex
+            index functions)
+     @param frictionCoefficient: the friction coefficient of the contact
+
+     @note Throws an RBDLError if the constraint is not a contact constraint.
+  */
+  void setContactFrictionCoefficient(
+      unsigned int groupIndex,
+      double frictionCoefficient);
+
   /** @brief Adds a single contact constraint (point-ground) to the
       constraint set.
 
@@ -828,7 +850,9 @@ struct RBDL_DLLAPI ConstraintSet {
 
     This function allocates the temporary vectors and matrices needed
     for the RigidBodyDynamics::InverseDynamicsConstraints and RigidBodyDynamics::InverseDynamicsConstraintsRelaxed
-    methods. In addition, the constant matrices S and P are set here. 
+    methods. In addition, the constant matrices S and P and the
+    corresponding index lists actuated_dof_indices and
+    unactuated_dof_indices are set here.
     This function needs to be called once
     before calling either RigidBodyDynamics::InverseDynamicsConstraints or
     RigidBodyDynamics::InverseDynamicsConstraintsRelaxed. It does not ever need be called
@@ -923,6 +947,12 @@ struct RBDL_DLLAPI ConstraintSet {
   Math::MatrixNd S;
   /// Selection matrix for the non-actuated parts of the model
   Math::MatrixNd P;
+  /// Indices of the actuated degrees of freedom, i.e. the columns of S
+  /// that contain a 1. The inverse-dynamics-with-constraints operators use
+  /// them to gather the blocks of H and G instead of multiplying with S.
+  std::vector<unsigned int> actuated_dof_indices;
+  /// Indices of the non-actuated degrees of freedom (columns of P)
+  std::vector<unsigned int> unactuated_dof_indices;
   /// Matrix that holds the relative cost of deviating from the desired
   /// accelerations
   Math::MatrixNd W;
@@ -931,6 +961,12 @@ struct RBDL_DLLAPI ConstraintSet {
 
   Math::VectorNd u;
   Math::VectorNd v;
+  /// Workspace for the entries of C of the actuated (SC) and non-actuated
+  /// (PC) degrees of freedom
+  Math::VectorNd SC;
+  Math::VectorNd PC;
+  /// Workspace for the actuated entries of the desired accelerations
+  Math::VectorNd SQDDotControls;
 
   Math::MatrixNd F;
   Math::MatrixNd Ful,Fur,Fll,Flr; //blocks of f for SimpleMath
@@ -956,6 +992,59 @@ struct RBDL_DLLAPI ConstraintSet {
   Math::VectorNd qddot_y;
   Math::VectorNd qddot_z;
 
+#ifndef RBDL_USE_CASADI_MATH
+  // Variables used by the range-space method with LinearSolverSparseLTL
+  /// For each constraint the (ascending) degrees of freedom on which its
+  /// row of G and its column of \f$L^{-T} G^T\f$ can be non-zero. This
+  /// symbolic pattern only grows and is reused across calls.
+  std::vector< std::vector<unsigned int> > sparse_ltl_support;
+  /// Membership flags of sparse_ltl_support.
+  std::vector< std::vector<bool> > sparse_ltl_mask;
+  /// Workspace for \f$L^{-T} G^T\f$.
+  Math::MatrixNd sparse_ltl_Y;
+  /// Workspace for \f$L^{-T} c\f$.
+  Math::VectorNd sparse_ltl_z;
+  /// Workspace for the LDLT decomposition of the constraint force system.
+  Eigen::LDLT<Math::MatrixNd> sparse_ltl_K_ldlt;
+
+  // Variables used by CalcAssemblyQ and CalcAssemblyQDot
+  /// Whether CalcAssemblyQ() starts with the factorization of the previous
+  /// call of CalcAssemblyQ() or CalcAssemblyQDot() (defaults to false).
+  /// This saves the factorization at the beginning of each time step when
+  /// the assembly is run after every step of a simulation.
+  bool assembly_warm_start;
+  /// Whether assembly_ldlt holds a usable factorization for
+  /// assembly_weights.
+  bool assembly_factorization_valid;
+  /// Number of factorizations performed by the last call of
+  /// CalcAssemblyQ() or CalcAssemblyQDot().
+  unsigned int assembly_factorization_count;
+  /// Weights of the degrees of freedom of the current factorization.
+  Math::VectorNd assembly_weights;
+  /// Workspace for the constraint Jacobian.
+  Math::MatrixNd assembly_G;
+  /// Workspace for \f$W^{-1} G^T\f$.
+  Math::MatrixNd assembly_WinvGT;
+  /// Workspace for the Schur complement \f$G W^{-1} G^T\f$.
+  Math::MatrixNd assembly_GWinvGT;
+  /// Workspace for the decomposition of the Schur complement.
+  Eigen::LDLT<Math::MatrixNd> assembly_ldlt;
+  /// Workspace for the KKT system that is used if a weight is not positive
+  /// or the constraints are redundant.
+  Math::MatrixNd assembly_A;
+  Math::VectorNd assembly_b;
+  Math::VectorNd assembly_x;
+  /// Workspace for the trial positions of an iteration.
+  Math::VectorNd assembly_q;
+  /// Workspace for the constraint errors.
+  Math::VectorNd assembly_e;
+  Math::VectorNd assembly_e_trial;
+  /// Workspace for the step of an iteration.
+  Math::VectorNd assembly_d;
+  /// Workspace for the multipliers of the Schur complement system.
+  Math::VectorNd assembly_lambda;
+#endif
+
   // Variables used by the IABI methods
   /// Workspace for the Inverse Articulated-Body Inertia.
   Math::MatrixNd K;
@@ -971,6 +1060,35 @@ struct RBDL_DLLAPI ConstraintSet {
   std::vector<Math::SpatialVector> f_ext_constraints;
   /// Workspace for the default point accelerations.
   std::vector<Math::Vector3d> point_accel_0;
+#ifndef RBDL_USE_CASADI_MATH
+  /// Movable bodies of the spatial test forces of all constraint rows, see
+  /// Constraint::calcSpatialTestForces.
+  std::vector<unsigned int> test_force_bodies;
+  /// Spatial test forces of all constraint rows in base coordinates.
+  std::vector<Math::SpatialVector> test_forces;
+  /// Spatial test forces of all constraint rows in body coordinates.
+  std::vector<Math::SpatialVector> test_forces_body;
+  /// Index of the first test force of each row (one more entry than rows).
+  std::vector<unsigned int> test_force_offsets;
+  /// Whether a row has spatial test forces. Otherwise its row of G is
+  /// used as generalized test force.
+  std::vector<bool> test_force_spatial;
+  /// Workspace for the output of Constraint::calcSpatialTestForces.
+  std::vector<unsigned int> row_test_force_bodies;
+  /// Workspace for the output of Constraint::calcSpatialTestForces.
+  std::vector<Math::SpatialVector> row_test_forces;
+  /// Workspace for the generalized test forces and constraint forces.
+  Math::VectorNd tau_t;
+#endif
+
+  // Variables used by ForwardDynamicsContactsPGS
+  /// Maximum number of Gauss-Seidel sweeps.
+  unsigned int pgs_max_iterations;
+  /// The iteration stops once no force changed by more than this value
+  /// during a sweep.
+  double pgs_tolerance;
+  /// Number of sweeps of the last call of ForwardDynamicsContactsPGS.
+  unsigned int pgs_iterations;
 
   /// Workspace for the bias force due to the test force
   std::vector<Math::SpatialVector> d_pA;
@@ -1105,11 +1223,22 @@ void CalcConstrainedSystemVariables (
   * \return true if the generalized joint positions were computed successfully,
   * false otherwise.f
   *
+  * \note If all weights are positive each step is computed from the Schur
+  * complement \f$G W^{-1} G^T\f$ of the weighted least-squares problem,
+  * whose factorization is kept in the workspace of CS. The factorization
+  * is reused in the following iterations as long as the constraint error
+  * at least halves in each of them, otherwise the Jacobian is updated and
+  * the system is factorized again. With CS.assembly_warm_start the
+  * factorization of the previous call of CalcAssemblyQ() or
+  * CalcAssemblyQDot() is reused as well. For non-positive weights or
+  * redundant constraints the full KKT system is solved in each iteration
+  * with CS.linear_solver. QInit and QOutput may be the same vector.
+  *
   */
 RBDL_DLLAPI
 bool CalcAssemblyQ(
   Model &model,
-  Math::VectorNd QInit,
+  const Math::VectorNd &QInit,
   ConstraintSet &CS,
   Math::VectorNd &QOutput,
   const Math::VectorNd &weights,
@@ -1128,6 +1257,10 @@ bool CalcAssemblyQ(
   * \param QDotOutput vector of the generalized joint velocities.
   * \param weights weighting coefficients for the different joint positions.
   *
+  * \note The factorization of the Schur complement computed at Q is kept in
+  * CS and can be used by the next call of CalcAssemblyQ() (see
+  * ConstraintSet::assembly_warm_start).
+  *
   */
 RBDL_DLLAPI
 void CalcAssemblyQDot(
@@ -1204,6 +1337,16 @@ void ForwardDynamicsConstraintsDirect (
   std::vector<Math::SpatialVector> *f_ext = NULL
 );
 
+/** \brief Computes forward dynamics with contact by constructing and
+ * solving the full lagrangian equation using the range-space method of
+ * SolveConstrainedSystemRangeSpaceSparse().
+ *
+ * \note When ConstraintSet::linear_solver is Math::LinearSolverSparseLTL
+ * the sparsity of the constraint Jacobian is exploited as well: only the
+ * degrees of freedom supporting a constraint are touched when computing
+ * \f$L^{-T} G^T\f$. The sparsity pattern is determined on the first call
+ * and reused afterwards.
+ */
 RBDL_DLLAPI
 void ForwardDynamicsConstraintsRangeSpaceSparse (
   Model &model,
@@ -1291,7 +1434,14 @@ void ForwardDynamicsConstraintsNullSpace (
  * ConstraintSet::force get modified and will contain the value
  * of the force acting along the normal.
  *
- * \note This function supports only contact constraints.
+ * \note Besides contact constraints the system may contain loop constraints
+ * and custom constraints. Their test forces are the spatial forces of
+ * Constraint::calcSpatialTestForces() or, for constraints that do not
+ * implement it, the rows of the constraint Jacobian as generalized forces.
+ * The latter requires a pass over all bodies of the model for each row.
+ * For such systems Baumgarte stabilization is applied as in
+ * ForwardDynamicsConstraintsDirect(). With CasADi only contact constraints
+ * are supported.
  *
  * \todo Allow for external forces
  */
@@ -1305,6 +1455,57 @@ void ForwardDynamicsContactsKokkevis (
   Math::VectorNd &QDDotOutput
 );
 
+#ifndef RBDL_USE_CASADI_MATH
+/** \brief Computes forward dynamics with unilateral contacts and Coulomb
+ * friction using a projected Gauss-Seidel (PGS) iteration.
+ *
+ * The constraint accelerations \f$\dot{v} = \phi + W f\f$ are built once
+ * per call with the test forces of ForwardDynamicsContactsKokkevis() (\f$W
+ * = -K\f$ is the Delassus operator). Instead of solving the linear system
+ * the forces are then iterated row by row and projected such that for each
+ * ContactConstraint
+ *
+ * - the force along its first normal vector is non-negative (pushing) and
+ *   zero if the point accelerates away from the ground,
+ * - the forces along its further normal vectors (friction directions) are
+ *   bounded by \f$\mu f_n\f$ where \f$\mu\f$ is the friction
+ *   coefficient (see ContactConstraint::setFrictionCoefficient()).
+ *
+ * The friction cone is approximated by a box and friction opposes the
+ * tangential acceleration, i.e. the solution describes sticking or
+ * separating contacts for the current step.
+ *
+ * The iteration starts from the projection of ConstraintSet::force, i.e.
+ * the forces of the previous call (warm start), and stops after
+ * ConstraintSet::pgs_max_iterations sweeps or once no force changed by
+ * more than ConstraintSet::pgs_tolerance. The number of sweeps is stored
+ * in ConstraintSet::pgs_iterations.
+ *
+ * As no contact has to be deactivated or re-activated by the caller, the
+ * set can contain all potential contacts and redundant contact points
+ * (e.g. four corners of a foot) for which the linear system of
+ * ForwardDynamicsContactsKokkevis() would be singular.
+ *
+ * \param model rigid body model
+ * \param Q     state vector of the internal joints
+ * \param QDot  velocity vector of the internal joints
+ * \param Tau   actuations of the internal joints
+ * \param CS a list of all contact points
+ * \param QDDotOutput accelerations of the internals joints
+ *
+ * \note This function supports only contact constraints.
+ */
+RBDL_DLLAPI
+void ForwardDynamicsContactsPGS (
+  Model &model,
+  const Math::VectorNd &Q,
+  const Math::VectorNd &QDot,
+  const Math::VectorNd &Tau,
+  ConstraintSet &CS,
+  Math::VectorNd &QDDotOutput
+);
+#endif
+
 
 #ifndef RBDL_USE_CASADI_MATH
 /**
@@ -19,6 +19,7 @@
 namespace RigidBodyDynamics {
 
 struct Model;
+struct ModelData;
 
 /** \page dynamics_page Dynamics
  *
@@ -81,6 +82,10 @@ RBDL_DLLAPI void NonlinearEffects (
  * \param Q     state vector of the model
  * \param H     a matrix where the result will be stored in
  * \param update_kinematics  whether the kinematics should be updated (safer, but at a higher computational cost!)
+ * \param lower_triangle_only  if true only the entries below and on the
+ * diagonal are written, i.e. for every degree of freedom the entries of its
+ * ancestors in the kinematic tree. This is the branch-sparse storage that
+ * SparseFactorizeLTL() expects and the upper triangle is left untouched.
  *
  * \note This function only evaluates the entries of H that are non-zero. One
  * Before calling this function one has to ensure that all other values
@@ -90,6 +95,27 @@ RBDL_DLLAPI void CompositeRigidBodyAlgorithm (
     Model& model,
     const Math::VectorNd &Q,
     Math::MatrixNd &H,
+    bool update_kinematics = true,
+    bool lower_triangle_only = false
+    );
+
+/** \brief Computes the composite rigid body inertias of all bodies
+ *
+ * For every body \f$i\f$ this computes the spatial inertia \f$I^c_i\f$ of
+ * the subtree that is supported by body \f$i\f$ (the body itself and all
+ * its descendants) expressed in the coordinates of body \f$i\f$ and stores
+ * it in model.Ic[i]. This is the backward pass of the
+ * CompositeRigidBodyAlgorithm() and is also used by
+ * Utils::CalcCentroidalMomentumMatrix().
+ *
+ * \param model rigid body model
+ * \param Q     state vector of the model
+ * \param update_kinematics  whether the joint transformations should be
+ * updated (safer, but at a higher computational cost!)
+ */
+RBDL_DLLAPI void CalcCompositeRigidBodyInertias (
+    Model& model,
+    const Math::VectorNd &Q,
     bool update_kinematics = true
     );
 
@@ -117,6 +143,43 @@ RBDL_DLLAPI void ForwardDynamics (
     std::vector<Math::SpatialVector> *f_ext = NULL
     );
 
+#ifndef RBDL_USE_CASADI_MATH
+/** \brief Computes forward dynamics for many states at once
+ *
+ * Every column of Q, QDot, Tau describes one sample and the generalized
+ * accelerations of sample i are written to column i of QDDot. The results
+ * are the same as calling ForwardDynamics() for each column (up to
+ * rounding).
+ *
+ * If all joints of the model are revolute or prismatic joints with a
+ * single axis the Articulated Body Algorithm is evaluated for groups of 8
+ * samples at once: every quantity of the recursion is stored as a
+ * structure of arrays with one entry per sample such that the operations
+ * of the samples are executed with SIMD instructions. Models with other
+ * joints (e.g. multi-dof, helical or custom joints) are evaluated sample by
+ * sample using a single workspace.
+ *
+ * \note The batched recursion does not write the kinematic quantities of
+ * the samples into the model (or workspace data). Its lane buffers are kept
+ * in ModelData::batch_bodies such that only the first call with a given
+ * workspace allocates memory.
+ *
+ * \param model rigid body model
+ * \param Q     states of the internal joints (q_size x N)
+ * \param QDot  velocities of the internal joints (qdot_size x N)
+ * \param Tau   actuations of the internal joints (qdot_size x N)
+ * \param QDDot accelerations of the internal joints (output, resized to
+ *              qdot_size x N if needed)
+ */
+RBDL_DLLAPI void ForwardDynamicsBatch (
+    Model &model,
+    const Math::MatrixNd &Q,
+    const Math::MatrixNd &QDot,
+    const Math::MatrixNd &Tau,
+    Math::MatrixNd &QDDot
+    );
+#endif
+
 /** \brief Computes forward dynamics by building and solving the full Lagrangian equation
  *
  * This method builds and solves the linear system
@@ -134,6 +197,12 @@ RBDL_DLLAPI void ForwardDynamics (
  * \param f_ext External forces acting on the body in base coordinates (optional, defaults to NULL)
  * \param H     preallocated workspace area for the joint space inertia matrix of size dof_count x dof_count (optional, defaults to NULL and allocates temporary matrix)
  * \param C     preallocated workspace area for the right hand side vector of size dof_count x 1 (optional, defaults to NULL and allocates temporary vector)
+ *
+ * \note With Math::LinearSolverSparseLTL only the lower triangle of H is
+ * computed and factorized in place by SparseFactorizeLTL() such that the
+ * system is solved in \f$O(n_{\textit{dof}} d^2)\f$ time, where \f$d\f$ is
+ * the depth of the kinematic tree. H then contains the factor \f$L\f$ with
+ * \f$H = L^T L\f$ instead of the joint space inertia matrix.
  */
 RBDL_DLLAPI void ForwardDynamicsLagrangian (
     Model &model,
@@ -176,6 +245,416 @@ RBDL_DLLAPI void CalcMInvTimesTau (
     bool update_kinematics=true
     );
 
+#ifndef RBDL_USE_CASADI_MATH
+/** \brief Factorization of the joint space inertia matrix of a single
+ * configuration
+ *
+ * Contains the structure preserving \f$L^TL\f$ decomposition of
+ * \f$M(q)\f$ computed by SparseFactorizeLTL(). Once computed with
+ * FactorizeMassMatrix() it does not depend on any values stored in Model
+ * or ModelData and \f$M(q)^{-1}\f$ can be applied to any number of right
+ * hand sides in \f$O(n_{\textit{dof}} d)\f$ time each, where \f$d\f$ is
+ * the depth of the kinematic tree.
+ */
+struct RBDL_DLLAPI MassMatrixFactorization {
+  MassMatrixFactorization();
+  MassMatrixFactorization (const Model &model);
+
+  /// \brief Allocates the storage for the degrees of freedom of model
+  void resize (const Model &model);
+
+  /// Lower triangular factor \f$L\f$ with \f$M(q) = L^T L\f$
+  Math::MatrixNd L;
+  /// Workspace for the transposed right hand sides of a solve to which
+  /// \f$L^{-T}\f$ and \f$L^{-1}\f$ are applied
+  Math::MatrixNd LInvT;
+};
+
+/** \brief Computes the factorization of the joint space inertia matrix for
+ * the generalized positions Q
+ *
+ * The joint space inertia matrix is computed by
+ * CompositeRigidBodyAlgorithm() and factorized in place by
+ * SparseFactorizeLTL(), which exploits the branch-induced sparsity.
+ *
+ * \param model rigid body model
+ * \param Q     state vector of the generalized positions
+ * \param factorization the factorization (output, resized if needed)
+ */
+RBDL_DLLAPI void FactorizeMassMatrix (
+    Model &model,
+    const Math::VectorNd &Q,
+    MassMatrixFactorization &factorization
+    );
+
+/** \brief Computes \f$M(q)^{-1} \tau\f$ with a factorization computed by
+ * FactorizeMassMatrix()
+ *
+ * \param model rigid body model the factorization was computed for
+ * \param factorization the factorization of \f$M(q)\f$
+ * \param Tau   the vector that should be multiplied with the inverse of
+ *              the joint space inertia matrix
+ * \param QDDot vector where the result will be stored
+ */
+RBDL_DLLAPI void CalcMInvTimesTau (
+    const Model &model,
+    MassMatrixFactorization &factorization,
+    const Math::VectorNd &Tau,
+    Math::VectorNd &QDDot
+    );
+
+/** \brief Computes \f$M(q)^{-1} \tau\f$ for every column of Tau
+ *
+ * All columns are processed together in a single pass over the sparse
+ * factor, e.g. to compute \f$M^{-1} J^T\f$ for the operational space
+ * inertia or the Delassus matrix of contacts.
+ *
+ * \param model rigid body model the factorization was computed for
+ * \param factorization the factorization of \f$M(q)\f$
+ * \param Tau   matrix of the right hand sides (qdot_size x N)
+ * \param QDDot matrix where the results will be stored (resized to
+ *              qdot_size x N if needed)
+ */
+RBDL_DLLAPI void CalcMInvTimesTau (
+    const Model &model,
+    MassMatrixFactorization &factorization,
+    const Math::MatrixNd &Tau,
+    Math::MatrixNd &QDDot
+    );
+
+/** \brief Computes the inverse operational space inertia \f$\Lambda^{-1}
+ * = J M(q)^{-1} J^T\f$ of a set of body points
+ *
+ * \f$J\f$ is the stacked point Jacobian of all points as computed by
+ * CalcPointJacobian(), such that block \f$(k, l)\f$ of the result is the
+ * linear acceleration of point k (in base coordinates) due to a unit
+ * force on point l (in base coordinates). For contacts with normals
+ * \f$N\f$ the Delassus matrix is \f$N^T \Lambda^{-1} N\f$.
+ *
+ * Neither \f$J\f$ nor \f$M(q)\f$ are formed. Instead the inverse
+ * articulated-body inertias \f$\Omega_i\f$ of all bodies are computed
+ * with a forward recursion over the articulated-body quantities of
+ * ForwardDynamics() and the unit forces of the points are propagated
+ * towards the root. Two points interact only through \f$\Omega\f$ of
+ * their nearest common ancestor, which results in a total cost of
+ * \f$O(n_{\textit{dof}} + m d + m^2)\f$ for m points and a tree of depth
+ * d.
+ *
+ * \param model rigid body model
+ * \param Q     state vector of the internal joints
+ * \param body_ids    the ids of the bodies the points are attached to
+ * \param body_points the points in body coordinates
+ * \param LambdaInv   the inverse operational space inertia (output,
+ *                    resized to 3m x 3m if needed)
+ * \param update_kinematics whether the articulated body inertias should
+ *                    be updated from Q. If false the values of a previous
+ *                    call of ForwardDynamics(), CalcMInvTimesTau() or
+ *                    this function at the same Q are used.
+ */
+RBDL_DLLAPI void CalcOperationalSpaceInertiaInverse (
+    Model &model,
+    const Math::VectorNd &Q,
+    const std::vector<unsigned int> &body_ids,
+    const std::vector<Math::Vector3d> &body_points,
+    Math::MatrixNd &LambdaInv,
+    bool update_kinematics = true
+    );
+
+/** \brief Computes the operational space inertia \f$\Lambda = (J
+ * M(q)^{-1} J^T)^{-1}\f$ of a set of body points
+ *
+ * Inverts the result of CalcOperationalSpaceInertiaInverse() with a
+ * Cholesky decomposition, see there for the parameters.
+ *
+ * \note The points must be kinematically independent, i.e. \f$J\f$ must
+ * have full row rank, otherwise \f$\Lambda\f$ is not defined.
+ */
+RBDL_DLLAPI void CalcOperationalSpaceInertia (
+    Model &model,
+    const Math::VectorNd &Q,
+    const std::vector<unsigned int> &body_ids,
+    const std::vector<Math::Vector3d> &body_points,
+    Math::MatrixNd &Lambda,
+    bool update_kinematics = true
+    );
+#endif
+
+#ifndef RBDL_USE_CASADI_MATH
+/** \brief Computes inverse dynamics and its partial derivatives with
+ * respect to the generalized positions and velocities
+ *
+ * The derivatives are obtained by differentiating the sweeps of the
+ * Recursive Newton-Euler Algorithm. A change of \f$q_k\f$ or
+ * \f$\dot{q}_k\f$ only changes the velocities and accelerations of the
+ * bodies supported by joint k and the forces of these bodies and their
+ * ancestors, which results in a total cost of \f$O(n_{\textit{dof}}^2)\f$.
+ *
+ * \param model rigid body model
+ * \param Q     state vector of the internal joints
+ * \param QDot  velocity vector of the internal joints
+ * \param QDDot accelerations of the internals joints
+ * \param Tau   actuations of the internal joints (output)
+ * \param dTau_dQ    \f$\partial \tau / \partial q\f$ (output, resized to
+ *                   qdot_size x qdot_size)
+ * \param dTau_dQDot \f$\partial \tau / \partial \dot{q}\f$ (output,
+ *                   resized to qdot_size x qdot_size)
+ *
+ * \note Only models with 1-DoF joints with a constant motion subspace are
+ * supported, i.e. revolute and prismatic joints including multi-DoF
+ * joints that are specified by their axes. For all other joints an
+ * Errors::RBDLError is thrown. External forces are not supported.
+ */
+RBDL_DLLAPI void InverseDynamicsDerivatives (
+    Model &model,
+    const Math::VectorNd &Q,
+    const Math::VectorNd &QDot,
+    const Math::VectorNd &QDDot,
+    Math::VectorNd &Tau,
+    Math::MatrixNd &dTau_dQ,
+    Math::MatrixNd &dTau_dQDot
+    );
+
+/** \brief Temporary storage of ForwardDynamicsDerivatives()
+ *
+ * Passing the same workspace to repeated calls avoids all allocations
+ * after the first call.
+ */
+struct RBDL_DLLAPI ForwardDynamicsDerivativesWorkspace {
+  ForwardDynamicsDerivativesWorkspace();
+  ForwardDynamicsDerivativesWorkspace (const Model &model);
+
+  /// \brief Allocates the storage for the degrees of freedom of model
+  void resize (const Model &model);
+
+  /// Factorization of the joint space inertia matrix
+  MassMatrixFactorization factorization;
+  /// Inverse dynamics forces at the computed accelerations
+  Math::VectorNd tau;
+};
+
+/** \brief Computes forward dynamics and its partial derivatives with
+ * respect to the generalized positions, velocities and forces
+ *
+ * Uses \f$\partial \ddot{q} / \partial q = -M^{-1} \partial \tau /
+ * \partial q\f$ and \f$\partial \ddot{q} / \partial \dot{q} = -M^{-1}
+ * \partial \tau / \partial \dot{q}\f$ where the derivatives of \f$\tau\f$
+ * are evaluated by InverseDynamicsDerivatives() at the accelerations
+ * computed by ForwardDynamics(). \f$M^{-1}\f$ is applied to the
+ * \f$3 n_{\textit{dof}}\f$ columns of the identity and of the two
+ * derivatives with a MassMatrixFactorization. Each column costs
+ * \f$O(n_{\textit{dof}} d)\f$, where \f$d\f$ is the depth of the
+ * kinematic tree, such that the total cost is \f$O(n_{\textit{dof}}^2
+ * d)\f$, i.e. up to \f$O(n_{\textit{dof}}^3)\f$ for a serial chain.
+ *
+ * \param model rigid body model
+ * \param Q     state vector of the internal joints
+ * \param QDot  velocity vector of the internal joints
+ * \param Tau   actuations of the internal joints
+ * \param QDDot accelerations of the internal joints (output)
+ * \param dQDDot_dQ    \f$\partial \ddot{q} / \partial q\f$ (output, resized
+ *                     to qdot_size x qdot_size)
+ * \param dQDDot_dQDot \f$\partial \ddot{q} / \partial \dot{q}\f$ (output,
+ *                     resized to qdot_size x qdot_size)
+ * \param dQDDot_dTau  \f$\partial \ddot{q} / \partial \tau = M^{-1}\f$
+ *                     (output, resized to qdot_size x qdot_size)
+ *
+ * \note The same restrictions as for InverseDynamicsDerivatives() apply.
+ */
+RBDL_DLLAPI void ForwardDynamicsDerivatives (
+    Model &model,
+    const Math::VectorNd &Q,
+    const Math::VectorNd &QDot,
+    const Math::VectorNd &Tau,
+    Math::VectorNd &QDDot,
+    Math::MatrixNd &dQDDot_dQ,
+    Math::MatrixNd &dQDDot_dQDot,
+    Math::MatrixNd &dQDDot_dTau
+    );
+#endif
+
+/** \brief Same as InverseDynamics() but stores all state dependent
+ * quantities in data
+ *
+ * All functions of this module have an overload that takes a const Model
+ * and a separate ModelData workspace. As model is not modified, multiple
+ * threads can evaluate the same Model concurrently as long as every
+ * thread uses its own ModelData.
+ *
+ * \param model rigid body model
+ * \param data  workspace created from model, see ModelData
+ * \param Q     state vector of the internal joints
+ * \param QDot  velocity vector of the internal joints
+ * \param QDDot accelerations of the internals joints
+ * \param Tau   actuations of the internal joints (output)
+ * \param f_ext External forces acting on the body in base coordinates (optional, defaults to NULL)
+ */
+RBDL_DLLAPI void InverseDynamics (
+    const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    const Math::VectorNd &QDot,
+    const Math::VectorNd &QDDot,
+    Math::VectorNd &Tau,
+    std::vector<Math::SpatialVector> *f_ext = NULL
+    );
+
+/** \brief Same as NonlinearEffects() but uses the workspace data */
+RBDL_DLLAPI void NonlinearEffects (
+    const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    const Math::VectorNd &QDot,
+    Math::VectorNd &Tau,
+    std::vector<Math::SpatialVector> *f_ext = NULL
+    );
+
+/** \brief Same as CompositeRigidBodyAlgorithm() but uses the workspace data */
+RBDL_DLLAPI void CompositeRigidBodyAlgorithm (
+    const Model& model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    Math::MatrixNd &H,
+    bool update_kinematics = true,
+    bool lower_triangle_only = false
+    );
+
+/** \brief Same as CalcCompositeRigidBodyInertias() but uses the workspace
+ * data */
+RBDL_DLLAPI void CalcCompositeRigidBodyInertias (
+    const Model& model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    bool update_kinematics = true
+    );
+
+/** \brief Same as ForwardDynamics() but uses the workspace data */
+RBDL_DLLAPI void ForwardDynamics (
+    const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    const Math::VectorNd &QDot,
+    const Math::VectorNd &Tau,
+    Math::VectorNd &QDDot,
+    std::vector<Math::SpatialVector> *f_ext = NULL
+    );
+
+#ifndef RBDL_USE_CASADI_MATH
+/** \brief Same as ForwardDynamicsBatch() but uses the workspace data */
+RBDL_DLLAPI void ForwardDynamicsBatch (
+    const Model &model,
+    ModelData &data,
+    const Math::MatrixNd &Q,
+    const Math::MatrixNd &QDot,
+    const Math::MatrixNd &Tau,
+    Math::MatrixNd &QDDot
+    );
+#endif
+
+/** \brief Same as ForwardDynamicsLagrangian() but uses the workspace data */
+RBDL_DLLAPI void ForwardDynamicsLagrangian (
+    const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    const Math::VectorNd &QDot,
+    const Math::VectorNd &Tau,
+    Math::VectorNd &QDDot,
+    Math::LinearSolver linear_solver = Math::LinearSolverColPivHouseholderQR,
+    std::vector<Math::SpatialVector> *f_ext = NULL,
+    Math::MatrixNd *H = NULL,
+    Math::VectorNd *C = NULL
+    );
+
+/** \brief Same as CalcMInvTimesTau() but uses the workspace data
+ *
+ * \note With update_kinematics=false the articulated body inertias that
+ * were computed by a previous call with the same data are reused.
+ */
+RBDL_DLLAPI void CalcMInvTimesTau (
+    const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    const Math::VectorNd &Tau,
+    Math::VectorNd &QDDot,
+    bool update_kinematics=true
+    );
+
+#ifndef RBDL_USE_CASADI_MATH
+/** \brief Same as FactorizeMassMatrix() but uses the workspace data */
+RBDL_DLLAPI void FactorizeMassMatrix (
+    const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    MassMatrixFactorization &factorization
+    );
+
+/** \brief Same as CalcOperationalSpaceInertiaInverse() but uses the
+ * workspace data */
+RBDL_DLLAPI void CalcOperationalSpaceInertiaInverse (
+    const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    const std::vector<unsigned int> &body_ids,
+    const std::vector<Math::Vector3d> &body_points,
+    Math::MatrixNd &LambdaInv,
+    bool update_kinematics = true
+    );
+
+/** \brief Same as CalcOperationalSpaceInertia() but uses the workspace
+ * data */
+RBDL_DLLAPI void CalcOperationalSpaceInertia (
+    const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    const std::vector<unsigned int> &body_ids,
+    const std::vector<Math::Vector3d> &body_points,
+    Math::MatrixNd &Lambda,
+    bool update_kinematics = true
+    );
+
+/** \brief Same as InverseDynamicsDerivatives() but uses the workspace data
+ */
+RBDL_DLLAPI void InverseDynamicsDerivatives (
+    const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    const Math::VectorNd &QDot,
+    const Math::VectorNd &QDDot,
+    Math::VectorNd &Tau,
+    Math::MatrixNd &dTau_dQ,
+    Math::MatrixNd &dTau_dQDot
+    );
+
+/** \brief Same as ForwardDynamicsDerivatives() but uses the workspace data
+ */
+RBDL_DLLAPI void ForwardDynamicsDerivatives (
+    const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    const Math::VectorNd &QDot,
+    const Math::VectorNd &Tau,
+    Math::VectorNd &QDDot,
+    Math::MatrixNd &dQDDot_dQ,
+    Math::MatrixNd &dQDDot_dQDot,
+    Math::MatrixNd &dQDDot_dTau
+    );
+
+/** \brief Same as ForwardDynamicsDerivatives() but uses the workspace data
+ * and the temporary storage of workspace
+ */
+RBDL_DLLAPI void ForwardDynamicsDerivatives (
+    const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    const Math::VectorNd &QDot,
+    const Math::VectorNd &Tau,
+    Math::VectorNd &QDDot,
+    Math::MatrixNd &dQDDot_dQ,
+    Math::MatrixNd &dQDDot_dQDot,
+    Math::MatrixNd &dQDDot_dTau,
+    ForwardDynamicsDerivativesWorkspace &workspace
+    );
+#endif
+
 /** @} */
 
 }
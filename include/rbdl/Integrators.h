@@ -0,0 +1,209 @@
+/*
+ * RBDL - Rigid Body Dynamics Library
+ * Copyright (c) 2011-2018 Martin Felis <martin@fysx.org>
+ *
+ * Licensed under the zlib license. See LICENSE for more details.
+ */
+
+#ifndef RBDL_INTEGRATORS_H
+#define RBDL_INTEGRATORS_H
+
+#include <vector>
+
+#include "rbdl/rbdl_math.h"
+#include "rbdl/Model.h"
+
+#ifndef RBDL_USE_CASADI_MATH
+
+namespace RigidBodyDynamics {
+
+struct ConstraintSet;
+
+/** \page integrators_page Time Integration
+ *
+ * The Integrator advances the state (Q, QDot) of a model by a time step
+ * using the accelerations of ForwardDynamics() or, if a ConstraintSet is
+ * given, of ForwardDynamicsConstraintsDirect(). All temporaries are
+ * allocated when the integrator is created so that a step does not
+ * allocate memory (apart from what the dynamics functions themselves
+ * allocate).
+ *
+ * \code
+ *   Integrator integrator (model, IntegratorRungeKutta4);
+ *
+ *   for (unsigned int i = 0; i < step_count; i++) {
+ *     integrator.Step (model, Q, QDot, Tau, 0.001);
+ *   }
+ * \endcode
+ *
+ * The quaternions of spherical joints are updated on the unit sphere with
+ * the exponential map of the angular velocity (see IntegrateQ()), all
+ * other positions are integrated linearly. Tau is kept constant during a
+ * step.
+ *
+ * With a ConstraintSet the positions and velocities are projected onto the
+ * constraint manifold after each step using CalcAssemblyQ() and
+ * CalcAssemblyQDot() to remove the drift of the constraint errors. This
+ * can be disabled with Integrator::project_constraints. The factorization
+ * of the velocity projection is kept in the ConstraintSet and reused for
+ * the position projection of the next step.
+ *
+ * Many independent systems (e.g. for Monte-Carlo studies) can be stepped
+ * in parallel with BatchExecutor::Integrate().
+ */
+
+/// \brief Integration schemes of the Integrator
+enum IntegratorMethod {
+  /** First order semi-implicit (symplectic) Euler: the velocities are
+   * updated first and the new velocities are used for the positions. One
+   * evaluation of the dynamics per step. */
+  IntegratorSemiImplicitEuler = 0,
+  /** Second order symplectic Stoermer-Verlet (velocity Verlet /
+   * leapfrog) scheme with half steps for the velocities. Two evaluations of
+   * the dynamics per step and good long-term energy behaviour. */
+  IntegratorStoermerVerlet,
+  /** Classical fourth order Runge-Kutta scheme. Four evaluations of the
+   * dynamics per step. */
+  IntegratorRungeKutta4,
+  IntegratorMethodLast
+};
+
+/** \brief Integrates the generalized positions with constant velocities
+ *
+ * Computes \f$ q(t + dt) \f$ for a constant \f$ \dot{q} \f$. The
+ * quaternion of a spherical joint is rotated by the angle \f$ |\omega| dt
+ * \f$ around the angular velocity \f$ \omega \f$ (expressed in the
+ * joint frame, i.e. the entries of QDot of the joint) and stays
+ * normalized.
+ *
+ * \param model rigid body model
+ * \param Q     generalized positions
+ * \param QDot  generalized velocities
+ * \param dt    time step
+ * \param QOut  generalized positions after the step (output, may be the
+ *              same vector as Q)
+ */
+RBDL_DLLAPI void IntegrateQ (
+    const Model &model,
+    const Math::VectorNd &Q,
+    const Math::VectorNd &QDot,
+    double dt,
+    Math::VectorNd &QOut
+    );
+
+/** \brief Explicit time integrator with preallocated workspace
+ *
+ * See \ref integrators_page for more information.
+ */
+class RBDL_DLLAPI Integrator {
+public:
+  Integrator ();
+  explicit Integrator (const Model &model,
+      IntegratorMethod method = IntegratorSemiImplicitEuler);
+
+  /// \brief Allocates the workspace for the given model
+  void resize (const Model &model);
+
+  /** \brief Advances Q and QDot in place by dt using the workspace data
+   *
+   * \param model rigid body model
+   * \param data  workspace created from model, see ModelData
+   * \param Q     generalized positions (input/output)
+   * \param QDot  generalized velocities (input/output)
+   * \param Tau   actuations of the internal joints
+   * \param dt    time step
+   */
+  void Step (
+      const Model &model,
+      ModelData &data,
+      Math::VectorNd &Q,
+      Math::VectorNd &QDot,
+      const Math::VectorNd &Tau,
+      double dt
+      );
+
+  /** \brief Advances Q and QDot in place by dt
+   *
+   * \param model rigid body model
+   * \param Q     generalized positions (input/output)
+   * \param QDot  generalized velocities (input/output)
+   * \param Tau   actuations of the internal joints
+   * \param dt    time step
+   * \param CS    constraints of the system (optional, defaults to NULL).
+   *              If given the accelerations are computed with
+   *              ForwardDynamicsConstraintsDirect() and the state is
+   *              projected onto the constraints after the step.
+   *
+   * \return false if the projection of the positions did not converge
+   * within projection_max_iterations, true otherwise. In the former case
+   * Q keeps the unprojected result of the step and only QDot is projected.
+   */
+  bool Step (
+      Model &model,
+      Math::VectorNd &Q,
+      Math::VectorNd &QDot,
+      const Math::VectorNd &Tau,
+      double dt,
+      ConstraintSet *CS = NULL
+      );
+
+  /// Integration scheme used by Step()
+  IntegratorMethod method;
+
+  /// Whether Step() projects the state onto the constraints of the
+  /// ConstraintSet (defaults to true)
+  bool project_constraints;
+  /// Weights of the degrees of freedom for CalcAssemblyQ() and
+  /// CalcAssemblyQDot() (defaults to ones)
+  Math::VectorNd projection_weights;
+  /// Tolerance of CalcAssemblyQ()
+  double projection_tolerance;
+  /// Maximum number of iterations of CalcAssemblyQ()
+  unsigned int projection_max_iterations;
+  /// Value of ConstraintSet::assembly_warm_start used by Step() for the
+  /// projection (defaults to true), i.e. the factorization of the
+  /// projection of the previous step is reused. The setting of the
+  /// ConstraintSet is restored after the projection.
+  bool projection_warm_start;
+
+private:
+  void Integrate (
+      const Model &model,
+      ModelData &data,
+      Model *constrained_model,
+      ConstraintSet *CS,
+      Math::VectorNd &Q,
+      Math::VectorNd &QDot,
+      const Math::VectorNd &Tau,
+      double dt
+      );
+
+  void CalcQDDot (
+      const Model &model,
+      ModelData &data,
+      Model *constrained_model,
+      ConstraintSet *CS,
+      const Math::VectorNd &Q,
+      const Math::VectorNd &QDot,
+      const Math::VectorNd &Tau,
+      Math::VectorNd &QDDot
+      );
+
+  /// positions of the intermediate stages
+  Math::VectorNd mQStage;
+  /// velocities of the stages
+  std::vector<Math::VectorNd> mQDotStage;
+  /// accelerations of the stages
+  std::vector<Math::VectorNd> mQDDotStage;
+  /// result of the constraint projection
+  Math::VectorNd mQProjected;
+  Math::VectorNd mQDotProjected;
+};
+
+}
+
+/* RBDL_USE_CASADI_MATH */
+#endif
+
+/* RBDL_INTEGRATORS_H */
+#endif
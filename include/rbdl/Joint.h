@@ -18,6 +18,7 @@ namespace RigidBodyDynamics
 {
 
 struct Model;
+struct ModelData;
 
 /** \page joint_description Joint Modeling
  *
@@ -757,9 +758,27 @@ void jcalc (
   const Math::VectorNd &qdot
 );
 
+/** \brief Computes all variables for a joint model and stores them in a
+ * separate workspace
+ *
+ * Same as jcalc() but writes the joint transformations, velocities and
+ * motion subspaces into data instead of model.
+ *
+ * \note For joints of type JointTypeCustom data has to be the workspace
+ * of model itself, otherwise an Errors::RBDLError is thrown.
+ */
+RBDL_DLLAPI
+void jcalc (
+  const Model &model,
+  ModelData &data,
+  unsigned int joint_id,
+  const Math::VectorNd &q,
+  const Math::VectorNd &qdot
+);
+
 RBDL_DLLAPI
 Math::SpatialTransform jcalc_XJ (
-  Model &model,
+  const Model &model,
   unsigned int joint_id,
   const Math::VectorNd &q);
 
@@ -770,6 +789,14 @@ void jcalc_X_lambda_S (
   const Math::VectorNd &q
 );
 
+RBDL_DLLAPI
+void jcalc_X_lambda_S (
+  const Model &model,
+  ModelData &data,
+  unsigned int joint_id,
+  const Math::VectorNd &q
+);
+
 struct RBDL_DLLAPI CustomJoint {
   CustomJoint()
   { }
@@ -15,6 +15,9 @@
 
 namespace RigidBodyDynamics {
 
+struct Model;
+struct ModelData;
+
 /** \page kinematics_page Kinematics
  * All functions related to kinematics are specified in the \ref
  * kinematics_group "Kinematics Module".
@@ -65,6 +68,38 @@ RBDL_DLLAPI void UpdateKinematicsCustom (Model &model,
     const Math::VectorNd *QDDot
     );
 
+/** \brief Updates body positions, velocities and/or accelerations only
+ * where the generalized state has changed.
+ *
+ * Computes the same values as UpdateKinematicsCustom() but remembers the
+ * generalized positions, velocities and accelerations that the values
+ * correspond to. On subsequent calls only the subtrees below joints whose
+ * values have changed are recomputed, e.g. when only the joints of an arm
+ * change the legs are not updated.
+ *
+ * All functions of RBDL that write kinematic quantities into the model
+ * invalidate the cache such that the following call of this function
+ * performs a full update. After modifications of the model itself (e.g.
+ * Model::SetJointFrame() for other workspaces) ModelData::InvalidateKinematicsCache()
+ * has to be called.
+ *
+ * The functions that take an update_kinematics argument can be called with
+ * update_kinematics = false after this function.
+ *
+ * \param model the model
+ * \param Q     the positional variables of the model
+ * \param QDot  the generalized velocities of the joints (requires Q)
+ * \param QDDot the generalized accelerations of the joints (requires QDot)
+ *
+ * \note Which bodies were recomputed is stored in
+ * ModelData::kinematics_cache_dirty.
+ */
+RBDL_DLLAPI void UpdateKinematicsIncremental (Model &model,
+    const Math::VectorNd *Q,
+    const Math::VectorNd *QDot,
+    const Math::VectorNd *QDDot
+    );
+
 /** \brief Returns the base coordinates of a point given in body coordinates.
  *
  * \param model the rigid body model
@@ -202,6 +237,103 @@ RBDL_DLLAPI void CalcBodySpatialJacobian (
     bool update_kinematics = true
     );
 
+#ifndef RBDL_USE_CASADI_MATH
+/** \brief Jacobian that only stores the columns of the supporting joints
+ *
+ * The Jacobian of a point on a body only has non-zero columns for the
+ * degrees of freedom of the joints between the body and the root. This
+ * structure stores these columns as a dense block together with the
+ * indices of the columns in the full Jacobian of size rows() x
+ * \#qdot_size.
+ *
+ * The products with vectors of size \#qdot_size only touch the stored
+ * columns and do not form the full Jacobian.
+ */
+struct RBDL_DLLAPI SparseJacobian {
+  SparseJacobian() :
+    cols (0)
+  {}
+
+  /// \brief Number of rows of the Jacobian
+  unsigned int rows() const {
+    return static_cast<unsigned int>(block.rows());
+  }
+
+  /** \brief Computes J * qdot
+   *
+   * \param qdot vector of size \#qdot_size
+   * \param result vector of size rows() (output)
+   */
+  void apply (const Math::VectorNd &qdot, Math::VectorNd &result) const;
+
+  /** \brief Computes J^T * f
+   *
+   * \param f vector of size rows()
+   * \param result vector of size \#qdot_size (output)
+   * \param accumulate if true J^T * f gets added to result, otherwise the
+   * entries of result that do not belong to a stored column are set to zero
+   */
+  void applyTranspose (const Math::VectorNd &f, Math::VectorNd &result,
+      bool accumulate = false) const;
+
+  /// \brief Writes the full Jacobian of size rows() x \#qdot_size into G
+  void toDense (Math::MatrixNd &G) const;
+
+  /// Number of columns of the full Jacobian, i.e. \#qdot_size
+  unsigned int cols;
+  /// Column indices of the full Jacobian of the columns of block in
+  /// ascending order
+  std::vector<unsigned int> column_index;
+  /// Values of the non-zero columns
+  Math::MatrixNd block;
+};
+
+/** \brief Computes the point jacobian for a point on a body in compact form
+ *
+ * Same as CalcPointJacobian() but only computes and stores the columns
+ * that belong to the joints supporting the body. The storage of G is
+ * reused, therefore repeated evaluations for the same body do not
+ * allocate memory. The result does not need to be initialized.
+ *
+ * \param model   rigid body model
+ * \param Q       state vector of the internal joints
+ * \param body_id the id of the body
+ * \param point_position the position of the point in body-local data
+ * \param G       the 3 x \#qdot_size jacobian in compact form (output)
+ * \param update_kinematics whether UpdateKinematics() should be called or not (default: true)
+ */
+RBDL_DLLAPI void CalcPointJacobianSparse (
+    Model &model,
+    const Math::VectorNd &Q,
+    unsigned int body_id,
+    const Math::Vector3d &point_position,
+    SparseJacobian &G,
+    bool update_kinematics = true
+    );
+
+/** \brief Computes a 6-D Jacobian for a point on a body in compact form
+ *
+ * Same as CalcPointJacobian6D() but only computes and stores the columns
+ * that belong to the joints supporting the body (see
+ * CalcPointJacobianSparse()).
+ *
+ * \param model   rigid body model
+ * \param Q       state vector of the internal joints
+ * \param body_id the id of the body
+ * \param point_position the position of the point in body-local data
+ * \param G       the 6 x \#qdot_size jacobian in compact form (output)
+ * \param update_kinematics whether UpdateKinematics() should be called or not (default: true)
+ */
+RBDL_DLLAPI void CalcPointJacobian6DSparse (
+    Model &model,
+    const Math::VectorNd &Q,
+    unsigned int body_id,
+    const Math::Vector3d &point_position,
+    SparseJacobian &G,
+    bool update_kinematics = true
+    );
+#endif
+
 /** \brief Computes the velocity of a point on a body 
  *
  * \param model   rigid body model
@@ -311,6 +443,186 @@ RBDL_DLLAPI
       bool update_kinematics = true
       );
 
+/** \brief Same as UpdateKinematics() but stores the results in data
+ *
+ * All functions of this module have an overload that takes a const Model
+ * and a separate ModelData workspace in which all state dependent
+ * quantities are stored. This allows evaluating the same Model from
+ * multiple threads, each thread using its own ModelData.
+ *
+ * \param model the model
+ * \param data  workspace created from model, see ModelData
+ * \param Q     the positional variables of the model
+ * \param QDot  the generalized velocities of the joints
+ * \param QDDot the generalized accelerations of the joints
+ */
+RBDL_DLLAPI void UpdateKinematics (const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    const Math::VectorNd &QDot,
+    const Math::VectorNd &QDDot
+    );
+
+/** \brief Same as UpdateKinematicsCustom() but stores the results in data
+ */
+RBDL_DLLAPI void UpdateKinematicsCustom (const Model &model,
+    ModelData &data,
+    const Math::VectorNd *Q,
+    const Math::VectorNd *QDot,
+    const Math::VectorNd *QDDot
+    );
+
+/** \brief Same as UpdateKinematicsIncremental() but uses the cache and
+ * results in data
+ */
+RBDL_DLLAPI void UpdateKinematicsIncremental (const Model &model,
+    ModelData &data,
+    const Math::VectorNd *Q,
+    const Math::VectorNd *QDot,
+    const Math::VectorNd *QDDot
+    );
+
+/** \brief Same as CalcBodyToBaseCoordinates() but uses the workspace data
+ */
+RBDL_DLLAPI Math::Vector3d CalcBodyToBaseCoordinates (
+    const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    unsigned int body_id,
+    const Math::Vector3d &body_point_position,
+    bool update_kinematics = true);
+
+/** \brief Same as CalcBaseToBodyCoordinates() but uses the workspace data
+ */
+RBDL_DLLAPI Math::Vector3d CalcBaseToBodyCoordinates (
+    const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    unsigned int body_id,
+    const Math::Vector3d &base_point_position,
+    bool update_kinematics = true);
+
+/** \brief Same as CalcBodyWorldOrientation() but uses the workspace data
+ */
+RBDL_DLLAPI Math::Matrix3d CalcBodyWorldOrientation (
+    const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    const unsigned int body_id,
+    bool update_kinematics = true);
+
+/** \brief Same as CalcPointJacobian() but uses the workspace data
+ */
+RBDL_DLLAPI void CalcPointJacobian (const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    unsigned int body_id,
+    const Math::Vector3d &point_position,
+    Math::MatrixNd &G,
+    bool update_kinematics = true
+    );
+
+/** \brief Same as CalcPointJacobian6D() but uses the workspace data
+ */
+RBDL_DLLAPI void CalcPointJacobian6D (const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    unsigned int body_id,
+    const Math::Vector3d &point_position,
+    Math::MatrixNd &G,
+    bool update_kinematics = true
+    );
+
+/** \brief Same as CalcBodySpatialJacobian() but uses the workspace data
+ */
+RBDL_DLLAPI void CalcBodySpatialJacobian (
+    const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    unsigned int body_id,
+    Math::MatrixNd &G,
+    bool update_kinematics = true
+    );
+
+#ifndef RBDL_USE_CASADI_MATH
+/** \brief Same as CalcPointJacobianSparse() but uses the workspace data
+ */
+RBDL_DLLAPI void CalcPointJacobianSparse (
+    const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    unsigned int body_id,
+    const Math::Vector3d &point_position,
+    SparseJacobian &G,
+    bool update_kinematics = true
+    );
+
+/** \brief Same as CalcPointJacobian6DSparse() but uses the workspace data
+ */
+RBDL_DLLAPI void CalcPointJacobian6DSparse (
+    const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    unsigned int body_id,
+    const Math::Vector3d &point_position,
+    SparseJacobian &G,
+    bool update_kinematics = true
+    );
+#endif
+
+/** \brief Same as CalcPointVelocity() but uses the workspace data
+ */
+RBDL_DLLAPI Math::Vector3d CalcPointVelocity (
+    const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    const Math::VectorNd &QDot,
+    unsigned int body_id,
+    const Math::Vector3d &point_position,
+    bool update_kinematics = true
+    );
+
+/** \brief Same as CalcPointVelocity6D() but uses the workspace data
+ */
+RBDL_DLLAPI
+  Math::SpatialVector CalcPointVelocity6D (
+      const Model &model,
+      ModelData &data,
+      const Math::VectorNd &Q,
+      const Math::VectorNd &QDot,
+      unsigned int body_id,
+      const Math::Vector3d &point_position,
+      bool update_kinematics = true
+      );
+
+/** \brief Same as CalcPointAcceleration() but uses the workspace data
+ */
+RBDL_DLLAPI
+  Math::Vector3d CalcPointAcceleration (
+      const Model &model,
+      ModelData &data,
+      const Math::VectorNd &Q,
+      const Math::VectorNd &QDot,
+      const Math::VectorNd &QDDot,
+      unsigned int body_id,
+      const Math::Vector3d &point_position,
+      bool update_kinematics = true
+      );
+
+/** \brief Same as CalcPointAcceleration6D() but uses the workspace data
+ */
+RBDL_DLLAPI
+  Math::SpatialVector CalcPointAcceleration6D (
+      const Model &model,
+      ModelData &data,
+      const Math::VectorNd &Q,
+      const Math::VectorNd &QDot,
+      const Math::VectorNd &QDDot,
+      unsigned int body_id,
+      const Math::Vector3d &point_position,
+      bool update_kinematics = true
+      );
+
 #ifndef RBDL_USE_CASADI_MATH
 /** \brief Computes the inverse kinematics iteratively using a damped Levenberg-Marquardt method (also known as Damped Least Squares method)
  *
@@ -356,6 +668,59 @@ RBDL_DLLAPI
       unsigned int max_iter = 55
       );
 
+/** \brief Preallocated storage for the point based InverseKinematics()
+ *
+ * Contains the stacked point Jacobians, the residuals and the factorization
+ * of the damped normal equations. Once sized for a model and a number of
+ * target points repeated calls of InverseKinematics() with the same number
+ * of target points do not allocate any memory.
+ */
+struct RBDL_DLLAPI InverseKinematicsWorkspace {
+  InverseKinematicsWorkspace();
+  InverseKinematicsWorkspace (const Model &model, unsigned int point_count);
+
+  /// \brief Allocates the storage for point_count target points of model
+  void resize (const Model &model, unsigned int point_count);
+
+  /// Stacked Jacobian of all body points
+  Math::MatrixNd J;
+  /// Temporary storage of a single point Jacobian
+  Math::MatrixNd G;
+  /// Residuals of all body points
+  Math::VectorNd e;
+  /// Damped normal matrix \f$J J^T + \lambda^2 I\f$
+  Math::MatrixNd JJT_lambda2_I;
+  /// Solution of the damped normal equations
+  Math::VectorNd z;
+  /// Change of the generalized coordinates of the current step
+  Math::VectorNd delta_theta;
+  /// Cholesky factorization of JJT_lambda2_I
+  Eigen::LLT<Math::MatrixNd> JJT_lambda2_I_llt;
+};
+
+/** \brief Same as the point based InverseKinematics() but uses the
+ * workspace data and solver storage
+ *
+ * The damped normal equations are solved with a Cholesky decomposition
+ * whose storage is kept in workspace. The workspace is resized if it does
+ * not match the model or the number of target points, which is the only
+ * case in which this function allocates memory.
+ */
+RBDL_DLLAPI
+  bool InverseKinematics (
+      const Model &model,
+      ModelData &data,
+      const Math::VectorNd &Qinit,
+      const std::vector<unsigned int>& body_id,
+      const std::vector<Math::Vector3d>& body_point,
+      const std::vector<Math::Vector3d>& target_pos,
+      Math::VectorNd &Qres,
+      InverseKinematicsWorkspace &workspace,
+      double step_tol = 1.0e-12,
+      double lambda = 0.01,
+      unsigned int max_iter = 55
+      );
+
 RBDL_DLLAPI Math::Vector3d CalcAngularVelocityfromMatrix (
     const Math::Matrix3d &RotMat);
 
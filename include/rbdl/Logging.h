@@ -8,7 +8,11 @@
 #ifndef RBDL_LOGGING_H
 #define RBDL_LOGGING_H
 
+#include <atomic>
+#include <cstdint>
+#include <ostream>
 #include <sstream>
+#include <vector>
 #include <rbdl/rbdl_config.h>
 
 class LoggingGuard;
@@ -70,5 +74,183 @@ class RBDL_DLLAPI LoggingGuard {
     std::ostringstream log_backup;
 };
 
+/** \def RBDL_TRACE_LEVEL
+ *
+ * Highest level of trace events that is compiled into the library (see
+ * \ref RigidBodyDynamics::TraceLevel). Trace points above this level are
+ * removed by the preprocessor. Set via the CMake cache variable of the
+ * same name.
+ */
+#ifndef RBDL_TRACE_LEVEL
+#define RBDL_TRACE_LEVEL 1
+#endif
+
+#if RBDL_TRACE_LEVEL >= 1
+#define RBDL_TRACE_ALGORITHM(name) \
+  RigidBodyDynamics::TraceScope _rbdl_trace_scope (name)
+#else
+#define RBDL_TRACE_ALGORITHM(name)
+#endif
+
+#if RBDL_TRACE_LEVEL >= 2
+#define RBDL_TRACE_BODY(name, body_id) \
+  do { \
+    if (RigidBodyDynamics::TraceIsEnabled ( \
+          RigidBodyDynamics::TraceLevelBodies)) { \
+      RigidBodyDynamics::TraceRecord (RigidBodyDynamics::TraceEventBody, \
+          name, body_id, 0); \
+    } \
+  } while (0)
+#else
+#define RBDL_TRACE_BODY(name, body_id)
+#endif
+
+namespace RigidBodyDynamics {
+
+/** \page trace_page Tracing
+ *
+ * In contrast to the logging via LogOutput, which is a single global
+ * stream that is only available in debug builds, the trace facility is
+ * meant to stay compiled into release builds and to be used from multiple
+ * threads at the same time.
+ *
+ * Every thread writes its events into its own fixed size ring buffer
+ * without taking a lock. Once a buffer is full the oldest events get
+ * overwritten. The events of all threads can be retrieved at any time
+ * with GetTraceEvents() or written to a stream with DumpTrace().
+ *
+ * Which events are recorded is controlled at two levels:
+ *   - at compile time \ref RBDL_TRACE_LEVEL defines which trace points
+ *     exist at all,
+ *   - at runtime SetTraceLevel() enables the trace points up to the given
+ *     level. The default is TraceLevelOff, in which case every trace point
+ *     only costs a single relaxed atomic load.
+ *
+ * \code
+ *   SetTraceLevel (TraceLevelAlgorithms);
+ *   ForwardDynamics (model, Q, QDot, Tau, QDDot);
+ *   SetTraceLevel (TraceLevelOff);
+ *
+ *   DumpTrace (std::cout);
+ * \endcode
+ */
+
+/// \brief Levels of detail of the trace events
+enum TraceLevel {
+  /// No events are recorded
+  TraceLevelOff = 0,
+  /// Entry and exit of the algorithms including their duration
+  TraceLevelAlgorithms = 1,
+  /// Additionally the bodies that are visited by the algorithms
+  TraceLevelBodies = 2
+};
+
+enum TraceEventType {
+  TraceEventEnter = 0,
+  TraceEventExit,
+  TraceEventBody
+};
+
+/// \brief Body id of trace events that do not refer to a body
+const unsigned int TraceNoBody = static_cast<unsigned int>(-1);
+
+/// \brief Number of events that are kept per thread
+const unsigned int TraceBufferSize = 4096;
+
+/// \brief A single entry of the trace
+struct RBDL_DLLAPI TraceEvent {
+  TraceEvent() :
+    time_ns (0),
+    duration_ns (0),
+    name (NULL),
+    body_id (TraceNoBody),
+    thread_index (0),
+    type (TraceEventEnter)
+  {}
+
+  /// Time stamp of the event (steady clock) in nanoseconds
+  uint64_t time_ns;
+  /// Duration of the algorithm call, only set for TraceEventExit
+  uint64_t duration_ns;
+  /// Name of the algorithm (a string literal)
+  const char *name;
+  /// Id of the body or TraceNoBody
+  unsigned int body_id;
+  /// Index of the thread that recorded the event
+  unsigned int thread_index;
+  TraceEventType type;
+};
+
+/// \brief Runtime trace level, use SetTraceLevel() to modify it
+extern RBDL_DLLAPI std::atomic<int> TraceLevelRuntime;
+
+/// \brief Enables all trace points up to the given level at runtime
+RBDL_DLLAPI void SetTraceLevel (TraceLevel level);
+
+RBDL_DLLAPI TraceLevel GetTraceLevel ();
+
+inline bool TraceIsEnabled (TraceLevel level) {
+  return TraceLevelRuntime.load (std::memory_order_relaxed) >= level;
+}
+
+/// \brief Returns the current time stamp of the trace clock in nanoseconds
+RBDL_DLLAPI uint64_t TraceTime ();
+
+/** \brief Adds an event to the ring buffer of the calling thread
+ *
+ * \param type event type
+ * \param name name of the algorithm, must be a string literal (or
+ * otherwise outlive the trace) as only the pointer is stored
+ * \param body_id id of the body or TraceNoBody
+ * \param duration_ns duration for TraceEventExit events
+ */
+RBDL_DLLAPI void TraceRecord (TraceEventType type, const char *name,
+    unsigned int body_id, uint64_t duration_ns);
+
+/** \brief Returns the events of all threads ordered by their time stamps
+ *
+ * Can be called while other threads are recording. Events that get
+ * overwritten during the call are skipped.
+ */
+RBDL_DLLAPI std::vector<TraceEvent> GetTraceEvents ();
+
+/// \brief Writes the events of GetTraceEvents() as one line per event
+RBDL_DLLAPI void DumpTrace (std::ostream &stream);
+
+/// \brief Discards the recorded events of all threads
+RBDL_DLLAPI void ClearTrace ();
+
+/** \brief Records the entry and exit of an algorithm for the lifetime of
+ * the object
+ *
+ * Use the RBDL_TRACE_ALGORITHM() macro so that the trace point can be
+ * removed at compile time.
+ */
+class RBDL_DLLAPI TraceScope {
+  public:
+    explicit TraceScope (const char *name) : mName (NULL), mStart (0) {
+      if (TraceIsEnabled (TraceLevelAlgorithms)) {
+        mName = name;
+        TraceRecord (TraceEventEnter, mName, TraceNoBody, 0);
+        mStart = TraceTime();
+      }
+    }
+    ~TraceScope () {
+      if (mName) {
+        TraceRecord (TraceEventExit, mName, TraceNoBody,
+            TraceTime() - mStart);
+      }
+    }
+
+  private:
+    TraceScope (const TraceScope &);
+    TraceScope& operator= (const TraceScope &);
+
+    const char *mName;
+    uint64_t mStart;
+};
+
+}
+
 /* RBDL_LOGGING_H */
 #endif
@@ -103,6 +103,200 @@ namespace RigidBodyDynamics
  * RigidBodyDynamics::Addons::URDFReadFromFile \endlink.
  */
 
+struct Model;
+
+#ifndef RBDL_USE_CASADI_MATH
+/// \brief Number of samples that ForwardDynamicsBatch() evaluates together
+static const int BatchLaneCount = 8;
+
+/** \brief A scalar of the batched Articulated %Body Algorithm with one
+ * entry per sample (structure of arrays), see ForwardDynamicsBatch()
+ */
+typedef Eigen::Array<Math::Scalar, 1, BatchLaneCount> BatchLanes;
+
+struct BatchSpatialVector {
+  BatchLanes x[6];
+};
+
+struct BatchSpatialMatrix {
+  BatchLanes m[6][6];
+};
+
+/// \brief Sample independent quantities of a body for the batched ABA
+struct BatchJoint {
+  /// X_lambda(q).E = E0 + cos(q) Ec + sin(q) Es
+  Math::Matrix3d E0, Ec, Es;
+  /// X_lambda(q).r = r0 + q rq
+  Math::Vector3d r0, rq;
+  Math::SpatialVector S;
+  Math::SpatialMatrix I;
+  bool revolute;
+};
+
+/// \brief Sample dependent quantities of a body for the batched ABA
+struct BatchBody {
+  BatchLanes E[3][3];
+  BatchLanes r[3];
+  BatchSpatialVector v, c, pA, U, a;
+  BatchSpatialMatrix IA;
+  BatchLanes d, u;
+};
+
+typedef std::vector<BatchJoint, Eigen::aligned_allocator<BatchJoint> >
+  BatchJointVector;
+typedef std::vector<BatchBody, Eigen::aligned_allocator<BatchBody> >
+  BatchBodyVector;
+#endif
+
+/** \brief Workspace of all state dependent quantities of a Model
+ *
+ * This structure contains all variables that the algorithms of RBDL write
+ * to while evaluating a given state, e.g. spatial velocities and
+ * accelerations, joint transformations, articulated body inertias and the
+ * temporary variables of the Articulated %Body Algorithm.
+ *
+ * Model derives from ModelData such that every Model carries its own
+ * workspace and all functions that take a single Model keep working as
+ * before. In addition the functions of \ref kinematics_group and \ref
+ * dynamics_group have overloads that take a const Model together with a
+ * separate ModelData. This allows to evaluate a single read-only Model
+ * concurrently from multiple threads where each thread uses its own
+ * ModelData:
+ *
+ * \code
+ * ModelData data (model);
+ * ForwardDynamics (model, data, Q, QDot, Tau, QDDot);
+ * \endcode
+ *
+ * A ModelData object is only valid for the Model it was created from and
+ * has to be recreated whenever bodies are added to the Model.
+ *
+ * \note Models that contain a CustomJoint can only be used with their
+ * own workspace, i.e. with the functions that take a single Model.
+ */
+struct RBDL_DLLAPI ModelData {
+  ModelData() :
+    kinematics_cache_level (0)
+  {}
+
+  /** \brief Creates a workspace with the dimensions and the current state
+   * of the given model.
+   */
+  explicit ModelData (const Model &model);
+
+  // State information
+  /// \brief The spatial velocity of the bodies
+  std::vector<Math::SpatialVector> v;
+  /// \brief The spatial acceleration of the bodies
+  std::vector<Math::SpatialVector> a;
+
+  ////////////////////////////////////
+  // Joints
+
+  /// \brief The joint axis for joint i
+  std::vector<Math::SpatialVector> S;
+
+  // Joint state variables
+  std::vector<Math::SpatialVector> v_J;
+  std::vector<Math::SpatialVector> c_J;
+
+  ////////////////////////////////////
+  // Special variables for joints with 3 degrees of freedom
+  /// \brief Motion subspace for joints with 3 degrees of freedom
+  std::vector<Math::Matrix63> multdof3_S;
+  std::vector<Math::Matrix63> multdof3_U;
+  std::vector<Math::Matrix3d> multdof3_Dinv;
+  std::vector<Math::Vector3d> multdof3_u;
+
+  ////////////////////////////////////
+  // Dynamics variables
+
+  /// \brief The velocity dependent spatial acceleration
+  std::vector<Math::SpatialVector> c;
+  /// \brief The spatial inertia of the bodies
+  std::vector<Math::SpatialMatrix> IA;
+  /// \brief The articulated body inertias IA in compact symmetric storage
+  /// as they are accumulated by the backward pass of the articulated body
+  /// algorithm
+  std::vector<Math::SpatialArticulatedBodyInertia> IA_compact;
+  /// \brief The spatial bias force
+  std::vector<Math::SpatialVector> pA;
+  /// \brief Temporary variable U_i (RBDA p. 130)
+  std::vector<Math::SpatialVector> U;
+  /// \brief Temporary variable D_i (RBDA p. 130)
+  Math::VectorNd d;
+  /// \brief Temporary variable u (RBDA p. 130)
+  Math::VectorNd u;
+  /// \brief Internal forces on the body (used only InverseDynamics())
+  std::vector<Math::SpatialVector> f;
+  /// \brief The composite rigid body inertia of body i (used only in
+  ///  CompositeRigidBodyAlgorithm())
+  std::vector<Math::SpatialRigidBodyInertia> Ic;
+  std::vector<Math::SpatialVector> hc;
+  std::vector<Math::SpatialVector> hdotc;
+  /// \brief The inverse articulated-body inertia of body i, i.e. the
+  /// apparent inverse inertia of body i in the whole tree (used only in
+  /// CalcOperationalSpaceInertiaInverse())
+  std::vector<Math::SpatialMatrix> Omega;
+  /// \brief The articulated force propagator \f$ {}^{\lambda(i)}X_i^*
+  /// (1 - U_i D_i^{-1} S_i^T) \f$ that transmits a force on body i to its
+  /// parent (used only in CalcOperationalSpaceInertiaInverse())
+  std::vector<Math::SpatialMatrix> Chi;
+
+#ifndef RBDL_USE_CASADI_MATH
+  /// \brief The joint constants of the batched articulated body algorithm
+  /// (used only in ForwardDynamicsBatch(), sized by its first call)
+  BatchJointVector batch_joints;
+  /// \brief The quantities of the batched articulated body algorithm for
+  /// BatchLaneCount samples (used only in ForwardDynamicsBatch(), sized by
+  /// its first call)
+  BatchBodyVector batch_bodies;
+#endif
+
+  ////////////////////////////////////
+  // Bodies
+
+  /** \brief Transformation from the parent body to the current body
+   * \f[
+   *	X_{\lambda(i)} = {}^{i} X_{\lambda(i)}
+   * \f]
+   */
+  std::vector<Math::SpatialTransform> X_lambda;
+  /// \brief Transformation from the base to bodies reference frame
+  std::vector<Math::SpatialTransform> X_base;
+
+  ////////////////////////////////////
+  // Kinematics cache (used only in UpdateKinematicsIncremental())
+
+  /** \brief Number of kinematic levels that are consistent with the cached
+   * state: 0 none, 1 positions (X_lambda, X_base), 2 positions and
+   * velocities (v, c), 3 positions, velocities and accelerations (a)
+   */
+  unsigned int kinematics_cache_level;
+  /// \brief Generalized positions of the cached kinematics
+  Math::VectorNd kinematics_cache_q;
+  /// \brief Generalized velocities of the cached kinematics
+  Math::VectorNd kinematics_cache_qdot;
+  /// \brief Generalized accelerations of the cached kinematics
+  Math::VectorNd kinematics_cache_qddot;
+  /** \brief Bodies that were recomputed by the last call of
+   * UpdateKinematicsIncremental(), bit 0: positions, bit 1: velocities,
+   * bit 2: accelerations
+   */
+  std::vector<unsigned char> kinematics_cache_dirty;
+
+  /** \brief Marks the cached kinematics as outdated
+   *
+   * All functions of RBDL that write kinematic quantities into the
+   * workspace call this. It only has to be called manually after the
+   * model was modified, e.g. by Model::SetJointFrame() for a workspace
+   * other than the model itself.
+   */
+  void InvalidateKinematicsCache() {
+    kinematics_cache_level = 0;
+  }
+};
+
 /** \brief Contains all information about the rigid body model
  *
  * This class contains all information required to perform the forward
@@ -118,9 +312,11 @@ namespace RigidBodyDynamics
  * and tau however start at 0 such that the first entry (e.g. q[0]) always
  * specifies the value for the first moving body.
  *
+ * The state dependent variables are inherited from ModelData.
+ *
  * \note To query the number of degrees of freedom use Model::dof_count.
  */
-struct RBDL_DLLAPI Model {
+struct RBDL_DLLAPI Model : public ModelData {
   Model();
 
   // Structural information
@@ -163,24 +359,12 @@ struct RBDL_DLLAPI Model {
   /// \brief the cartesian vector of the gravity
   Math::Vector3d gravity;
 
-  // State information
-  /// \brief The spatial velocity of the bodies
-  std::vector<Math::SpatialVector> v;
-  /// \brief The spatial acceleration of the bodies
-  std::vector<Math::SpatialVector> a;
-
   ////////////////////////////////////
   // Joints
 
   /// \brief All joints
 
   std::vector<Joint> mJoints;
-  /// \brief The joint axis for joint i
-  std::vector<Math::SpatialVector> S;
-
-  // Joint state variables
-  std::vector<Math::SpatialVector> v_J;
-  std::vector<Math::SpatialVector> c_J;
 
   std::vector<unsigned int> mJointUpdateOrder;
 
@@ -193,11 +377,6 @@ struct RBDL_DLLAPI Model {
 
   ////////////////////////////////////
   // Special variables for joints with 3 degrees of freedom
-  /// \brief Motion subspace for joints with 3 degrees of freedom
-  std::vector<Math::Matrix63> multdof3_S;
-  std::vector<Math::Matrix63> multdof3_U;
-  std::vector<Math::Matrix3d> multdof3_Dinv;
-  std::vector<Math::Vector3d> multdof3_u;
   std::vector<unsigned int> multdof3_w_index;
 
   std::vector<CustomJoint*> mCustomJoints;
@@ -205,39 +384,13 @@ struct RBDL_DLLAPI Model {
   ////////////////////////////////////
   // Dynamics variables
 
-  /// \brief The velocity dependent spatial acceleration
-  std::vector<Math::SpatialVector> c;
-  /// \brief The spatial inertia of the bodies
-  std::vector<Math::SpatialMatrix> IA;
-  /// \brief The spatial bias force
-  std::vector<Math::SpatialVector> pA;
-  /// \brief Temporary variable U_i (RBDA p. 130)
-  std::vector<Math::SpatialVector> U;
-  /// \brief Temporary variable D_i (RBDA p. 130)
-  Math::VectorNd d;
-  /// \brief Temporary variable u (RBDA p. 130)
-  Math::VectorNd u;
-  /// \brief Internal forces on the body (used only InverseDynamics())
-  std::vector<Math::SpatialVector> f;
   /// \brief The spatial inertia of body i (used only in
   ///  CompositeRigidBodyAlgorithm())
   std::vector<Math::SpatialRigidBodyInertia> I;
-  std::vector<Math::SpatialRigidBodyInertia> Ic;
-  std::vector<Math::SpatialVector> hc;
-  std::vector<Math::SpatialVector> hdotc;
 
   ////////////////////////////////////
   // Bodies
 
-  /** \brief Transformation from the parent body to the current body
-   * \f[
-   *	X_{\lambda(i)} = {}^{i} X_{\lambda(i)}
-   * \f]
-   */
-  std::vector<Math::SpatialTransform> X_lambda;
-  /// \brief Transformation from the base to bodies reference frame
-  std::vector<Math::SpatialTransform> X_base;
-
   /// \brief All bodies that are attached to a body via a fixed joint.
   std::vector<FixedBody> mFixedBodies;
   /** \brief Value that is used to discriminate between fixed and movable
@@ -372,7 +525,7 @@ struct RBDL_DLLAPI Model {
 
   /** \brief Checks whether the body is rigidly attached to another body.
   */
-  bool IsFixedBodyId (unsigned int body_id)
+  bool IsFixedBodyId (unsigned int body_id) const
   {
     if (body_id >= fixed_body_discriminator
         && body_id < std::numeric_limits<unsigned int>::max()
@@ -382,7 +535,7 @@ struct RBDL_DLLAPI Model {
     return false;
   }
 
-  bool IsBodyId (unsigned int id)
+  bool IsBodyId (unsigned int id) const
   {
     if (id > 0 && id < mBodies.size()) {
       return true;
@@ -403,7 +556,7 @@ struct RBDL_DLLAPI Model {
    * freedom. This function returns the id of the actual
    * non-virtual parent body.
    */
-  unsigned int GetParentBodyId (unsigned int id)
+  unsigned int GetParentBodyId (unsigned int id) const
   {
     if (id >= fixed_body_discriminator) {
       return mFixedBodies[id - fixed_body_discriminator].mMovableParent;
@@ -421,7 +574,7 @@ struct RBDL_DLLAPI Model {
   /** Returns the joint frame transformtion, i.e. the second argument to
     Model::AddBody().
     */
-  Math::SpatialTransform GetJointFrame (unsigned int id)
+  Math::SpatialTransform GetJointFrame (unsigned int id) const
   {
     if (id >= fixed_body_discriminator) {
       return mFixedBodies[id - fixed_body_discriminator].mParentTransform;
@@ -461,6 +614,8 @@ struct RBDL_DLLAPI Model {
     } else if (id > 0) {
       X_T[id] = transform;
     }
+
+    InvalidateKinematicsCache();
   }
 
   /** Gets the quaternion for body i (only valid if body i is connected by
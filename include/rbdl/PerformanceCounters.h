@@ -0,0 +1,173 @@
+/*
+ * RBDL - Rigid Body Dynamics Library
+ * Copyright (c) 2011-2018 Martin Felis <martin@fysx.org>
+ *
+ * Licensed under the zlib license. See LICENSE for more details.
+ */
+
+#ifndef RBDL_PERFORMANCE_COUNTERS_H
+#define RBDL_PERFORMANCE_COUNTERS_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <rbdl/rbdl_config.h>
+#include <rbdl/Logging.h>
+
+/** \def RBDL_ENABLE_PERF_COUNTERS
+ *
+ * Enables the performance counters of the algorithms. If it is not defined
+ * the macros declare a NullPerformanceCounter that the compiler removes
+ * and the counters stay empty. The macro arguments are compiled in both
+ * cases.
+ */
+#ifdef RBDL_ENABLE_PERF_COUNTERS
+#define RBDL_PERF_COUNTER(name) \
+  static RigidBodyDynamics::PerformanceCounter &_rbdl_perf_counter = \
+    RigidBodyDynamics::GetPerformanceCounter (name); \
+  RigidBodyDynamics::PerformanceCounterScope _rbdl_perf_counter_scope ( \
+      _rbdl_perf_counter)
+#else
+#define RBDL_PERF_COUNTER(name) \
+  RigidBodyDynamics::NullPerformanceCounter _rbdl_perf_counter (name)
+#endif
+#define RBDL_PERF_COUNT_ITERATIONS(count) \
+  _rbdl_perf_counter.AddIterations (count)
+
+namespace RigidBodyDynamics {
+
+/** \page performance_counters_page Performance Counters
+ *
+ * If RBDL was built with the CMake option RBDL_ENABLE_PERF_COUNTERS the
+ * main algorithms (ForwardDynamics(), InverseDynamics(),
+ * CompositeRigidBodyAlgorithm(), CalcPointJacobian(), the
+ * ForwardDynamicsConstraints functions, CalcAssemblyQ() and
+ * InverseKinematics()) count their calls, the cumulative and the maximum
+ * wall time of a call and, for the iterative ones, the number of
+ * iterations. The counters are shared by all threads.
+ *
+ * \code
+ *   ResetPerformanceCounters ();
+ *   for (...) {
+ *     ForwardDynamics (model, Q, QDot, Tau, QDDot);
+ *   }
+ *   WritePerformanceCountersJSON (std::cout);
+ * \endcode
+ *
+ * Without the option the query functions are still available but no
+ * algorithm registers a counter so that there is no runtime overhead.
+ */
+
+/// \brief Counter of a single algorithm, see \ref performance_counters_page
+class RBDL_DLLAPI PerformanceCounter {
+  public:
+    explicit PerformanceCounter (const std::string &name);
+
+    void AddCall (uint64_t duration_ns) {
+      call_count.fetch_add (1, std::memory_order_relaxed);
+      total_time_ns.fetch_add (duration_ns, std::memory_order_relaxed);
+
+      uint64_t max = max_time_ns.load (std::memory_order_relaxed);
+      while (duration_ns > max
+          && !max_time_ns.compare_exchange_weak (max, duration_ns,
+            std::memory_order_relaxed)) {
+      }
+    }
+
+    void AddIterations (uint64_t count) {
+      iteration_count.fetch_add (count, std::memory_order_relaxed);
+    }
+
+    void reset ();
+
+    const std::string name;
+    std::atomic<uint64_t> call_count;
+    std::atomic<uint64_t> total_time_ns;
+    std::atomic<uint64_t> max_time_ns;
+    std::atomic<uint64_t> iteration_count;
+
+  private:
+    PerformanceCounter (const PerformanceCounter &);
+    PerformanceCounter& operator= (const PerformanceCounter &);
+};
+
+/** \brief Stand-in for a PerformanceCounter that does nothing
+ *
+ * Used by RBDL_PERF_COUNTER() if RBDL_ENABLE_PERF_COUNTERS is not defined.
+ */
+class NullPerformanceCounter {
+  public:
+    explicit NullPerformanceCounter (const char *name) {
+      (void) name;
+    }
+
+    void AddIterations (uint64_t count) {
+      (void) count;
+    }
+};
+
+/// \brief Copy of the values of a PerformanceCounter
+struct RBDL_DLLAPI PerformanceCounterStats {
+  PerformanceCounterStats() :
+    call_count (0),
+    total_time_ns (0),
+    max_time_ns (0),
+    iteration_count (0)
+  {}
+
+  std::string name;
+  uint64_t call_count;
+  uint64_t total_time_ns;
+  uint64_t max_time_ns;
+  uint64_t iteration_count;
+};
+
+/** \brief Returns the counter with the given name, it is created if it does
+ * not exist yet.
+ *
+ * The returned reference stays valid for the lifetime of the program.
+ */
+RBDL_DLLAPI PerformanceCounter& GetPerformanceCounter (const char *name);
+
+/// \brief Returns the current values of all counters sorted by name
+RBDL_DLLAPI std::vector<PerformanceCounterStats> GetPerformanceCounterStats ();
+
+/// \brief Sets all counters to zero
+RBDL_DLLAPI void ResetPerformanceCounters ();
+
+/** \brief Writes all counters as a JSON object that maps the name of the
+ * algorithm to its counts and times (in nanoseconds)
+ */
+RBDL_DLLAPI void WritePerformanceCountersJSON (std::ostream &stream);
+
+/** \brief Adds the wall time of its lifetime as a call to a
+ * PerformanceCounter
+ *
+ * Use the RBDL_PERF_COUNTER() macro so that the counter can be removed at
+ * compile time.
+ */
+class RBDL_DLLAPI PerformanceCounterScope {
+  public:
+    explicit PerformanceCounterScope (PerformanceCounter &counter) :
+      mCounter (counter),
+      mStart (TraceTime())
+    {}
+    ~PerformanceCounterScope () {
+      mCounter.AddCall (TraceTime() - mStart);
+    }
+
+  private:
+    PerformanceCounterScope (const PerformanceCounterScope &);
+    PerformanceCounterScope& operator= (const PerformanceCounterScope &);
+
+    PerformanceCounter &mCounter;
+    uint64_t mStart;
+};
+
+}
+
+/* RBDL_PERFORMANCE_COUNTERS_H */
+#endif
@@ -48,7 +48,7 @@ struct RBDL_DLLAPI SpatialRigidBodyInertia {
     Izx (Izx), Izy(Izy), Izz(Izz)
   { }
 
-  SpatialVector operator* (const SpatialVector &mv) {
+  SpatialVector operator* (const SpatialVector &mv) const {
     Vector3d mv_lower (mv[3], mv[4], mv[5]);
 
     Vector3d res_upper = Vector3d (
@@ -64,7 +64,7 @@ struct RBDL_DLLAPI SpatialRigidBodyInertia {
         );
   }
 
-  SpatialRigidBodyInertia operator+ (const SpatialRigidBodyInertia &rbi) {
+  SpatialRigidBodyInertia operator+ (const SpatialRigidBodyInertia &rbi) const {
     return SpatialRigidBodyInertia (
         m + rbi.m,
         h + rbi.h,
@@ -135,6 +135,150 @@ struct RBDL_DLLAPI SpatialRigidBodyInertia {
   Scalar Ixx, Iyx, Iyy, Izx, Izy, Izz;
 };
 
+/** \brief Compact representation of a symmetric spatial inertia such as the
+ * articulated body inertia.
+ *
+ * Stores the two symmetric 3x3 blocks I and M by their lower triangle and
+ * the 3x3 coupling block H of
+ *
+ *   IA = [ I    H ]
+ *        [ H^T  M ]
+ *
+ * which are 21 instead of 36 scalars. In contrast to
+ * SpatialRigidBodyInertia the lower right block is not required to be a
+ * multiple of the identity.
+ */
+struct RBDL_DLLAPI SpatialArticulatedBodyInertia {
+  SpatialArticulatedBodyInertia() :
+    Ixx (0.), Iyx(0.), Iyy(0.), Izx(0.), Izy(0.), Izz(0.),
+    H (Matrix3d::Zero()),
+    Mxx (0.), Myx(0.), Myy(0.), Mzx(0.), Mzy(0.), Mzz(0.)
+  {}
+  explicit SpatialArticulatedBodyInertia (const SpatialMatrix &IA) {
+    createFromMatrix (IA);
+  }
+  SpatialArticulatedBodyInertia (const SpatialRigidBodyInertia &rbi) :
+    Ixx (rbi.Ixx), Iyx(rbi.Iyx), Iyy(rbi.Iyy),
+    Izx (rbi.Izx), Izy(rbi.Izy), Izz(rbi.Izz),
+    H (VectorCrossMatrix (rbi.h)),
+    Mxx (rbi.m), Myx(0.), Myy(rbi.m), Mzx(0.), Mzy(0.), Mzz(rbi.m)
+  {}
+
+  SpatialVector operator* (const SpatialVector &mv) const {
+    Vector3d mv_upper (mv[0], mv[1], mv[2]);
+    Vector3d mv_lower (mv[3], mv[4], mv[5]);
+
+    Vector3d res_upper = Vector3d (
+        Ixx * mv[0] + Iyx * mv[1] + Izx * mv[2],
+        Iyx * mv[0] + Iyy * mv[1] + Izy * mv[2],
+        Izx * mv[0] + Izy * mv[1] + Izz * mv[2]
+        ) + H * mv_lower;
+    Vector3d res_lower = Vector3d (
+        Mxx * mv[3] + Myx * mv[4] + Mzx * mv[5],
+        Myx * mv[3] + Myy * mv[4] + Mzy * mv[5],
+        Mzx * mv[3] + Mzy * mv[4] + Mzz * mv[5]
+        ) + H.transpose() * mv_upper;
+
+    return SpatialVector (
+        res_upper[0], res_upper[1], res_upper[2],
+        res_lower[0], res_lower[1], res_lower[2]
+        );
+  }
+
+  SpatialArticulatedBodyInertia operator+ (
+      const SpatialArticulatedBodyInertia &IA) const {
+    SpatialArticulatedBodyInertia result (*this);
+    result.Ixx += IA.Ixx;
+    result.Iyx += IA.Iyx; result.Iyy += IA.Iyy;
+    result.Izx += IA.Izx; result.Izy += IA.Izy; result.Izz += IA.Izz;
+    result.H += IA.H;
+    result.Mxx += IA.Mxx;
+    result.Myx += IA.Myx; result.Myy += IA.Myy;
+    result.Mzx += IA.Mzx; result.Mzy += IA.Mzy; result.Mzz += IA.Mzz;
+    return result;
+  }
+
+  SpatialArticulatedBodyInertia& operator+= (
+      const SpatialArticulatedBodyInertia &IA) {
+    Ixx += IA.Ixx;
+    Iyx += IA.Iyx; Iyy += IA.Iyy;
+    Izx += IA.Izx; Izy += IA.Izy; Izz += IA.Izz;
+    H += IA.H;
+    Mxx += IA.Mxx;
+    Myx += IA.Myx; Myy += IA.Myy;
+    Mzx += IA.Mzx; Mzy += IA.Mzy; Mzz += IA.Mzz;
+    return *this;
+  }
+
+  SpatialArticulatedBodyInertia operator- (
+      const SpatialArticulatedBodyInertia &IA) const {
+    SpatialArticulatedBodyInertia result (*this);
+    result.Ixx -= IA.Ixx;
+    result.Iyx -= IA.Iyx; result.Iyy -= IA.Iyy;
+    result.Izx -= IA.Izx; result.Izy -= IA.Izy; result.Izz -= IA.Izz;
+    result.H -= IA.H;
+    result.Mxx -= IA.Mxx;
+    result.Myx -= IA.Myx; result.Myy -= IA.Myy;
+    result.Mzx -= IA.Mzx; result.Mzy -= IA.Mzy; result.Mzz -= IA.Mzz;
+    return result;
+  }
+
+  /** Subtracts a * b^T where b has to be a multiple of a such that the
+   * result stays symmetric, e.g. U (U / d)^T in the articulated body
+   * algorithm. */
+  void subtractOuterProduct (const SpatialVector &a, const SpatialVector &b) {
+    Ixx -= a[0] * b[0];
+    Iyx -= a[1] * b[0]; Iyy -= a[1] * b[1];
+    Izx -= a[2] * b[0]; Izy -= a[2] * b[1]; Izz -= a[2] * b[2];
+    for (unsigned int j = 0; j < 3; j++) {
+      for (unsigned int k = 0; k < 3; k++) {
+        H(j,k) -= a[j] * b[k + 3];
+      }
+    }
+    Mxx -= a[3] * b[3];
+    Myx -= a[4] * b[3]; Myy -= a[4] * b[4];
+    Mzx -= a[5] * b[3]; Mzy -= a[5] * b[4]; Mzz -= a[5] * b[5];
+  }
+
+  /** Reads the lower triangles of the diagonal blocks and the upper right
+   * block of IA. IA is assumed to be symmetric. */
+  void createFromMatrix (const SpatialMatrix &IA) {
+    Ixx = IA(0,0);
+    Iyx = IA(1,0); Iyy = IA(1,1);
+    Izx = IA(2,0); Izy = IA(2,1); Izz = IA(2,2);
+    H = IA.block<3,3>(0,3);
+    Mxx = IA(3,3);
+    Myx = IA(4,3); Myy = IA(4,4);
+    Mzx = IA(5,3); Mzy = IA(5,4); Mzz = IA(5,5);
+  }
+
+  SpatialMatrix toMatrix() const {
+    SpatialMatrix result;
+    setSpatialMatrix (result);
+    return result;
+  }
+
+  void setSpatialMatrix (SpatialMatrix &mat) const {
+    mat(0,0) = Ixx; mat(0,1) = Iyx; mat(0,2) = Izx;
+    mat(1,0) = Iyx; mat(1,1) = Iyy; mat(1,2) = Izy;
+    mat(2,0) = Izx; mat(2,1) = Izy; mat(2,2) = Izz;
+
+    mat.block<3,3>(0,3) = H;
+    mat.block<3,3>(3,0) = H.transpose();
+
+    mat(3,3) = Mxx; mat(3,4) = Myx; mat(3,5) = Mzx;
+    mat(4,3) = Myx; mat(4,4) = Myy; mat(4,5) = Mzy;
+    mat(5,3) = Mzx; mat(5,4) = Mzy; mat(5,5) = Mzz;
+  }
+
+  /// Upper left block (angular part) stored by its lower triangle
+  Scalar Ixx, Iyx, Iyy, Izx, Izy, Izz;
+  /// Upper right coupling block, the lower left block is H^T
+  Matrix3d H;
+  /// Lower right block (linear part) stored by its lower triangle
+  Scalar Mxx, Myx, Myy, Mzx, Mzy, Mzz;
+};
+
 /** \brief Compact representation of spatial transformations.
  *
  * Instead of using a verbose 6x6 matrix, this structure only stores a 3x3
@@ -156,7 +300,7 @@ struct RBDL_DLLAPI SpatialTransform {
    *
    * \returns (E * w, - E * rxw + E * v)
    */
-  SpatialVector apply (const SpatialVector &v_sp) {
+  SpatialVector apply (const SpatialVector &v_sp) const {
     Vector3d v_rxw (
         v_sp[3] - r[1]*v_sp[2] + r[2]*v_sp[1],
         v_sp[4] - r[2]*v_sp[0] + r[0]*v_sp[2],
@@ -176,7 +320,7 @@ struct RBDL_DLLAPI SpatialTransform {
    *
    * \returns (E^T * n + rx * E^T * f, E^T * f)
    */
-  SpatialVector applyTranspose (const SpatialVector &f_sp) {
+  SpatialVector applyTranspose (const SpatialVector &f_sp) const {
     Vector3d E_T_f (
         E(0,0) * f_sp[3] + E(1,0) * f_sp[4] + E(2,0) * f_sp[5],
         E(0,1) * f_sp[3] + E(1,1) * f_sp[4] + E(2,1) * f_sp[5],
@@ -195,7 +339,7 @@ struct RBDL_DLLAPI SpatialTransform {
 
   /** Same as X^* I X^{-1}
   */
-  SpatialRigidBodyInertia apply (const SpatialRigidBodyInertia &rbi) {
+  SpatialRigidBodyInertia apply (const SpatialRigidBodyInertia &rbi) const {
     return SpatialRigidBodyInertia (
         rbi.m,
         E * (rbi.h - rbi.m * r),
@@ -215,7 +359,7 @@ struct RBDL_DLLAPI SpatialTransform {
 
   /** Same as X^T I X
   */
-  SpatialRigidBodyInertia applyTranspose (const SpatialRigidBodyInertia &rbi) {
+  SpatialRigidBodyInertia applyTranspose (const SpatialRigidBodyInertia &rbi) const {
     Vector3d E_T_mr = E.transpose() * rbi.h + rbi.m * r;
     return SpatialRigidBodyInertia (
         rbi.m,
@@ -230,7 +374,78 @@ struct RBDL_DLLAPI SpatialTransform {
         - VectorCrossMatrix (E_T_mr) * VectorCrossMatrix (r));
   }
 
-  SpatialVector applyAdjoint (const SpatialVector &f_sp) {
+  /** Same as X^T IA X for a symmetric spatial inertia IA = [I H; H^T M].
+   *
+   * Exploits the symmetry of the diagonal blocks and the structure of X
+   * which needs less than half of the operations of the 6x6 products.
+   *
+   * \returns (E^T I E + rx H_E^T - H' rx, H', E^T M E) with
+   * H_E = E^T H E and H' = H_E + rx E^T M E
+   */
+  SpatialArticulatedBodyInertia applyTranspose (
+      const SpatialArticulatedBodyInertia &IA) const {
+    Matrix3d Ia_E = Matrix3d (
+        IA.Ixx, IA.Iyx, IA.Izx,
+        IA.Iyx, IA.Iyy, IA.Izy,
+        IA.Izx, IA.Izy, IA.Izz
+        ) * E;
+    Matrix3d Ma_E = Matrix3d (
+        IA.Mxx, IA.Myx, IA.Mzx,
+        IA.Myx, IA.Myy, IA.Mzy,
+        IA.Mzx, IA.Mzy, IA.Mzz
+        ) * E;
+    Matrix3d H_E = E.transpose() * (IA.H * E);
+
+    SpatialArticulatedBodyInertia result;
+
+    // lower triangle of E^T M E
+    result.Mxx = E(0,0) * Ma_E(0,0) + E(1,0) * Ma_E(1,0) + E(2,0) * Ma_E(2,0);
+    result.Myx = E(0,1) * Ma_E(0,0) + E(1,1) * Ma_E(1,0) + E(2,1) * Ma_E(2,0);
+    result.Myy = E(0,1) * Ma_E(0,1) + E(1,1) * Ma_E(1,1) + E(2,1) * Ma_E(2,1);
+    result.Mzx = E(0,2) * Ma_E(0,0) + E(1,2) * Ma_E(1,0) + E(2,2) * Ma_E(2,0);
+    result.Mzy = E(0,2) * Ma_E(0,1) + E(1,2) * Ma_E(1,1) + E(2,2) * Ma_E(2,1);
+    result.Mzz = E(0,2) * Ma_E(0,2) + E(1,2) * Ma_E(1,2) + E(2,2) * Ma_E(2,2);
+
+    // H' = H_E + rx E^T M E, evaluated column wise as cross products
+    Vector3d rx_m0 = r.cross (Vector3d (result.Mxx, result.Myx, result.Mzx));
+    Vector3d rx_m1 = r.cross (Vector3d (result.Myx, result.Myy, result.Mzy));
+    Vector3d rx_m2 = r.cross (Vector3d (result.Mzx, result.Mzy, result.Mzz));
+    result.H = Matrix3d (
+        H_E(0,0) + rx_m0[0], H_E(0,1) + rx_m1[0], H_E(0,2) + rx_m2[0],
+        H_E(1,0) + rx_m0[1], H_E(1,1) + rx_m1[1], H_E(1,2) + rx_m2[1],
+        H_E(2,0) + rx_m0[2], H_E(2,1) + rx_m1[2], H_E(2,2) + rx_m2[2]
+        );
+
+    // (rx H_E^T)(i,j) = (r x h_E_j)_i and (H' rx)(i,j) = -(r x h'_i)_j
+    // where h_E_j and h'_i denote rows of H_E and H'
+    Vector3d rx_he0 = r.cross (Vector3d (H_E(0,0), H_E(0,1), H_E(0,2)));
+    Vector3d rx_he1 = r.cross (Vector3d (H_E(1,0), H_E(1,1), H_E(1,2)));
+    Vector3d rx_he2 = r.cross (Vector3d (H_E(2,0), H_E(2,1), H_E(2,2)));
+    Vector3d rx_h0 = r.cross (Vector3d (
+          result.H(0,0), result.H(0,1), result.H(0,2)));
+    Vector3d rx_h1 = r.cross (Vector3d (
+          result.H(1,0), result.H(1,1), result.H(1,2)));
+    Vector3d rx_h2 = r.cross (Vector3d (
+          result.H(2,0), result.H(2,1), result.H(2,2)));
+
+    // lower triangle of E^T I E + rx H_E^T - H' rx
+    result.Ixx = E(0,0) * Ia_E(0,0) + E(1,0) * Ia_E(1,0) + E(2,0) * Ia_E(2,0)
+      + rx_he0[0] + rx_h0[0];
+    result.Iyx = E(0,1) * Ia_E(0,0) + E(1,1) * Ia_E(1,0) + E(2,1) * Ia_E(2,0)
+      + rx_he0[1] + rx_h1[0];
+    result.Iyy = E(0,1) * Ia_E(0,1) + E(1,1) * Ia_E(1,1) + E(2,1) * Ia_E(2,1)
+      + rx_he1[1] + rx_h1[1];
+    result.Izx = E(0,2) * Ia_E(0,0) + E(1,2) * Ia_E(1,0) + E(2,2) * Ia_E(2,0)
+      + rx_he0[2] + rx_h2[0];
+    result.Izy = E(0,2) * Ia_E(0,1) + E(1,2) * Ia_E(1,1) + E(2,2) * Ia_E(2,1)
+      + rx_he1[2] + rx_h2[1];
+    result.Izz = E(0,2) * Ia_E(0,2) + E(1,2) * Ia_E(1,2) + E(2,2) * Ia_E(2,2)
+      + rx_he2[2] + rx_h2[2];
+
+    return result;
+  }
+
+  SpatialVector applyAdjoint (const SpatialVector &f_sp) const {
     Vector3d En_rxf = E * (Vector3d (f_sp[0], f_sp[1], f_sp[2]) - r.cross(Vector3d (f_sp[3], f_sp[4], f_sp[5])));
     //		Vector3d En_rxf = E * (Vector3d (f_sp[0], f_sp[1], f_sp[2]) - r.cross(Eigen::Map<Vector3d> (&(f_sp[3]))));
 
@@ -0,0 +1,392 @@
+/*
+ * RBDL - Rigid Body Dynamics Library
+ * Copyright (c) 2011-2018 Martin Felis <martin@fysx.org>
+ *
+ * Licensed under the zlib license. See LICENSE for more details.
+ */
+
+#ifndef RBDL_UNROLLED_DYNAMICS_H
+#define RBDL_UNROLLED_DYNAMICS_H
+
+#include <cmath>
+#include <utility>
+
+#include "rbdl/rbdl_math.h"
+#include "rbdl/Model.h"
+#include "rbdl/Joint.h"
+
+#ifndef RBDL_USE_CASADI_MATH
+
+namespace RigidBodyDynamics {
+
+/** \page unrolled_dynamics_page Unrolled Forward Dynamics
+ *
+ * The regular ForwardDynamics() has to check the type and the number of
+ * degrees of freedom of every joint in every pass of the Articulated Body
+ * Algorithm. For models whose joints are known at compile time the
+ * function ForwardDynamicsUnrolled() takes the joint types of the model as
+ * template arguments. All sweeps over the bodies are then unrolled by the
+ * compiler and contain no branches on the joint type. For the joints
+ * JointTypeRevoluteX, JointTypeRevoluteY and JointTypeRevoluteZ the
+ * motion subspace is a unit vector and the ABA terms reduce to selecting
+ * rows and columns of the articulated body inertia.
+ *
+ * The template arguments are the joint types of the bodies 1 ...
+ * mBodies.size() - 1 in the order in which they were added to the model.
+ * Fixed joints are not part of this list as they are merged into their
+ * parent bodies. Multi-DoF joints that are specified by their axes (e.g.
+ * Joint(SpatialVector, SpatialVector)) are emulated using one body per
+ * axis. Each of these bodies has to be listed with its single axis joint
+ * type, i.e. JointTypeRevoluteX, JointTypeRevoluteY, JointTypeRevoluteZ for
+ * rotations about a coordinate axis, JointTypeRevolute for other rotations
+ * and JointTypePrismatic for translations. Custom joints are not
+ * supported.
+ *
+ * \code
+ *   // a planar double pendulum
+ *   typedef UnrolledJoints<JointTypeRevoluteZ, JointTypeRevoluteZ>
+ *     PendulumJoints;
+ *
+ *   // check once that the joints of the model match
+ *   assert (PendulumJoints::Matches (model));
+ *
+ *   ForwardDynamicsUnrolled<PendulumJoints> (model, data, Q, QDot, Tau,
+ *       QDDot);
+ * \endcode
+ */
+
+/** \brief Compile-time list of the joint types of a model
+ *
+ * See \ref unrolled_dynamics_page for more information.
+ */
+template <JointType... Types>
+struct UnrolledJoints {
+  /// Number of movable bodies (excluding the root body)
+  static constexpr unsigned int BodyCount = sizeof...(Types);
+
+  /** \brief Returns whether the joints of model are of the given types
+   *
+   * This has to hold true for every model that is passed to
+   * ForwardDynamicsUnrolled().
+   */
+  static bool Matches (const Model &model) {
+    const JointType types[] = { Types... };
+
+    if (model.mBodies.size() != BodyCount + 1) {
+      return false;
+    }
+
+    for (unsigned int i = 0; i < BodyCount; i++) {
+      if (model.mJoints[i + 1].mJointType != types[i]) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+};
+
+/** \brief Compile-time properties of a joint type used by the unrolled
+ * algorithms.
+ */
+template <JointType Type>
+struct UnrolledJointTraits {
+  static constexpr bool IsAxisRevolute =
+    Type == JointTypeRevoluteX
+    || Type == JointTypeRevoluteY
+    || Type == JointTypeRevoluteZ;
+
+  static constexpr unsigned int DoFCount =
+    (Type == JointTypeSpherical
+     || Type == JointTypeEulerZYX
+     || Type == JointTypeEulerXYZ
+     || Type == JointTypeEulerYXZ
+     || Type == JointTypeEulerZXY
+     || Type == JointTypeTranslationXYZ) ? 3 : 1;
+
+  /// Rotation axis of the revolute joints about a coordinate axis
+  static constexpr unsigned int Axis =
+    Type == JointTypeRevoluteX ? 0 : (Type == JointTypeRevoluteY ? 1 : 2);
+
+  static_assert (Type == JointTypeRevolute
+      || Type == JointTypePrismatic
+      || Type == JointTypeHelical
+      || IsAxisRevolute
+      || DoFCount == 3,
+      "Joint type is not supported by the unrolled algorithms!");
+};
+
+/** \cond false */
+namespace UnrolledDetail {
+
+/** \brief Joint transformation and velocity of body i
+ *
+ * For revolute joints around a coordinate axis the rotation is applied
+ * directly to the rows of the joint frame transformation X_T.
+ */
+template <JointType Type, unsigned int i>
+inline void JointCalc (
+    const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    const Math::VectorNd &QDot) {
+  typedef UnrolledJointTraits<Type> Traits;
+
+  if constexpr (Traits::IsAxisRevolute) {
+    // rows of E that get mixed by the rotation about Axis
+    constexpr unsigned int a = (Traits::Axis + 1) % 3;
+    constexpr unsigned int b = (Traits::Axis + 2) % 3;
+
+    const unsigned int q_index = model.mJoints[i].q_index;
+    const Math::Scalar s = sin (Q[q_index]);
+    const Math::Scalar c = cos (Q[q_index]);
+    const Math::Matrix3d &E_T = model.X_T[i].E;
+
+    data.X_lambda[i].E.row(Traits::Axis) = E_T.row(Traits::Axis);
+    data.X_lambda[i].E.row(a) = c * E_T.row(a) + s * E_T.row(b);
+    data.X_lambda[i].E.row(b) = -s * E_T.row(a) + c * E_T.row(b);
+    data.X_lambda[i].r = model.X_T[i].r;
+
+    data.v_J[i][Traits::Axis] = QDot[q_index];
+  } else {
+    jcalc (model, data, i, Q, QDot);
+  }
+}
+
+/** \brief Adds X^T * Ia * X to IA for a symmetric Ia
+ *
+ * With X = diag(E, E) * [1 0; -rx 1] and the rotated blocks A, B, C of Ia
+ * the product is [A - B rx + rx U^T, U; U^T, C] with U = B + rx C. The
+ * products with rx are evaluated as cross products.
+ */
+inline void AddTransformedInertia (
+    const Math::SpatialTransform &X,
+    const Math::SpatialMatrix &Ia,
+    Math::SpatialMatrix &IA) {
+  const Math::Matrix3d E_T = X.E.transpose();
+  const Math::Vector3d &r = X.r;
+  Math::Matrix3d temp;
+
+  temp.noalias() = Ia.block<3,3>(0,0).lazyProduct (X.E);
+  Math::Matrix3d A;
+  A.noalias() = E_T.lazyProduct (temp);
+
+  temp.noalias() = Ia.block<3,3>(0,3).lazyProduct (X.E);
+  Math::Matrix3d B;
+  B.noalias() = E_T.lazyProduct (temp);
+
+  temp.noalias() = Ia.block<3,3>(3,3).lazyProduct (X.E);
+  Math::Matrix3d C;
+  C.noalias() = E_T.lazyProduct (temp);
+
+  Math::Matrix3d U = B;
+  for (unsigned int j = 0; j < 3; j++) {
+    U.col(j) += r.cross (Math::Vector3d (C.col(j)));
+  }
+
+  // A - B rx + rx U^T
+  for (unsigned int j = 0; j < 3; j++) {
+    A.row(j) += r.cross (Math::Vector3d (B.row(j).transpose())).transpose();
+    A.col(j) += r.cross (Math::Vector3d (U.row(j).transpose()));
+  }
+
+  IA.block<3,3>(0,0) += A;
+  IA.block<3,3>(0,3) += U;
+  IA.block<3,3>(3,0) += U.transpose();
+  IA.block<3,3>(3,3) += C;
+}
+
+template <JointType Type, unsigned int i>
+inline void ForwardPass (
+    const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    const Math::VectorNd &QDot) {
+  const unsigned int lambda = model.lambda[i];
+
+  JointCalc<Type, i> (model, data, Q, QDot);
+
+  if (lambda != 0) {
+    data.X_base[i] = data.X_lambda[i] * data.X_base[lambda];
+  } else {
+    data.X_base[i] = data.X_lambda[i];
+  }
+
+  data.v[i] = data.X_lambda[i].apply (data.v[lambda]) + data.v_J[i];
+  data.c[i] = data.c_J[i] + Math::crossm (data.v[i], data.v_J[i]);
+  model.I[i].setSpatialMatrix (data.IA[i]);
+  data.pA[i] = Math::crossf (data.v[i], model.I[i] * data.v[i]);
+}
+
+template <JointType Type, unsigned int i>
+inline void BackwardPass (
+    const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Tau) {
+  typedef UnrolledJointTraits<Type> Traits;
+
+  const unsigned int q_index = model.mJoints[i].q_index;
+  const unsigned int lambda = model.lambda[i];
+
+  Math::SpatialMatrix Ia;
+  Math::SpatialVector pa;
+
+  if constexpr (Traits::IsAxisRevolute) {
+    data.U[i] = data.IA[i].col(Traits::Axis);
+    data.d[i] = data.U[i][Traits::Axis];
+    data.u[i] = Tau[q_index] - data.pA[i][Traits::Axis];
+
+    if (lambda == 0) {
+      return;
+    }
+
+    Ia = data.IA[i] - data.U[i] * (data.U[i] / data.d[i]).transpose();
+    pa = data.pA[i] + Ia * data.c[i] + data.U[i] * data.u[i] / data.d[i];
+  } else if constexpr (Traits::DoFCount == 1) {
+    data.U[i] = data.IA[i] * data.S[i];
+    data.d[i] = data.S[i].dot (data.U[i]);
+    data.u[i] = Tau[q_index] - data.S[i].dot (data.pA[i]);
+
+    if (lambda == 0) {
+      return;
+    }
+
+    Ia = data.IA[i] - data.U[i] * (data.U[i] / data.d[i]).transpose();
+    pa = data.pA[i] + Ia * data.c[i] + data.U[i] * data.u[i] / data.d[i];
+  } else {
+    data.multdof3_U[i] = data.IA[i] * data.multdof3_S[i];
+    data.multdof3_Dinv[i] = (data.multdof3_S[i].transpose()
+        * data.multdof3_U[i]).inverse().eval();
+    Math::Vector3d tau_temp (Tau.block(q_index, 0, 3, 1));
+    data.multdof3_u[i] = tau_temp
+      - data.multdof3_S[i].transpose() * data.pA[i];
+
+    if (lambda == 0) {
+      return;
+    }
+
+    Ia = data.IA[i]
+      - data.multdof3_U[i] * data.multdof3_Dinv[i]
+      * data.multdof3_U[i].transpose();
+    pa = data.pA[i] + Ia * data.c[i]
+      + data.multdof3_U[i] * data.multdof3_Dinv[i] * data.multdof3_u[i];
+  }
+
+  AddTransformedInertia (data.X_lambda[i], Ia, data.IA[lambda]);
+  data.pA[lambda].noalias() += data.X_lambda[i].applyTranspose (pa);
+}
+
+template <JointType Type, unsigned int i>
+inline void AccelerationPass (
+    const Model &model,
+    ModelData &data,
+    Math::VectorNd &QDDot) {
+  typedef UnrolledJointTraits<Type> Traits;
+
+  const unsigned int q_index = model.mJoints[i].q_index;
+  const unsigned int lambda = model.lambda[i];
+
+  data.a[i] = data.X_lambda[i].apply (data.a[lambda]) + data.c[i];
+
+  if constexpr (Traits::IsAxisRevolute) {
+    QDDot[q_index] = (data.u[i] - data.U[i].dot (data.a[i])) / data.d[i];
+    data.a[i][Traits::Axis] += QDDot[q_index];
+  } else if constexpr (Traits::DoFCount == 1) {
+    QDDot[q_index] = (data.u[i] - data.U[i].dot (data.a[i])) / data.d[i];
+    data.a[i] = data.a[i] + data.S[i] * QDDot[q_index];
+  } else {
+    Math::Vector3d qdd_temp = data.multdof3_Dinv[i]
+      * (data.multdof3_u[i] - data.multdof3_U[i].transpose() * data.a[i]);
+    QDDot.block(q_index, 0, 3, 1) = qdd_temp;
+    data.a[i] = data.a[i] + data.multdof3_S[i] * qdd_temp;
+  }
+}
+
+template <JointType... Types, std::size_t... I>
+inline void ForwardDynamicsUnrolled (
+    const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    const Math::VectorNd &QDot,
+    const Math::VectorNd &Tau,
+    Math::VectorNd &QDDot,
+    std::index_sequence<I...>) {
+  constexpr JointType types[] = { Types... };
+  constexpr unsigned int n = sizeof...(Types);
+
+  data.v[0].setZero();
+  (ForwardPass<types[I], I + 1> (model, data, Q, QDot), ...);
+
+  (BackwardPass<types[n - 1 - I], n - I> (model, data, Tau), ...);
+
+  data.a[0] = Math::SpatialVector (0., 0., 0.,
+      -model.gravity[0], -model.gravity[1], -model.gravity[2]);
+  (AccelerationPass<types[I], I + 1> (model, data, QDDot), ...);
+}
+
+template <JointType... Types>
+inline void ForwardDynamicsUnrolled (
+    const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    const Math::VectorNd &QDot,
+    const Math::VectorNd &Tau,
+    Math::VectorNd &QDDot,
+    UnrolledJoints<Types...>) {
+  ForwardDynamicsUnrolled<Types...> (model, data, Q, QDot, Tau, QDDot,
+      std::make_index_sequence<sizeof...(Types)>());
+}
+
+}
+/** \endcond */
+
+/** \brief Computes forward dynamics with an Articulated Body Algorithm
+ * that is unrolled for the joint types Joints
+ *
+ * Computes the same as ForwardDynamics() without external forces. See
+ * \ref unrolled_dynamics_page for more information.
+ *
+ * \param model rigid body model, Joints::Matches (model) must be true
+ * \param data  workspace created from model, see ModelData
+ * \param Q     state vector of the internal joints
+ * \param QDot  velocity vector of the internal joints
+ * \param Tau   actuations of the internal joints
+ * \param QDDot accelerations of the internal joints (output)
+ */
+template <typename Joints>
+inline void ForwardDynamicsUnrolled (
+    const Model &model,
+    ModelData &data,
+    const Math::VectorNd &Q,
+    const Math::VectorNd &QDot,
+    const Math::VectorNd &Tau,
+    Math::VectorNd &QDDot) {
+  assert (Joints::Matches (model));
+
+  // the unrolled joint calculations do not all go through jcalc()
+  data.InvalidateKinematicsCache();
+
+  UnrolledDetail::ForwardDynamicsUnrolled (model, data, Q, QDot, Tau, QDDot,
+      Joints());
+}
+
+/** \brief Same as ForwardDynamicsUnrolled() but uses the model's own
+ * workspace
+ */
+template <typename Joints>
+inline void ForwardDynamicsUnrolled (
+    Model &model,
+    const Math::VectorNd &Q,
+    const Math::VectorNd &QDot,
+    const Math::VectorNd &Tau,
+    Math::VectorNd &QDDot) {
+  ForwardDynamicsUnrolled<Joints> (model, model, Q, QDot, Tau, QDDot);
+}
+
+}
+
+/* RBDL_USE_CASADI_MATH */
+#endif
+
+/* RBDL_UNROLLED_DYNAMICS_H */
+#endif
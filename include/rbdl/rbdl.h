@@ -12,10 +12,14 @@
 #include "rbdl/rbdl_mathutils.h"
 
 #include "rbdl/Logging.h"
+#include "rbdl/PerformanceCounters.h"
 
 #include "rbdl/Body.h"
 #include "rbdl/Model.h"
 #include "rbdl/Dynamics.h"
+#include "rbdl/Integrators.h"
+#include "rbdl/BatchExecutor.h"
+#include "rbdl/UnrolledDynamics.h"
 #include "rbdl/Joint.h"
 #include "rbdl/Kinematics.h"
 #include "rbdl/Constraints.h"
@@ -11,6 +11,8 @@
 #define RBDL_API_VERSION (@RBDL_VERSION_MAJOR@ << 16) + (@RBDL_VERSION_MINOR@ << 8) + @RBDL_VERSION_PATCH@
 
 #cmakedefine RBDL_ENABLE_LOGGING
+#define RBDL_TRACE_LEVEL @RBDL_TRACE_LEVEL@
+#cmakedefine RBDL_ENABLE_PERF_COUNTERS
 #cmakedefine RBDL_BUILD_COMMIT "@RBDL_BUILD_COMMIT@"
 #cmakedefine RBDL_BUILD_TYPE "@RBDL_BUILD_TYPE@"
 #cmakedefine RBDL_BUILD_BRANCH "@RBDL_BUILD_BRANCH@"
@@ -23,6 +25,7 @@
 #cmakedefine RBDL_BUILD_STATIC
 #cmakedefine RBDL_USE_ROS_URDF_LIBRARY
 #cmakedefine RBDL_USE_CASADI_MATH
+#cmakedefine RBDL_USE_SINGLE_PRECISION
 
 /* compatibility defines */
 #ifdef _WIN32
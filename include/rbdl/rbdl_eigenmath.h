@@ -14,20 +14,20 @@
  */
 #define RBDL_TEMPLATE_DLLAPI
 
-EIGEN_DEFINE_STL_VECTOR_SPECIALIZATION(Eigen::Vector2d)
-EIGEN_DEFINE_STL_VECTOR_SPECIALIZATION(Eigen::Vector3d)
-EIGEN_DEFINE_STL_VECTOR_SPECIALIZATION(Eigen::Matrix3d)
-EIGEN_DEFINE_STL_VECTOR_SPECIALIZATION(Eigen::Vector4d)
-EIGEN_DEFINE_STL_VECTOR_SPECIALIZATION(Eigen::MatrixXd)
+EIGEN_DEFINE_STL_VECTOR_SPECIALIZATION(Eigen::Matrix<Vector1_t, 2, 1>)
+EIGEN_DEFINE_STL_VECTOR_SPECIALIZATION(Eigen::Matrix<Vector1_t, 3, 1>)
+EIGEN_DEFINE_STL_VECTOR_SPECIALIZATION(Eigen::Matrix<Vector1_t, 3, 3>)
+EIGEN_DEFINE_STL_VECTOR_SPECIALIZATION(Eigen::Matrix<Vector1_t, 4, 1>)
+EIGEN_DEFINE_STL_VECTOR_SPECIALIZATION(Eigen::Matrix<Vector1_t, Eigen::Dynamic, Eigen::Dynamic>)
 
-class RBDL_TEMPLATE_DLLAPI Vector2_t : public Eigen::Vector2d
+class RBDL_TEMPLATE_DLLAPI Vector2_t : public Eigen::Matrix<Vector1_t, 2, 1>
 {
   public:
-    typedef Eigen::Vector2d Base;
+    typedef Eigen::Matrix<Vector1_t, 2, 1> Base;
 
     template<typename OtherDerived>
       Vector2_t(const Eigen::MatrixBase<OtherDerived>& other)
-      : Eigen::Vector2d(other)
+      : Eigen::Matrix<Vector1_t, 2, 1>(other)
       {}
 
     template<typename OtherDerived>
@@ -41,7 +41,7 @@ class RBDL_TEMPLATE_DLLAPI Vector2_t : public Eigen::Vector2d
     {}
 
     EIGEN_STRONG_INLINE Vector2_t(
-        const double& v0, const double& v1
+        const Scalar& v0, const Scalar& v1
         )
     {
       Base::_check_template_params();
@@ -49,7 +49,7 @@ class RBDL_TEMPLATE_DLLAPI Vector2_t : public Eigen::Vector2d
       (*this) << v0, v1;
     }
 
-    void set(const double& v0, const double& v1)
+    void set(const Scalar& v0, const Scalar& v1)
     {
       Base::_check_template_params();
 
@@ -57,14 +57,14 @@ class RBDL_TEMPLATE_DLLAPI Vector2_t : public Eigen::Vector2d
     }
 };
 
-class RBDL_TEMPLATE_DLLAPI Vector3_t : public Eigen::Vector3d
+class RBDL_TEMPLATE_DLLAPI Vector3_t : public Eigen::Matrix<Vector1_t, 3, 1>
 {
   public:
-    typedef Eigen::Vector3d Base;
+    typedef Eigen::Matrix<Vector1_t, 3, 1> Base;
 
     template<typename OtherDerived>
       Vector3_t(const Eigen::MatrixBase<OtherDerived>& other)
-      : Eigen::Vector3d(other)
+      : Eigen::Matrix<Vector1_t, 3, 1>(other)
       {}
 
     template<typename OtherDerived>
@@ -78,7 +78,7 @@ class RBDL_TEMPLATE_DLLAPI Vector3_t : public Eigen::Vector3d
     {}
 
     EIGEN_STRONG_INLINE Vector3_t(
-        const double& v0, const double& v1, const double& v2
+        const Scalar& v0, const Scalar& v1, const Scalar& v2
         )
     {
       Base::_check_template_params();
@@ -86,7 +86,7 @@ class RBDL_TEMPLATE_DLLAPI Vector3_t : public Eigen::Vector3d
       (*this) << v0, v1, v2;
     }
 
-    void set(const double& v0, const double& v1, const double& v2)
+    void set(const Scalar& v0, const Scalar& v1, const Scalar& v2)
     {
       Base::_check_template_params();
 
@@ -94,14 +94,14 @@ class RBDL_TEMPLATE_DLLAPI Vector3_t : public Eigen::Vector3d
     }
 };
 
-class RBDL_TEMPLATE_DLLAPI Matrix3_t : public Eigen::Matrix3d
+class RBDL_TEMPLATE_DLLAPI Matrix3_t : public Eigen::Matrix<Vector1_t, 3, 3>
 {
   public:
-    typedef Eigen::Matrix3d Base;
+    typedef Eigen::Matrix<Vector1_t, 3, 3> Base;
 
     template<typename OtherDerived>
       Matrix3_t(const Eigen::MatrixBase<OtherDerived>& other)
-      : Eigen::Matrix3d(other)
+      : Eigen::Matrix<Vector1_t, 3, 3>(other)
       {}
 
     template<typename OtherDerived>
@@ -115,9 +115,9 @@ class RBDL_TEMPLATE_DLLAPI Matrix3_t : public Eigen::Matrix3d
     {}
 
     EIGEN_STRONG_INLINE Matrix3_t(
-        const double& m00, const double& m01, const double& m02,
-        const double& m10, const double& m11, const double& m12,
-        const double& m20, const double& m21, const double& m22
+        const Scalar& m00, const Scalar& m01, const Scalar& m02,
+        const Scalar& m10, const Scalar& m11, const Scalar& m12,
+        const Scalar& m20, const Scalar& m21, const Scalar& m22
         )
     {
       Base::_check_template_params();
@@ -130,14 +130,14 @@ class RBDL_TEMPLATE_DLLAPI Matrix3_t : public Eigen::Matrix3d
     }
 };
 
-class RBDL_TEMPLATE_DLLAPI Vector4_t : public Eigen::Vector4d
+class RBDL_TEMPLATE_DLLAPI Vector4_t : public Eigen::Matrix<Vector1_t, 4, 1>
 {
   public:
-    typedef Eigen::Vector4d Base;
+    typedef Eigen::Matrix<Vector1_t, 4, 1> Base;
 
     template<typename OtherDerived>
       Vector4_t(const Eigen::MatrixBase<OtherDerived>& other)
-      : Eigen::Vector4d(other)
+      : Eigen::Matrix<Vector1_t, 4, 1>(other)
       {}
 
     template<typename OtherDerived>
@@ -151,7 +151,7 @@ class RBDL_TEMPLATE_DLLAPI Vector4_t : public Eigen::Vector4d
     {}
 
     EIGEN_STRONG_INLINE Vector4_t(
-        const double& v0, const double& v1, const double& v2, const double& v3
+        const Scalar& v0, const Scalar& v1, const Scalar& v2, const Scalar& v3
         )
     {
       Base::_check_template_params();
@@ -159,7 +159,7 @@ class RBDL_TEMPLATE_DLLAPI Vector4_t : public Eigen::Vector4d
       (*this) << v0, v1, v2, v3;
     }
 
-    void set(const double& v0, const double& v1, const double& v2, const double& v3)
+    void set(const Scalar& v0, const Scalar& v1, const Scalar& v2, const Scalar& v3)
     {
       Base::_check_template_params();
 
@@ -167,14 +167,14 @@ class RBDL_TEMPLATE_DLLAPI Vector4_t : public Eigen::Vector4d
     }
 };
 
-class RBDL_TEMPLATE_DLLAPI SpatialVector_t : public Eigen::Matrix<double, 6, 1>
+class RBDL_TEMPLATE_DLLAPI SpatialVector_t : public Eigen::Matrix<Vector1_t, 6, 1>
 {
   public:
-    typedef Eigen::Matrix<double, 6, 1> Base;
+    typedef Eigen::Matrix<Vector1_t, 6, 1> Base;
 
     template<typename OtherDerived>
       SpatialVector_t(const Eigen::MatrixBase<OtherDerived>& other)
-      : Eigen::Matrix<double, 6, 1>(other)
+      : Eigen::Matrix<Vector1_t, 6, 1>(other)
       {}
 
     template<typename OtherDerived>
@@ -188,8 +188,8 @@ class RBDL_TEMPLATE_DLLAPI SpatialVector_t : public Eigen::Matrix<double, 6, 1>
     {}
 
     EIGEN_STRONG_INLINE SpatialVector_t(
-        const double& v0, const double& v1, const double& v2,
-        const double& v3, const double& v4, const double& v5
+        const Scalar& v0, const Scalar& v1, const Scalar& v2,
+        const Scalar& v3, const Scalar& v4, const Scalar& v5
         )
     {
       Base::_check_template_params();
@@ -198,8 +198,8 @@ class RBDL_TEMPLATE_DLLAPI SpatialVector_t : public Eigen::Matrix<double, 6, 1>
     }
 
     void set(
-        const double& v0, const double& v1, const double& v2,
-        const double& v3, const double& v4, const double& v5
+        const Scalar& v0, const Scalar& v1, const Scalar& v2,
+        const Scalar& v3, const Scalar& v4, const Scalar& v5
         )
     {
       Base::_check_template_params();
@@ -208,14 +208,14 @@ class RBDL_TEMPLATE_DLLAPI SpatialVector_t : public Eigen::Matrix<double, 6, 1>
     }
 };
 
-class RBDL_TEMPLATE_DLLAPI Matrix4_t : public Eigen::Matrix<double, 4, 4>
+class RBDL_TEMPLATE_DLLAPI Matrix4_t : public Eigen::Matrix<Vector1_t, 4, 4>
 {
   public:
-    typedef Eigen::Matrix<double, 4, 4> Base;
+    typedef Eigen::Matrix<Vector1_t, 4, 4> Base;
 
     template<typename OtherDerived>
       Matrix4_t(const Eigen::MatrixBase<OtherDerived>& other)
-      : Eigen::Matrix<double, 4, 4>(other)
+      : Eigen::Matrix<Vector1_t, 4, 4>(other)
       {}
 
     template<typename OtherDerived>
@@ -263,14 +263,14 @@ class RBDL_TEMPLATE_DLLAPI Matrix4_t : public Eigen::Matrix<double, 4, 4>
     }
 };
 
-class RBDL_TEMPLATE_DLLAPI SpatialMatrix_t : public Eigen::Matrix<double, 6, 6>
+class RBDL_TEMPLATE_DLLAPI SpatialMatrix_t : public Eigen::Matrix<Vector1_t, 6, 6>
 {
   public:
-    typedef Eigen::Matrix<double, 6, 6> Base;
+    typedef Eigen::Matrix<Vector1_t, 6, 6> Base;
 
     template<typename OtherDerived>
       SpatialMatrix_t(const Eigen::MatrixBase<OtherDerived>& other)
-      : Eigen::Matrix<double, 6, 6>(other)
+      : Eigen::Matrix<Vector1_t, 6, 6>(other)
       {}
 
     template<typename OtherDerived>
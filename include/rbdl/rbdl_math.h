@@ -37,15 +37,20 @@ typedef RBDLCasadiMath::MX_Xd_dynamic VectorN_t;
 #include <Eigen/StdVector>
 #include <Eigen/QR>
 
+#ifdef RBDL_USE_SINGLE_PRECISION
+typedef float Vector1_t;
+#else
+typedef double Vector1_t;
+#endif
+
 #include "rbdl/rbdl_eigenmath.h"
 
-typedef double Vector1_t;
-typedef Eigen::Matrix<double, 2, 2> Matrix2_t;
-typedef Eigen::Matrix<double, 6, 3> Matrix63_t;
-typedef Eigen::Matrix<double, 4, 3> Matrix43_t;
+typedef Eigen::Matrix<Vector1_t, 2, 2> Matrix2_t;
+typedef Eigen::Matrix<Vector1_t, 6, 3> Matrix63_t;
+typedef Eigen::Matrix<Vector1_t, 4, 3> Matrix43_t;
 
-typedef Eigen::VectorXd VectorN_t;
-typedef Eigen::MatrixXd MatrixN_t;
+typedef Eigen::Matrix<Vector1_t, Eigen::Dynamic, 1> VectorN_t;
+typedef Eigen::Matrix<Vector1_t, Eigen::Dynamic, Eigen::Dynamic> MatrixN_t;
 #endif
 
 namespace RigidBodyDynamics {
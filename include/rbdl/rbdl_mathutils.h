@@ -23,6 +23,12 @@ namespace Math {
  * Please note that these methods are only available when Eigen3 is used.
  * When the math library SimpleMath is used it will always use a slow
  * column pivoting gauss elimination.
+ *
+ * LinearSolverSparseLTL exploits the branch-induced sparsity of the joint
+ * space inertia matrix and of the constraint Jacobian and is only
+ * supported by ForwardDynamicsLagrangian(),
+ * ForwardDynamicsConstraintsRangeSpaceSparse() and
+ * ComputeConstraintImpulsesRangeSpaceSparse().
  */
 enum RBDL_DLLAPI LinearSolver {
   LinearSolverUnknown = 0,
@@ -30,6 +36,7 @@ enum RBDL_DLLAPI LinearSolver {
   LinearSolverColPivHouseholderQR,
   LinearSolverHouseholderQR,
   LinearSolverLLT,
+  LinearSolverSparseLTL,
   LinearSolverLast,
 };
 
@@ -246,7 +253,7 @@ RBDL_DLLAPI inline Vector3d angular_acceleration_from_angle_rates (const Vector3
 }
 
 RBDL_DLLAPI
-void SparseFactorizeLTL (Model &model, Math::MatrixNd &H);
+void SparseFactorizeLTL (const Model &model, Math::MatrixNd &H);
 
 RBDL_DLLAPI
 void SparseMultiplyHx (Model &model, Math::MatrixNd &L);
@@ -257,9 +264,11 @@ RBDL_DLLAPI
 void SparseMultiplyLTx (Model &model, Math::MatrixNd &L);
 
 RBDL_DLLAPI
-void SparseSolveLx (Model &model, Math::MatrixNd &L, Math::VectorNd &x);
+void SparseSolveLx (const Model &model, const Math::MatrixNd &L,
+    Math::VectorNd &x);
 RBDL_DLLAPI
-void SparseSolveLTx (Model &model, Math::MatrixNd &L, Math::VectorNd &x); 
+void SparseSolveLTx (const Model &model, const Math::MatrixNd &L,
+    Math::VectorNd &x); 
 
 } /* Math */
 
@@ -64,6 +64,63 @@ RBDL_DLLAPI void CalcCenterOfMass (
   bool update_kinematics = true
 );
 
+#ifndef RBDL_USE_CASADI_MATH
+/** \brief Computes the centroidal momentum matrix.
+ *
+ * The centroidal momentum matrix \f$A_G(q)\f$ maps the joint velocities to
+ * the spatial momentum of the whole model at the Center of Mass:
+ * \f$ h_G = (k_G, m \dot{c}) = A_G(q) \dot{q} \f$, where \f$ k_G \f$ is the
+ * angular momentum at the COM and \f$ m \dot{c} \f$ the linear momentum,
+ * both in base coordinates.
+ *
+ * The matrix is computed in \f$O(n)\f$ from the composite rigid body
+ * inertias (see CalcCompositeRigidBodyInertias()): the columns of joint
+ * \f$i\f$ are \f$ X_G^* {}^0X_i^* I^c_i S_i \f$.
+ *
+ * \param model The model for which we want to compute the matrix
+ * \param q The current joint positions
+ * \param A_G (output) centroidal momentum matrix of size 6 x qdot_size.
+ * The first three rows are the angular, the last three rows the linear part.
+ * \param update_kinematics (optional input) whether the kinematics should be updated (defaults to true)
+ */
+RBDL_DLLAPI void CalcCentroidalMomentumMatrix (
+  Model &model,
+  const Math::VectorNd &q,
+  Math::MatrixNd &A_G,
+  bool update_kinematics = true
+);
+
+/** \brief Computes the bias term of the centroidal dynamics.
+ *
+ * Computes \f$ \dot{A}_G \dot{q} \f$ such that the rate of change of the
+ * centroidal momentum is \f$ \dot{h}_G = A_G \ddot{q} + \dot{A}_G \dot{q}
+ * \f$. It is evaluated in \f$O(n)\f$ as \f$ X_G^* \sum_i {}^0X_i^* (I^c_i
+ * c_i + v_i \times^* I_i v_i) \f$ with the velocity product accelerations
+ * \f$ c_i \f$ of the joints, i.e. without forming \f$ \dot{A}_G \f$.
+ *
+ * \param model The model for which we want to compute the bias term
+ * \param q The current joint positions
+ * \param qdot The current joint velocities
+ * \param A_G_dot_qdot (output) \f$ \dot{A}_G \dot{q} \f$ (angular part
+ * first) at the COM in base coordinates
+ * \param A_G (optional output) centroidal momentum matrix, computed in the
+ * same pass (see CalcCentroidalMomentumMatrix())
+ * \param update_kinematics (optional input) whether the kinematics should be updated (defaults to true)
+ *
+ * \note When update_kinematics is false the velocities and velocity product
+ * accelerations of the bodies must have been computed with the given q and
+ * qdot, e.g. by UpdateKinematicsCustom (model, &q, &qdot, NULL).
+ */
+RBDL_DLLAPI void CalcCentroidalMomentumBias (
+  Model &model,
+  const Math::VectorNd &q,
+  const Math::VectorNd &qdot,
+  Math::SpatialVector &A_G_dot_qdot,
+  Math::MatrixNd *A_G = NULL,
+  bool update_kinematics = true
+);
+#endif
+
 /** \brief Computes the Zero-Moment-Point (ZMP) on a given contact surface.
  *
  * \param model The model for which we want to compute the ZMP
@@ -245,6 +245,10 @@ IF (RBDL_FOUND)
       MESSAGE(STATUS "Found RBDL: ${RBDL_LIBRARY}")
    ENDIF (NOT RBDL_FIND_QUIETLY)
 
+   # the BatchExecutor of RBDL uses std::thread
+   FIND_PACKAGE (Threads REQUIRED)
+   SET (RBDL_LIBRARY ${RBDL_LIBRARY} Threads::Threads)
+
    foreach ( COMPONENT ${RBDL_FIND_COMPONENTS} )
      IF (RBDL_${COMPONENT}_FOUND)
        IF (NOT RBDL_FIND_QUIETLY)
@@ -9,5 +9,5 @@ Version: @RBDL_VERSION@
 Requires: eigen3
 Conflicts:
 Libs: -L${libdir} -lrbdl -Wl,-rpath ${libdir}
-Libs.private:
+Libs.private: @CMAKE_THREAD_LIBS_INIT@
 Cflags: -I${includedir}
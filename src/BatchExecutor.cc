@@ -0,0 +1,325 @@
+/*
+ * RBDL - Rigid Body Dynamics Library
+ * Copyright (c) 2011-2018 Martin Felis <martin@fysx.org>
+ *
+ * Licensed under the zlib license. See LICENSE for more details.
+ */
+
+#include <algorithm>
+
+#include "rbdl/rbdl_errors.h"
+#include "rbdl/BatchExecutor.h"
+#include "rbdl/Dynamics.h"
+
+#ifndef RBDL_USE_CASADI_MATH
+
+namespace RigidBodyDynamics {
+
+using namespace Math;
+
+/// number of chunks per thread, more chunks allow better load balancing
+static const unsigned int BatchChunksPerThread = 4;
+
+BatchExecutor::BatchExecutor (const Model &model, unsigned int thread_count) :
+  mModel (model),
+  mGeneration (0),
+  mPendingThreads (0),
+  mStop (false),
+  mFunction (NULL),
+  mSampleCount (0),
+  mChunkSize (1) {
+  if (model.mCustomJoints.size() > 0) {
+    throw Errors::RBDLError("Error: BatchExecutor does not support models "
+        "with custom joints!\n");
+  }
+
+  if (thread_count == 0) {
+    thread_count = std::max (1u, std::thread::hardware_concurrency());
+  }
+
+  try {
+    for (unsigned int i = 0; i < thread_count; i++) {
+      mWorkers.push_back (new Worker (model));
+    }
+
+    // the calling thread acts as worker 0
+    for (unsigned int i = 1; i < thread_count; i++) {
+      mThreads.push_back (std::thread (&BatchExecutor::WorkerLoop, this, i));
+    }
+  } catch (...) {
+    // the destructor does not run for a partially constructed object
+    Shutdown();
+    throw;
+  }
+}
+
+BatchExecutor::~BatchExecutor () {
+  Shutdown();
+}
+
+void BatchExecutor::Shutdown () {
+  {
+    std::lock_guard<std::mutex> lock (mMutex);
+    mStop = true;
+  }
+  mStartCondition.notify_all();
+
+  for (unsigned int i = 0; i < mThreads.size(); i++) {
+    mThreads[i].join();
+  }
+
+  for (unsigned int i = 0; i < mWorkers.size(); i++) {
+    delete mWorkers[i];
+  }
+  mThreads.clear();
+  mWorkers.clear();
+}
+
+void BatchExecutor::Run (
+    unsigned int sample_count,
+    const SampleFunction &function) {
+  RunWorkers (sample_count, [&function] (unsigned int i, Worker &worker) {
+      function (i, worker.data);
+      });
+}
+
+void BatchExecutor::RunWorkers (
+    unsigned int sample_count,
+    const WorkerFunction &function) {
+  if (sample_count == 0) {
+    return;
+  }
+
+  unsigned int thread_count = mWorkers.size();
+  mChunkSize = std::max (1u,
+      sample_count / (thread_count * BatchChunksPerThread));
+  unsigned int chunk_count = (sample_count + mChunkSize - 1) / mChunkSize;
+
+  // Consecutive chunks are assigned to the same worker so that every
+  // worker initially processes a contiguous range of samples.
+  for (unsigned int w = 0; w < thread_count; w++) {
+    unsigned int chunk_begin = (w * chunk_count) / thread_count;
+    unsigned int chunk_end = ((w + 1) * chunk_count) / thread_count;
+
+    std::lock_guard<std::mutex> lock (mWorkers[w]->mutex);
+    mWorkers[w]->chunks.clear();
+    for (unsigned int c = chunk_begin; c < chunk_end; c++) {
+      mWorkers[w]->chunks.push_back (c * mChunkSize);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock (mMutex);
+    mFunction = &function;
+    mSampleCount = sample_count;
+    mException = std::exception_ptr();
+    mPendingThreads = mThreads.size();
+    mGeneration++;
+  }
+  mStartCondition.notify_all();
+
+  ProcessChunks (0);
+
+  std::unique_lock<std::mutex> lock (mMutex);
+  mDoneCondition.wait (lock, [this] { return mPendingThreads == 0; });
+  mFunction = NULL;
+
+  if (mException) {
+    std::exception_ptr exception = mException;
+    mException = std::exception_ptr();
+    std::rethrow_exception (exception);
+  }
+}
+
+void BatchExecutor::WorkerLoop (unsigned int worker_index) {
+  unsigned long generation = 0;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock (mMutex);
+      mStartCondition.wait (lock, [this, generation] {
+          return mStop || mGeneration != generation;
+          });
+
+      if (mStop) {
+        return;
+      }
+      generation = mGeneration;
+    }
+
+    ProcessChunks (worker_index);
+
+    {
+      std::lock_guard<std::mutex> lock (mMutex);
+      mPendingThreads--;
+    }
+    mDoneCondition.notify_one();
+  }
+}
+
+void BatchExecutor::ProcessChunks (unsigned int worker_index) {
+  Worker &worker = *mWorkers[worker_index];
+  unsigned int chunk_begin = 0;
+
+  while (PopChunk (worker_index, chunk_begin)) {
+    unsigned int chunk_end = std::min (chunk_begin + mChunkSize, mSampleCount);
+
+    for (unsigned int i = chunk_begin; i < chunk_end; i++) {
+      try {
+        (*mFunction) (i, worker);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock (mMutex);
+        if (!mException) {
+          mException = std::current_exception();
+        }
+      }
+    }
+  }
+}
+
+bool BatchExecutor::PopChunk (
+    unsigned int worker_index,
+    unsigned int &chunk_begin) {
+  {
+    Worker &worker = *mWorkers[worker_index];
+    std::lock_guard<std::mutex> lock (worker.mutex);
+    if (!worker.chunks.empty()) {
+      chunk_begin = worker.chunks.front();
+      worker.chunks.pop_front();
+      return true;
+    }
+  }
+
+  // own queue is empty: steal from the back of the other queues
+  for (unsigned int k = 1; k < mWorkers.size(); k++) {
+    Worker &victim = *mWorkers[(worker_index + k) % mWorkers.size()];
+    std::lock_guard<std::mutex> lock (victim.mutex);
+    if (!victim.chunks.empty()) {
+      chunk_begin = victim.chunks.back();
+      victim.chunks.pop_back();
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void BatchExecutor::CheckColumns (
+    const MatrixNd &M,
+    unsigned int rows,
+    unsigned int cols) const {
+  if (M.rows() != rows) {
+    throw Errors::RBDLDofMismatchError("Error: batch rows do not match the "
+        "dimensions of the model!\n");
+  }
+
+  if (M.cols() != cols) {
+    throw Errors::RBDLSizeMismatchError("Error: batch inputs have a "
+        "different number of samples!\n");
+  }
+}
+
+void BatchExecutor::ForwardDynamics (
+    const MatrixNd &Q,
+    const MatrixNd &QDot,
+    const MatrixNd &Tau,
+    MatrixNd &QDDot) {
+  CheckColumns (Q, mModel.q_size, Q.cols());
+  CheckColumns (QDot, mModel.qdot_size, Q.cols());
+  CheckColumns (Tau, mModel.qdot_size, Q.cols());
+
+  QDDot.resize (mModel.qdot_size, Q.cols());
+
+  RunWorkers (Q.cols(), [&] (unsigned int i, Worker &worker) {
+      worker.q = Q.col(i);
+      worker.qdot = QDot.col(i);
+      worker.u = Tau.col(i);
+      RigidBodyDynamics::ForwardDynamics (mModel, worker.data,
+          worker.q, worker.qdot, worker.u, worker.result);
+      QDDot.col(i) = worker.result;
+      });
+}
+
+void BatchExecutor::InverseDynamics (
+    const MatrixNd &Q,
+    const MatrixNd &QDot,
+    const MatrixNd &QDDot,
+    MatrixNd &Tau) {
+  CheckColumns (Q, mModel.q_size, Q.cols());
+  CheckColumns (QDot, mModel.qdot_size, Q.cols());
+  CheckColumns (QDDot, mModel.qdot_size, Q.cols());
+
+  Tau.resize (mModel.qdot_size, Q.cols());
+
+  RunWorkers (Q.cols(), [&] (unsigned int i, Worker &worker) {
+      worker.q = Q.col(i);
+      worker.qdot = QDot.col(i);
+      worker.u = QDDot.col(i);
+      RigidBodyDynamics::InverseDynamics (mModel, worker.data,
+          worker.q, worker.qdot, worker.u, worker.result);
+      Tau.col(i) = worker.result;
+      });
+}
+
+void BatchExecutor::NonlinearEffects (
+    const MatrixNd &Q,
+    const MatrixNd &QDot,
+    MatrixNd &Tau) {
+  CheckColumns (Q, mModel.q_size, Q.cols());
+  CheckColumns (QDot, mModel.qdot_size, Q.cols());
+
+  Tau.resize (mModel.qdot_size, Q.cols());
+
+  RunWorkers (Q.cols(), [&] (unsigned int i, Worker &worker) {
+      worker.q = Q.col(i);
+      worker.qdot = QDot.col(i);
+      RigidBodyDynamics::NonlinearEffects (mModel, worker.data,
+          worker.q, worker.qdot, worker.result);
+      Tau.col(i) = worker.result;
+      });
+}
+
+void BatchExecutor::CompositeRigidBodyAlgorithm (
+    const MatrixNd &Q,
+    std::vector<MatrixNd> &H) {
+  CheckColumns (Q, mModel.q_size, Q.cols());
+
+  H.resize (Q.cols());
+
+  RunWorkers (Q.cols(), [&] (unsigned int i, Worker &worker) {
+      worker.q = Q.col(i);
+      H[i].setZero (mModel.qdot_size, mModel.qdot_size);
+      RigidBodyDynamics::CompositeRigidBodyAlgorithm (mModel, worker.data,
+          worker.q, H[i]);
+      });
+}
+
+void BatchExecutor::Integrate (
+    IntegratorMethod method,
+    double dt,
+    unsigned int step_count,
+    MatrixNd &Q,
+    MatrixNd &QDot,
+    const MatrixNd &Tau) {
+  CheckColumns (Q, mModel.q_size, Q.cols());
+  CheckColumns (QDot, mModel.qdot_size, Q.cols());
+  CheckColumns (Tau, mModel.qdot_size, Q.cols());
+
+  RunWorkers (Q.cols(), [&] (unsigned int i, Worker &worker) {
+      worker.q = Q.col(i);
+      worker.qdot = QDot.col(i);
+      worker.u = Tau.col(i);
+      worker.integrator.method = method;
+      for (unsigned int step = 0; step < step_count; step++) {
+        worker.integrator.Step (mModel, worker.data, worker.q, worker.qdot,
+            worker.u, dt);
+      }
+      Q.col(i) = worker.q;
+      QDot.col(i) = worker.qdot;
+      });
+}
+
+}
+
+/* RBDL_USE_CASADI_MATH */
+#endif
@@ -26,7 +26,8 @@ using namespace Math;
 //==============================================================================
 ContactConstraint::ContactConstraint():
   Constraint("",ConstraintTypeContact,1,
-             std::numeric_limits<unsigned int>::max()){}
+             std::numeric_limits<unsigned int>::max()),
+  frictionCoefficient(std::numeric_limits<double>::infinity()){}
 
 //==============================================================================
 ContactConstraint::ContactConstraint(
@@ -41,7 +42,8 @@ ContactConstraint::ContactConstraint(
         Constraint(contactConstraintName,
                    ConstraintTypeContact,
                    unsigned(int(1)),
-                   userDefinedIdNumber)
+                   userDefinedIdNumber),
+        frictionCoefficient(std::numeric_limits<double>::infinity())
 {
 
   T.push_back(groundConstraintUnitVector); 
@@ -94,13 +96,14 @@ void ContactConstraint::calcConstraintJacobian( Model &model,
                               ConstraintCache &cache,
                               bool updateKinematics)
 {
-  cache.mat3NA.setZero();
-  CalcPointJacobian(model, Q,bodyIds[0],bodyFrames[0].r,cache.mat3NA,
-                    updateKinematics);
+  //The point Jacobian is shared with the other constraints on this point
+  const Math::MatrixNd &pointJacobian6D =
+      cache.getPointJacobian6D(model,Q,bodyIds[0],bodyFrames[0].r,
+                               updateKinematics);
 
   for(unsigned int i=0; i < sizeOfConstraint; ++i){
     GSysUpd.block(rowInSystem+i,0,1,GSysUpd.cols()) =
-        T[i].transpose()*cache.mat3NA;
+        T[i].transpose()*pointJacobian6D.block(3,0,3,GSysUpd.cols());
   }
 }
 
@@ -117,9 +120,10 @@ void ContactConstraint::calcGamma(  Model &model,
 {
 
 
-  cache.vec3A = CalcPointAcceleration (model, Q, QDot, cache.vecNZeros,
-                                       bodyIds[0], bodyFrames[0].r,
-                                       updateKinematics);
+  cache.vec3A = cache.getPointBiasAcceleration6D(model, Q, QDot,
+                                                bodyIds[0], bodyFrames[0].r,
+                                                updateKinematics
+                                                ).block(3,0,3,1);
 
   for(unsigned int i=0; i < sizeOfConstraint; ++i){
     gammaSysUpd.block(rowInSystem+i,0,1,1) =
@@ -138,8 +142,8 @@ void ContactConstraint::calcPositionError(Model &model,
                                                       ConstraintCache &cache,
                                                       bool updateKinematics)
 {
-  cache.vec3A = CalcBodyToBaseCoordinates(model,Q,bodyIds[0],bodyFrames[0].r,
-                                          updateKinematics)  - groundPoint;
+  cache.vec3A = cache.getPointPosition(model,Q,bodyIds[0],bodyFrames[0].r,
+                                       updateKinematics)  - groundPoint;
   for(unsigned int i = 0; i < sizeOfConstraint; ++i){
     if(positionConstraint[i]){
       errSysUpd[rowInSystem+i] = cache.vec3A.dot( T[i] );
@@ -160,8 +164,9 @@ void ContactConstraint::calcVelocityError(  Model &model,
                             ConstraintCache &cache,
                             bool updateKinematics)
 {
-  cache.vec3A =  CalcPointVelocity(model,Q,QDot,bodyIds[0],bodyFrames[0].r,
-                                    updateKinematics);
+  cache.vec3A =  cache.getPointVelocity6D(model,Q,QDot,bodyIds[0],
+                                          bodyFrames[0].r,updateKinematics
+                                          ).block(3,0,3,1);
   for(unsigned int i = 0; i < sizeOfConstraint; ++i){
     if(velocityConstraint[i]){
       derrSysUpd[rowInSystem+i] = cache.vec3A.dot( T[i] );
@@ -226,6 +231,30 @@ void ContactConstraint::calcConstraintForces(
   constraintForcesUpd[1].block(3,0,3,1) = -cache.vec3A;
 }
 //==============================================================================
+bool ContactConstraint::calcSpatialTestForces(
+              Model &model,
+              const double time,
+              const Math::VectorNd &Q,
+              unsigned int rowIndex,
+              std::vector< unsigned int > &constraintBodiesUpd,
+              std::vector< Math::SpatialVector > &constraintForcesUpd,
+              ConstraintCache &cache,
+              bool updateKinematics)
+{
+  constraintBodiesUpd.resize(1);
+  constraintForcesUpd.resize(1);
+  constraintBodiesUpd[0] = bodyIds[0];
+
+  //The force along the normal acts on the contact point. Shifted to the
+  //origin of the base frame it also exerts a moment.
+  cache.vec3A = cache.getPointPosition(model,Q,bodyIds[0],bodyFrames[0].r,
+                                       updateKinematics);
+  constraintForcesUpd[0].block(0,0,3,1) = cache.vec3A.cross(T[rowIndex]);
+  constraintForcesUpd[0].block(3,0,3,1) = T[rowIndex];
+
+  return true;
+}
+//==============================================================================
 void ContactConstraint::
         appendNormalVector(const Math::Vector3d& normal,
                            bool velocityLevelConstraint)
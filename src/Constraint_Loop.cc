@@ -92,19 +92,17 @@ void LoopConstraint::calcConstraintJacobian( Model &model,
 
     //Compute the spatial Jacobians of the predecessor point Gp and the
     //successor point Gs and evaluate Gs-Gp
-    cache.mat6NA.setZero();
-    cache.mat6NB.setZero();
-    CalcPointJacobian6D(model,Q,bodyIds[0],bodyFrames[0].r,cache.mat6NA,
-                        updateKinematics);
-    CalcPointJacobian6D(model,Q,bodyIds[1],bodyFrames[1].r,cache.mat6NB,
-                        updateKinematics);
-    cache.mat6NA = cache.mat6NB-cache.mat6NA;
+    cache.mat6NA = cache.getPointJacobian6D(model,Q,bodyIds[1],
+                                            bodyFrames[1].r,updateKinematics);
+    cache.mat6NA -= cache.getPointJacobian6D(model,Q,bodyIds[0],
+                                             bodyFrames[0].r,updateKinematics);
 
     //Evaluate the transform from the world frame into the constraint frame
     //that is attached to the precessor body
-    cache.stA.r = CalcBodyToBaseCoordinates(model,Q,bodyIds[0],bodyFrames[0].r,
-                                            updateKinematics);
-    cache.stA.E = CalcBodyWorldOrientation(model,Q,bodyIds[0],updateKinematics
+    cache.stA.r = cache.getPointPosition(model,Q,bodyIds[0],bodyFrames[0].r,
+                                         updateKinematics);
+    cache.stA.E = cache.getBodyWorldOrientation(model,Q,bodyIds[0],
+                                           updateKinematics
                                            ).transpose()*bodyFrames[0].E;
 
     for(unsigned int i=0; i<sizeOfConstraint;++i){
@@ -131,30 +129,33 @@ void LoopConstraint::calcGamma(  Model &model,
   //Please refer to Ch. 8 of Featherstone's Rigid Body Dynamics text for details
 
   // Express the constraint axis in the base frame.
-  cache.stA.r = CalcBodyToBaseCoordinates(model,Q,bodyIds[0],bodyFrames[0].r,
-                                          updateKinematics);
-  cache.stA.E = CalcBodyWorldOrientation(model,Q,bodyIds[0],updateKinematics
-                                         ).transpose()*bodyFrames[0].E;
+  cache.stA.r = cache.getPointPosition(model,Q,bodyIds[0],bodyFrames[0].r,
+                                       updateKinematics);
+  cache.stA.E = cache.getBodyWorldOrientation(model,Q,bodyIds[0],
+                                              updateKinematics
+                                              ).transpose()*bodyFrames[0].E;
 
   // Compute the spatial velocities of the two constrained bodies.
   //vel_p
-  cache.svecA = CalcPointVelocity6D(model,Q,QDot,bodyIds[0],bodyFrames[0].r,
-                                    updateKinematics);
+  cache.svecA = cache.getPointVelocity6D(model,Q,QDot,bodyIds[0],
+                                         bodyFrames[0].r,updateKinematics);
 
   //vel_s
-  cache.svecB = CalcPointVelocity6D(model,Q,QDot,bodyIds[1],bodyFrames[1].r,
-                                    updateKinematics);
+  cache.svecB = cache.getPointVelocity6D(model,Q,QDot,bodyIds[1],
+                                         bodyFrames[1].r,updateKinematics);
 
   // Compute the velocity product accelerations. These correspond to the
   // accelerations that the bodies would have if q ddot were 0. If this
   // confuses you please see Sec. 8.2 of Featherstone's Rigid Body Dynamics text
 
   //acc_p
-  cache.svecC = CalcPointAcceleration6D(model,Q,QDot,cache.vecNZeros,
-                                        bodyIds[0],bodyFrames[0].r,updateKinematics);
+  cache.svecC = cache.getPointBiasAcceleration6D(model,Q,QDot,bodyIds[0],
+                                                 bodyFrames[0].r,
+                                                 updateKinematics);
   //acc_s
-  cache.svecD = CalcPointAcceleration6D(model,Q,QDot,cache.vecNZeros,
-                                        bodyIds[1],bodyFrames[1].r,updateKinematics);
+  cache.svecD = cache.getPointBiasAcceleration6D(model,Q,QDot,bodyIds[1],
+                                                 bodyFrames[1].r,
+                                                 updateKinematics);
 
   for(unsigned int i=0; i<sizeOfConstraint;++i){
 
@@ -187,16 +188,18 @@ void LoopConstraint::calcPositionError(Model &model,
   // Compute the position of the two contact points.
 
   //Kp: predecessor frame
-  cache.stA.r = CalcBodyToBaseCoordinates(model,Q,bodyIds[0],bodyFrames[0].r,
-                                          updateKinematics);
-  cache.stA.E = CalcBodyWorldOrientation(model,Q,bodyIds[0],updateKinematics
-                                         ).transpose()*bodyFrames[0].E;
+  cache.stA.r = cache.getPointPosition(model,Q,bodyIds[0],bodyFrames[0].r,
+                                       updateKinematics);
+  cache.stA.E = cache.getBodyWorldOrientation(model,Q,bodyIds[0],
+                                              updateKinematics
+                                              ).transpose()*bodyFrames[0].E;
 
   //Ks: successor frame
-  cache.stB.r = CalcBodyToBaseCoordinates(model,Q,bodyIds[1],bodyFrames[1].r,
-                                          updateKinematics);
-  cache.stB.E = CalcBodyWorldOrientation(model,Q,bodyIds[1],updateKinematics
-                                         ).transpose()*bodyFrames[1].E;
+  cache.stB.r = cache.getPointPosition(model,Q,bodyIds[1],bodyFrames[1].r,
+                                       updateKinematics);
+  cache.stB.E = cache.getBodyWorldOrientation(model,Q,bodyIds[1],
+                                              updateKinematics
+                                              ).transpose()*bodyFrames[1].E;
 
 
   // Compute the orientation from the predecessor to the successor frame.
@@ -346,6 +349,48 @@ void LoopConstraint::calcConstraintForces(
 
 
 
+}
+//==============================================================================
+bool LoopConstraint::calcSpatialTestForces(
+              Model &model,
+              const double time,
+              const Math::VectorNd &Q,
+              unsigned int rowIndex,
+              std::vector< unsigned int > &constraintBodiesUpd,
+              std::vector< Math::SpatialVector > &constraintForcesUpd,
+              ConstraintCache &cache,
+              bool updateKinematics)
+{
+  constraintBodiesUpd.resize(2);
+  constraintForcesUpd.resize(2);
+  constraintBodiesUpd[0] = bodyIds[0];
+  constraintBodiesUpd[1] = bodyIds[1];
+
+  //Resolve the constraint axis in the global frame as in
+  //calcConstraintJacobian
+  cache.stA.r = cache.getPointPosition(model,Q,bodyIds[0],bodyFrames[0].r,
+                                       updateKinematics);
+  cache.stA.E = cache.getBodyWorldOrientation(model,Q,bodyIds[0],
+                                              updateKinematics
+                                              ).transpose()*bodyFrames[0].E;
+  cache.svecA = cache.stA.apply(T[rowIndex]);
+  cache.vec3A = cache.svecA.block(0,0,3,1);
+  cache.vec3B = cache.svecA.block(3,0,3,1);
+
+  //The wrench acts with opposite signs on the predecessor and the successor
+  //point (see calcConstraintForces). Both are shifted to the origin of the
+  //base frame.
+  constraintForcesUpd[0].block(0,0,3,1) =
+      -(cache.vec3A + cache.stA.r.cross(cache.vec3B));
+  constraintForcesUpd[0].block(3,0,3,1) = -cache.vec3B;
+
+  cache.vec3C = cache.getPointPosition(model,Q,bodyIds[1],bodyFrames[1].r,
+                                       updateKinematics);
+  constraintForcesUpd[1].block(0,0,3,1) =
+      cache.vec3A + cache.vec3C.cross(cache.vec3B);
+  constraintForcesUpd[1].block(3,0,3,1) = cache.vec3B;
+
+  return true;
 }
 //==============================================================================
 void LoopConstraint::
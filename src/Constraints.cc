@@ -5,6 +5,8 @@
  * Licensed under the zlib license. See LICENSE for more details.
  */
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -16,6 +18,7 @@
 #include "rbdl/rbdl_mathutils.h"
 #include "rbdl/rbdl_errors.h"
 #include "rbdl/Logging.h"
+#include "rbdl/PerformanceCounters.h"
 
 #include "rbdl/Model.h"
 #include "rbdl/Joint.h"
@@ -417,6 +420,9 @@ bool ConstraintSet::Bind (const Model &model)
   cache.mat6NC.resize(6, model.qdot_size);
   cache.mat6ND.resize(6, model.qdot_size);
 
+  cache.bodyKinematics.reserve(2 * constraints.size());
+  cache.pointKinematics.reserve(2 * constraints.size());
+
 
   unsigned int n_constr = size();
 
@@ -447,10 +453,41 @@ bool ConstraintSet::Bind (const Model &model)
 #endif
   GT_qr_Q = MatrixNd::Zero (model.dof_count, model.dof_count);
   Y = MatrixNd::Zero (model.dof_count, G.rows());
-  Z = MatrixNd::Zero (model.dof_count, model.dof_count - G.rows());
+  // there is no null space if the set has more (redundant) constraints than
+  // degrees of freedom, e.g. contact points for ForwardDynamicsContactsPGS
+  unsigned int null_space_dim = 0;
+  if (model.dof_count > n_constr) {
+    null_space_dim = model.dof_count - n_constr;
+  }
+  Z = MatrixNd::Zero (model.dof_count, null_space_dim);
   qddot_y = VectorNd::Zero (model.dof_count);
   qddot_z = VectorNd::Zero (model.dof_count);
 
+#ifndef RBDL_USE_CASADI_MATH
+  sparse_ltl_support = std::vector< std::vector<unsigned int> > (n_constr);
+  sparse_ltl_mask = std::vector< std::vector<bool> > (n_constr,
+                    std::vector<bool> (model.dof_count, false));
+  sparse_ltl_Y = MatrixNd::Zero (model.dof_count, n_constr);
+  sparse_ltl_z = VectorNd::Zero (model.dof_count);
+  sparse_ltl_K_ldlt = Eigen::LDLT<Math::MatrixNd> (n_constr);
+
+  assembly_factorization_valid = false;
+  assembly_weights = VectorNd::Zero (model.dof_count);
+  assembly_G = MatrixNd::Zero (n_constr, model.dof_count);
+  assembly_WinvGT = MatrixNd::Zero (model.dof_count, n_constr);
+  assembly_GWinvGT = MatrixNd::Zero (n_constr, n_constr);
+  assembly_ldlt = Eigen::LDLT<Math::MatrixNd> (n_constr);
+  assembly_A = MatrixNd::Zero (model.dof_count + n_constr,
+                               model.dof_count + n_constr);
+  assembly_b = VectorNd::Zero (model.dof_count + n_constr);
+  assembly_x = VectorNd::Zero (model.dof_count + n_constr);
+  assembly_q = VectorNd::Zero (model.q_size);
+  assembly_e = VectorNd::Zero (n_constr);
+  assembly_e_trial = VectorNd::Zero (n_constr);
+  assembly_d = VectorNd::Zero (model.dof_count);
+  assembly_lambda = VectorNd::Zero (n_constr);
+#endif
+
   K.conservativeResize (n_constr, n_constr);
   K.setZero();
   a.conservativeResize (n_constr);
@@ -463,6 +500,19 @@ bool ConstraintSet::Bind (const Model &model)
   QDDot_0.conservativeResize (model.dof_count);
   QDDot_0.setZero();
 
+#ifndef RBDL_USE_CASADI_MATH
+  test_force_bodies.clear();
+  test_force_bodies.reserve (2 * n_constr);
+  test_forces.clear();
+  test_forces.reserve (2 * n_constr);
+  test_forces_body.clear();
+  test_forces_body.reserve (2 * n_constr);
+  test_force_offsets.assign (n_constr + 1, 0);
+  test_force_spatial.assign (n_constr, false);
+  row_test_force_bodies.reserve (2);
+  row_test_forces.reserve (2);
+  tau_t = VectorNd::Zero (model.dof_count);
+#endif
 
   f_ext_constraints.resize (model.mBodies.size(), SpatialVector::Zero());
 
@@ -516,15 +566,23 @@ void ConstraintSet::SetActuationMap(const Model &model,
 
   u.resize(na);
   v.resize(nu);
+  SC.resize(na);
+  PC.resize(nu);
+  SQDDotControls.resize(na);
+
+  actuated_dof_indices.clear();
+  unactuated_dof_indices.clear();
 
   unsigned int j=0;
   unsigned int k=0;
   for(unsigned int i=0; i<model.dof_count; ++i) {
     if(actuatedDofUpd[i]) {
       S(j,i) = 1.;
+      actuated_dof_indices.push_back(i);
       ++j;
     } else {
       P(k,i) = 1.;
+      unactuated_dof_indices.push_back(i);
       ++k;
     }
   }
@@ -652,6 +710,10 @@ void ConstraintSet::clear()
   }
 
   d_u.setZero();
+
+#ifndef RBDL_USE_CASADI_MATH
+  assembly_factorization_valid = false;
+#endif
 }
 
 
@@ -750,6 +812,132 @@ void SolveConstrainedSystemRangeSpaceSparse (
   SparseSolveLx (model, H, qddot);
 }
 
+//==============================================================================
+#ifndef RBDL_USE_CASADI_MATH
+/** Extends the cached sparsity pattern of the rows of CS.G by the columns
+ * that have non-zero entries. As \f$L^{-T}\f$ only propagates values from
+ * a degree of freedom to its ancestors the pattern is closed under
+ * model.lambda_q.
+ */
+static void UpdateSparseLTLPattern (Model &model, ConstraintSet &CS)
+{
+  for (unsigned int r = 0; r < CS.G.rows(); r++) {
+    std::vector<bool> &mask = CS.sparse_ltl_mask[r];
+    bool changed = false;
+
+    for (unsigned int k = 0; k < model.dof_count; k++) {
+      if (CS.G(r,k) == 0. || mask[k]) {
+        continue;
+      }
+
+      unsigned int j = k + 1;
+      while (j != 0 && !mask[j - 1]) {
+        mask[j - 1] = true;
+        j = model.lambda_q[j];
+      }
+      changed = true;
+    }
+
+    if (changed) {
+      std::vector<unsigned int> &support = CS.sparse_ltl_support[r];
+      support.clear();
+      for (unsigned int k = 0; k < model.dof_count; k++) {
+        if (mask[k]) {
+          support.push_back (k);
+        }
+      }
+    }
+  }
+}
+
+/** Range-space solution of the constrained system that only operates on
+ * the entries of \f$L^{-T} G^T\f$ that are structurally non-zero.
+ */
+static void SolveConstrainedSystemSparseLTL (
+  Model &model,
+  ConstraintSet &CS,
+  const Math::VectorNd &c,
+  const Math::VectorNd &gamma,
+  Math::VectorNd &qddot,
+  Math::VectorNd &lambda
+)
+{
+  SparseFactorizeLTL (model, CS.H);
+  UpdateSparseLTLPattern (model, CS);
+
+  const MatrixNd &L = CS.H;
+  MatrixNd &Y = CS.sparse_ltl_Y;
+
+  for (unsigned int r = 0; r < CS.G.rows(); r++) {
+    const std::vector<unsigned int> &support = CS.sparse_ltl_support[r];
+
+    for (unsigned int s = 0; s < support.size(); s++) {
+      Y(support[s], r) = CS.G(r, support[s]);
+    }
+
+    // SparseSolveLTx() restricted to the support of the column
+    for (unsigned int s = support.size(); s > 0; s--) {
+      unsigned int i = support[s - 1];
+      Y(i, r) = Y(i, r) / L(i, i);
+      unsigned int j = model.lambda_q[i + 1];
+      while (j != 0) {
+        Y(j - 1, r) = Y(j - 1, r) - L(i, j - 1) * Y(i, r);
+        j = model.lambda_q[j];
+      }
+    }
+  }
+
+  CS.sparse_ltl_z = c;
+  SparseSolveLTx (model, CS.H, CS.sparse_ltl_z);
+
+  for (unsigned int r = 0; r < CS.G.rows(); r++) {
+    const std::vector<unsigned int> &support = CS.sparse_ltl_support[r];
+
+    for (unsigned int t = 0; t <= r; t++) {
+      double k_rt = 0.;
+      for (unsigned int s = 0; s < support.size(); s++) {
+        k_rt += Y(support[s], r) * Y(support[s], t);
+      }
+      CS.K(r, t) = k_rt;
+      CS.K(t, r) = k_rt;
+    }
+
+    double a_r = gamma[r];
+    for (unsigned int s = 0; s < support.size(); s++) {
+      a_r -= Y(support[s], r) * CS.sparse_ltl_z[support[s]];
+    }
+    CS.a[r] = a_r;
+  }
+
+  // K is only semidefinite for redundant constraints. Vanishing pivots of
+  // the pivoting LDLT are detected relative to the largest one and such
+  // systems are solved with a rank revealing QR instead.
+  CS.sparse_ltl_K_ldlt.compute (CS.K);
+  double pivot_max = CS.sparse_ltl_K_ldlt.vectorD().cwiseAbs().maxCoeff();
+  double pivot_min = CS.sparse_ltl_K_ldlt.vectorD().cwiseAbs().minCoeff();
+
+  if (CS.sparse_ltl_K_ldlt.info() == Eigen::Success
+      && pivot_min > pivot_max * Eigen::NumTraits<double>::dummy_precision()) {
+    lambda = CS.sparse_ltl_K_ldlt.solve (CS.a);
+  } else {
+    Eigen::ColPivHouseholderQR<MatrixNd> K_qr (CS.K);
+    K_qr.setThreshold (Eigen::NumTraits<double>::dummy_precision());
+    lambda = K_qr.solve (CS.a);
+  }
+
+  qddot = c;
+  for (unsigned int r = 0; r < CS.G.rows(); r++) {
+    const std::vector<unsigned int> &support = CS.sparse_ltl_support[r];
+    for (unsigned int s = 0; s < support.size(); s++) {
+      qddot[support[s]] += CS.G(r, support[s]) * lambda[r];
+    }
+  }
+
+  SparseSolveLTx (model, CS.H, qddot);
+  SparseSolveLx (model, CS.H, qddot);
+}
+#endif
+
 //==============================================================================
 RBDL_DLLAPI
 void SolveConstrainedSystemNullSpace (
@@ -822,6 +1010,40 @@ void SolveConstrainedSystemNullSpace (
 }
 
 
+//==============================================================================
+/** Activates the body point cache of a constraint set during the
+ * evaluation of its constraints, unless it has already been activated by
+ * the calling function.
+ */
+class ConstraintPointCacheScope {
+public:
+  explicit ConstraintPointCacheScope (ConstraintCache &cache) :
+    mCache (cache),
+    mOwner (!cache.pointCacheActive) {
+    if (mOwner) {
+      mCache.beginPointCache();
+    }
+  }
+
+  ~ConstraintPointCacheScope() {
+    if (mOwner) {
+      mCache.endPointCache();
+    }
+  }
+
+  /// Records that the kinematics of the model are up to date to the given
+  /// level (see ConstraintCache::kinematicsLevel).
+  void setKinematicsLevel (unsigned int level) {
+    if (level > mCache.kinematicsLevel) {
+      mCache.kinematicsLevel = level;
+    }
+  }
+
+private:
+  ConstraintCache &mCache;
+  bool mOwner;
+};
+
 //==============================================================================
 RBDL_DLLAPI
 void CalcConstraintsPositionError (
@@ -834,8 +1056,11 @@ void CalcConstraintsPositionError (
 {
   assert(err.size() == CS.size());
 
+  ConstraintPointCacheScope point_cache_scope (CS.cache);
+
   if(update_kinematics) {
     UpdateKinematicsCustom (model, &Q, NULL, NULL);
+    point_cache_scope.setKinematicsLevel (1);
   }
 
   for(unsigned int i=0; i<CS.constraints.size(); ++i) {
@@ -854,8 +1079,11 @@ void CalcConstraintsJacobian (
   bool update_kinematics
 )
 {
+  ConstraintPointCacheScope point_cache_scope (CS.cache);
+
   if (update_kinematics) {
     UpdateKinematicsCustom (model, &Q, NULL, NULL);
+    point_cache_scope.setKinematicsLevel (1);
   }
 
   for(unsigned int i=0; i<CS.constraints.size(); ++i) {
@@ -875,7 +1103,7 @@ void CalcConstraintsVelocityError (
   bool update_kinematics
 )
 {
-
+  ConstraintPointCacheScope point_cache_scope (CS.cache);
 
   CalcConstraintsJacobian (model, Q, CS, CS.G, update_kinematics);
 
@@ -898,6 +1126,9 @@ void CalcConstrainedSystemVariables (
   std::vector<Math::SpatialVector> *f_ext
 )
 {
+  // All constraints share the kinematics of their body points.
+  ConstraintPointCacheScope point_cache_scope (CS.cache);
+
   // Compute G
   if(update_kinematics){
     UpdateKinematicsCustom(model, &Q, NULL, NULL);
@@ -905,6 +1136,7 @@ void CalcConstrainedSystemVariables (
 
   // Compute C
   NonlinearEffects(model, Q, QDot, CS.C, f_ext);
+  point_cache_scope.setKinematicsLevel (2);
   assert(CS.H.cols() == model.dof_count && CS.H.rows() == model.dof_count);
 
   // Compute H
@@ -925,8 +1157,11 @@ void CalcConstrainedSystemVariables (
   Vector3d prev_body_point = Vector3d::Zero();
   Vector3d gamma_i = Vector3d::Zero();
 
+  // The bias accelerations of all bodies are computed once for all
+  // constraints from the velocity product accelerations of NonlinearEffects.
   CS.QDDot_0.setZero();
   UpdateKinematicsCustom(model, NULL, NULL, &CS.QDDot_0);
+  point_cache_scope.setKinematicsLevel (3);
 
 
   for(unsigned int i=0; i<CS.constraints.size(); ++i) {
@@ -942,10 +1177,109 @@ void CalcConstrainedSystemVariables (
 
 //==============================================================================
 #ifndef RBDL_USE_CASADI_MATH
+/** Computes the Jacobian at Q and factorizes the Schur complement
+ * \f$G W^{-1} G^T\f$ of the assembly problem. Returns false if the
+ * constraints are redundant at Q, i.e. if the factorization cannot be used
+ * to solve for the multipliers.
+ */
+static bool FactorizeAssemblySchurComplement (
+  Model &model,
+  const VectorNd &Q,
+  ConstraintSet &cs,
+  const VectorNd &weights
+)
+{
+  if (cs.size() == 0) {
+    return false;
+  }
+
+  cs.assembly_G.setZero();
+  CalcConstraintsJacobian (model, Q, cs, cs.assembly_G);
+
+  for (unsigned int i = 0; i < model.dof_count; ++i) {
+    cs.assembly_WinvGT.row(i) = cs.assembly_G.col(i).transpose()
+                                / weights[i];
+  }
+  cs.assembly_GWinvGT.noalias() = cs.assembly_G * cs.assembly_WinvGT;
+  cs.assembly_ldlt.compute (cs.assembly_GWinvGT);
+  cs.assembly_weights = weights;
+  cs.assembly_factorization_count++;
+
+  // G W^-1 G^T is positive semi-definite. Zero pivots of the LDLT
+  // decomposition are caused by linearly dependent constraints.
+  double pivot_max = cs.assembly_ldlt.vectorD().cwiseAbs().maxCoeff();
+  double pivot_min = cs.assembly_ldlt.vectorD().cwiseAbs().minCoeff();
+
+  cs.assembly_factorization_valid =
+    cs.assembly_ldlt.info() == Eigen::Success
+    && pivot_min > 1.0e-12 * pivot_max;
+
+  return cs.assembly_factorization_valid;
+}
+
+/** Solves the KKT system of the assembly problem formed with
+ * cs.assembly_G and the weights for the right hand side cs.assembly_b. The
+ * solution is stored in cs.assembly_x.
+ */
+static void SolveAssemblyKKT (
+  ConstraintSet &cs,
+  const VectorNd &weights
+)
+{
+  unsigned int n = weights.size();
+  unsigned int nc = cs.size();
+
+  cs.assembly_A.setZero();
+  for (unsigned int i = 0; i < n; ++i) {
+    cs.assembly_A(i,i) = weights[i];
+  }
+  cs.assembly_A.block (n, 0, nc, n) = cs.assembly_G;
+  cs.assembly_A.block (0, n, n, nc) = cs.assembly_G.transpose();
+
+  SolveLinearSystem (cs.assembly_A, cs.assembly_b, cs.assembly_x,
+                     cs.linear_solver);
+}
+
+/** Computes QOut = Q + d, where the entries of d of spherical joints are
+ * applied as a rotation of the joint quaternion.
+ */
+static void ApplyAssemblyStep (
+  const Model &model,
+  const VectorNd &Q,
+  const VectorNd &d,
+  VectorNd &QOut
+)
+{
+  QOut = Q;
+
+  for (size_t i = 0; i < model.mJoints.size(); ++i) {
+    // If the joint is spherical, translate the corresponding components
+    // of d into a modification in the joint quaternion.
+    if (model.mJoints[i].mJointType == JointTypeSpherical) {
+      Quaternion quat = model.GetQuaternion(i, Q);
+      Vector3d omega = d.block<3,1>(model.mJoints[i].q_index,0);
+      // Convert the 3d representation of the displacement to 4d and sum it
+      // to the components of the quaternion.
+      quat += quat.omegaToQDot(omega);
+      // The quaternion needs to be normalized after the previous sum.
+      quat /= quat.norm();
+      model.SetQuaternion(i, quat, QOut);
+    }
+    // If the current joint is not spherical, simply add the corresponding
+    // components of d.
+    else {
+      unsigned int qIdx = model.mJoints[i].q_index;
+      for(size_t j = 0; j < model.mJoints[i].mDoFCount; ++j) {
+        QOut[qIdx + j] += d[qIdx + j];
+      }
+    }
+  }
+}
+
 RBDL_DLLAPI
 bool CalcAssemblyQ (
   Model &model,
-  Math::VectorNd QInit, // Note: passed by value intentionally
+  const Math::VectorNd &QInit,
   ConstraintSet &cs,
   Math::VectorNd &Q,
   const Math::VectorNd &weights,
@@ -953,6 +1287,8 @@ bool CalcAssemblyQ (
   unsigned int max_iter
 )
 {
+  RBDL_TRACE_ALGORITHM ("CalcAssemblyQ");
+  RBDL_PERF_COUNTER ("CalcAssemblyQ");
 
   if(Q.size() != model.q_size) {
     throw Errors::RBDLDofMismatchError("Incorrect Q vector size.\n");
@@ -964,86 +1300,83 @@ bool CalcAssemblyQ (
     throw Errors::RBDLDofMismatchError("Incorrect weights vector size.\n");
   }
 
-  // Initialize variables.
-  MatrixNd constraintJac (cs.size(), model.dof_count);
-  MatrixNd A = MatrixNd::Zero (cs.size() + model.dof_count, cs.size()
-                               + model.dof_count);
-  VectorNd b = VectorNd::Zero (cs.size() + model.dof_count);
-  VectorNd x = VectorNd::Zero (cs.size() + model.dof_count);
-  VectorNd d = VectorNd::Zero (model.dof_count);
-  VectorNd e = VectorNd::Zero (cs.size());
-
-  // The top-left block is the weight matrix and is constant.
-  for(unsigned int i = 0; i < weights.size(); ++i) {
-    A(i,i) = weights[i];
-  }
+  // The iterations are performed directly on the output vector (which may
+  // be QInit itself).
+  Q = QInit;
+  cs.assembly_factorization_count = 0;
 
   // Check if the error is small enough already. If so, just return the initial
   // guess as the solution.
-  CalcConstraintsPositionError (model, QInit, cs, e);
-  if (e.norm() < tolerance) {
-    Q = QInit;
+  CalcConstraintsPositionError (model, Q, cs, cs.assembly_e);
+  if (cs.assembly_e.norm() < tolerance) {
     return true;
   }
 
+  // The Schur complement G W^-1 G^T only exists for positive weights.
+  bool use_schur_complement = weights.minCoeff() > 0.;
+  if (!use_schur_complement
+      || !cs.assembly_warm_start
+      || cs.assembly_weights != weights) {
+    cs.assembly_factorization_valid = false;
+  }
+
   // We solve the linearized problem iteratively.
   // Iterations are stopped if the maximum is reached.
   for(unsigned int it = 0; it < max_iter; ++it) {
-    // Compute the constraint jacobian and build A and b.
-    constraintJac.setZero();
-    CalcConstraintsJacobian (model, QInit, cs, constraintJac);
-    A.block (model.dof_count, 0, cs.size(), model.dof_count) = constraintJac;
-    A.block (0, model.dof_count, model.dof_count, cs.size())
-      = constraintJac.transpose();
-    b.block (model.dof_count, 0, cs.size(), 1) = -e;
-
-    // Solve the sistem A*x = b.
-    SolveLinearSystem (A, b, x, cs.linear_solver);
-
-    // Extract the d = (Q - QInit) vector from x.
-    d = x.block (0, 0, model.dof_count, 1);
-
-    // Update solution.
-    for (size_t i = 0; i < model.mJoints.size(); ++i) {
-      // If the joint is spherical, translate the corresponding components
-      // of d into a modification in the joint quaternion.
-      if (model.mJoints[i].mJointType == JointTypeSpherical) {
-        Quaternion quat = model.GetQuaternion(i, QInit);
-        Vector3d omega = d.block<3,1>(model.mJoints[i].q_index,0);
-        // Convert the 3d representation of the displacement to 4d and sum it
-        // to the components of the quaternion.
-        quat += quat.omegaToQDot(omega);
-        // The quaternion needs to be normalized after the previous sum.
-        quat /= quat.norm();
-        model.SetQuaternion(i, quat, QInit);
-      }
-      // If the current joint is not spherical, simply add the corresponding
-      // components of d to QInit.
-      else {
-        unsigned int qIdx = model.mJoints[i].q_index;
-        for(size_t j = 0; j < model.mJoints[i].mDoFCount; ++j) {
-          QInit[qIdx + j] += d[qIdx + j];
-        }
-      }
+    RBDL_PERF_COUNT_ITERATIONS (1);
+
+    bool updated_jacobian = false;
+
+    if (use_schur_complement && !cs.assembly_factorization_valid) {
+      use_schur_complement = FactorizeAssemblySchurComplement (model, Q, cs,
+                             weights);
+      updated_jacobian = true;
     }
 
-    // Update the errors.
-    CalcConstraintsPositionError (model, QInit, cs, e);
+    if (use_schur_complement) {
+      // The minimum norm step d = -W^-1 G^T (G W^-1 G^T)^-1 e.
+      cs.assembly_lambda = cs.assembly_ldlt.solve (cs.assembly_e);
+      cs.assembly_d.noalias() = -cs.assembly_WinvGT * cs.assembly_lambda;
+    } else {
+      cs.assembly_G.setZero();
+      CalcConstraintsJacobian (model, Q, cs, cs.assembly_G);
+      cs.assembly_b.setZero();
+      cs.assembly_b.tail(cs.size()) = -cs.assembly_e;
+      SolveAssemblyKKT (cs, weights);
+      cs.assembly_d = cs.assembly_x.head(model.dof_count);
+      updated_jacobian = true;
+    }
+
+    ApplyAssemblyStep (model, Q, cs.assembly_d, cs.assembly_q);
+    CalcConstraintsPositionError (model, cs.assembly_q, cs,
+                                  cs.assembly_e_trial);
+
+    // A factorization from an earlier configuration is only kept as long
+    // as the error converges fast enough. Otherwise the step is rejected
+    // and the system is factorized at the current positions.
+    if (!updated_jacobian
+        && cs.assembly_e_trial.norm() > 0.5 * cs.assembly_e.norm()) {
+      cs.assembly_factorization_valid = false;
+      continue;
+    }
+
+    Q = cs.assembly_q;
+    cs.assembly_e.swap (cs.assembly_e_trial);
 
     // Check if the error and the step are small enough to end.
-    if (e.norm() < tolerance && d.norm() < tolerance) {
-      Q = QInit;
+    if (cs.assembly_e.norm() < tolerance
+        && cs.assembly_d.norm() < tolerance) {
       return true;
     }
   }
 
   // Return false if maximum number of iterations is exceeded.
-  Q = QInit;
   return false;
 }
 #endif
 
 //==============================================================================
+#ifdef RBDL_USE_CASADI_MATH
 RBDL_DLLAPI
 void CalcAssemblyQDot (
   Model &model,
@@ -1054,6 +1387,7 @@ void CalcAssemblyQDot (
   const Math::VectorNd &weights
 )
 {
+  RBDL_TRACE_ALGORITHM ("CalcAssemblyQDot");
   if(QDot.size() != model.dof_count) {
     throw Errors::RBDLDofMismatchError("Incorrect QDot vector size.\n");
   }
@@ -1090,6 +1424,53 @@ void CalcAssemblyQDot (
   // Copy the result to the output variable.
   QDot = x.block (0, 0, model.dof_count, 1);
 }
+#else
+RBDL_DLLAPI
+void CalcAssemblyQDot (
+  Model &model,
+  const Math::VectorNd &Q,
+  const Math::VectorNd &QDotInit,
+  ConstraintSet &cs,
+  Math::VectorNd &QDot,
+  const Math::VectorNd &weights
+)
+{
+  RBDL_TRACE_ALGORITHM ("CalcAssemblyQDot");
+  if(QDot.size() != model.dof_count) {
+    throw Errors::RBDLDofMismatchError("Incorrect QDot vector size.\n");
+  }
+  if(Q.size() != model.q_size) {
+    throw Errors::RBDLDofMismatchError("Incorrect Q vector size.\n");
+  }
+  if(QDotInit.size() != QDot.size()) {
+    throw Errors::RBDLDofMismatchError("Incorrect QDotInit vector size.\n");
+  }
+  if(weights.size() != QDot.size()) {
+    throw Errors::RBDLDofMismatchError("Incorrect weight vector size.\n");
+  }
+
+  cs.assembly_factorization_count = 0;
+
+  if (weights.minCoeff() > 0.
+      && FactorizeAssemblySchurComplement (model, Q, cs, weights)) {
+    // QDot = QDotInit - W^-1 G^T (G W^-1 G^T)^-1 G QDotInit
+    cs.assembly_e.noalias() = cs.assembly_G * QDotInit;
+    cs.assembly_lambda = cs.assembly_ldlt.solve (cs.assembly_e);
+    QDot = QDotInit;
+    QDot.noalias() -= cs.assembly_WinvGT * cs.assembly_lambda;
+    return;
+  }
+
+  cs.assembly_G.setZero();
+  CalcConstraintsJacobian (model, Q, cs, cs.assembly_G);
+  cs.assembly_b.setZero();
+  cs.assembly_b.head(model.dof_count) = weights.cwiseProduct (QDotInit);
+  SolveAssemblyKKT (cs, weights);
+
+  // Copy the result to the output variable.
+  QDot = cs.assembly_x.head(model.dof_count);
+}
+#endif
 
 //==============================================================================
 RBDL_DLLAPI
@@ -1104,6 +1485,8 @@ void ForwardDynamicsConstraintsDirect (
   std::vector<Math::SpatialVector> *f_ext
 )
 {
+  RBDL_TRACE_ALGORITHM ("ForwardDynamicsConstraintsDirect");
+  RBDL_PERF_COUNTER ("ForwardDynamicsConstraintsDirect");
   RBDL_LOG << "-------- " << __func__ << " --------" << std::endl;
 
   CalcConstrainedSystemVariables (model, Q, QDot, Tau, CS, update_kinematics, 
@@ -1135,10 +1518,20 @@ void ForwardDynamicsConstraintsRangeSpaceSparse (
   bool update_kinematics,
   std::vector<Math::SpatialVector> *f_ext)
 {
+  RBDL_TRACE_ALGORITHM ("ForwardDynamicsConstraintsRangeSpaceSparse");
+  RBDL_PERF_COUNTER ("ForwardDynamicsConstraintsRangeSpaceSparse");
 
   CalcConstrainedSystemVariables (model, Q, QDot, Tau, CS, update_kinematics,
                                   f_ext);
 
+#ifndef RBDL_USE_CASADI_MATH
+  if (CS.linear_solver == LinearSolverSparseLTL) {
+    SolveConstrainedSystemSparseLTL (model, CS, Tau - CS.C, CS.gamma, QDDot,
+                                     CS.force);
+    return;
+  }
+#endif
+
   SolveConstrainedSystemRangeSpaceSparse (model, CS.H, CS.G, Tau - CS.C
                                           , CS.gamma, QDDot, CS.force, CS.K, CS.a, CS.linear_solver);
 }
@@ -1157,6 +1550,8 @@ void ForwardDynamicsConstraintsNullSpace (
   std::vector<Math::SpatialVector> *f_ext
 )
 {
+  RBDL_TRACE_ALGORITHM ("ForwardDynamicsConstraintsNullSpace");
+  RBDL_PERF_COUNTER ("ForwardDynamicsConstraintsNullSpace");
 
   RBDL_LOG << "-------- " << __func__ << " --------" << std::endl;
 
@@ -1185,6 +1580,7 @@ void ComputeConstraintImpulsesDirect (
   Math::VectorNd &QDotPlus
 )
 {
+  RBDL_TRACE_ALGORITHM ("ComputeConstraintImpulsesDirect");
 
   // Compute H
   UpdateKinematicsCustom (model, &Q, NULL, NULL);
@@ -1218,6 +1614,7 @@ void ComputeConstraintImpulsesRangeSpaceSparse (
   Math::VectorNd &QDotPlus
 )
 {
+  RBDL_TRACE_ALGORITHM ("ComputeConstraintImpulsesRangeSpaceSparse");
 
   // Compute H
   UpdateKinematicsCustom (model, &Q, NULL, NULL);
@@ -1226,6 +1623,14 @@ void ComputeConstraintImpulsesRangeSpaceSparse (
   // Compute G
   CalcConstraintsJacobian (model, Q, CS, CS.G, false);
 
+#ifndef RBDL_USE_CASADI_MATH
+  if (CS.linear_solver == LinearSolverSparseLTL) {
+    SolveConstrainedSystemSparseLTL (model, CS, CS.H * QDotMinus, CS.v_plus,
+                                     QDotPlus, CS.impulse);
+    return;
+  }
+#endif
+
   SolveConstrainedSystemRangeSpaceSparse (model, CS.H, CS.G, CS.H * QDotMinus
                                           , CS.v_plus, QDotPlus, CS.impulse, CS.K, CS.a, CS.linear_solver);
 
@@ -1242,6 +1647,7 @@ void ComputeConstraintImpulsesNullSpace (
   Math::VectorNd &QDotPlus
 )
 {
+  RBDL_TRACE_ALGORITHM ("ComputeConstraintImpulsesNullSpace");
 
   // Compute H
   UpdateKinematicsCustom (model, &Q, NULL, NULL);
@@ -1285,6 +1691,9 @@ void ForwardDynamicsApplyConstraintForces (
 
   unsigned int i = 0;
 
+  // the accelerations get overwritten
+  model.InvalidateKinematicsCache();
+
   for (i = 1; i < model.mBodies.size(); i++) {
     model.IA[i] = model.I[i].toMatrix();;
     model.pA[i] = crossf(model.v[i],model.I[i] * model.v[i]);
@@ -1460,6 +1869,11 @@ void ForwardDynamicsApplyConstraintForces (
     This function is essentially similar to ForwardDynamics() except that it
     tries to only perform computations of variables that change due to
     external forces defined in f_t.
+
+    The test forces f_t may act on all bodies up to body_id, the entries of
+    the bodies after body_id have to be zero. If Tau_t is given it is added
+    as generalized test force. In this case body_id has to be at least the
+    last body whose joint has a non-zero entry in Tau_t.
  */
 RBDL_DLLAPI
 void ForwardDynamicsAccelerationDeltas (
@@ -1467,7 +1881,8 @@ void ForwardDynamicsAccelerationDeltas (
   ConstraintSet &CS,
   VectorNd &QDDot_t,
   const unsigned int body_id,
-  const std::vector<SpatialVector> &f_t
+  const std::vector<SpatialVector> &f_t,
+  const VectorNd *Tau_t
 )
 {
   RBDL_LOG << "-------- " << __func__ << " ------" << std::endl;
@@ -1476,6 +1891,9 @@ void ForwardDynamicsAccelerationDeltas (
   assert (CS.d_a.size() == model.mBodies.size());
   assert (CS.d_u.size() == model.mBodies.size());
 
+  // the accelerations get overwritten
+  model.InvalidateKinematicsCache();
+
   // TODO reset all values (debug)
   for (unsigned int i = 0; i < model.mBodies.size(); i++) {
     CS.d_pA[i].setZero();
@@ -1488,13 +1906,26 @@ void ForwardDynamicsAccelerationDeltas (
   }
 
   for (unsigned int i = body_id; i > 0; i--) {
+#ifdef RBDL_USE_CASADI_MATH
     if (i == body_id) {
       CS.d_pA[i] = -model.X_base[i].applyAdjoint(f_t[i]);
     }
+#else
+    if (f_t[i] != SpatialVector::Zero()) {
+      CS.d_pA[i] -= model.X_base[i].applyAdjoint(f_t[i]);
+    }
+#endif
+
+    unsigned int q_index = model.mJoints[i].q_index;
 
     if (model.mJoints[i].mDoFCount == 3
         && model.mJoints[i].mJointType != JointTypeCustom) {
       CS.d_multdof3_u[i] = - model.multdof3_S[i].transpose() * (CS.d_pA[i]);
+      if (Tau_t != NULL) {
+        CS.d_multdof3_u[i] += Vector3d ((*Tau_t)[q_index],
+                                        (*Tau_t)[q_index + 1],
+                                        (*Tau_t)[q_index + 2]);
+      }
 
       unsigned int lambda = model.lambda[i];
       if (lambda != 0) {
@@ -1507,6 +1938,9 @@ void ForwardDynamicsAccelerationDeltas (
     } else if(model.mJoints[i].mDoFCount == 1
               && model.mJoints[i].mJointType != JointTypeCustom) {
       CS.d_u[i] = - model.S[i].dot(CS.d_pA[i]);
+      if (Tau_t != NULL) {
+        CS.d_u[i] += (*Tau_t)[q_index];
+      }
       unsigned int lambda = model.lambda[i];
 
       if (lambda != 0) {
@@ -1521,6 +1955,11 @@ void ForwardDynamicsAccelerationDeltas (
       //CS.
       model.mCustomJoints[kI]->d_u =
         - model.mCustomJoints[kI]->S.transpose() * (CS.d_pA[i]);
+      if (Tau_t != NULL) {
+        for (unsigned int z = 0; z < dofI; ++z) {
+          model.mCustomJoints[kI]->d_u[z] += (*Tau_t)[q_index + z];
+        }
+      }
       unsigned int lambda = model.lambda[i];
       if (lambda != 0) {
         CS.d_pA[lambda] =
@@ -1546,7 +1985,8 @@ void ForwardDynamicsAccelerationDeltas (
   }
 
   QDDot_t[0] = 0.;
-  CS.d_a[0] = model.a[0];
+  // the test forces do not change the acceleration of the base
+  CS.d_a[0].setZero();
 
   for (unsigned int i = 1; i < model.mBodies.size(); i++) {
     unsigned int q_index = model.mJoints[i].q_index;
@@ -1599,18 +2039,21 @@ inline void set_zero (std::vector<SpatialVector> &spatial_values)
 }
 
 //==============================================================================
-RBDL_DLLAPI
-void ForwardDynamicsContactsKokkevis (
+/** @brief Computes the default constraint accelerations CS.a and the matrix
+    CS.K of the contact system of ForwardDynamicsContactsKokkevis.
+
+    CS.K(i,j) is the change of the acceleration along the normal j that is
+    caused by a unit test force along the normal i, i.e. the negative
+    Delassus operator of the contacts.
+ */
+static void CalcContactSystemKokkevis (
   Model &model,
   const VectorNd &Q,
   const VectorNd &QDot,
   const VectorNd &Tau,
-  ConstraintSet &CS,
-  VectorNd &QDDot
+  ConstraintSet &CS
 )
 {
-  RBDL_LOG << "-------- " << __func__ << " ------" << std::endl;
-
   assert (CS.f_ext_constraints.size() == model.mBodies.size());
   assert (CS.QDDot_0.size() == model.dof_count);
   assert (CS.QDDot_t.size() == model.dof_count);
@@ -1629,6 +2072,10 @@ void ForwardDynamicsContactsKokkevis (
     throw Errors::RBDLError(errormsg.str());
   }
 
+  // ForwardDynamicsAccelerationDeltas applies the forces of all bodies, so
+  // the contact forces of the previous call must not remain.
+  set_zero (CS.f_ext_constraints);
+
   Vector3d point_accel_t;
 
   unsigned int ci = 0; //constraint index:
@@ -1696,7 +2143,8 @@ void ForwardDynamicsContactsKokkevis (
           << std::endl;
       {
         ForwardDynamicsAccelerationDeltas(model, CS, CS.QDDot_t
-                                          , movable_body_id, CS.f_ext_constraints);
+                                          , movable_body_id, CS.f_ext_constraints
+                                          , NULL);
 
         RBDL_LOG << "QDDot_0 = " << CS.QDDot_0.transpose() << std::endl;
         RBDL_LOG << "QDDot_t = " << (CS.QDDot_t + CS.QDDot_0).transpose()
@@ -1743,6 +2191,237 @@ void ForwardDynamicsContactsKokkevis (
 
   RBDL_LOG << "K = " << std::endl << CS.K << std::endl;
   RBDL_LOG << "a = " << std::endl << CS.a << std::endl;
+}
+
+//==============================================================================
+/** @brief Applies the contact forces CS.force of the system built by
+    CalcContactSystemKokkevis() and computes the resulting accelerations.
+ */
+static void ApplyContactForcesKokkevis (
+  Model &model,
+  const VectorNd &Tau,
+  ConstraintSet &CS,
+  VectorNd &QDDot
+)
+{
+  for(unsigned int bi=0; bi<CS.contactConstraints.size(); ++bi) {
+    unsigned int body_id =
+      CS.contactConstraints[bi]->getBodyIds()[0];
+    unsigned int movable_body_id = body_id;
+
+    if (model.IsFixedBodyId(body_id)) {
+      unsigned int fbody_id = body_id - model.fixed_body_discriminator;
+      movable_body_id = model.mFixedBodies[fbody_id].mMovableParent;
+    }
+    unsigned int ci = CS.contactConstraints[bi]->getConstraintIndex();
+
+    for(unsigned int k=0;
+        k<CS.contactConstraints[bi]->getConstraintSize(); ++k) {
+      CS.f_ext_constraints[movable_body_id] -= CS.f_t[ci+k] * CS.force[ci+k];
+      RBDL_LOG << "f_ext[" << movable_body_id << "] = "
+          << CS.f_ext_constraints[movable_body_id].transpose() << std::endl;
+    }
+
+  }
+
+
+
+  {
+    SUPPRESS_LOGGING;
+    ForwardDynamicsApplyConstraintForces (model, Tau, CS, QDDot);
+  }
+
+  RBDL_LOG << "QDDot after applying f_ext: " << QDDot.transpose() << std::endl;
+}
+
+#ifndef RBDL_USE_CASADI_MATH
+//==============================================================================
+/** @brief Computes the default constraint accelerations CS.a and the matrix
+    CS.K of ForwardDynamicsContactsKokkevis for arbitrary constraints.
+
+    The test forces of a row are the negative spatial forces of
+    Constraint::calcSpatialTestForces or, if a constraint does not provide
+    them, the negative row of G as generalized force. The change of the
+    constraint accelerations due to the spatial test forces of a row j is
+    the sum of the products of its forces with the acceleration changes of
+    the bodies, which avoids the evaluation of the full row of G.
+ */
+static void CalcConstraintSystemKokkevis (
+  Model &model,
+  const VectorNd &Q,
+  const VectorNd &QDot,
+  const VectorNd &Tau,
+  ConstraintSet &CS
+)
+{
+  {
+    SUPPRESS_LOGGING;
+    ForwardDynamics(model, Q, QDot, Tau, CS.QDDot_0);
+  }
+
+  // All constraints share the kinematics of their body points. The bias
+  // accelerations are computed once for all constraints.
+  ConstraintPointCacheScope point_cache_scope (CS.cache);
+  CS.QDDot_t.setZero();
+  UpdateKinematicsCustom(model, &Q, &QDot, &CS.QDDot_t);
+  point_cache_scope.setKinematicsLevel (3);
+
+  CalcConstraintsJacobian (model, Q, CS, CS.G, false);
+
+  unsigned int row = 0;
+  CS.test_force_bodies.clear();
+  CS.test_forces.clear();
+  CS.test_forces_body.clear();
+
+  for (unsigned int ci = 0; ci < CS.constraints.size(); ci++) {
+    Constraint *constraint = CS.constraints[ci].get();
+
+    constraint->calcGamma(model, 0, Q, QDot, CS.G, CS.gamma, CS.cache);
+    if (constraint->isBaumgarteStabilizationEnabled()) {
+      constraint->calcPositionError(model, 0, Q, CS.err, CS.cache);
+      constraint->calcVelocityError(model, 0, Q, QDot, CS.G, CS.errd,
+                                    CS.cache);
+      constraint->addInBaumgarteStabilizationForces(CS.err, CS.errd,
+          CS.gamma);
+    }
+
+    for (unsigned int k = 0; k < constraint->getConstraintSize(); k++) {
+      row = constraint->getConstraintIndex() + k;
+      CS.test_force_offsets[row] = CS.test_forces.size();
+      CS.test_force_spatial[row] = constraint->calcSpatialTestForces(model,
+                                   0, Q, k, CS.row_test_force_bodies,
+                                   CS.row_test_forces, CS.cache);
+
+      if (!CS.test_force_spatial[row]) {
+        continue;
+      }
+
+      for (unsigned int bi = 0; bi < CS.row_test_force_bodies.size(); bi++) {
+        unsigned int movable_body_id = GetMovableBodyId(model,
+                                       CS.row_test_force_bodies[bi]);
+
+        // forces on the ground do not affect the system
+        if (movable_body_id == 0) {
+          continue;
+        }
+
+        CS.test_force_bodies.push_back (movable_body_id);
+        CS.test_forces.push_back (CS.row_test_forces[bi]);
+        CS.test_forces_body.push_back (
+          model.X_base[movable_body_id].applyAdjoint (CS.row_test_forces[bi]));
+      }
+    }
+  }
+  CS.test_force_offsets[CS.size()] = CS.test_forces.size();
+
+  CS.a.noalias() = CS.G * CS.QDDot_0;
+  CS.a -= CS.gamma;
+
+  set_zero (CS.f_ext_constraints);
+  CS.tau_t.setZero();
+
+  for (unsigned int ri = 0; ri < CS.size(); ri++) {
+    if (CS.test_force_spatial[ri]) {
+      unsigned int last_body_id = 0;
+      for (unsigned int ti = CS.test_force_offsets[ri];
+           ti < CS.test_force_offsets[ri + 1]; ti++) {
+        CS.f_ext_constraints[CS.test_force_bodies[ti]] -= CS.test_forces[ti];
+        last_body_id = std::max (last_body_id, CS.test_force_bodies[ti]);
+      }
+
+      ForwardDynamicsAccelerationDeltas(model, CS, CS.QDDot_t, last_body_id,
+                                        CS.f_ext_constraints, NULL);
+
+      for (unsigned int ti = CS.test_force_offsets[ri];
+           ti < CS.test_force_offsets[ri + 1]; ti++) {
+        CS.f_ext_constraints[CS.test_force_bodies[ti]].setZero();
+      }
+    } else {
+      CS.tau_t = -CS.G.row(ri).transpose();
+      ForwardDynamicsAccelerationDeltas(model, CS, CS.QDDot_t,
+                                        model.mBodies.size() - 1,
+                                        CS.f_ext_constraints, &CS.tau_t);
+    }
+
+    for (unsigned int rj = 0; rj < CS.size(); rj++) {
+      if (CS.test_force_spatial[rj]) {
+        double accel = 0.;
+        for (unsigned int ti = CS.test_force_offsets[rj];
+             ti < CS.test_force_offsets[rj + 1]; ti++) {
+          accel += CS.test_forces_body[ti].dot(
+                     CS.d_a[CS.test_force_bodies[ti]]);
+        }
+        CS.K(ri, rj) = accel;
+      } else {
+        CS.K(ri, rj) = CS.G.row(rj).dot(CS.QDDot_t);
+      }
+    }
+  }
+
+  RBDL_LOG << "K = " << std::endl << CS.K << std::endl;
+  RBDL_LOG << "a = " << std::endl << CS.a << std::endl;
+}
+
+//==============================================================================
+/** @brief Applies the constraint forces CS.force of the system built by
+    CalcConstraintSystemKokkevis() and computes the resulting accelerations.
+ */
+static void ApplyConstraintForcesKokkevis (
+  Model &model,
+  const VectorNd &Tau,
+  ConstraintSet &CS,
+  VectorNd &QDDot
+)
+{
+  set_zero (CS.f_ext_constraints);
+  CS.tau_t = Tau;
+
+  for (unsigned int ri = 0; ri < CS.size(); ri++) {
+    if (CS.test_force_spatial[ri]) {
+      for (unsigned int ti = CS.test_force_offsets[ri];
+           ti < CS.test_force_offsets[ri + 1]; ti++) {
+        CS.f_ext_constraints[CS.test_force_bodies[ti]] +=
+          CS.test_forces[ti] * CS.force[ri];
+      }
+    } else {
+      CS.tau_t += CS.G.row(ri).transpose() * CS.force[ri];
+    }
+  }
+
+  {
+    SUPPRESS_LOGGING;
+    ForwardDynamicsApplyConstraintForces (model, CS.tau_t, CS, QDDot);
+  }
+
+  RBDL_LOG << "QDDot after applying f_ext: " << QDDot.transpose() << std::endl;
+}
+#endif
+
+//==============================================================================
+RBDL_DLLAPI
+void ForwardDynamicsContactsKokkevis (
+  Model &model,
+  const VectorNd &Q,
+  const VectorNd &QDot,
+  const VectorNd &Tau,
+  ConstraintSet &CS,
+  VectorNd &QDDot
+)
+{
+  RBDL_TRACE_ALGORITHM ("ForwardDynamicsContactsKokkevis");
+  RBDL_LOG << "-------- " << __func__ << " ------" << std::endl;
+
+  bool contacts_only =
+    CS.constraints.size() == CS.contactConstraints.size();
+
+#ifndef RBDL_USE_CASADI_MATH
+  if (!contacts_only) {
+    CalcConstraintSystemKokkevis (model, Q, QDot, Tau, CS);
+  } else
+#endif
+  {
+    CalcContactSystemKokkevis (model, Q, QDot, Tau, CS);
+  }
 
 #ifdef RBDL_USE_CASADI_MATH
     auto linsol = casadi::Linsol("linear_solver", "symbolicqr", CS.K.sparsity());
@@ -1767,37 +2446,152 @@ void ForwardDynamicsContactsKokkevis (
 
   RBDL_LOG << "f = " << CS.force.transpose() << std::endl;
 
+#ifndef RBDL_USE_CASADI_MATH
+  if (!contacts_only) {
+    ApplyConstraintForcesKokkevis (model, Tau, CS, QDDot);
+    return;
+  }
+#endif
 
-  for(bi=0; bi<CS.contactConstraints.size(); ++bi) {
-    unsigned int body_id =
-      CS.contactConstraints[bi]->getBodyIds()[0];
-    unsigned int movable_body_id = body_id;
+  ApplyContactForcesKokkevis (model, Tau, CS, QDDot);
+}
 
-    if (model.IsFixedBodyId(body_id)) {
-      unsigned int fbody_id = body_id - model.fixed_body_discriminator;
-      movable_body_id = model.mFixedBodies[fbody_id].mMovableParent;
-    }
-    ci = CS.contactConstraints[bi]->getConstraintIndex();
+//==============================================================================
+#ifndef RBDL_USE_CASADI_MATH
+RBDL_DLLAPI
+void ForwardDynamicsContactsPGS (
+  Model &model,
+  const VectorNd &Q,
+  const VectorNd &QDot,
+  const VectorNd &Tau,
+  ConstraintSet &CS,
+  VectorNd &QDDot
+)
+{
+  RBDL_TRACE_ALGORITHM ("ForwardDynamicsContactsPGS");
+  RBDL_PERF_COUNTER ("ForwardDynamicsContactsPGS");
+  RBDL_LOG << "-------- " << __func__ << " ------" << std::endl;
 
-    for(unsigned int k=0;
-        k<CS.contactConstraints[bi]->getConstraintSize(); ++k) {
-      CS.f_ext_constraints[movable_body_id] -= CS.f_t[ci+k] * CS.force[ci+k];
-      RBDL_LOG << "f_ext[" << movable_body_id << "] = "
-          << CS.f_ext_constraints[movable_body_id].transpose() << std::endl;
+  CalcContactSystemKokkevis (model, Q, QDot, Tau, CS);
+
+  // The constraint accelerations are CS.a - CS.K^T * CS.force. Each sweep
+  // sets the acceleration of one row after another to zero and projects the
+  // force onto its admissible set. The first row of every contact is its
+  // normal and precedes the friction rows so that their bounds always use
+  // the current normal force.
+  CS.pgs_iterations = 0;
+  bool converged = false;
+
+  while (!converged && CS.pgs_iterations < CS.pgs_max_iterations) {
+    double max_force_change = 0.;
+
+    for (unsigned int bi = 0; bi < CS.contactConstraints.size(); bi++) {
+      unsigned int ci = CS.contactConstraints[bi]->getConstraintIndex();
+      double mu = CS.contactConstraints[bi]->getFrictionCoefficient();
+
+      for (unsigned int k = 0;
+          k < CS.contactConstraints[bi]->getConstraintSize(); k++) {
+        unsigned int row = ci + k;
+        double force = CS.force[row];
+
+        // rows with a vanishing diagonal (e.g. points on fixed bodies)
+        // cannot be influenced by their own force
+        if (CS.K(row, row) < 0.) {
+          double accel = CS.a[row] - CS.K.col(row).dot(CS.force);
+          force = force + accel / CS.K(row, row);
+        }
+
+        if (k == 0) {
+          if (force < 0.) {
+            force = 0.;
+          }
+        } else {
+          double limit = 0.;
+          if (CS.force[ci] > 0.) {
+            limit = mu * CS.force[ci];
+          }
+          if (force > limit) {
+            force = limit;
+          } else if (force < -limit) {
+            force = -limit;
+          }
+        }
+
+        max_force_change = std::max (max_force_change,
+            static_cast<double>(std::fabs (force - CS.force[row])));
+        CS.force[row] = force;
+      }
     }
 
+    CS.pgs_iterations++;
+    converged = max_force_change <= CS.pgs_tolerance;
   }
 
+  RBDL_PERF_COUNT_ITERATIONS (CS.pgs_iterations);
+  RBDL_LOG << "f = " << CS.force.transpose() << std::endl;
+  RBDL_LOG << "PGS iterations = " << CS.pgs_iterations << std::endl;
 
+  ApplyContactForcesKokkevis (model, Tau, CS, QDDot);
+}
+#endif
 
-  {
-    SUPPRESS_LOGGING;
-    ForwardDynamicsApplyConstraintForces (model, Tau, CS, QDDot);
+
+//==============================================================================
+// The selection matrices S and P of the actuation map only pick rows and
+// columns, so instead of multiplying with them the entries are gathered and
+// scattered with the index lists of the ConstraintSet.
+
+// Out(row_offset + i, col_offset + j) = M(rows[i], cols[j])
+static void GatherBlock (
+  const MatrixNd &M,
+  const std::vector<unsigned int> &rows,
+  const std::vector<unsigned int> &cols,
+  MatrixNd &Out,
+  unsigned int row_offset = 0,
+  unsigned int col_offset = 0)
+{
+  for(unsigned int i=0; i<rows.size(); ++i) {
+    for(unsigned int j=0; j<cols.size(); ++j) {
+      Out(row_offset+i, col_offset+j) = M(rows[i], cols[j]);
+    }
   }
+}
 
-  RBDL_LOG << "QDDot after applying f_ext: " << QDDot.transpose() << std::endl;
+// Out(row_offset + i, k) = M(k, cols[i]), i.e. the rows of S * M^T
+static void GatherTransposedColumns (
+  const MatrixNd &M,
+  const std::vector<unsigned int> &cols,
+  MatrixNd &Out,
+  unsigned int row_offset = 0)
+{
+  for(unsigned int i=0; i<cols.size(); ++i) {
+    for(unsigned int k=0; k<M.rows(); ++k) {
+      Out(row_offset+i, k) = M(k, cols[i]);
+    }
+  }
 }
 
+// Out[i] = x[indices[i]], i.e. S * x
+static void GatherVector (
+  const VectorNd &x,
+  const std::vector<unsigned int> &indices,
+  VectorNd &Out)
+{
+  for(unsigned int i=0; i<indices.size(); ++i) {
+    Out[i] = x[indices[i]];
+  }
+}
+
+// Out[indices[i]] = x[i], i.e. S^T * x for the entries of indices
+static void ScatterVector (
+  const VectorNd &x,
+  const std::vector<unsigned int> &indices,
+  VectorNd &Out)
+{
+  for(unsigned int i=0; i<indices.size(); ++i) {
+    Out[indices[i]] = x[i];
+  }
+}
 
 //==============================================================================
 #ifndef RBDL_USE_CASADI_MATH
@@ -1818,14 +2612,17 @@ bool isConstrainedSystemFullyActuated(
 
   unsigned int n  = unsigned(    CS.H.rows());
   unsigned int nc = unsigned( CS.name.size());
-  unsigned int na = unsigned(    CS.S.rows());
+  unsigned int na = unsigned( CS.actuated_dof_indices.size());
   unsigned int nu = n-na;
 
 
   CalcConstrainedSystemVariables(model,Q,QDot,VectorNd::Zero(QDot.rows()),CS,
                                  update_kinematics, f_ext);
 
-  CS.GPT = CS.G*CS.P.transpose();
+  // GPT = G * P^T
+  for(unsigned int i=0; i<nu; ++i) {
+    CS.GPT.col(i) = CS.G.col(CS.unactuated_dof_indices[i]);
+  }
 
   CS.GPT_full_qr.compute(CS.GPT);
   unsigned int r = unsigned(CS.GPT_full_qr.rank());
@@ -1854,6 +2651,7 @@ void InverseDynamicsConstraints(
   bool update_kinematics,
   std::vector<Math::SpatialVector> *f_ext)
 {
+  RBDL_TRACE_ALGORITHM ("InverseDynamicsConstraints");
 
   RBDL_LOG << "-------- " << __func__ << " ------" << std::endl;
 
@@ -1866,9 +2664,12 @@ void InverseDynamicsConstraints(
 
   unsigned int n  = unsigned(    CS.H.rows());
   unsigned int nc = unsigned( CS.name.size());
-  unsigned int na = unsigned(    CS.S.rows());
+  unsigned int na = unsigned( CS.actuated_dof_indices.size());
   unsigned int nu = n-na;
 
+  const std::vector<unsigned int> &actuated   = CS.actuated_dof_indices;
+  const std::vector<unsigned int> &unactuated = CS.unactuated_dof_indices;
+
   TauOutput.setZero();
   CalcConstrainedSystemVariables(model,Q,QDot,TauOutput,CS,update_kinematics,
                                 f_ext);
@@ -1882,18 +2683,18 @@ void InverseDynamicsConstraints(
   //  [ I                         ][   -tau]   [  v*     ]
   //double alpha = 0.1;
 
-  CS.Ful = CS.S*CS.H*CS.S.transpose();
-  CS.Fur = CS.S*CS.H*CS.P.transpose();
-  CS.Fll = CS.P*CS.H*CS.S.transpose();
-  CS.Flr = CS.P*CS.H*CS.P.transpose();
+  GatherBlock(CS.H, actuated,   actuated,   CS.Ful);
+  GatherBlock(CS.H, actuated,   unactuated, CS.Fur);
+  GatherBlock(CS.H, unactuated, actuated,   CS.Fll);
+  GatherBlock(CS.H, unactuated, unactuated, CS.Flr);
 
-  CS.GTu = CS.S*(CS.G.transpose());
-  CS.GTl = CS.P*(CS.G.transpose());
+  GatherTransposedColumns(CS.G, actuated,   CS.GTu);
+  GatherTransposedColumns(CS.G, unactuated, CS.GTl);
 
   //Exploiting the block triangular structure
   //u:
   //I u = S*qdd*
-  CS.u = CS.S*QDDotDesired;
+  GatherVector(QDDotDesired, actuated, CS.u);
   // v
   //(JP')v = -gamma - (JS')u
   //Using GT
@@ -1904,8 +2705,9 @@ void InverseDynamicsConstraints(
                      CS.v, CS.linear_solver);
 
   // lambda
+  GatherVector(CS.C, unactuated, CS.PC);
   SolveLinearSystem(CS.GTl,
-                    -CS.P*CS.C
+                    -CS.PC
                     - CS.Fll*CS.u
                     - CS.Flr*CS.v,
                     CS.force,
@@ -1916,13 +2718,14 @@ void InverseDynamicsConstraints(
   }
 
   //Evaluating qdd
-  QDDotOutput = CS.S.transpose()*CS.u + CS.P.transpose()*CS.v;
+  ScatterVector(CS.u, actuated,   QDDotOutput);
+  ScatterVector(CS.v, unactuated, QDDotOutput);
 
   //Evaluating tau
-  TauOutput = -CS.S.transpose()*( -CS.S*CS.C
-                                  -( CS.Ful*CS.u
-                                     +CS.Fur*CS.v
-                                     -CS.GTu*CS.force));
+  GatherVector(CS.C, actuated, CS.SC);
+  TauOutput.setZero();
+  ScatterVector(CS.SC + CS.Ful*CS.u + CS.Fur*CS.v - CS.GTu*CS.force,
+                actuated, TauOutput);
 
 
 
@@ -1942,6 +2745,7 @@ void InverseDynamicsConstraintsRelaxed(
   bool update_kinematics,
   std::vector<Math::SpatialVector> *f_ext)
 {
+  RBDL_TRACE_ALGORITHM ("InverseDynamicsConstraintsRelaxed");
   RBDL_LOG << "-------- " << __func__ << " --------" << std::endl;
 
   //Check that the input vectors and matricies are sized appropriately
@@ -1959,9 +2763,12 @@ void InverseDynamicsConstraintsRelaxed(
 
   unsigned int n  = unsigned(    CS.H.rows());
   unsigned int nc = unsigned( CS.name.size());
-  unsigned int na = unsigned(    CS.S.rows());
+  unsigned int na = unsigned( CS.actuated_dof_indices.size());
   unsigned int nu = n-na;
 
+  const std::vector<unsigned int> &actuated   = CS.actuated_dof_indices;
+  const std::vector<unsigned int> &unactuated = CS.unactuated_dof_indices;
+
   //MM 2020/5/29:
   //  The updates I made to Henning's original formulation have
   //  almost certainly made the sensitivity of the resulting qdd
@@ -1986,19 +2793,23 @@ void InverseDynamicsConstraintsRelaxed(
   //  CS.Winv(i,i) = diagInv;
   //}
 
-  CS.W = 100.0*CS.S*CS.H*CS.S.transpose();
+  GatherVector(CS.C, actuated, CS.SC);
+
+  GatherBlock(CS.H, actuated, actuated, CS.Ful);
+  CS.W = 100.0*CS.Ful;
   CS.Winv = CS.W.inverse();
-  CS.WinvSC = CS.Winv * CS.S * CS.C;
+  CS.WinvSC.noalias() = CS.Winv * CS.SC;
 
   //CS.W = CS.S*CS.H*CS.S.transpose();
 
-  CS.F.block(  0,  0, na, na) = CS.S*CS.H*CS.S.transpose() + CS.W;
-  CS.F.block(  0, na, na, nu) = CS.S*CS.H*CS.P.transpose();
-  CS.F.block( na,  0, nu, na) = CS.P*CS.H*CS.S.transpose();
-  CS.F.block( na, na, nu, nu) = CS.P*CS.H*CS.P.transpose();
+  GatherBlock(CS.H, actuated,   actuated,   CS.F);
+  GatherBlock(CS.H, actuated,   unactuated, CS.F,  0, na);
+  GatherBlock(CS.H, unactuated, actuated,   CS.F, na,  0);
+  GatherBlock(CS.H, unactuated, unactuated, CS.F, na, na);
+  CS.F.block(  0,  0, na, na) += CS.W;
 
-  CS.GT.block(  0, 0,na, nc) = CS.S*(CS.G.transpose());
-  CS.GT.block( na, 0,nu, nc) = CS.P*(CS.G.transpose());
+  GatherTransposedColumns(CS.G, actuated,   CS.GT);
+  GatherTransposedColumns(CS.G, unactuated, CS.GT, na);
 
   CS.GT_qr.compute (CS.GT);
   CS.GT_qr.householderQ().evalTo (CS.GT_qr_Q);
@@ -2024,16 +2835,18 @@ void InverseDynamicsConstraintsRelaxed(
   //    +SC - WS( qdd* + (S' W^-1 S)N )
   //
 
-  CS.u = CS.S*CS.C - CS.W*(CS.S*(QDDotControls
-                                 +(CS.S.transpose()*CS.WinvSC)));
+  GatherVector(QDDotControls, actuated, CS.SQDDotControls);
+  CS.SQDDotControls += CS.WinvSC;
+  CS.u = CS.SC;
+  CS.u.noalias() -= CS.W*CS.SQDDotControls;
   //CS.u =  CS.S*CS.C - CS.W*(CS.S*QDDotControls);
-  CS.v =  CS.P*CS.C;
+  GatherVector(CS.C, unactuated, CS.v);
 
-  for(unsigned int i=0; i<CS.S.rows(); ++i) {
+  for(unsigned int i=0; i<na; ++i) {
     CS.g[i] = CS.u[i];
   }
-  unsigned int j=CS.S.rows();
-  for(unsigned int i=0; i<CS.P.rows(); ++i) {
+  unsigned int j=na;
+  for(unsigned int i=0; i<nu; ++i) {
     CS.g[j] = CS.v[i];
     ++j;
   }
@@ -2056,21 +2869,22 @@ void InverseDynamicsConstraintsRelaxed(
   // p = Ypy + Zpz = [v,w]
   // qdd = S'v + P'w
   QDDotOutput = CS.Y*CS.py + CS.Z*CS.pz;
-  for(unsigned int i=0; i<CS.S.rows(); ++i) {
+  for(unsigned int i=0; i<na; ++i) {
     CS.u[i] = QDDotOutput[i];
   }
-  j = CS.S.rows();
-  for(unsigned int i=0; i<CS.P.rows(); ++i) {
+  j = na;
+  for(unsigned int i=0; i<nu; ++i) {
     CS.v[i] = QDDotOutput[j];
     ++j;
   }
 
-  QDDotOutput = CS.S.transpose()*CS.u
-                +CS.P.transpose()*CS.v;
+  ScatterVector(CS.u, actuated,   QDDotOutput);
+  ScatterVector(CS.v, unactuated, QDDotOutput);
 
-  TauOutput = (CS.S.transpose()*CS.W*CS.S)*(
-                QDDotControls+(CS.S.transpose()*CS.WinvSC)
-                -QDDotOutput);
+  TauOutput.setZero();
+  CS.SQDDotControls -= CS.u;
+  CS.SC.noalias() = CS.W*CS.SQDDotControls;
+  ScatterVector(CS.SC, actuated, TauOutput);
   //TauOutput =  CS.S.transpose()*CS.W*CS.S*(QDDotControls - QDDotOutput);
 
 
@@ -2258,5 +3072,312 @@ void ConstraintSet::calcBaumgarteStabilizationForces(
       baumgarteForces);
 
 }
+//==============================================================================
+
+void ConstraintSet::setContactFrictionCoefficient(
+  unsigned int groupIndex,
+  double frictionCoefficient)
+{
+  assert(groupIndex <= unsigned(constraints.size()-1));
+
+  std::shared_ptr<ContactConstraint> contactConstraint =
+    std::dynamic_pointer_cast<ContactConstraint>(constraints[groupIndex]);
+
+  if (!contactConstraint) {
+    std::ostringstream errormsg;
+    errormsg << "Error: constraint " << groupIndex
+             << " is not a ContactConstraint and has no friction coefficient"
+             << std::endl;
+    throw Errors::RBDLError(errormsg.str());
+  }
+
+  contactConstraint->setFrictionCoefficient(frictionCoefficient);
+}
+
+//==============================================================================
+
+void ConstraintCache::beginPointCache()
+{
+  pointCacheActive = true;
+  bodyKinematicsCount = 0;
+  pointKinematicsCount = 0;
+  kinematicsLevel = 0;
+}
+
+void ConstraintCache::endPointCache()
+{
+  pointCacheActive = false;
+}
+
+unsigned int ConstraintCache::findBodyKinematics(unsigned int bodyId)
+{
+  for(unsigned int i=0; i<bodyKinematicsCount; ++i) {
+    if(bodyKinematics[i].bodyId == bodyId) {
+      return i;
+    }
+  }
+
+  if(bodyKinematicsCount == bodyKinematics.size()) {
+    bodyKinematics.push_back(ConstraintBodyKinematics());
+  }
+
+  ConstraintBodyKinematics &body = bodyKinematics[bodyKinematicsCount];
+  body.bodyId = bodyId;
+  body.hasFrame = false;
+  body.hasJacobian = false;
+  body.hasVelocity = false;
+  body.hasBiasAcceleration = false;
+
+  return bodyKinematicsCount++;
+}
+
+unsigned int ConstraintCache::findPointKinematics(
+  unsigned int bodyId,
+  const Math::Vector3d &bodyPoint)
+{
+  //Without an active cache every request starts from scratch
+  if(!pointCacheActive) {
+    bodyKinematicsCount = 0;
+    pointKinematicsCount = 0;
+  }
+
+#ifndef RBDL_USE_CASADI_MATH
+  for(unsigned int i=0; i<pointKinematicsCount; ++i) {
+    if(bodyKinematics[pointKinematics[i].bodyIndex].bodyId == bodyId
+        && pointKinematics[i].bodyPoint == bodyPoint) {
+      return i;
+    }
+  }
+#endif
+
+  if(pointKinematicsCount == pointKinematics.size()) {
+    pointKinematics.push_back(ConstraintPointKinematics());
+  }
+
+  ConstraintPointKinematics &point = pointKinematics[pointKinematicsCount];
+  point.bodyIndex = findBodyKinematics(bodyId);
+  point.bodyPoint = bodyPoint;
+  point.hasPosition = false;
+  point.hasJacobian = false;
+  point.hasVelocity = false;
+  point.hasBiasAcceleration = false;
+
+  return pointKinematicsCount++;
+}
+
+bool ConstraintCache::updateKinematicsTo(bool updateKinematics,
+    unsigned int level)
+{
+  if(!pointCacheActive) {
+    return updateKinematics;
+  }
+
+  //The model state does not change while the cache is active, thus the
+  //kinematics only have to be updated once
+  if(!updateKinematics || kinematicsLevel >= level) {
+    return false;
+  }
+
+  kinematicsLevel = level;
+  return true;
+}
+
+void ConstraintCache::calcBodyFrame(Model &model,
+                                    const Math::VectorNd &Q,
+                                    ConstraintBodyKinematics &body,
+                                    bool updateKinematics)
+{
+  if(body.hasFrame) {
+    return;
+  }
+
+  body.orientation = CalcBodyWorldOrientation(model, Q, body.bodyId,
+                     updateKinematicsTo(updateKinematics, 1));
+  body.position = CalcBodyToBaseCoordinates(model, Q, body.bodyId,
+                  Vector3dZero, false);
+  body.hasFrame = true;
+}
+
+void ConstraintCache::calcPointOffset(Model &model,
+                                      const Math::VectorNd &Q,
+                                      ConstraintPointKinematics &point,
+                                      bool updateKinematics)
+{
+  if(point.hasPosition) {
+    return;
+  }
+
+  ConstraintBodyKinematics &body = bodyKinematics[point.bodyIndex];
+  calcBodyFrame(model, Q, body, updateKinematics);
+
+  point.offset = body.orientation.transpose()*point.bodyPoint;
+  point.position = body.position + point.offset;
+  point.hasPosition = true;
+}
+
+const Math::Vector3d& ConstraintCache::getPointPosition(
+  Model &model,
+  const Math::VectorNd &Q,
+  unsigned int bodyId,
+  const Math::Vector3d &bodyPoint,
+  bool updateKinematics)
+{
+  ConstraintPointKinematics &point =
+    pointKinematics[findPointKinematics(bodyId, bodyPoint)];
+
+  calcPointOffset(model, Q, point, updateKinematics);
+
+  return point.position;
+}
+
+const Math::Matrix3d& ConstraintCache::getBodyWorldOrientation(
+  Model &model,
+  const Math::VectorNd &Q,
+  unsigned int bodyId,
+  bool updateKinematics)
+{
+  if(!pointCacheActive) {
+    bodyKinematicsCount = 0;
+    pointKinematicsCount = 0;
+  }
+
+  ConstraintBodyKinematics &body = bodyKinematics[findBodyKinematics(bodyId)];
+  calcBodyFrame(model, Q, body, updateKinematics);
+
+  return body.orientation;
+}
+
+const Math::MatrixNd& ConstraintCache::getPointJacobian6D(
+  Model &model,
+  const Math::VectorNd &Q,
+  unsigned int bodyId,
+  const Math::Vector3d &bodyPoint,
+  bool updateKinematics)
+{
+  ConstraintPointKinematics &point =
+    pointKinematics[findPointKinematics(bodyId, bodyPoint)];
+
+  if(point.hasJacobian) {
+    return point.jacobian6D;
+  }
+
+  if(point.jacobian6D.rows() != 6 || point.jacobian6D.cols() != model.qdot_size) {
+    point.jacobian6D.resize(6, model.qdot_size);
+  }
+
+#ifdef RBDL_USE_CASADI_MATH
+  point.jacobian6D.setZero();
+  CalcPointJacobian6D(model, Q, bodyId, bodyPoint, point.jacobian6D,
+                      updateKinematics);
+#else
+  ConstraintBodyKinematics &body = bodyKinematics[point.bodyIndex];
+
+  if(!body.hasJacobian) {
+    if(body.jacobian6D.rows() != 6
+        || body.jacobian6D.cols() != model.qdot_size) {
+      body.jacobian6D.resize(6, model.qdot_size);
+    }
+    body.jacobian6D.setZero();
+    CalcPointJacobian6D(model, Q, bodyId, Vector3dZero, body.jacobian6D,
+                        updateKinematicsTo(updateKinematics, 1));
+    body.hasJacobian = true;
+  }
+  calcPointOffset(model, Q, point, false);
+
+  // The linear velocity of the point is v + omega x offset
+  point.jacobian6D = body.jacobian6D;
+  point.jacobian6D.block(3, 0, 3, model.qdot_size).noalias() -=
+    VectorCrossMatrix(point.offset)
+    * body.jacobian6D.block(0, 0, 3, model.qdot_size);
+#endif
+
+  point.hasJacobian = pointCacheActive;
+  return point.jacobian6D;
+}
+
+const Math::SpatialVector& ConstraintCache::getPointVelocity6D(
+  Model &model,
+  const Math::VectorNd &Q,
+  const Math::VectorNd &QDot,
+  unsigned int bodyId,
+  const Math::Vector3d &bodyPoint,
+  bool updateKinematics)
+{
+  ConstraintPointKinematics &point =
+    pointKinematics[findPointKinematics(bodyId, bodyPoint)];
+
+  if(point.hasVelocity) {
+    return point.velocity6D;
+  }
+
+#ifdef RBDL_USE_CASADI_MATH
+  point.velocity6D = CalcPointVelocity6D(model, Q, QDot, bodyId, bodyPoint,
+                                         updateKinematics);
+#else
+  ConstraintBodyKinematics &body = bodyKinematics[point.bodyIndex];
+
+  if(!body.hasVelocity) {
+    body.velocity6D = CalcPointVelocity6D(model, Q, QDot, bodyId,
+                                          Vector3dZero,
+                                          updateKinematicsTo(updateKinematics, 2));
+    body.hasVelocity = true;
+  }
+  calcPointOffset(model, Q, point, false);
+
+  Vector3d omega = body.velocity6D.block<3,1>(0,0);
+  point.velocity6D = body.velocity6D;
+  point.velocity6D.block<3,1>(3,0) += omega.cross(point.offset);
+#endif
+
+  point.hasVelocity = pointCacheActive;
+  return point.velocity6D;
+}
+
+const Math::SpatialVector& ConstraintCache::getPointBiasAcceleration6D(
+  Model &model,
+  const Math::VectorNd &Q,
+  const Math::VectorNd &QDot,
+  unsigned int bodyId,
+  const Math::Vector3d &bodyPoint,
+  bool updateKinematics)
+{
+  ConstraintPointKinematics &point =
+    pointKinematics[findPointKinematics(bodyId, bodyPoint)];
+
+  if(point.hasBiasAcceleration) {
+    return point.biasAcceleration6D;
+  }
+
+#ifdef RBDL_USE_CASADI_MATH
+  point.biasAcceleration6D = CalcPointAcceleration6D(model, Q, QDot,
+                             vecNZeros, bodyId, bodyPoint, updateKinematics);
+#else
+  ConstraintBodyKinematics &body = bodyKinematics[point.bodyIndex];
+
+  if(!body.hasBiasAcceleration) {
+    body.biasAcceleration6D = CalcPointAcceleration6D(model, Q, QDot,
+                              vecNZeros, bodyId, Vector3dZero,
+                              updateKinematicsTo(updateKinematics, 3));
+    body.hasBiasAcceleration = true;
+  }
+  if(!body.hasVelocity) {
+    body.velocity6D = CalcPointVelocity6D(model, Q, QDot, bodyId,
+                                          Vector3dZero, false);
+    body.hasVelocity = true;
+  }
+  calcPointOffset(model, Q, point, false);
+
+  // The classical acceleration of the point is
+  // a + omegadot x offset + omega x (omega x offset)
+  Vector3d omega = body.velocity6D.block<3,1>(0,0);
+  Vector3d omega_dot = body.biasAcceleration6D.block<3,1>(0,0);
+  point.biasAcceleration6D = body.biasAcceleration6D;
+  point.biasAcceleration6D.block<3,1>(3,0) += omega_dot.cross(point.offset)
+      + omega.cross(omega.cross(point.offset));
+#endif
+
+  point.hasBiasAcceleration = pointCacheActive;
+  return point.biasAcceleration6D;
+}
 
 } /* namespace RigidBodyDynamics */
@@ -5,13 +5,16 @@
  * Licensed under the zlib license. See LICENSE for more details.
  */
 
+#include <algorithm>
 #include <iostream>
 #include <limits>
 #include <assert.h>
 #include <string.h>
+#include <sstream>
 
 #include "rbdl/rbdl_mathutils.h"
 #include "rbdl/Logging.h"
+#include "rbdl/PerformanceCounters.h"
 
 #include "rbdl/Model.h"
 #include "rbdl/Joint.h"
@@ -24,36 +27,39 @@ namespace RigidBodyDynamics {
 using namespace Math;
 
 RBDL_DLLAPI void InverseDynamics (
-    Model &model,
+    const Model &model,
+    ModelData &data,
     const VectorNd &Q,
     const VectorNd &QDot,
     const VectorNd &QDDot,
     VectorNd &Tau,
     std::vector<SpatialVector> *f_ext) {
+  RBDL_TRACE_ALGORITHM ("InverseDynamics");
+  RBDL_PERF_COUNTER ("InverseDynamics");
   RBDL_LOG << "-------- " << __func__ << " --------" << std::endl;
 
   // Reset the velocity of the root body
-  model.v[0].setZero();
-  model.a[0].set (0., 0., 0., -model.gravity[0], -model.gravity[1], -model.gravity[2]);
+  data.v[0].setZero();
+  data.a[0].set (0., 0., 0., -model.gravity[0], -model.gravity[1], -model.gravity[2]);
 
   for (unsigned int i = 1; i < model.mBodies.size(); i++) {
     unsigned int q_index = model.mJoints[i].q_index;
     unsigned int lambda = model.lambda[i];
 
-    jcalc (model, i, Q, QDot);
+    jcalc (model, data, i, Q, QDot);
 
-    model.v[i] = model.X_lambda[i].apply(model.v[lambda]) + model.v_J[i];
-    model.c[i] = model.c_J[i] + crossm(model.v[i],model.v_J[i]);
+    data.v[i] = data.X_lambda[i].apply(data.v[lambda]) + data.v_J[i];
+    data.c[i] = data.c_J[i] + crossm(data.v[i],data.v_J[i]);
 
     if(model.mJoints[i].mJointType != JointTypeCustom){
       if (model.mJoints[i].mDoFCount == 1) {
-        model.a[i] =  model.X_lambda[i].apply(model.a[lambda])
-          + model.c[i]
-          + model.S[i] * QDDot[q_index];
+        data.a[i] =  data.X_lambda[i].apply(data.a[lambda])
+          + data.c[i]
+          + data.S[i] * QDDot[q_index];
       } else if (model.mJoints[i].mDoFCount == 3) {
-        model.a[i] =  model.X_lambda[i].apply(model.a[lambda])
-          + model.c[i]
-          + model.multdof3_S[i] * Vector3d (QDDot[q_index],
+        data.a[i] =  data.X_lambda[i].apply(data.a[lambda])
+          + data.c[i]
+          + data.multdof3_S[i] * Vector3d (QDDot[q_index],
               QDDot[q_index + 1],
               QDDot[q_index + 2]);
       }
@@ -63,87 +69,101 @@ RBDL_DLLAPI void InverseDynamics (
       for(unsigned z = 0; z < model.mCustomJoints[k]->mDoFCount; ++z){
         customJointQDDot[z] = QDDot[q_index+z];
       }
-      model.a[i] =  model.X_lambda[i].apply(model.a[lambda])
-        + model.c[i]
+      data.a[i] =  data.X_lambda[i].apply(data.a[lambda])
+        + data.c[i]
         + model.mCustomJoints[k]->S * customJointQDDot;
     }
 
     if (!model.mBodies[i].mIsVirtual) {
-      model.f[i] = model.I[i] * model.a[i] + crossf(model.v[i],model.I[i] * model.v[i]);
+      data.f[i] = model.I[i] * data.a[i] + crossf(data.v[i],model.I[i] * data.v[i]);
     } else {
-      model.f[i].setZero();
+      data.f[i].setZero();
     }
   }
 
   if (f_ext != NULL) {
     for (unsigned int i = 1; i < model.mBodies.size(); i++) {
       unsigned int lambda = model.lambda[i];
-      model.X_base[i] = model.X_lambda[i] * model.X_base[lambda];
-      model.f[i] -= model.X_base[i].toMatrixAdjoint() * (*f_ext)[i];
+      data.X_base[i] = data.X_lambda[i] * data.X_base[lambda];
+      data.f[i] -= data.X_base[i].toMatrixAdjoint() * (*f_ext)[i];
     }
   }
 
   for (unsigned int i = model.mBodies.size() - 1; i > 0; i--) {
     if(model.mJoints[i].mJointType != JointTypeCustom){
       if (model.mJoints[i].mDoFCount == 1) {
-        Tau[model.mJoints[i].q_index] = model.S[i].dot(model.f[i]);
+        Tau[model.mJoints[i].q_index] = data.S[i].dot(data.f[i]);
       } else if (model.mJoints[i].mDoFCount == 3) {
         Tau.block<3,1>(model.mJoints[i].q_index, 0)
-          = model.multdof3_S[i].transpose() * model.f[i];
+          = data.multdof3_S[i].transpose() * data.f[i];
       }
     } else if (model.mJoints[i].mJointType == JointTypeCustom) {  
       unsigned int k = model.mJoints[i].custom_joint_index;
       Tau.block(model.mJoints[i].q_index,0,
           model.mCustomJoints[k]->mDoFCount, 1)
-        = model.mCustomJoints[k]->S.transpose() * model.f[i];
+        = model.mCustomJoints[k]->S.transpose() * data.f[i];
     }
 
     if (model.lambda[i] != 0) {
-      model.f[model.lambda[i]] = model.f[model.lambda[i]] + model.X_lambda[i].applyTranspose(model.f[i]);
+      data.f[model.lambda[i]] = data.f[model.lambda[i]] + data.X_lambda[i].applyTranspose(data.f[i]);
     }
   }
 }
 
-RBDL_DLLAPI void NonlinearEffects ( 
+RBDL_DLLAPI void InverseDynamics (
     Model &model,
     const VectorNd &Q,
     const VectorNd &QDot,
+    const VectorNd &QDDot,
+    VectorNd &Tau,
+    std::vector<SpatialVector> *f_ext) {
+  InverseDynamics (model, model, Q, QDot, QDDot, Tau, f_ext);
+}
+
+RBDL_DLLAPI void NonlinearEffects ( 
+    const Model &model,
+    ModelData &data,
+    const VectorNd &Q,
+    const VectorNd &QDot,
     VectorNd &Tau,
     std::vector<Math::SpatialVector> *f_ext) {
+  RBDL_TRACE_ALGORITHM ("NonlinearEffects");
   RBDL_LOG << "-------- " << __func__ << " --------" << std::endl;
 
   SpatialVector spatial_gravity (0., 0., 0., -model.gravity[0], -model.gravity[1], -model.gravity[2]);
 
   // Reset the velocity of the root body
-  model.v[0].setZero();
-  model.a[0] = spatial_gravity;
+  data.v[0].setZero();
+  data.a[0] = spatial_gravity;
 
   for (unsigned int i = 1; i < model.mJointUpdateOrder.size(); i++) {
-    jcalc (model, model.mJointUpdateOrder[i], Q, QDot);
+    jcalc (model, data, model.mJointUpdateOrder[i], Q, QDot);
   }
 
   for (unsigned int i = 1; i < model.mBodies.size(); i++) {
     if (model.lambda[i] == 0) {
-      model.v[i] = model.v_J[i];
-      model.a[i] = model.X_lambda[i].apply(spatial_gravity);
+      data.v[i] = data.v_J[i];
+      // crossm(v[i], v_J[i]) vanishes as v[i] = v_J[i]
+      data.c[i] = data.c_J[i];
+      data.a[i] = data.X_lambda[i].apply(spatial_gravity);
     }	else {
-      model.v[i] = model.X_lambda[i].apply(model.v[model.lambda[i]]) + model.v_J[i];
-      model.c[i] = model.c_J[i] + crossm(model.v[i],model.v_J[i]);
-      model.a[i] = model.X_lambda[i].apply(model.a[model.lambda[i]]) + model.c[i];
+      data.v[i] = data.X_lambda[i].apply(data.v[model.lambda[i]]) + data.v_J[i];
+      data.c[i] = data.c_J[i] + crossm(data.v[i],data.v_J[i]);
+      data.a[i] = data.X_lambda[i].apply(data.a[model.lambda[i]]) + data.c[i];
     }
 
     if (!model.mBodies[i].mIsVirtual) {
-      model.f[i] = model.I[i] * model.a[i] + crossf(model.v[i],model.I[i] * model.v[i]);
+      data.f[i] = model.I[i] * data.a[i] + crossf(data.v[i],model.I[i] * data.v[i]);
 #ifdef RBDL_USE_CASADI_MATH
       if (f_ext != NULL)
 #else
       if (f_ext != NULL && (*f_ext)[i] != SpatialVector::Zero())
 #endif
       {
-        model.f[i] -= model.X_base[i].toMatrixAdjoint() * (*f_ext)[i];
+        data.f[i] -= data.X_base[i].toMatrixAdjoint() * (*f_ext)[i];
       }            
     } else {
-      model.f[i].setZero();
+      data.f[i].setZero();
     }
   }
 
@@ -151,74 +171,83 @@ RBDL_DLLAPI void NonlinearEffects (
     if(model.mJoints[i].mJointType != JointTypeCustom){
       if (model.mJoints[i].mDoFCount == 1) {
         Tau[model.mJoints[i].q_index]
-          = model.S[i].dot(model.f[i]);
+          = data.S[i].dot(data.f[i]);
       } else if (model.mJoints[i].mDoFCount == 3) {
         Tau.block<3,1>(model.mJoints[i].q_index, 0)
-          = model.multdof3_S[i].transpose() * model.f[i];
+          = data.multdof3_S[i].transpose() * data.f[i];
       }
     } else if(model.mJoints[i].mJointType == JointTypeCustom) {
       unsigned int k = model.mJoints[i].custom_joint_index;
       Tau.block(model.mJoints[i].q_index,0,
           model.mCustomJoints[k]->mDoFCount, 1)
-        = model.mCustomJoints[k]->S.transpose() * model.f[i];
+        = model.mCustomJoints[k]->S.transpose() * data.f[i];
     }
 
     if (model.lambda[i] != 0) {
-      model.f[model.lambda[i]] = model.f[model.lambda[i]] + model.X_lambda[i].applyTranspose(model.f[i]);
+      data.f[model.lambda[i]] = data.f[model.lambda[i]] + data.X_lambda[i].applyTranspose(data.f[i]);
     }
   }
 }
 
+RBDL_DLLAPI void NonlinearEffects (
+    Model &model,
+    const VectorNd &Q,
+    const VectorNd &QDot,
+    VectorNd &Tau,
+    std::vector<Math::SpatialVector> *f_ext) {
+  NonlinearEffects (model, model, Q, QDot, Tau, f_ext);
+}
+
 RBDL_DLLAPI void CompositeRigidBodyAlgorithm (
-    Model& model,
+    const Model &model,
+    ModelData &data,
     const VectorNd &Q,
     MatrixNd &H,
-    bool update_kinematics) {
+    bool update_kinematics,
+    bool lower_triangle_only) {
+  RBDL_TRACE_ALGORITHM ("CompositeRigidBodyAlgorithm");
+  RBDL_PERF_COUNTER ("CompositeRigidBodyAlgorithm");
   RBDL_LOG << "-------- " << __func__ << " --------" << std::endl;
 
   assert (H.rows() == model.dof_count && H.cols() == model.dof_count);
 
-  for (unsigned int i = 1; i < model.mBodies.size(); i++) {
-    if (update_kinematics) {
-      jcalc_X_lambda_S (model, i, Q);
-    }
-    model.Ic[i] = model.I[i];
-  }
+  CalcCompositeRigidBodyInertias (model, data, Q, update_kinematics);
 
   for (unsigned int i = model.mBodies.size() - 1; i > 0; i--) {
-    if (model.lambda[i] != 0) {
-      model.Ic[model.lambda[i]] = model.Ic[model.lambda[i]] + model.X_lambda[i].applyTranspose(model.Ic[i]);
-    }
-
+    RBDL_TRACE_BODY ("CompositeRigidBodyAlgorithm", i);
     unsigned int dof_index_i = model.mJoints[i].q_index;
 
     if (model.mJoints[i].mDoFCount == 1 
         && model.mJoints[i].mJointType != JointTypeCustom) {
 
-      SpatialVector F             = model.Ic[i] * model.S[i];
-      H(dof_index_i, dof_index_i) = model.S[i].dot(F);
+      SpatialVector F             = data.Ic[i] * data.S[i];
+      H(dof_index_i, dof_index_i) = data.S[i].dot(F);
 
       unsigned int j = i;
       unsigned int dof_index_j = dof_index_i;
 
       while (model.lambda[j] != 0) {
-        F = model.X_lambda[j].applyTranspose(F);
+        F = data.X_lambda[j].applyTranspose(F);
         j = model.lambda[j];
         dof_index_j = model.mJoints[j].q_index;
 
         if(model.mJoints[j].mJointType != JointTypeCustom) {
           if (model.mJoints[j].mDoFCount == 1) {
-            H(dof_index_i,dof_index_j) = F.dot(model.S[j]);
-            H(dof_index_j,dof_index_i) = H(dof_index_i,dof_index_j);
+            H(dof_index_i,dof_index_j) = F.dot(data.S[j]);
+            if (!lower_triangle_only) {
+              H(dof_index_j,dof_index_i) = H(dof_index_i,dof_index_j);
+            }
           } else if (model.mJoints[j].mDoFCount == 3) {
             Vector3d H_temp2 = 
-              (F.transpose() * model.multdof3_S[j]).transpose();
+              (F.transpose() * data.multdof3_S[j]).transpose();
             RBDL_LOG << F.transpose() << std::endl 
-              << model.multdof3_S[j] << std::endl;
+              << data.multdof3_S[j] << std::endl;
             RBDL_LOG << H_temp2.transpose() << std::endl;
 
             H.block<1,3>(dof_index_i,dof_index_j) = H_temp2.transpose();
-            H.block<3,1>(dof_index_j,dof_index_i) = H_temp2;
+            if (!lower_triangle_only) {
+              H.block<3,1>(dof_index_j,dof_index_i) = H_temp2;
+            }
           }
         } else if (model.mJoints[j].mJointType == JointTypeCustom){        
           unsigned int k      = model.mJoints[j].custom_joint_index;
@@ -233,33 +262,39 @@ RBDL_DLLAPI void CompositeRigidBodyAlgorithm (
           RBDL_LOG << H_temp2.transpose() << std::endl;
 
           H.block(dof_index_i,dof_index_j,1,dof) = H_temp2.transpose();
-          H.block(dof_index_j,dof_index_i,dof,1) = H_temp2;
+          if (!lower_triangle_only) {
+            H.block(dof_index_j,dof_index_i,dof,1) = H_temp2;
+          }
         }
       }
     } else if (model.mJoints[i].mDoFCount == 3
         && model.mJoints[i].mJointType != JointTypeCustom) {
-      Matrix63 F_63 = model.Ic[i].toMatrix() * model.multdof3_S[i];
-      H.block<3,3>(dof_index_i, dof_index_i) = model.multdof3_S[i].transpose() * F_63;
+      Matrix63 F_63 = data.Ic[i].toMatrix() * data.multdof3_S[i];
+      H.block<3,3>(dof_index_i, dof_index_i) = data.multdof3_S[i].transpose() * F_63;
 
       unsigned int j = i;
       unsigned int dof_index_j = dof_index_i;
 
       while (model.lambda[j] != 0) {
-        F_63 = model.X_lambda[j].toMatrixTranspose() * (F_63);
+        F_63 = data.X_lambda[j].toMatrixTranspose() * (F_63);
         j = model.lambda[j];
         dof_index_j = model.mJoints[j].q_index;
 
         if(model.mJoints[j].mJointType != JointTypeCustom){
           if (model.mJoints[j].mDoFCount == 1) {
-            Vector3d H_temp2 = F_63.transpose() * (model.S[j]);
+            Vector3d H_temp2 = F_63.transpose() * (data.S[j]);
 
             H.block<3,1>(dof_index_i,dof_index_j) = H_temp2;
-            H.block<1,3>(dof_index_j,dof_index_i) = H_temp2.transpose();
+            if (!lower_triangle_only) {
+              H.block<1,3>(dof_index_j,dof_index_i) = H_temp2.transpose();
+            }
           } else if (model.mJoints[j].mDoFCount == 3) {
-            Matrix3d H_temp2 = F_63.transpose() * (model.multdof3_S[j]);
+            Matrix3d H_temp2 = F_63.transpose() * (data.multdof3_S[j]);
 
             H.block<3,3>(dof_index_i,dof_index_j) = H_temp2;
-            H.block<3,3>(dof_index_j,dof_index_i) = H_temp2.transpose();
+            if (!lower_triangle_only) {
+              H.block<3,3>(dof_index_j,dof_index_i) = H_temp2.transpose();
+            }
           }
         } else if (model.mJoints[j].mJointType == JointTypeCustom){
           unsigned int k = model.mJoints[j].custom_joint_index;
@@ -268,14 +303,16 @@ RBDL_DLLAPI void CompositeRigidBodyAlgorithm (
           MatrixNd H_temp2 = F_63.transpose() * (model.mCustomJoints[k]->S);
 
           H.block(dof_index_i,dof_index_j,3,dof) = H_temp2;
-          H.block(dof_index_j,dof_index_i,dof,3) = H_temp2.transpose();
+          if (!lower_triangle_only) {
+            H.block(dof_index_j,dof_index_i,dof,3) = H_temp2.transpose();
+          }
         }
       }
     } else if (model.mJoints[i].mJointType == JointTypeCustom) {      
       unsigned int kI = model.mJoints[i].custom_joint_index;
       unsigned int dofI = model.mCustomJoints[kI]->mDoFCount;
 
-      MatrixNd F_Nd = model.Ic[i].toMatrix()
+      MatrixNd F_Nd = data.Ic[i].toMatrix()
         * model.mCustomJoints[kI]->S;
 
       H.block(dof_index_i, dof_index_i,dofI,dofI)
@@ -285,23 +322,27 @@ RBDL_DLLAPI void CompositeRigidBodyAlgorithm (
       unsigned int dof_index_j = dof_index_i;
 
       while (model.lambda[j] != 0) {
-        F_Nd = model.X_lambda[j].toMatrixTranspose() * (F_Nd);
+        F_Nd = data.X_lambda[j].toMatrixTranspose() * (F_Nd);
         j = model.lambda[j];
         dof_index_j = model.mJoints[j].q_index;
 
         if(model.mJoints[j].mJointType != JointTypeCustom){
           if (model.mJoints[j].mDoFCount == 1) {
-            MatrixNd H_temp2 = F_Nd.transpose() * (model.S[j]);
+            MatrixNd H_temp2 = F_Nd.transpose() * (data.S[j]);
             H.block(   dof_index_i,  dof_index_j,
                 H_temp2.rows(),H_temp2.cols()) = H_temp2;
-            H.block(dof_index_j,dof_index_i,
-                H_temp2.cols(),H_temp2.rows()) = H_temp2.transpose();
+            if (!lower_triangle_only) {
+              H.block(dof_index_j,dof_index_i,
+                  H_temp2.cols(),H_temp2.rows()) = H_temp2.transpose();
+            }
           } else if (model.mJoints[j].mDoFCount == 3) {
-            MatrixNd H_temp2 = F_Nd.transpose() * (model.multdof3_S[j]);
+            MatrixNd H_temp2 = F_Nd.transpose() * (data.multdof3_S[j]);
             H.block(dof_index_i,   dof_index_j,
                 H_temp2.rows(),H_temp2.cols()) = H_temp2;
-            H.block(dof_index_j,   dof_index_i,
-                H_temp2.cols(),H_temp2.rows()) = H_temp2.transpose();
+            if (!lower_triangle_only) {
+              H.block(dof_index_j,   dof_index_i,
+                  H_temp2.cols(),H_temp2.rows()) = H_temp2.transpose();
+            }
           }
         } else if (model.mJoints[j].mJointType == JointTypeCustom){
           unsigned int k   = model.mJoints[j].custom_joint_index;
@@ -310,20 +351,63 @@ RBDL_DLLAPI void CompositeRigidBodyAlgorithm (
           MatrixNd H_temp2 = F_Nd.transpose() * (model.mCustomJoints[k]->S);
 
           H.block(dof_index_i,dof_index_j,3,dof) = H_temp2;
-          H.block(dof_index_j,dof_index_i,dof,3) = H_temp2.transpose();
+          if (!lower_triangle_only) {
+            H.block(dof_index_j,dof_index_i,dof,3) = H_temp2.transpose();
+          }
         }
       }
     }
   }
 }
 
+RBDL_DLLAPI void CompositeRigidBodyAlgorithm (
+    Model& model,
+    const VectorNd &Q,
+    MatrixNd &H,
+    bool update_kinematics,
+    bool lower_triangle_only) {
+  CompositeRigidBodyAlgorithm (model, model, Q, H, update_kinematics,
+      lower_triangle_only);
+}
+
+RBDL_DLLAPI void CalcCompositeRigidBodyInertias (
+    const Model& model,
+    ModelData &data,
+    const VectorNd &Q,
+    bool update_kinematics) {
+  for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+    if (update_kinematics) {
+      jcalc_X_lambda_S (model, data, i, Q);
+    }
+    data.Ic[i] = model.I[i];
+  }
+
+  // children have larger ids than their parents, therefore Ic[i] is
+  // complete once the loop reaches body i
+  for (unsigned int i = model.mBodies.size() - 1; i > 0; i--) {
+    if (model.lambda[i] != 0) {
+      data.Ic[model.lambda[i]] = data.Ic[model.lambda[i]] + data.X_lambda[i].applyTranspose(data.Ic[i]);
+    }
+  }
+}
+
+RBDL_DLLAPI void CalcCompositeRigidBodyInertias (
+    Model& model,
+    const VectorNd &Q,
+    bool update_kinematics) {
+  CalcCompositeRigidBodyInertias (model, model, Q, update_kinematics);
+}
+
 RBDL_DLLAPI void ForwardDynamics (
-    Model &model,
+    const Model &model,
+    ModelData &data,
     const VectorNd &Q,
     const VectorNd &QDot,
     const VectorNd &Tau,
     VectorNd &QDDot,
     std::vector<SpatialVector> *f_ext) {
+  RBDL_TRACE_ALGORITHM ("ForwardDynamics");
+  RBDL_PERF_COUNTER ("ForwardDynamics");
   RBDL_LOG << "-------- " << __func__ << " --------" << std::endl;
 
   SpatialVector spatial_gravity (0., 0., 0., model.gravity[0], model.gravity[1], model.gravity[2]);
@@ -336,40 +420,44 @@ RBDL_DLLAPI void ForwardDynamics (
   RBDL_LOG << "---" << std::endl;
 
   // Reset the velocity of the root body
-  model.v[0].setZero();
+  data.v[0].setZero();
 
   for (i = 1; i < model.mBodies.size(); i++) {
     unsigned int lambda = model.lambda[i];
 
-    jcalc (model, i, Q, QDot);
+    jcalc (model, data, i, Q, QDot);
 
     if (lambda != 0)
-      model.X_base[i] = model.X_lambda[i] * model.X_base[lambda];
+      data.X_base[i] = data.X_lambda[i] * data.X_base[lambda];
     else
-      model.X_base[i] = model.X_lambda[i];
+      data.X_base[i] = data.X_lambda[i];
 
-    model.v[i] = model.X_lambda[i].apply( model.v[lambda]) + model.v_J[i];
+    data.v[i] = data.X_lambda[i].apply( data.v[lambda]) + data.v_J[i];
 
     /*
        RBDL_LOG << "X_J (" << i << "):" << std::endl << X_J << std::endl;
        RBDL_LOG << "v_J (" << i << "):" << std::endl << v_J << std::endl;
-       RBDL_LOG << "v_lambda" << i << ":" << std::endl << model.v.at(lambda) << std::endl;
-       RBDL_LOG << "X_base (" << i << "):" << std::endl << model.X_base[i] << std::endl;
-       RBDL_LOG << "X_lambda (" << i << "):" << std::endl << model.X_lambda[i] << std::endl;
-       RBDL_LOG << "SpatialVelocity (" << i << "): " << model.v[i] << std::endl;
+       RBDL_LOG << "v_lambda" << i << ":" << std::endl << data.v.at(lambda) << std::endl;
+       RBDL_LOG << "X_base (" << i << "):" << std::endl << data.X_base[i] << std::endl;
+       RBDL_LOG << "X_lambda (" << i << "):" << std::endl << data.X_lambda[i] << std::endl;
+       RBDL_LOG << "SpatialVelocity (" << i << "): " << data.v[i] << std::endl;
        */
-    model.c[i] = model.c_J[i] + crossm(model.v[i],model.v_J[i]);
-    model.I[i].setSpatialMatrix (model.IA[i]);
+    data.c[i] = data.c_J[i] + crossm(data.v[i],data.v_J[i]);
+#ifdef RBDL_USE_CASADI_MATH
+    model.I[i].setSpatialMatrix (data.IA[i]);
+#else
+    data.IA_compact[i] = SpatialArticulatedBodyInertia (model.I[i]);
+#endif
 
-    model.pA[i] = crossf(model.v[i],model.I[i] * model.v[i]);
+    data.pA[i] = crossf(data.v[i],model.I[i] * data.v[i]);
 
 #ifdef RBDL_USE_CASADI_MATH
     if (f_ext != NULL) {
 #else
     if (f_ext != NULL && (*f_ext)[i] != SpatialVector::Zero()) {
 #endif
-      RBDL_LOG << "External force (" << i << ") = " << model.X_base[i].toMatrixAdjoint() * (*f_ext)[i] << std::endl;
-      model.pA[i] -= model.X_base[i].toMatrixAdjoint() * (*f_ext)[i];
+      RBDL_LOG << "External force (" << i << ") = " << data.X_base[i].toMatrixAdjoint() * (*f_ext)[i] << std::endl;
+      data.pA[i] -= data.X_base[i].toMatrixAdjoint() * (*f_ext)[i];
     }
   }
 
@@ -378,97 +466,112 @@ RBDL_DLLAPI void ForwardDynamics (
   RBDL_LOG << "--- first loop ---" << std::endl;
 
   for (i = model.mBodies.size() - 1; i > 0; i--) {
+    RBDL_TRACE_BODY ("ForwardDynamics", i);
     unsigned int q_index = model.mJoints[i].q_index;
 
+#ifndef RBDL_USE_CASADI_MATH
+    // all children of body i have been added to IA_compact[i]
+    data.IA_compact[i].setSpatialMatrix (data.IA[i]);
+#endif
+
     if (model.mJoints[i].mDoFCount == 1
         && model.mJoints[i].mJointType != JointTypeCustom) {
 
-      model.U[i] = model.IA[i] * model.S[i];
-      model.d[i] = model.S[i].dot(model.U[i]);
-      model.u[i] = Tau[q_index] - model.S[i].dot(model.pA[i]);
-      //      RBDL_LOG << "u[" << i << "] = " << model.u[i] << std::endl;
+      data.U[i] = data.IA[i] * data.S[i];
+      data.d[i] = data.S[i].dot(data.U[i]);
+      data.u[i] = Tau[q_index] - data.S[i].dot(data.pA[i]);
+      //      RBDL_LOG << "u[" << i << "] = " << data.u[i] << std::endl;
 
       unsigned int lambda = model.lambda[i];
       if (lambda != 0) {
-        SpatialMatrix Ia =    model.IA[i]
-          - model.U[i]
-          * (model.U[i] / model.d[i]).transpose();
+#ifdef RBDL_USE_CASADI_MATH
+        SpatialMatrix Ia =    data.IA[i]
+          - data.U[i]
+          * (data.U[i] / data.d[i]).transpose();
 
-        SpatialVector pa =  model.pA[i]
-          + Ia * model.c[i]
-          + model.U[i] * model.u[i] / model.d[i];
+        SpatialVector pa =  data.pA[i]
+          + Ia * data.c[i]
+          + data.U[i] * data.u[i] / data.d[i];
 
-#ifdef RBDL_USE_CASADI_MATH
-        model.IA[lambda]
-          += model.X_lambda[i].toMatrixTranspose()
-          * Ia * model.X_lambda[i].toMatrix();
+        data.IA[lambda]
+          += data.X_lambda[i].toMatrixTranspose()
+          * Ia * data.X_lambda[i].toMatrix();
 
-        model.pA[lambda] += model.X_lambda[i].applyTranspose(pa);
+        data.pA[lambda] += data.X_lambda[i].applyTranspose(pa);
 #else
-        model.IA[lambda].noalias()
-          += model.X_lambda[i].toMatrixTranspose()
-          * Ia * model.X_lambda[i].toMatrix();
-        model.pA[lambda].noalias()
-          += model.X_lambda[i].applyTranspose(pa);
+        SpatialArticulatedBodyInertia Ia = data.IA_compact[i];
+        Ia.subtractOuterProduct (data.U[i], data.U[i] / data.d[i]);
+
+        SpatialVector pa =  data.pA[i]
+          + Ia * data.c[i]
+          + data.U[i] * data.u[i] / data.d[i];
+
+        data.IA_compact[lambda] += data.X_lambda[i].applyTranspose (Ia);
+        data.pA[lambda].noalias()
+          += data.X_lambda[i].applyTranspose(pa);
 #endif
 
         RBDL_LOG << "pA[" << lambda << "] = "
-          << model.pA[lambda].transpose() << std::endl;
+          << data.pA[lambda].transpose() << std::endl;
       }
     } else if (model.mJoints[i].mDoFCount == 3
         && model.mJoints[i].mJointType != JointTypeCustom) {
-      model.multdof3_U[i] = model.IA[i] * model.multdof3_S[i];
+      data.multdof3_U[i] = data.IA[i] * data.multdof3_S[i];
 
 #ifdef RBDL_USE_CASADI_MATH
-      model.multdof3_Dinv[i] = (model.multdof3_S[i].transpose()
-          * model.multdof3_U[i]).inverse();
+      data.multdof3_Dinv[i] = (data.multdof3_S[i].transpose()
+          * data.multdof3_U[i]).inverse();
 #else
-      model.multdof3_Dinv[i] = (model.multdof3_S[i].transpose()
-          * model.multdof3_U[i]).inverse().eval();
+      data.multdof3_Dinv[i] = (data.multdof3_S[i].transpose()
+          * data.multdof3_U[i]).inverse().eval();
 #endif
       Vector3d tau_temp(Tau.block(q_index,0,3,1));
-      model.multdof3_u[i] = tau_temp 
-        - model.multdof3_S[i].transpose() * model.pA[i];
+      data.multdof3_u[i] = tau_temp 
+        - data.multdof3_S[i].transpose() * data.pA[i];
 
       // RBDL_LOG << "multdof3_u[" << i << "] = " 
-      //                      << model.multdof3_u[i].transpose() << std::endl;
+      //                      << data.multdof3_u[i].transpose() << std::endl;
       unsigned int lambda = model.lambda[i];
       if (lambda != 0) {
-        SpatialMatrix Ia = model.IA[i]
-          - model.multdof3_U[i]
-          * model.multdof3_Dinv[i]
-          * model.multdof3_U[i].transpose();
-        SpatialVector pa = model.pA[i]
+#ifdef RBDL_USE_CASADI_MATH
+        SpatialMatrix Ia = data.IA[i]
+          - data.multdof3_U[i]
+          * data.multdof3_Dinv[i]
+          * data.multdof3_U[i].transpose();
+#else
+        SpatialArticulatedBodyInertia Ia = data.IA_compact[i]
+          - SpatialArticulatedBodyInertia (SpatialMatrix (data.multdof3_U[i]
+                * data.multdof3_Dinv[i]
+                * data.multdof3_U[i].transpose()));
+#endif
+        SpatialVector pa = data.pA[i]
           + Ia
-          * model.c[i]
-          + model.multdof3_U[i]
-          * model.multdof3_Dinv[i]
-          * model.multdof3_u[i];
+          * data.c[i]
+          + data.multdof3_U[i]
+          * data.multdof3_Dinv[i]
+          * data.multdof3_u[i];
 #ifdef RBDL_USE_CASADI_MATH
-        model.IA[lambda]
-          += model.X_lambda[i].toMatrixTranspose()
+        data.IA[lambda]
+          += data.X_lambda[i].toMatrixTranspose()
           * Ia
-          * model.X_lambda[i].toMatrix();
+          * data.X_lambda[i].toMatrix();
 
-        model.pA[lambda] += model.X_lambda[i].applyTranspose(pa);
+        data.pA[lambda] += data.X_lambda[i].applyTranspose(pa);
 #else
-        model.IA[lambda].noalias()
-          += model.X_lambda[i].toMatrixTranspose()
-          * Ia
-          * model.X_lambda[i].toMatrix();
+        data.IA_compact[lambda] += data.X_lambda[i].applyTranspose (Ia);
 
-        model.pA[lambda].noalias()
-          += model.X_lambda[i].applyTranspose(pa);
+        data.pA[lambda].noalias()
+          += data.X_lambda[i].applyTranspose(pa);
 #endif
         RBDL_LOG << "pA[" << lambda << "] = "
-          << model.pA[lambda].transpose()
+          << data.pA[lambda].transpose()
           << std::endl;
       }
     } else if (model.mJoints[i].mJointType == JointTypeCustom) {
       unsigned int kI   = model.mJoints[i].custom_joint_index;
       unsigned int dofI = model.mCustomJoints[kI]->mDoFCount;
       model.mCustomJoints[kI]->U =
-        model.IA[i] * model.mCustomJoints[kI]->S;
+        data.IA[i] * model.mCustomJoints[kI]->S;
 
 #ifdef RBDL_USE_CASADI_MATH
       model.mCustomJoints[kI]->Dinv
@@ -481,35 +584,41 @@ RBDL_DLLAPI void ForwardDynamics (
 #endif
       VectorNd tau_temp(Tau.block(q_index,0,dofI,1));
       model.mCustomJoints[kI]->u = tau_temp
-        - model.mCustomJoints[kI]->S.transpose() * model.pA[i];
+        - model.mCustomJoints[kI]->S.transpose() * data.pA[i];
 
       //      RBDL_LOG << "multdof3_u[" << i << "] = " 
-      //      << model.multdof3_u[i].transpose() << std::endl;
+      //      << data.multdof3_u[i].transpose() << std::endl;
       unsigned int lambda = model.lambda[i];
       if (lambda != 0) {
-        SpatialMatrix Ia = model.IA[i]
+#ifdef RBDL_USE_CASADI_MATH
+        SpatialMatrix Ia = data.IA[i]
           - (model.mCustomJoints[kI]->U
               * model.mCustomJoints[kI]->Dinv
               * model.mCustomJoints[kI]->U.transpose());
-        SpatialVector pa =  model.pA[i] 
-          + Ia * model.c[i]
+#else
+        SpatialArticulatedBodyInertia Ia = data.IA_compact[i]
+          - SpatialArticulatedBodyInertia (SpatialMatrix (
+                model.mCustomJoints[kI]->U
+                * model.mCustomJoints[kI]->Dinv
+                * model.mCustomJoints[kI]->U.transpose()));
+#endif
+        SpatialVector pa =  data.pA[i] 
+          + Ia * data.c[i]
           + (model.mCustomJoints[kI]->U
               * model.mCustomJoints[kI]->Dinv
               * model.mCustomJoints[kI]->u);
 
 #ifdef RBDL_USE_CASADI_MATH
-        model.IA[lambda] += model.X_lambda[i].toMatrixTranspose()
+        data.IA[lambda] += data.X_lambda[i].toMatrixTranspose()
           * Ia
-          * model.X_lambda[i].toMatrix();
-        model.pA[lambda] += model.X_lambda[i].applyTranspose(pa);
+          * data.X_lambda[i].toMatrix();
+        data.pA[lambda] += data.X_lambda[i].applyTranspose(pa);
 #else
-        model.IA[lambda].noalias() += model.X_lambda[i].toMatrixTranspose()
-          * Ia
-          * model.X_lambda[i].toMatrix();
-        model.pA[lambda].noalias() += model.X_lambda[i].applyTranspose(pa);
+        data.IA_compact[lambda] += data.X_lambda[i].applyTranspose (Ia);
+        data.pA[lambda].noalias() += data.X_lambda[i].applyTranspose(pa);
 #endif
         RBDL_LOG << "pA[" << lambda << "] = "
-          << model.pA[lambda].transpose()
+          << data.pA[lambda].transpose()
           << std::endl;
       }
     }
@@ -517,27 +626,27 @@ RBDL_DLLAPI void ForwardDynamics (
 
   //  ClearLogOutput();
 
-  model.a[0] = spatial_gravity * -1.;
+  data.a[0] = spatial_gravity * -1.;
 
   for (i = 1; i < model.mBodies.size(); i++) {
     unsigned int q_index = model.mJoints[i].q_index;
     unsigned int lambda = model.lambda[i];
-    SpatialTransform X_lambda = model.X_lambda[i];
+    SpatialTransform X_lambda = data.X_lambda[i];
 
-    model.a[i] = X_lambda.apply(model.a[lambda]) + model.c[i];
-    RBDL_LOG << "a'[" << i << "] = " << model.a[i].transpose() << std::endl;
+    data.a[i] = X_lambda.apply(data.a[lambda]) + data.c[i];
+    RBDL_LOG << "a'[" << i << "] = " << data.a[i].transpose() << std::endl;
 
     if (model.mJoints[i].mDoFCount == 1
         && model.mJoints[i].mJointType != JointTypeCustom) {
-      QDDot[q_index] = (1./model.d[i]) * (model.u[i] - model.U[i].dot(model.a[i]));
-      model.a[i] = model.a[i] + model.S[i] * QDDot[q_index];
+      QDDot[q_index] = (1./data.d[i]) * (data.u[i] - data.U[i].dot(data.a[i]));
+      data.a[i] = data.a[i] + data.S[i] * QDDot[q_index];
     } else if (model.mJoints[i].mDoFCount == 3
         && model.mJoints[i].mJointType != JointTypeCustom) {
-      Vector3d qdd_temp = model.multdof3_Dinv[i] * (model.multdof3_u[i] - model.multdof3_U[i].transpose() * model.a[i]);
+      Vector3d qdd_temp = data.multdof3_Dinv[i] * (data.multdof3_u[i] - data.multdof3_U[i].transpose() * data.a[i]);
       QDDot[q_index] = qdd_temp[0];
       QDDot[q_index + 1] = qdd_temp[1];
       QDDot[q_index + 2] = qdd_temp[2];
-      model.a[i] = model.a[i] + model.multdof3_S[i] * qdd_temp;
+      data.a[i] = data.a[i] + data.multdof3_S[i] * qdd_temp;
     } else if (model.mJoints[i].mJointType == JointTypeCustom) {
       unsigned int kI = model.mJoints[i].custom_joint_index;
       unsigned int dofI=model.mCustomJoints[kI]->mDoFCount;
@@ -545,13 +654,13 @@ RBDL_DLLAPI void ForwardDynamics (
       VectorNd qdd_temp = model.mCustomJoints[kI]->Dinv
         * (  model.mCustomJoints[kI]->u
             - model.mCustomJoints[kI]->U.transpose()
-            * model.a[i]);
+            * data.a[i]);
 
       for(int z=0; z<dofI; ++z){
         QDDot[q_index+z] = qdd_temp[z];
       }
 
-      model.a[i] = model.a[i]
+      data.a[i] = data.a[i]
         + model.mCustomJoints[kI]->S * qdd_temp;
     } 
   }
@@ -559,16 +668,414 @@ RBDL_DLLAPI void ForwardDynamics (
   RBDL_LOG << "QDDot = " << QDDot.transpose() << std::endl;
 }
 
-RBDL_DLLAPI void ForwardDynamicsLagrangian (
+RBDL_DLLAPI void ForwardDynamics (
     Model &model,
     const VectorNd &Q,
     const VectorNd &QDot,
     const VectorNd &Tau,
     VectorNd &QDDot,
+    std::vector<SpatialVector> *f_ext) {
+  ForwardDynamics (model, model, Q, QDot, Tau, QDDot, f_ext);
+}
+
+#ifndef RBDL_USE_CASADI_MATH
+// ForwardDynamicsBatch() evaluates BatchLaneCount samples together. Every
+// scalar of the ABA becomes an array with one entry per sample (structure
+// of arrays) so that Eigen evaluates the operations of all samples with
+// packet (SIMD) instructions. The lane types are declared in Model.h as
+// ModelData keeps them as workspace.
+
+// Fills the joint constants if all joints of the model have a single
+// constant axis, otherwise returns false.
+static bool batch_init_joints (const Model &model, BatchJointVector &joints) {
+  joints.resize (model.mBodies.size());
+
+  for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+    const Joint &joint = model.mJoints[i];
+    const SpatialTransform &X_T = model.X_T[i];
+    BatchJoint &bj = joints[i];
+
+    bj.S = joint.mJointAxes[0];
+    bj.I = model.I[i].toMatrix();
+
+    if (joint.mJointType == JointTypeRevolute
+        || joint.mJointType == JointTypeRevoluteX
+        || joint.mJointType == JointTypeRevoluteY
+        || joint.mJointType == JointTypeRevoluteZ) {
+      // Xrot (q, axis).E = cos(q) (1 - axis axis^T) + axis axis^T
+      //   + sin(q) K with the skew symmetric K below
+      Vector3d axis (bj.S[0], bj.S[1], bj.S[2]);
+      Matrix3d axis_axis = axis * axis.transpose();
+      Matrix3d K (
+          0., axis[2], -axis[1],
+          -axis[2], 0., axis[0],
+          axis[1], -axis[0], 0.);
+
+      bj.E0 = axis_axis * X_T.E;
+      bj.Ec = (Matrix3d::Identity() - axis_axis) * X_T.E;
+      bj.Es = K * X_T.E;
+      bj.r0 = X_T.r;
+      bj.rq.setZero();
+      bj.revolute = true;
+    } else if (joint.mJointType == JointTypePrismatic) {
+      bj.E0 = X_T.E;
+      bj.Ec.setZero();
+      bj.Es.setZero();
+      bj.r0 = X_T.r;
+      bj.rq = X_T.E.transpose() * Vector3d (bj.S[3], bj.S[4], bj.S[5]);
+      bj.revolute = false;
+    } else {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// out = X_lambda * in
+static inline void batch_apply (const BatchBody &b,
+    const BatchSpatialVector &in, BatchSpatialVector &out) {
+  BatchLanes rxw[3];
+  rxw[0] = in.x[3] - b.r[1] * in.x[2] + b.r[2] * in.x[1];
+  rxw[1] = in.x[4] - b.r[2] * in.x[0] + b.r[0] * in.x[2];
+  rxw[2] = in.x[5] - b.r[0] * in.x[1] + b.r[1] * in.x[0];
+
+  for (int k = 0; k < 3; k++) {
+    out.x[k] = b.E[k][0] * in.x[0] + b.E[k][1] * in.x[1]
+      + b.E[k][2] * in.x[2];
+    out.x[k + 3] = b.E[k][0] * rxw[0] + b.E[k][1] * rxw[1]
+      + b.E[k][2] * rxw[2];
+  }
+}
+
+// out += X_lambda^T * f
+static inline void batch_add_apply_transpose (const BatchBody &b,
+    const BatchSpatialVector &f, BatchSpatialVector &out) {
+  BatchLanes E_T_n[3], E_T_f[3];
+  for (int k = 0; k < 3; k++) {
+    E_T_n[k] = b.E[0][k] * f.x[0] + b.E[1][k] * f.x[1] + b.E[2][k] * f.x[2];
+    E_T_f[k] = b.E[0][k] * f.x[3] + b.E[1][k] * f.x[4] + b.E[2][k] * f.x[5];
+  }
+
+  out.x[0] += E_T_n[0] - b.r[2] * E_T_f[1] + b.r[1] * E_T_f[2];
+  out.x[1] += E_T_n[1] + b.r[2] * E_T_f[0] - b.r[0] * E_T_f[2];
+  out.x[2] += E_T_n[2] - b.r[1] * E_T_f[0] + b.r[0] * E_T_f[1];
+  out.x[3] += E_T_f[0];
+  out.x[4] += E_T_f[1];
+  out.x[5] += E_T_f[2];
+}
+
+// IA += X_lambda^T Ia X_lambda for a symmetric Ia. With X_lambda =
+// diag(E, E) [1 0; -rx 1] the blocks [A B; B^T C] of diag(E,E)^T Ia
+// diag(E,E) are shifted to [A - H - H^T - rx C rx, B + rx C; ., C] with
+// H = B rx.
+static void batch_add_transformed_inertia (const BatchBody &b,
+    const BatchSpatialMatrix &Ia, BatchSpatialMatrix &IA) {
+  BatchLanes N[6][6];
+  BatchLanes ME[3][3];
+
+  const int blocks[3][2] = { {0, 0}, {0, 3}, {3, 3} };
+  for (int bi = 0; bi < 3; bi++) {
+    int row = blocks[bi][0];
+    int col = blocks[bi][1];
+
+    for (int k = 0; k < 3; k++) {
+      for (int l = 0; l < 3; l++) {
+        ME[k][l] = Ia.m[row + k][col] * b.E[0][l]
+          + Ia.m[row + k][col + 1] * b.E[1][l]
+          + Ia.m[row + k][col + 2] * b.E[2][l];
+      }
+    }
+
+    for (int k = 0; k < 3; k++) {
+      for (int l = 0; l < 3; l++) {
+        N[row + k][col + l] = b.E[0][k] * ME[0][l]
+          + b.E[1][k] * ME[1][l]
+          + b.E[2][k] * ME[2][l];
+      }
+    }
+  }
+
+  const BatchLanes *r = b.r;
+  BatchLanes H[3][3], Crx[3][3];
+  for (int k = 0; k < 3; k++) {
+    // H = B rx
+    H[k][0] = N[k][4] * r[2] - N[k][5] * r[1];
+    H[k][1] = N[k][5] * r[0] - N[k][3] * r[2];
+    H[k][2] = N[k][3] * r[1] - N[k][4] * r[0];
+    // C rx
+    Crx[k][0] = N[3 + k][4] * r[2] - N[3 + k][5] * r[1];
+    Crx[k][1] = N[3 + k][5] * r[0] - N[3 + k][3] * r[2];
+    Crx[k][2] = N[3 + k][3] * r[1] - N[3 + k][4] * r[0];
+  }
+
+  for (int l = 0; l < 3; l++) {
+    // rx C and rx C rx column l
+    BatchLanes rxC[3], rxCrx[3];
+    rxC[0] = r[1] * N[5][3 + l] - r[2] * N[4][3 + l];
+    rxC[1] = r[2] * N[3][3 + l] - r[0] * N[5][3 + l];
+    rxC[2] = r[0] * N[4][3 + l] - r[1] * N[3][3 + l];
+    rxCrx[0] = r[1] * Crx[2][l] - r[2] * Crx[1][l];
+    rxCrx[1] = r[2] * Crx[0][l] - r[0] * Crx[2][l];
+    rxCrx[2] = r[0] * Crx[1][l] - r[1] * Crx[0][l];
+
+    for (int k = 0; k < 3; k++) {
+      IA.m[k][l] += N[k][l] - H[k][l] - H[l][k] - rxCrx[k];
+      IA.m[k][3 + l] += N[k][3 + l] + rxC[k];
+      IA.m[3 + l][k] = IA.m[k][3 + l];
+      IA.m[3 + k][3 + l] += N[3 + k][3 + l];
+    }
+  }
+}
+
+// Evaluates the ABA for the samples first_col, ..., first_col +
+// BatchLaneCount - 1. Missing samples at the end of the batch are filled
+// with the last sample and are not written to QDDot.
+static void batch_forward_dynamics (
+    const Model &model,
+    const BatchJointVector &joints,
+    BatchBodyVector &bodies,
+    const MatrixNd &Q,
+    const MatrixNd &QDot,
+    const MatrixNd &Tau,
+    MatrixNd &QDDot,
+    unsigned int first_col) {
+  const unsigned int n_cols = Q.cols();
+  const unsigned int n_bodies = model.mBodies.size();
+
+  BatchLanes q, qdot, tau;
+
+  for (unsigned int i = 1; i < n_bodies; i++) {
+    const BatchJoint &bj = joints[i];
+    BatchBody &b = bodies[i];
+    unsigned int q_index = model.mJoints[i].q_index;
+    unsigned int lambda = model.lambda[i];
+
+    for (int l = 0; l < BatchLaneCount; l++) {
+      unsigned int col = std::min (first_col + l, n_cols - 1);
+      q[l] = Q(q_index, col);
+      qdot[l] = QDot(q_index, col);
+    }
+
+    if (bj.revolute) {
+      BatchLanes sin_q = q.sin();
+      BatchLanes cos_q = q.cos();
+      for (int k = 0; k < 3; k++) {
+        for (int l = 0; l < 3; l++) {
+          b.E[k][l] = bj.E0(k,l) + cos_q * bj.Ec(k,l) + sin_q * bj.Es(k,l);
+        }
+        b.r[k].setConstant (bj.r0[k]);
+      }
+    } else {
+      for (int k = 0; k < 3; k++) {
+        for (int l = 0; l < 3; l++) {
+          b.E[k][l].setConstant (bj.E0(k,l));
+        }
+        b.r[k] = bj.r0[k] + q * bj.rq[k];
+      }
+    }
+
+    BatchSpatialVector v_J;
+    for (int k = 0; k < 6; k++) {
+      v_J.x[k] = bj.S[k] * qdot;
+    }
+
+    if (lambda != 0) {
+      batch_apply (b, bodies[lambda].v, b.v);
+      for (int k = 0; k < 6; k++) {
+        b.v.x[k] += v_J.x[k];
+      }
+    } else {
+      b.v = v_J;
+    }
+
+    // c = v x v_J (the joints have constant axes, i.e. c_J = 0)
+    const BatchLanes *v = b.v.x;
+    const BatchLanes *w = v_J.x;
+    b.c.x[0] = -v[2] * w[1] + v[1] * w[2];
+    b.c.x[1] = v[2] * w[0] - v[0] * w[2];
+    b.c.x[2] = -v[1] * w[0] + v[0] * w[1];
+    b.c.x[3] = -v[5] * w[1] + v[4] * w[2] - v[2] * w[4] + v[1] * w[5];
+    b.c.x[4] = v[5] * w[0] - v[3] * w[2] + v[2] * w[3] - v[0] * w[5];
+    b.c.x[5] = -v[4] * w[0] + v[3] * w[1] - v[1] * w[3] + v[0] * w[4];
+
+    // pA = v x* I v
+    BatchLanes Iv[6];
+    for (int k = 0; k < 6; k++) {
+      Iv[k] = bj.I(k,0) * v[0] + bj.I(k,1) * v[1] + bj.I(k,2) * v[2]
+        + bj.I(k,3) * v[3] + bj.I(k,4) * v[4] + bj.I(k,5) * v[5];
+      for (int l = 0; l < 6; l++) {
+        b.IA.m[k][l].setConstant (bj.I(k,l));
+      }
+    }
+    b.pA.x[0] = -v[2] * Iv[1] + v[1] * Iv[2] - v[5] * Iv[4] + v[4] * Iv[5];
+    b.pA.x[1] = v[2] * Iv[0] - v[0] * Iv[2] + v[5] * Iv[3] - v[3] * Iv[5];
+    b.pA.x[2] = -v[1] * Iv[0] + v[0] * Iv[1] - v[4] * Iv[3] + v[3] * Iv[4];
+    b.pA.x[3] = -v[2] * Iv[4] + v[1] * Iv[5];
+    b.pA.x[4] = v[2] * Iv[3] - v[0] * Iv[5];
+    b.pA.x[5] = -v[1] * Iv[3] + v[0] * Iv[4];
+  }
+
+  for (unsigned int i = n_bodies - 1; i > 0; i--) {
+    const BatchJoint &bj = joints[i];
+    BatchBody &b = bodies[i];
+    unsigned int q_index = model.mJoints[i].q_index;
+    unsigned int lambda = model.lambda[i];
+
+    for (int l = 0; l < BatchLaneCount; l++) {
+      tau[l] = Tau(q_index, std::min (first_col + l, n_cols - 1));
+    }
+
+    b.d.setZero();
+    b.u = tau;
+    for (int k = 0; k < 6; k++) {
+      b.U.x[k].setZero();
+      for (int l = 0; l < 6; l++) {
+        if (bj.S[l] != 0.) {
+          b.U.x[k] += b.IA.m[k][l] * bj.S[l];
+        }
+      }
+    }
+    for (int k = 0; k < 6; k++) {
+      if (bj.S[k] != 0.) {
+        b.d += bj.S[k] * b.U.x[k];
+        b.u -= bj.S[k] * b.pA.x[k];
+      }
+    }
+
+    if (lambda != 0) {
+      BatchLanes d_inv = b.d.inverse();
+      BatchLanes u_d_inv = b.u * d_inv;
+
+      // Ia = IA - U U^T / d, stored in IA
+      for (int k = 0; k < 6; k++) {
+        BatchLanes U_d_inv = b.U.x[k] * d_inv;
+        for (int l = 0; l < 6; l++) {
+          b.IA.m[k][l] -= U_d_inv * b.U.x[l];
+        }
+      }
+
+      // pa = pA + Ia c + U u / d
+      BatchSpatialVector pa;
+      for (int k = 0; k < 6; k++) {
+        pa.x[k] = b.pA.x[k] + b.U.x[k] * u_d_inv
+          + b.IA.m[k][0] * b.c.x[0] + b.IA.m[k][1] * b.c.x[1]
+          + b.IA.m[k][2] * b.c.x[2] + b.IA.m[k][3] * b.c.x[3]
+          + b.IA.m[k][4] * b.c.x[4] + b.IA.m[k][5] * b.c.x[5];
+      }
+
+      batch_add_transformed_inertia (b, b.IA, bodies[lambda].IA);
+      batch_add_apply_transpose (b, pa, bodies[lambda].pA);
+    }
+  }
+
+  BatchSpatialVector a_root;
+  for (int k = 0; k < 3; k++) {
+    a_root.x[k].setZero();
+    a_root.x[k + 3].setConstant (-model.gravity[k]);
+  }
+
+  for (unsigned int i = 1; i < n_bodies; i++) {
+    const BatchJoint &bj = joints[i];
+    BatchBody &b = bodies[i];
+    unsigned int q_index = model.mJoints[i].q_index;
+    unsigned int lambda = model.lambda[i];
+
+    batch_apply (b, lambda != 0 ? bodies[lambda].a : a_root, b.a);
+
+    BatchLanes U_a (BatchLanes::Zero());
+    for (int k = 0; k < 6; k++) {
+      b.a.x[k] += b.c.x[k];
+      U_a += b.U.x[k] * b.a.x[k];
+    }
+
+    BatchLanes qddot = (b.u - U_a) / b.d;
+    for (int k = 0; k < 6; k++) {
+      if (bj.S[k] != 0.) {
+        b.a.x[k] += bj.S[k] * qddot;
+      }
+    }
+
+    for (int l = 0; l < BatchLaneCount && first_col + l < n_cols; l++) {
+      QDDot(q_index, first_col + l) = qddot[l];
+    }
+  }
+}
+
+RBDL_DLLAPI void ForwardDynamicsBatch (
+    const Model &model,
+    ModelData &data,
+    const MatrixNd &Q,
+    const MatrixNd &QDot,
+    const MatrixNd &Tau,
+    MatrixNd &QDDot) {
+  if (Q.rows() != model.q_size
+      || QDot.rows() != model.qdot_size
+      || Tau.rows() != model.qdot_size) {
+    throw Errors::RBDLDofMismatchError("Error: batch rows do not match the "
+        "dimensions of the model!\n");
+  }
+
+  if (QDot.cols() != Q.cols() || Tau.cols() != Q.cols()) {
+    throw Errors::RBDLSizeMismatchError("Error: batch inputs have a "
+        "different number of samples!\n");
+  }
+
+  QDDot.resize (model.qdot_size, Q.cols());
+
+  if (Q.cols() > 0 && batch_init_joints (model, data.batch_joints)) {
+    // only allocates on the first call with this workspace
+    data.batch_bodies.resize (model.mBodies.size());
+
+    for (unsigned int j = 0; j < Q.cols(); j += BatchLaneCount) {
+      batch_forward_dynamics (model, data.batch_joints, data.batch_bodies,
+          Q, QDot, Tau, QDDot, j);
+    }
+
+    return;
+  }
+
+  // Models with multi dof, helical or custom joints are evaluated sample
+  // by sample. The columns are copied into preallocated vectors as the
+  // single sample functions only accept VectorNd arguments.
+  VectorNd q (model.q_size);
+  VectorNd qdot (model.qdot_size);
+  VectorNd tau (model.qdot_size);
+  VectorNd qddot (model.qdot_size);
+
+  for (unsigned int j = 0; j < Q.cols(); j++) {
+    q = Q.col(j);
+    qdot = QDot.col(j);
+    tau = Tau.col(j);
+
+    ForwardDynamics (model, data, q, qdot, tau, qddot);
+
+    QDDot.col(j) = qddot;
+  }
+}
+
+RBDL_DLLAPI void ForwardDynamicsBatch (
+    Model &model,
+    const MatrixNd &Q,
+    const MatrixNd &QDot,
+    const MatrixNd &Tau,
+    MatrixNd &QDDot) {
+  ForwardDynamicsBatch (model, model, Q, QDot, Tau, QDDot);
+}
+#endif
+
+RBDL_DLLAPI void ForwardDynamicsLagrangian (
+    const Model &model,
+    ModelData &data,
+    const VectorNd &Q,
+    const VectorNd &QDot,
+    const VectorNd &Tau,
+    VectorNd &QDDot,
     Math::LinearSolver linear_solver,
     std::vector<SpatialVector> *f_ext,
     Math::MatrixNd *H,
     Math::VectorNd *C) {
+  RBDL_TRACE_ALGORITHM ("ForwardDynamicsLagrangian");
   RBDL_LOG << "-------- " << __func__ << " --------" << std::endl;
 
   bool free_H = false;
@@ -588,8 +1095,14 @@ RBDL_DLLAPI void ForwardDynamicsLagrangian (
   // method.
   QDDot.setZero();
 
-  InverseDynamics (model, Q, QDot, QDDot, (*C), f_ext);
-  CompositeRigidBodyAlgorithm (model, Q, *H, false);
+  // the sparse solver only needs the lower triangle of H
+  bool lower_triangle_only = false;
+#ifndef RBDL_USE_CASADI_MATH
+  lower_triangle_only = linear_solver == LinearSolverSparseLTL;
+#endif
+
+  InverseDynamics (model, data, Q, QDot, QDDot, (*C), f_ext);
+  CompositeRigidBodyAlgorithm (model, data, Q, *H, false, lower_triangle_only);
 
   RBDL_LOG << "A = " << std::endl << *H << std::endl;
   RBDL_LOG << "b = " << std::endl << *C * -1. + Tau << std::endl;
@@ -610,6 +1123,12 @@ RBDL_DLLAPI void ForwardDynamicsLagrangian (
     case (LinearSolverLLT) :
       QDDot = H->llt().solve (*C * -1. + Tau);
       break;
+    case (LinearSolverSparseLTL) :
+      SparseFactorizeLTL (model, *H);
+      QDDot = *C * -1. + Tau;
+      SparseSolveLTx (model, *H, QDDot);
+      SparseSolveLx (model, *H, QDDot);
+      break;
     default:
       RBDL_LOG << "Error: Invalid linear solver: " << linear_solver << std::endl;
       assert (0);
@@ -628,132 +1147,173 @@ RBDL_DLLAPI void ForwardDynamicsLagrangian (
   RBDL_LOG << "x = " << QDDot << std::endl;
 }
 
-RBDL_DLLAPI void CalcMInvTimesTau ( Model &model,
+RBDL_DLLAPI void ForwardDynamicsLagrangian (
+    Model &model,
     const VectorNd &Q,
+    const VectorNd &QDot,
     const VectorNd &Tau,
     VectorNd &QDDot,
-    bool update_kinematics) {
-
-  RBDL_LOG << "Q          = " << Q.transpose() << std::endl;
-  RBDL_LOG << "---" << std::endl;
-
-  // Reset the velocity of the root body
-  model.v[0].setZero();
-  model.a[0].setZero();
-
-  if (update_kinematics) {
-    for (unsigned int i = 1; i < model.mBodies.size(); i++) {
-      jcalc_X_lambda_S (model, model.mJointUpdateOrder[i], Q);
-
-      model.v_J[i].setZero();
-      model.v[i].setZero();
-      model.c[i].setZero();
-      model.pA[i].setZero();
-      model.I[i].setSpatialMatrix (model.IA[i]);
-    }
-  }
+    Math::LinearSolver linear_solver,
+    std::vector<SpatialVector> *f_ext,
+    Math::MatrixNd *H,
+    Math::VectorNd *C) {
+  ForwardDynamicsLagrangian (model, model, Q, QDot, Tau, QDDot, linear_solver,
+      f_ext, H, C);
+}
 
+// Updates the joint transformations and motion subspaces and computes the
+// articulated-body inertias IA together with U and D (RBDA p. 130) which only
+// depend on the positions.
+static void CalcArticulatedBodyInertias (
+    const Model &model,
+    ModelData &data,
+    const VectorNd &Q) {
   for (unsigned int i = 1; i < model.mBodies.size(); i++) {
-    model.pA[i].setZero();
+    jcalc_X_lambda_S (model, data, model.mJointUpdateOrder[i], Q);
+#ifdef RBDL_USE_CASADI_MATH
+    model.I[i].setSpatialMatrix (data.IA[i]);
+#else
+    data.IA_compact[i] = SpatialArticulatedBodyInertia (model.I[i]);
+#endif
   }
 
-  // ClearLogOutput();
-
-  if (update_kinematics) {
-    // Compute Articulate Body Inertias
-    for (unsigned int i = model.mBodies.size() - 1; i > 0; i--) {
-      unsigned int q_index = model.mJoints[i].q_index;
-
-      if (model.mJoints[i].mDoFCount == 1
-          && model.mJoints[i].mJointType != JointTypeCustom) {
-        model.U[i] = model.IA[i] * model.S[i];
-        model.d[i] = model.S[i].dot(model.U[i]);
-        //      RBDL_LOG << "u[" << i << "] = " << model.u[i] << std::endl;
-        unsigned int lambda = model.lambda[i];
+  for (unsigned int i = model.mBodies.size() - 1; i > 0; i--) {
+#ifndef RBDL_USE_CASADI_MATH
+    // all children of body i have been added to IA_compact[i]
+    data.IA_compact[i].setSpatialMatrix (data.IA[i]);
+#endif
 
-        if (lambda != 0) {
-          SpatialMatrix Ia = model.IA[i] - 
-            model.U[i] * (model.U[i] / model.d[i]).transpose();
+    if (model.mJoints[i].mDoFCount == 1
+        && model.mJoints[i].mJointType != JointTypeCustom) {
+      data.U[i] = data.IA[i] * data.S[i];
+      data.d[i] = data.S[i].dot(data.U[i]);
+      //      RBDL_LOG << "u[" << i << "] = " << data.u[i] << std::endl;
+      unsigned int lambda = model.lambda[i];
 
+      if (lambda != 0) {
 #ifdef RBDL_USE_CASADI_MATH
-          model.IA[lambda] += model.X_lambda[i].toMatrixTranspose()
-            * Ia
-            * model.X_lambda[i].toMatrix();
+        SpatialMatrix Ia = data.IA[i] - 
+          data.U[i] * (data.U[i] / data.d[i]).transpose();
+
+        data.IA[lambda] += data.X_lambda[i].toMatrixTranspose()
+          * Ia
+          * data.X_lambda[i].toMatrix();
 #else
-          model.IA[lambda].noalias() += model.X_lambda[i].toMatrixTranspose()
-            * Ia
-            * model.X_lambda[i].toMatrix();
+        SpatialArticulatedBodyInertia Ia = data.IA_compact[i];
+        Ia.subtractOuterProduct (data.U[i], data.U[i] / data.d[i]);
+
+        data.IA_compact[lambda] += data.X_lambda[i].applyTranspose (Ia);
 #endif
-        }
-      } else if (model.mJoints[i].mDoFCount == 3
-          && model.mJoints[i].mJointType != JointTypeCustom) {
+      }
+    } else if (model.mJoints[i].mDoFCount == 3
+        && model.mJoints[i].mJointType != JointTypeCustom) {
 
-        model.multdof3_U[i] = model.IA[i] * model.multdof3_S[i];
+      data.multdof3_U[i] = data.IA[i] * data.multdof3_S[i];
 
 #ifdef RBDL_USE_CASADI_MATH
-        model.multdof3_Dinv[i] = 
-          (model.multdof3_S[i].transpose() * model.multdof3_U[i]).inverse();
+      data.multdof3_Dinv[i] = 
+        (data.multdof3_S[i].transpose() * data.multdof3_U[i]).inverse();
 #else
-        model.multdof3_Dinv[i] = 
-          (model.multdof3_S[i].transpose()*model.multdof3_U[i]).inverse().eval();
+      data.multdof3_Dinv[i] = 
+        (data.multdof3_S[i].transpose()*data.multdof3_U[i]).inverse().eval();
 #endif
-        //      RBDL_LOG << "mCustomJoints[kI]->u[" << i << "] = "
-        //<< model.mCustomJoints[kI]->u[i].transpose() << std::endl;
+      //      RBDL_LOG << "mCustomJoints[kI]->u[" << i << "] = "
+      //<< model.mCustomJoints[kI]->u[i].transpose() << std::endl;
 
-        unsigned int lambda = model.lambda[i];
-
-        if (lambda != 0) {
-          SpatialMatrix Ia = model.IA[i]
-            - ( model.multdof3_U[i]
-                * model.multdof3_Dinv[i]
-                * model.multdof3_U[i].transpose());
+      unsigned int lambda = model.lambda[i];
 
+      if (lambda != 0) {
 #ifdef RBDL_USE_CASADI_MATH
-          model.IA[lambda] +=
-            model.X_lambda[i].toMatrixTranspose()
-            * Ia * model.X_lambda[i].toMatrix();
+        SpatialMatrix Ia = data.IA[i]
+          - ( data.multdof3_U[i]
+              * data.multdof3_Dinv[i]
+              * data.multdof3_U[i].transpose());
+
+        data.IA[lambda] +=
+          data.X_lambda[i].toMatrixTranspose()
+          * Ia * data.X_lambda[i].toMatrix();
 #else
-          model.IA[lambda].noalias() +=
-            model.X_lambda[i].toMatrixTranspose()
-            * Ia
-            * model.X_lambda[i].toMatrix();
+        SpatialArticulatedBodyInertia Ia = data.IA_compact[i]
+          - SpatialArticulatedBodyInertia (SpatialMatrix (data.multdof3_U[i]
+                * data.multdof3_Dinv[i]
+                * data.multdof3_U[i].transpose()));
+
+        data.IA_compact[lambda] += data.X_lambda[i].applyTranspose (Ia);
 #endif
-        }
-      } else if (model.mJoints[i].mJointType == JointTypeCustom) {
-        unsigned int kI     = model.mJoints[i].custom_joint_index;
-        unsigned int dofI   = model.mCustomJoints[kI]->mDoFCount;
-        model.mCustomJoints[kI]->U = model.IA[i] * model.mCustomJoints[kI]->S;
+      }
+    } else if (model.mJoints[i].mJointType == JointTypeCustom) {
+      unsigned int kI     = model.mJoints[i].custom_joint_index;
+      unsigned int dofI   = model.mCustomJoints[kI]->mDoFCount;
+      model.mCustomJoints[kI]->U = data.IA[i] * model.mCustomJoints[kI]->S;
 
 #ifdef RBDL_USE_CASADI_MATH
-        model.mCustomJoints[kI]->Dinv=(model.mCustomJoints[kI]->S.transpose()
-            * model.mCustomJoints[kI]->U
-            ).inverse();
+      model.mCustomJoints[kI]->Dinv=(model.mCustomJoints[kI]->S.transpose()
+          * model.mCustomJoints[kI]->U
+          ).inverse();
 #else
-        model.mCustomJoints[kI]->Dinv = (model.mCustomJoints[kI]->S.transpose()
-            * model.mCustomJoints[kI]->U
-            ).inverse().eval();
+      model.mCustomJoints[kI]->Dinv = (model.mCustomJoints[kI]->S.transpose()
+          * model.mCustomJoints[kI]->U
+          ).inverse().eval();
 #endif
-        //      RBDL_LOG << "mCustomJoints[kI]->u[" << i << "] = "
-        //<< model.mCustomJoints[kI]->u.transpose() << std::endl;
-        unsigned int lambda = model.lambda[i];
+      //      RBDL_LOG << "mCustomJoints[kI]->u[" << i << "] = "
+      //<< model.mCustomJoints[kI]->u.transpose() << std::endl;
+      unsigned int lambda = model.lambda[i];
 
-        if (lambda != 0) {
-          SpatialMatrix Ia = model.IA[i] 
-            - ( model.mCustomJoints[kI]->U
-                * model.mCustomJoints[kI]->Dinv
-                * model.mCustomJoints[kI]->U.transpose());
+      if (lambda != 0) {
 #ifdef RBDL_USE_CASADI_MATH
-          model.IA[lambda] += model.X_lambda[i].toMatrixTranspose()
-            * Ia * model.X_lambda[i].toMatrix();
+        SpatialMatrix Ia = data.IA[i] 
+          - ( model.mCustomJoints[kI]->U
+              * model.mCustomJoints[kI]->Dinv
+              * model.mCustomJoints[kI]->U.transpose());
+        data.IA[lambda] += data.X_lambda[i].toMatrixTranspose()
+          * Ia * data.X_lambda[i].toMatrix();
 #else
-          model.IA[lambda].noalias() += model.X_lambda[i].toMatrixTranspose()
-            * Ia
-            * model.X_lambda[i].toMatrix();
+        SpatialArticulatedBodyInertia Ia = data.IA_compact[i]
+          - SpatialArticulatedBodyInertia (SpatialMatrix (
+                model.mCustomJoints[kI]->U
+                * model.mCustomJoints[kI]->Dinv
+                * model.mCustomJoints[kI]->U.transpose()));
+
+        data.IA_compact[lambda] += data.X_lambda[i].applyTranspose (Ia);
 #endif
-        }
       }
     }
   }
+}
+
+RBDL_DLLAPI void CalcMInvTimesTau ( const Model &model,
+    ModelData &data,
+    const VectorNd &Q,
+    const VectorNd &Tau,
+    VectorNd &QDDot,
+    bool update_kinematics) {
+  RBDL_TRACE_ALGORITHM ("CalcMInvTimesTau");
+
+  RBDL_LOG << "Q          = " << Q.transpose() << std::endl;
+  RBDL_LOG << "---" << std::endl;
+
+  // velocities and accelerations get overwritten
+  data.InvalidateKinematicsCache();
+
+  // Reset the velocity of the root body
+  data.v[0].setZero();
+  data.a[0].setZero();
+
+  if (update_kinematics) {
+    CalcArticulatedBodyInertias (model, data, Q);
+
+    for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+      data.v_J[i].setZero();
+      data.v[i].setZero();
+      data.c[i].setZero();
+    }
+  }
+
+  for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+    data.pA[i].setZero();
+  }
+
+  // ClearLogOutput();
 
   // compute articulated bias forces
   for (unsigned int i = model.mBodies.size() - 1; i > 0; i--) {
@@ -762,19 +1322,19 @@ RBDL_DLLAPI void CalcMInvTimesTau ( Model &model,
     if (model.mJoints[i].mDoFCount == 1
         && model.mJoints[i].mJointType != JointTypeCustom) {
 
-      model.u[i] = Tau[q_index] - model.S[i].dot(model.pA[i]);
-      // RBDL_LOG << "u[" << i << "] = " << model.u[i] << std::endl;
+      data.u[i] = Tau[q_index] - data.S[i].dot(data.pA[i]);
+      // RBDL_LOG << "u[" << i << "] = " << data.u[i] << std::endl;
       unsigned int lambda = model.lambda[i];
       if (lambda != 0) {
-        SpatialVector pa = model.pA[i] + model.U[i] * model.u[i] / model.d[i];
+        SpatialVector pa = data.pA[i] + data.U[i] * data.u[i] / data.d[i];
 
 #ifdef RBDL_USE_CASADI_MATH
-        model.pA[lambda] += model.X_lambda[i].applyTranspose(pa);
+        data.pA[lambda] += data.X_lambda[i].applyTranspose(pa);
 #else
-        model.pA[lambda].noalias() += model.X_lambda[i].applyTranspose(pa);
+        data.pA[lambda].noalias() += data.X_lambda[i].applyTranspose(pa);
 #endif
         RBDL_LOG << "pA[" << lambda << "] = "
-          << model.pA[lambda].transpose() << std::endl;
+          << data.pA[lambda].transpose() << std::endl;
       }
     } else if (model.mJoints[i].mDoFCount == 3
         && model.mJoints[i].mJointType != JointTypeCustom) {
@@ -782,26 +1342,26 @@ RBDL_DLLAPI void CalcMInvTimesTau ( Model &model,
       Vector3d tau_temp ( Tau[q_index],
           Tau[q_index + 1],
           Tau[q_index + 2]);
-      model.multdof3_u[i] = tau_temp 
-        - model.multdof3_S[i].transpose()*model.pA[i];
+      data.multdof3_u[i] = tau_temp 
+        - data.multdof3_S[i].transpose()*data.pA[i];
       //      RBDL_LOG << "multdof3_u[" << i << "] = "
-      // << model.multdof3_u[i].transpose() << std::endl;
+      // << data.multdof3_u[i].transpose() << std::endl;
       unsigned int lambda = model.lambda[i];
 
       if (lambda != 0) {
-        SpatialVector pa = model.pA[i]
-          + model.multdof3_U[i]
-          * model.multdof3_Dinv[i]
-          * model.multdof3_u[i];
+        SpatialVector pa = data.pA[i]
+          + data.multdof3_U[i]
+          * data.multdof3_Dinv[i]
+          * data.multdof3_u[i];
 
 #ifdef RBDL_USE_CASADI_MATH
-        model.pA[lambda] += model.X_lambda[i].applyTranspose(pa);
+        data.pA[lambda] += data.X_lambda[i].applyTranspose(pa);
 #else
-        model.pA[lambda].noalias() +=
-          model.X_lambda[i].applyTranspose(pa);
+        data.pA[lambda].noalias() +=
+          data.X_lambda[i].applyTranspose(pa);
 #endif
         RBDL_LOG << "pA[" << lambda << "] = "
-          << model.pA[lambda].transpose() << std::endl;
+          << data.pA[lambda].transpose() << std::endl;
       }
     } else if (model.mJoints[i].mJointType == JointTypeCustom) {
       unsigned int kI     = model.mJoints[i].custom_joint_index;
@@ -809,25 +1369,25 @@ RBDL_DLLAPI void CalcMInvTimesTau ( Model &model,
       VectorNd tau_temp(Tau.block(q_index,0,dofI,1));
 
       model.mCustomJoints[kI]->u = 
-        tau_temp - ( model.mCustomJoints[kI]->S.transpose()* model.pA[i]);
+        tau_temp - ( model.mCustomJoints[kI]->S.transpose()* data.pA[i]);
       //      RBDL_LOG << "mCustomJoints[kI]->u"
       // << model.mCustomJoints[kI]->u.transpose() << std::endl;
       unsigned int lambda = model.lambda[i];
 
       if (lambda != 0) {
-        SpatialVector pa = model.pA[i]
+        SpatialVector pa = data.pA[i]
           + (   model.mCustomJoints[kI]->U
               * model.mCustomJoints[kI]->Dinv
               * model.mCustomJoints[kI]->u);
 
 #ifdef RBDL_USE_CASADI_MATH
-        model.pA[lambda] += model.X_lambda[i].applyTranspose(pa);
+        data.pA[lambda] += data.X_lambda[i].applyTranspose(pa);
 #else
-        model.pA[lambda].noalias() +=
-          model.X_lambda[i].applyTranspose(pa);
+        data.pA[lambda].noalias() +=
+          data.X_lambda[i].applyTranspose(pa);
 #endif
         RBDL_LOG << "pA[" << lambda << "] = "
-          << model.pA[lambda].transpose() << std::endl;
+          << data.pA[lambda].transpose() << std::endl;
       }
     }
   }
@@ -837,38 +1397,38 @@ RBDL_DLLAPI void CalcMInvTimesTau ( Model &model,
   for (unsigned int i = 1; i < model.mBodies.size(); i++) {
     unsigned int q_index = model.mJoints[i].q_index;
     unsigned int lambda = model.lambda[i];
-    SpatialTransform X_lambda = model.X_lambda[i];
+    SpatialTransform X_lambda = data.X_lambda[i];
 
-    model.a[i] = X_lambda.apply(model.a[lambda]) + model.c[i];
-    RBDL_LOG << "a'[" << i << "] = " << model.a[i].transpose() << std::endl;
+    data.a[i] = X_lambda.apply(data.a[lambda]) + data.c[i];
+    RBDL_LOG << "a'[" << i << "] = " << data.a[i].transpose() << std::endl;
 
     if (model.mJoints[i].mDoFCount == 1
         && model.mJoints[i].mJointType != JointTypeCustom) {
-      QDDot[q_index] = (1./model.d[i])*(model.u[i]-model.U[i].dot(model.a[i]));
-      model.a[i]     = model.a[i] + model.S[i] * QDDot[q_index];
+      QDDot[q_index] = (1./data.d[i])*(data.u[i]-data.U[i].dot(data.a[i]));
+      data.a[i]     = data.a[i] + data.S[i] * QDDot[q_index];
     } else if (model.mJoints[i].mDoFCount == 3
         && model.mJoints[i].mJointType != JointTypeCustom) {
       Vector3d qdd_temp = 
-        model.multdof3_Dinv[i] * (model.multdof3_u[i]
-            - model.multdof3_U[i].transpose()*model.a[i]);
+        data.multdof3_Dinv[i] * (data.multdof3_u[i]
+            - data.multdof3_U[i].transpose()*data.a[i]);
 
       QDDot[q_index]      = qdd_temp[0];
       QDDot[q_index + 1]  = qdd_temp[1];
       QDDot[q_index + 2]  = qdd_temp[2];
-      model.a[i]          = model.a[i] + model.multdof3_S[i] * qdd_temp;
+      data.a[i]          = data.a[i] + data.multdof3_S[i] * qdd_temp;
     } else if (model.mJoints[i].mJointType == JointTypeCustom) {
       unsigned int kI     = model.mJoints[i].custom_joint_index;
       unsigned int dofI   = model.mCustomJoints[kI]->mDoFCount;
 
       VectorNd qdd_temp = model.mCustomJoints[kI]->Dinv
         * (  model.mCustomJoints[kI]->u 
-            - model.mCustomJoints[kI]->U.transpose() * model.a[i]);
+            - model.mCustomJoints[kI]->U.transpose() * data.a[i]);
 
       for(unsigned z = 0; z < dofI; ++z){
         QDDot[q_index+z]      = qdd_temp[z];
       }
 
-      model.a[i] =    model.a[i]
+      data.a[i] =    data.a[i]
         + model.mCustomJoints[kI]->S * qdd_temp;
     }
   }
@@ -876,4 +1436,492 @@ RBDL_DLLAPI void CalcMInvTimesTau ( Model &model,
   RBDL_LOG << "QDDot = " << QDDot.transpose() << std::endl;
 }
 
+RBDL_DLLAPI void CalcMInvTimesTau ( Model &model,
+    const VectorNd &Q,
+    const VectorNd &Tau,
+    VectorNd &QDDot,
+    bool update_kinematics) {
+  CalcMInvTimesTau (model, model, Q, Tau, QDDot, update_kinematics);
+}
+
+#ifndef RBDL_USE_CASADI_MATH
+RBDL_DLLAPI
+MassMatrixFactorization::MassMatrixFactorization() {
+}
+
+RBDL_DLLAPI
+MassMatrixFactorization::MassMatrixFactorization (const Model &model) {
+  resize (model);
+}
+
+RBDL_DLLAPI
+void MassMatrixFactorization::resize (const Model &model) {
+  L = MatrixNd::Zero (model.qdot_size, model.qdot_size);
+}
+
+RBDL_DLLAPI void FactorizeMassMatrix (
+    const Model &model,
+    ModelData &data,
+    const VectorNd &Q,
+    MassMatrixFactorization &factorization) {
+  RBDL_TRACE_ALGORITHM ("FactorizeMassMatrix");
+  RBDL_LOG << "-------- " << __func__ << " --------" << std::endl;
+
+  if (factorization.L.rows() != model.qdot_size
+      || factorization.L.cols() != model.qdot_size) {
+    factorization.resize (model);
+  } else {
+    factorization.L.setZero();
+  }
+
+  CompositeRigidBodyAlgorithm (model, data, Q, factorization.L, true, true);
+  SparseFactorizeLTL (model, factorization.L);
+}
+
+RBDL_DLLAPI void FactorizeMassMatrix (
+    Model &model,
+    const VectorNd &Q,
+    MassMatrixFactorization &factorization) {
+  FactorizeMassMatrix (model, model, Q, factorization);
+}
+
+RBDL_DLLAPI void CalcMInvTimesTau (
+    const Model &model,
+    MassMatrixFactorization &factorization,
+    const MatrixNd &Tau,
+    MatrixNd &QDDot) {
+  const MatrixNd &L = factorization.L;
+  MatrixNd &LInvT = factorization.LInvT;
+
+  if (L.rows() != model.qdot_size) {
+    throw Errors::RBDLError("Error: mass matrix factorization does not "
+        "match the model!\n");
+  }
+
+  if (Tau.rows() != model.qdot_size) {
+    throw Errors::RBDLDofMismatchError("Error: rows of Tau do not match the "
+        "dimensions of the model!\n");
+  }
+
+  // The right hand sides are stored as rows such that every step of the
+  // sparse substitutions updates all of them with a single vector
+  // operation.
+  LInvT = Tau.transpose();
+
+  // same as SparseSolveLTx()
+  for (unsigned int i = model.qdot_size; i > 0; i--) {
+    LInvT.col(i - 1) /= L(i - 1, i - 1);
+    unsigned int j = model.lambda_q[i];
+    while (j != 0) {
+      LInvT.col(j - 1) -= L(i - 1, j - 1) * LInvT.col(i - 1);
+      j = model.lambda_q[j];
+    }
+  }
+
+  // same as SparseSolveLx()
+  for (unsigned int i = 1; i <= model.qdot_size; i++) {
+    unsigned int j = model.lambda_q[i];
+    while (j != 0) {
+      LInvT.col(i - 1) -= L(i - 1, j - 1) * LInvT.col(j - 1);
+      j = model.lambda_q[j];
+    }
+    LInvT.col(i - 1) /= L(i - 1, i - 1);
+  }
+
+  QDDot = LInvT.transpose();
+}
+
+RBDL_DLLAPI void CalcMInvTimesTau (
+    const Model &model,
+    MassMatrixFactorization &factorization,
+    const VectorNd &Tau,
+    VectorNd &QDDot) {
+  if (factorization.L.rows() != model.qdot_size) {
+    throw Errors::RBDLError("Error: mass matrix factorization does not "
+        "match the model!\n");
+  }
+
+  if (Tau.size() != model.qdot_size) {
+    throw Errors::RBDLDofMismatchError("Error: size of Tau does not match "
+        "the dimensions of the model!\n");
+  }
+
+  QDDot = Tau;
+  SparseSolveLTx (model, factorization.L, QDDot);
+  SparseSolveLx (model, factorization.L, QDDot);
+}
+#endif
+
+#ifndef RBDL_USE_CASADI_MATH
+RBDL_DLLAPI void CalcOperationalSpaceInertiaInverse (
+    const Model &model,
+    ModelData &data,
+    const VectorNd &Q,
+    const std::vector<unsigned int> &body_ids,
+    const std::vector<Vector3d> &body_points,
+    MatrixNd &LambdaInv,
+    bool update_kinematics) {
+  RBDL_TRACE_ALGORITHM ("CalcOperationalSpaceInertiaInverse");
+  RBDL_PERF_COUNTER ("CalcOperationalSpaceInertiaInverse");
+
+  if (body_ids.size() != body_points.size()) {
+    throw Errors::RBDLSizeMismatchError("Error: number of body ids and "
+        "body points do not match!\n");
+  }
+
+  if (update_kinematics) {
+    CalcArticulatedBodyInertias (model, data, Q);
+  }
+
+  // The inverse articulated-body inertia of body i is the acceleration of
+  // body i that results from a unit force on body i. It is the sum of the
+  // joint space responses S D^-1 S^T of the joint of body i and of its
+  // ancestors, which see the force through the force propagators Chi.
+  for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+    unsigned int lambda = model.lambda[i];
+    SpatialMatrix S_Dinv_ST;
+    SpatialMatrix U_Dinv_ST;
+
+    if (model.mJoints[i].mDoFCount == 1
+        && model.mJoints[i].mJointType != JointTypeCustom) {
+      SpatialVector S_Dinv = data.S[i] / data.d[i];
+      S_Dinv_ST = data.S[i] * S_Dinv.transpose();
+      U_Dinv_ST = data.U[i] * S_Dinv.transpose();
+    } else if (model.mJoints[i].mDoFCount == 3
+        && model.mJoints[i].mJointType != JointTypeCustom) {
+      Matrix63 S_Dinv = data.multdof3_S[i] * data.multdof3_Dinv[i];
+      S_Dinv_ST = S_Dinv * data.multdof3_S[i].transpose();
+      U_Dinv_ST = data.multdof3_U[i] * S_Dinv.transpose();
+    } else if (model.mJoints[i].mJointType == JointTypeCustom) {
+      unsigned int kI = model.mJoints[i].custom_joint_index;
+      MatrixNd S_Dinv = model.mCustomJoints[kI]->S
+        * model.mCustomJoints[kI]->Dinv;
+      S_Dinv_ST = S_Dinv * model.mCustomJoints[kI]->S.transpose();
+      U_Dinv_ST = model.mCustomJoints[kI]->U * S_Dinv.transpose();
+    }
+
+    data.Chi[i] = data.X_lambda[i].toMatrixTranspose()
+      * (SpatialMatrix::Identity() - U_Dinv_ST);
+
+    if (lambda != 0) {
+      data.X_base[i] = data.X_lambda[i] * data.X_base[lambda];
+      data.Omega[i] = data.Chi[i].transpose() * data.Omega[lambda]
+        * data.Chi[i] + S_Dinv_ST;
+    } else {
+      data.X_base[i] = data.X_lambda[i];
+      data.Omega[i] = S_Dinv_ST;
+    }
+  }
+
+  // Propagates the spatial forces of unit forces at the points towards the
+  // root. path_force holds the force at every ancestor of a point.
+  unsigned int point_count = body_ids.size();
+  std::vector<unsigned int> path_start (point_count + 1, 0);
+  std::vector<unsigned int> path_body;
+  std::vector<Matrix63> path_force;
+
+  for (unsigned int k = 0; k < point_count; k++) {
+    unsigned int body_id = body_ids[k];
+    Vector3d point = body_points[k];
+
+    if (model.IsFixedBodyId (body_id)) {
+      const FixedBody &fixed_body =
+        model.mFixedBodies[body_id - model.fixed_body_discriminator];
+      body_id = fixed_body.mMovableParent;
+      point = fixed_body.mParentTransform.E.transpose() * point
+        + fixed_body.mParentTransform.r;
+    }
+
+    // spatial force in body coordinates of a force in base coordinates
+    // that acts on the point
+    Matrix63 force;
+    force.block<3,3>(0,0) = VectorCrossMatrix (point)
+      * data.X_base[body_id].E;
+    force.block<3,3>(3,0) = data.X_base[body_id].E;
+
+    path_start[k] = path_body.size();
+    while (body_id != 0) {
+      path_body.push_back (body_id);
+      path_force.push_back (force);
+
+      force = data.Chi[body_id] * force;
+      body_id = model.lambda[body_id];
+    }
+  }
+  path_start[point_count] = path_body.size();
+
+  if (LambdaInv.rows() != 3 * point_count
+      || LambdaInv.cols() != 3 * point_count) {
+    LambdaInv.resize (3 * point_count, 3 * point_count);
+  }
+
+  // Two points only interact through the inverse articulated-body inertia
+  // of their nearest common ancestor. As parents have lower ids than their
+  // children it is found by merging the two paths.
+  for (unsigned int k = 0; k < point_count; k++) {
+    for (unsigned int l = 0; l <= k; l++) {
+      unsigned int a = path_start[k];
+      unsigned int b = path_start[l];
+      Matrix3d block (Matrix3d::Zero());
+
+      while (a < path_start[k + 1] && b < path_start[l + 1]) {
+        if (path_body[a] > path_body[b]) {
+          a++;
+        } else if (path_body[a] < path_body[b]) {
+          b++;
+        } else {
+          block = path_force[a].transpose() * data.Omega[path_body[a]]
+            * path_force[b];
+          break;
+        }
+      }
+
+      LambdaInv.block<3,3>(3 * k, 3 * l) = block;
+      LambdaInv.block<3,3>(3 * l, 3 * k) = block.transpose();
+    }
+  }
+}
+
+RBDL_DLLAPI void CalcOperationalSpaceInertiaInverse (
+    Model &model,
+    const VectorNd &Q,
+    const std::vector<unsigned int> &body_ids,
+    const std::vector<Vector3d> &body_points,
+    MatrixNd &LambdaInv,
+    bool update_kinematics) {
+  CalcOperationalSpaceInertiaInverse (model, model, Q, body_ids,
+      body_points, LambdaInv, update_kinematics);
+}
+
+RBDL_DLLAPI void CalcOperationalSpaceInertia (
+    const Model &model,
+    ModelData &data,
+    const VectorNd &Q,
+    const std::vector<unsigned int> &body_ids,
+    const std::vector<Vector3d> &body_points,
+    MatrixNd &Lambda,
+    bool update_kinematics) {
+  CalcOperationalSpaceInertiaInverse (model, data, Q, body_ids, body_points,
+      Lambda, update_kinematics);
+
+  Lambda = Lambda.llt().solve (MatrixNd::Identity (Lambda.rows(),
+        Lambda.cols()));
+}
+
+RBDL_DLLAPI void CalcOperationalSpaceInertia (
+    Model &model,
+    const VectorNd &Q,
+    const std::vector<unsigned int> &body_ids,
+    const std::vector<Vector3d> &body_points,
+    MatrixNd &Lambda,
+    bool update_kinematics) {
+  CalcOperationalSpaceInertia (model, model, Q, body_ids, body_points,
+      Lambda, update_kinematics);
+}
+#endif
+
+#ifndef RBDL_USE_CASADI_MATH
+static void CheckDerivativeJoints (const Model &model) {
+  for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+    JointType type = model.mJoints[i].mJointType;
+
+    if (model.mJoints[i].mDoFCount != 1
+        || type == JointTypeCustom
+        || type == JointTypeHelical) {
+      std::ostringstream errormsg;
+      errormsg << "Error: dynamics derivatives are not supported for the "
+        << "joint of body " << i << "! Only 1-DoF joints with a constant "
+        << "motion subspace are supported." << std::endl;
+      throw Errors::RBDLError(errormsg.str());
+    }
+  }
+}
+
+RBDL_DLLAPI void InverseDynamicsDerivatives (
+    const Model &model,
+    ModelData &data,
+    const VectorNd &Q,
+    const VectorNd &QDot,
+    const VectorNd &QDDot,
+    VectorNd &Tau,
+    MatrixNd &dTau_dQ,
+    MatrixNd &dTau_dQDot) {
+  RBDL_TRACE_ALGORITHM ("InverseDynamicsDerivatives");
+  RBDL_LOG << "-------- " << __func__ << " --------" << std::endl;
+
+  CheckDerivativeJoints (model);
+
+  // afterwards data.f contains the forces transmitted by the joints
+  InverseDynamics (model, data, Q, QDot, QDDot, Tau);
+
+  const unsigned int body_count = model.mBodies.size();
+
+  dTau_dQ.setZero (model.qdot_size, model.qdot_size);
+  dTau_dQDot.setZero (model.qdot_size, model.qdot_size);
+
+  std::vector<SpatialVector> dv (body_count, SpatialVector::Zero());
+  std::vector<SpatialVector> da (body_count, SpatialVector::Zero());
+  std::vector<SpatialVector> df (body_count, SpatialVector::Zero());
+  std::vector<bool> supported (body_count, false);
+
+  for (unsigned int j = 1; j < body_count; j++) {
+    const unsigned int k = model.mJoints[j].q_index;
+    const SpatialVector &S_j = data.S[j];
+
+    for (unsigned int wrt_qdot = 0; wrt_qdot < 2; wrt_qdot++) {
+      MatrixNd &dTau = wrt_qdot ? dTau_dQDot : dTau_dQ;
+
+      // Forward sweep over the bodies supported by joint j. With
+      // X_lambda = X_J(q_k) X_T we have d X_lambda / d q_k = -S_j x X_lambda.
+      for (unsigned int i = j; i < body_count; i++) {
+        const unsigned int lambda = model.lambda[i];
+
+        supported[i] = (i == j) || (lambda >= j && supported[lambda]);
+        if (!supported[i]) {
+          continue;
+        }
+
+        if (i == j && !wrt_qdot) {
+          dv[i] = crossm (data.v[i], S_j);
+          da[i] = - crossm (S_j, data.X_lambda[i].apply (data.a[lambda]))
+            + crossm (dv[i], data.v_J[i]);
+        } else if (i == j) {
+          dv[i] = S_j;
+          da[i] = crossm (dv[i], data.v_J[i]) + crossm (data.v[i], S_j);
+        } else {
+          dv[i] = data.X_lambda[i].apply (dv[lambda]);
+          da[i] = data.X_lambda[i].apply (da[lambda])
+            + crossm (dv[i], data.v_J[i]);
+        }
+
+        df[i] = model.I[i] * da[i]
+          + crossf (dv[i], model.I[i] * data.v[i])
+          + crossf (data.v[i], model.I[i] * dv[i]);
+      }
+
+      // Backward sweep over the supported bodies
+      for (unsigned int i = body_count - 1; i >= j; i--) {
+        if (!supported[i]) {
+          continue;
+        }
+
+        dTau(model.mJoints[i].q_index, k) = data.S[i].dot (df[i]);
+
+        if (i != j) {
+          df[model.lambda[i]] += data.X_lambda[i].applyTranspose (df[i]);
+        }
+      }
+
+      // Forces of the ancestors of body j
+      SpatialVector dF = df[j];
+      if (!wrt_qdot) {
+        dF += crossf (S_j, data.f[j]);
+      }
+
+      for (unsigned int i = j; model.lambda[i] != 0; i = model.lambda[i]) {
+        dF = data.X_lambda[i].applyTranspose (dF);
+        dTau(model.mJoints[model.lambda[i]].q_index, k)
+          = data.S[model.lambda[i]].dot (dF);
+      }
+    }
+  }
+}
+
+RBDL_DLLAPI void InverseDynamicsDerivatives (
+    Model &model,
+    const VectorNd &Q,
+    const VectorNd &QDot,
+    const VectorNd &QDDot,
+    VectorNd &Tau,
+    MatrixNd &dTau_dQ,
+    MatrixNd &dTau_dQDot) {
+  InverseDynamicsDerivatives (model, model, Q, QDot, QDDot, Tau, dTau_dQ,
+      dTau_dQDot);
+}
+
+RBDL_DLLAPI
+ForwardDynamicsDerivativesWorkspace::ForwardDynamicsDerivativesWorkspace() {
+}
+
+RBDL_DLLAPI
+ForwardDynamicsDerivativesWorkspace::ForwardDynamicsDerivativesWorkspace (
+    const Model &model) {
+  resize (model);
+}
+
+RBDL_DLLAPI
+void ForwardDynamicsDerivativesWorkspace::resize (const Model &model) {
+  factorization.resize (model);
+  tau = VectorNd::Zero (model.qdot_size);
+}
+
+RBDL_DLLAPI void ForwardDynamicsDerivatives (
+    const Model &model,
+    ModelData &data,
+    const VectorNd &Q,
+    const VectorNd &QDot,
+    const VectorNd &Tau,
+    VectorNd &QDDot,
+    MatrixNd &dQDDot_dQ,
+    MatrixNd &dQDDot_dQDot,
+    MatrixNd &dQDDot_dTau,
+    ForwardDynamicsDerivativesWorkspace &workspace) {
+  RBDL_TRACE_ALGORITHM ("ForwardDynamicsDerivatives");
+  RBDL_LOG << "-------- " << __func__ << " --------" << std::endl;
+
+  CheckDerivativeJoints (model);
+
+  if (workspace.tau.size() != model.qdot_size) {
+    workspace.resize (model);
+  }
+
+  ForwardDynamics (model, data, Q, QDot, Tau, QDDot);
+
+  InverseDynamicsDerivatives (model, data, Q, QDot, QDDot, workspace.tau,
+      dQDDot_dQ, dQDDot_dQDot);
+
+  MassMatrixFactorization &minv = workspace.factorization;
+  FactorizeMassMatrix (model, data, Q, minv);
+
+  // CalcMInvTimesTau() copies the right hand sides into minv.LInvT before
+  // writing the result such that all solves can be done in place.
+  dQDDot_dTau.setIdentity (model.qdot_size, model.qdot_size);
+  CalcMInvTimesTau (model, minv, dQDDot_dTau, dQDDot_dTau);
+
+  dQDDot_dQ *= -1.;
+  CalcMInvTimesTau (model, minv, dQDDot_dQ, dQDDot_dQ);
+
+  dQDDot_dQDot *= -1.;
+  CalcMInvTimesTau (model, minv, dQDDot_dQDot, dQDDot_dQDot);
+}
+
+RBDL_DLLAPI void ForwardDynamicsDerivatives (
+    const Model &model,
+    ModelData &data,
+    const VectorNd &Q,
+    const VectorNd &QDot,
+    const VectorNd &Tau,
+    VectorNd &QDDot,
+    MatrixNd &dQDDot_dQ,
+    MatrixNd &dQDDot_dQDot,
+    MatrixNd &dQDDot_dTau) {
+  ForwardDynamicsDerivativesWorkspace workspace (model);
+  ForwardDynamicsDerivatives (model, data, Q, QDot, Tau, QDDot, dQDDot_dQ,
+      dQDDot_dQDot, dQDDot_dTau, workspace);
+}
+
+RBDL_DLLAPI void ForwardDynamicsDerivatives (
+    Model &model,
+    const VectorNd &Q,
+    const VectorNd &QDot,
+    const VectorNd &Tau,
+    VectorNd &QDDot,
+    MatrixNd &dQDDot_dQ,
+    MatrixNd &dQDDot_dQDot,
+    MatrixNd &dQDDot_dTau) {
+  ForwardDynamicsDerivatives (model, model, Q, QDot, Tau, QDDot, dQDDot_dQ,
+      dQDDot_dQDot, dQDDot_dTau);
+}
+#endif
+
 } /* namespace RigidBodyDynamics */
@@ -0,0 +1,217 @@
+/*
+ * RBDL - Rigid Body Dynamics Library
+ * Copyright (c) 2011-2018 Martin Felis <martin@fysx.org>
+ *
+ * Licensed under the zlib license. See LICENSE for more details.
+ */
+
+#include "rbdl/rbdl_errors.h"
+#include "rbdl/Integrators.h"
+#include "rbdl/Constraints.h"
+#include "rbdl/Dynamics.h"
+
+#ifndef RBDL_USE_CASADI_MATH
+
+namespace RigidBodyDynamics {
+
+using namespace Math;
+
+RBDL_DLLAPI void IntegrateQ (
+    const Model &model,
+    const VectorNd &Q,
+    const VectorNd &QDot,
+    double dt,
+    VectorNd &QOut) {
+  if (QOut.size() != model.q_size) {
+    QOut.resize (model.q_size);
+  }
+
+  for (unsigned int i = 1; i < model.mJoints.size(); i++) {
+    unsigned int q_index = model.mJoints[i].q_index;
+
+    if (model.mJoints[i].mJointType == JointTypeSpherical) {
+      Quaternion quat = model.GetQuaternion (i, Q);
+      Vector3d omega (QDot[q_index], QDot[q_index + 1], QDot[q_index + 2]);
+      double angle = omega.norm() * dt;
+
+      if (angle != 0.) {
+        quat = quat * Quaternion::fromAxisAngle (omega, angle);
+      }
+      quat /= quat.norm();
+
+      model.SetQuaternion (i, quat, QOut);
+    } else {
+      for (unsigned int j = 0; j < model.mJoints[i].mDoFCount; j++) {
+        QOut[q_index + j] = Q[q_index + j] + dt * QDot[q_index + j];
+      }
+    }
+  }
+}
+
+Integrator::Integrator () :
+  method (IntegratorSemiImplicitEuler),
+  project_constraints (true),
+  projection_tolerance (1.0e-12),
+  projection_max_iterations (100),
+  projection_warm_start (true)
+{}
+
+Integrator::Integrator (const Model &model, IntegratorMethod method) :
+  method (method),
+  project_constraints (true),
+  projection_tolerance (1.0e-12),
+  projection_max_iterations (100),
+  projection_warm_start (true) {
+  resize (model);
+}
+
+void Integrator::resize (const Model &model) {
+  projection_weights = VectorNd::Constant (model.dof_count, 1.);
+
+  mQStage = VectorNd::Zero (model.q_size);
+  mQDotStage.assign (4, VectorNd::Zero (model.qdot_size));
+  mQDDotStage.assign (4, VectorNd::Zero (model.qdot_size));
+  mQProjected = VectorNd::Zero (model.q_size);
+  mQDotProjected = VectorNd::Zero (model.qdot_size);
+}
+
+void Integrator::Step (
+    const Model &model,
+    ModelData &data,
+    VectorNd &Q,
+    VectorNd &QDot,
+    const VectorNd &Tau,
+    double dt) {
+  Integrate (model, data, NULL, NULL, Q, QDot, Tau, dt);
+}
+
+bool Integrator::Step (
+    Model &model,
+    VectorNd &Q,
+    VectorNd &QDot,
+    const VectorNd &Tau,
+    double dt,
+    ConstraintSet *CS) {
+  Integrate (model, model, &model, CS, Q, QDot, Tau, dt);
+
+  if (CS == NULL || !project_constraints) {
+    return true;
+  }
+
+  // The warm start setting of the caller is restored after the projection
+  bool assembly_warm_start = CS->assembly_warm_start;
+  CS->assembly_warm_start = projection_warm_start;
+  bool converged = CalcAssemblyQ (model, Q, *CS, mQProjected,
+      projection_weights, projection_tolerance, projection_max_iterations);
+  CS->assembly_warm_start = assembly_warm_start;
+
+  // The result of a failed projection may be further off the constraints
+  // than the integrated positions, so those are kept instead.
+  if (converged) {
+    Q = mQProjected;
+  }
+
+  CalcAssemblyQDot (model, Q, QDot, *CS, mQDotProjected, projection_weights);
+  QDot = mQDotProjected;
+
+  return converged;
+}
+
+void Integrator::CalcQDDot (
+    const Model &model,
+    ModelData &data,
+    Model *constrained_model,
+    ConstraintSet *CS,
+    const VectorNd &Q,
+    const VectorNd &QDot,
+    const VectorNd &Tau,
+    VectorNd &QDDot) {
+  if (CS != NULL) {
+    ForwardDynamicsConstraintsDirect (*constrained_model, Q, QDot, Tau, *CS,
+        QDDot);
+  } else {
+    ForwardDynamics (model, data, Q, QDot, Tau, QDDot);
+  }
+}
+
+void Integrator::Integrate (
+    const Model &model,
+    ModelData &data,
+    Model *constrained_model,
+    ConstraintSet *CS,
+    VectorNd &Q,
+    VectorNd &QDot,
+    const VectorNd &Tau,
+    double dt) {
+  if (Q.size() != model.q_size
+      || QDot.size() != model.qdot_size
+      || Tau.size() != model.qdot_size) {
+    throw Errors::RBDLDofMismatchError("Error: state dimensions do not "
+        "match the dimensions of the model!\n");
+  }
+
+  if (mQStage.size() != model.q_size
+      || mQDotStage[0].size() != model.qdot_size) {
+    throw Errors::RBDLSizeMismatchError("Error: integrator workspace does "
+        "not match the model, call Integrator::resize()!\n");
+  }
+
+  switch (method) {
+    case IntegratorSemiImplicitEuler:
+      CalcQDDot (model, data, constrained_model, CS, Q, QDot, Tau,
+          mQDDotStage[0]);
+      QDot += dt * mQDDotStage[0];
+      IntegrateQ (model, Q, QDot, dt, Q);
+      break;
+    case IntegratorStoermerVerlet:
+      CalcQDDot (model, data, constrained_model, CS, Q, QDot, Tau,
+          mQDDotStage[0]);
+      QDot += (0.5 * dt) * mQDDotStage[0];
+      IntegrateQ (model, Q, QDot, dt, Q);
+      // the velocity dependent forces of the second half step are
+      // evaluated with an explicit estimate of the new velocities, which
+      // keeps the scheme second order for Coriolis and centrifugal forces
+      mQDotStage[1] = QDot + (0.5 * dt) * mQDDotStage[0];
+      CalcQDDot (model, data, constrained_model, CS, Q, mQDotStage[1], Tau,
+          mQDDotStage[1]);
+      QDot += (0.5 * dt) * mQDDotStage[1];
+      break;
+    case IntegratorRungeKutta4:
+      // the stage velocities are integrated from the initial positions
+      // which keeps the quaternions on the unit sphere
+      mQDotStage[0] = QDot;
+      CalcQDDot (model, data, constrained_model, CS, Q, mQDotStage[0], Tau,
+          mQDDotStage[0]);
+
+      IntegrateQ (model, Q, mQDotStage[0], 0.5 * dt, mQStage);
+      mQDotStage[1] = QDot + (0.5 * dt) * mQDDotStage[0];
+      CalcQDDot (model, data, constrained_model, CS, mQStage, mQDotStage[1],
+          Tau, mQDDotStage[1]);
+
+      IntegrateQ (model, Q, mQDotStage[1], 0.5 * dt, mQStage);
+      mQDotStage[2] = QDot + (0.5 * dt) * mQDDotStage[1];
+      CalcQDDot (model, data, constrained_model, CS, mQStage, mQDotStage[2],
+          Tau, mQDDotStage[2]);
+
+      IntegrateQ (model, Q, mQDotStage[2], dt, mQStage);
+      mQDotStage[3] = QDot + dt * mQDDotStage[2];
+      CalcQDDot (model, data, constrained_model, CS, mQStage, mQDotStage[3],
+          Tau, mQDDotStage[3]);
+
+      // the weighted sums are accumulated in the first stage
+      mQDotStage[0] += 2. * (mQDotStage[1] + mQDotStage[2]) + mQDotStage[3];
+      mQDDotStage[0] += 2. * (mQDDotStage[1] + mQDDotStage[2])
+        + mQDDotStage[3];
+
+      IntegrateQ (model, Q, mQDotStage[0], dt / 6., Q);
+      QDot += (dt / 6.) * mQDDotStage[0];
+      break;
+    default:
+      throw Errors::RBDLError("Error: invalid integrator method!\n");
+  }
+}
+
+}
+
+/* RBDL_USE_CASADI_MATH */
+#endif
@@ -46,8 +46,25 @@ namespace RigidBodyDynamics {
 
 using namespace Math;
 
+/** \brief Returns the (non-const) model on which a CustomJoint operates.
+ *
+ * The interface of CustomJoint writes its results directly into the
+ * Model. This is only possible if data is the workspace of the model
+ * itself.
+ */
+static Model& CustomJointModel (const Model &model, ModelData &data) {
+  if (static_cast<const ModelData*>(&model) != &data) {
+    throw Errors::RBDLError("Error: custom joints can only be evaluated "
+        "using the ModelData of the Model itself!");
+  }
+
+  // data is the workspace of model, therefore model is not actually const
+  return const_cast<Model&>(model);
+}
+
 RBDL_DLLAPI void jcalc (
-    Model &model,
+    const Model &model,
+    ModelData &data,
     unsigned int joint_id,
     const VectorNd &q,
     const VectorNd &qdot
@@ -55,11 +72,13 @@ RBDL_DLLAPI void jcalc (
   // exception if we calculate it for the root body
   assert (joint_id > 0);
 
+  data.InvalidateKinematicsCache();
+
   if (model.mJoints[joint_id].mJointType == JointTypeRevoluteX) {
     Scalar s, c;
     sincosp (q[model.mJoints[joint_id].q_index], &s, &c);
 
-    model.X_lambda[joint_id].E = Matrix3d (
+    data.X_lambda[joint_id].E = Matrix3d (
         model.X_T[joint_id].E(0, 0),
         model.X_T[joint_id].E(0, 1),
         model.X_T[joint_id].E(0, 2),
@@ -72,14 +91,14 @@ RBDL_DLLAPI void jcalc (
         -s * model.X_T[joint_id].E(1, 1) + c * model.X_T[joint_id].E(2, 1),
         -s * model.X_T[joint_id].E(1, 2) + c * model.X_T[joint_id].E(2, 2));
 
-    model.X_lambda[joint_id].r = model.X_T[joint_id].r;
+    data.X_lambda[joint_id].r = model.X_T[joint_id].r;
 
-    model.v_J[joint_id][0] = qdot[model.mJoints[joint_id].q_index];
+    data.v_J[joint_id][0] = qdot[model.mJoints[joint_id].q_index];
   } else if (model.mJoints[joint_id].mJointType == JointTypeRevoluteY) {
     Scalar s, c;
     sincosp (q[model.mJoints[joint_id].q_index], &s, &c);
 
-    model.X_lambda[joint_id].E = Matrix3d (
+    data.X_lambda[joint_id].E = Matrix3d (
         c * model.X_T[joint_id].E(0, 0) + -s * model.X_T[joint_id].E(2, 0),
         c * model.X_T[joint_id].E(0, 1) + -s * model.X_T[joint_id].E(2, 1),
         c * model.X_T[joint_id].E(0, 2) + -s * model.X_T[joint_id].E(2, 2),
@@ -92,14 +111,14 @@ RBDL_DLLAPI void jcalc (
         s * model.X_T[joint_id].E(0, 1) + c * model.X_T[joint_id].E(2, 1),
         s * model.X_T[joint_id].E(0, 2) + c * model.X_T[joint_id].E(2, 2));
 
-    model.X_lambda[joint_id].r = model.X_T[joint_id].r;
+    data.X_lambda[joint_id].r = model.X_T[joint_id].r;
 
-    model.v_J[joint_id][1] = qdot[model.mJoints[joint_id].q_index];
+    data.v_J[joint_id][1] = qdot[model.mJoints[joint_id].q_index];
   } else if (model.mJoints[joint_id].mJointType == JointTypeRevoluteZ) {
     Scalar s, c;
     sincosp (q[model.mJoints[joint_id].q_index], &s, &c);
 
-    model.X_lambda[joint_id].E = Matrix3d (
+    data.X_lambda[joint_id].E = Matrix3d (
          c * model.X_T[joint_id].E(0, 0) + s * model.X_T[joint_id].E(1, 0),
          c * model.X_T[joint_id].E(0, 1) + s * model.X_T[joint_id].E(1, 1),
          c * model.X_T[joint_id].E(0, 2) + s * model.X_T[joint_id].E(1, 2),
@@ -112,43 +131,43 @@ RBDL_DLLAPI void jcalc (
         model.X_T[joint_id].E(2, 1),
         model.X_T[joint_id].E(2, 2));
 
-    model.X_lambda[joint_id].r = model.X_T[joint_id].r;
+    data.X_lambda[joint_id].r = model.X_T[joint_id].r;
 
-    model.v_J[joint_id][2] = qdot[model.mJoints[joint_id].q_index];
+    data.v_J[joint_id][2] = qdot[model.mJoints[joint_id].q_index];
   } else if (model.mJoints[joint_id].mJointType == JointTypeHelical) {
     SpatialTransform X_J = jcalc_XJ (model, joint_id, q);
-    jcalc_X_lambda_S(model, joint_id, q);
+    jcalc_X_lambda_S(model, data, joint_id, q);
     Scalar Jqd = qdot[model.mJoints[joint_id].q_index];
-    model.v_J[joint_id] = model.S[joint_id] * Jqd;
+    data.v_J[joint_id] = data.S[joint_id] * Jqd;
 
-    Vector3d St = model.S[joint_id].block(0,0,3,1);
+    Vector3d St = data.S[joint_id].block(0,0,3,1);
     Vector3d c = X_J.E * model.mJoints[joint_id].mJointAxes[0].block(3,0,3,1);
     c = St.cross(c);
     c *= -Jqd * Jqd;
-    model.c_J[joint_id] = SpatialVector(0,0,0,c[0],c[1],c[2]);
-    model.X_lambda[joint_id] = X_J * model.X_T[joint_id];
+    data.c_J[joint_id] = SpatialVector(0,0,0,c[0],c[1],c[2]);
+    data.X_lambda[joint_id] = X_J * model.X_T[joint_id];
   } else if (model.mJoints[joint_id].mDoFCount == 1 &&
       model.mJoints[joint_id].mJointType != JointTypeCustom) {
     SpatialTransform X_J = jcalc_XJ (model, joint_id, q);
-    model.v_J[joint_id] =
-      model.S[joint_id] * qdot[model.mJoints[joint_id].q_index];
-    model.X_lambda[joint_id] = X_J * model.X_T[joint_id];
+    data.v_J[joint_id] =
+      data.S[joint_id] * qdot[model.mJoints[joint_id].q_index];
+    data.X_lambda[joint_id] = X_J * model.X_T[joint_id];
   } else if (model.mJoints[joint_id].mJointType == JointTypeSpherical) {
     SpatialTransform X_J = SpatialTransform (model.GetQuaternion (joint_id, q).toMatrix(),
           Vector3d (0., 0., 0.));
 
-    model.multdof3_S[joint_id](0,0) = 1.;
-    model.multdof3_S[joint_id](1,1) = 1.;
-    model.multdof3_S[joint_id](2,2) = 1.;
+    data.multdof3_S[joint_id](0,0) = 1.;
+    data.multdof3_S[joint_id](1,1) = 1.;
+    data.multdof3_S[joint_id](2,2) = 1.;
 
     Vector3d omega (qdot[model.mJoints[joint_id].q_index],
         qdot[model.mJoints[joint_id].q_index+1],
         qdot[model.mJoints[joint_id].q_index+2]);
 
-    model.v_J[joint_id] = SpatialVector (
+    data.v_J[joint_id] = SpatialVector (
         omega[0], omega[1], omega[2],
         0., 0., 0.);
-    model.X_lambda[joint_id] = X_J * model.X_T[joint_id];
+    data.X_lambda[joint_id] = X_J * model.X_T[joint_id];
   } else if (model.mJoints[joint_id].mJointType == JointTypeEulerZYX) {
     Scalar q0 = q[model.mJoints[joint_id].q_index];
     Scalar q1 = q[model.mJoints[joint_id].q_index + 1];
@@ -168,28 +187,28 @@ RBDL_DLLAPI void jcalc (
         ),
         Vector3d::Zero());
 
-    model.multdof3_S[joint_id](0,0) = -s1;
-    model.multdof3_S[joint_id](0,2) = 1.;
+    data.multdof3_S[joint_id](0,0) = -s1;
+    data.multdof3_S[joint_id](0,2) = 1.;
 
-    model.multdof3_S[joint_id](1,0) = c1 * s2;
-    model.multdof3_S[joint_id](1,1) = c2;
+    data.multdof3_S[joint_id](1,0) = c1 * s2;
+    data.multdof3_S[joint_id](1,1) = c2;
 
-    model.multdof3_S[joint_id](2,0) = c1 * c2;
-    model.multdof3_S[joint_id](2,1) = - s2;
+    data.multdof3_S[joint_id](2,0) = c1 * c2;
+    data.multdof3_S[joint_id](2,1) = - s2;
 
     Scalar qdot0 = qdot[model.mJoints[joint_id].q_index];
     Scalar qdot1 = qdot[model.mJoints[joint_id].q_index + 1];
     Scalar qdot2 = qdot[model.mJoints[joint_id].q_index + 2];
 
-    model.v_J[joint_id] =
-      model.multdof3_S[joint_id] * Vector3d (qdot0, qdot1, qdot2);
+    data.v_J[joint_id] =
+      data.multdof3_S[joint_id] * Vector3d (qdot0, qdot1, qdot2);
 
-    model.c_J[joint_id].set(
+    data.c_J[joint_id].set(
         -c1*qdot0*qdot1,
         -s1*s2*qdot0*qdot1 + c1*c2*qdot0*qdot2 - s2*qdot1*qdot2,
         -s1*c2*qdot0*qdot1 - c1*s2*qdot0*qdot2 - c2*qdot1*qdot2,
         0.,0., 0.);
-    model.X_lambda[joint_id] = X_J * model.X_T[joint_id];
+    data.X_lambda[joint_id] = X_J * model.X_T[joint_id];
   } else if (model.mJoints[joint_id].mJointType == JointTypeEulerXYZ) {
     Scalar q0 = q[model.mJoints[joint_id].q_index];
     Scalar q1 = q[model.mJoints[joint_id].q_index + 1];
@@ -209,29 +228,29 @@ RBDL_DLLAPI void jcalc (
         ),
         Vector3d::Zero());
 
-    model.multdof3_S[joint_id](0,0) = c2 * c1;
-    model.multdof3_S[joint_id](0,1) = s2;
+    data.multdof3_S[joint_id](0,0) = c2 * c1;
+    data.multdof3_S[joint_id](0,1) = s2;
 
-    model.multdof3_S[joint_id](1,0) = -s2 * c1;
-    model.multdof3_S[joint_id](1,1) = c2;
+    data.multdof3_S[joint_id](1,0) = -s2 * c1;
+    data.multdof3_S[joint_id](1,1) = c2;
 
-    model.multdof3_S[joint_id](2,0) = s1;
-    model.multdof3_S[joint_id](2,2) = 1.;
+    data.multdof3_S[joint_id](2,0) = s1;
+    data.multdof3_S[joint_id](2,2) = 1.;
 
     Scalar qdot0 = qdot[model.mJoints[joint_id].q_index];
     Scalar qdot1 = qdot[model.mJoints[joint_id].q_index + 1];
     Scalar qdot2 = qdot[model.mJoints[joint_id].q_index + 2];
 
-    model.v_J[joint_id] =
-      model.multdof3_S[joint_id] * Vector3d (qdot0, qdot1, qdot2);
+    data.v_J[joint_id] =
+      data.multdof3_S[joint_id] * Vector3d (qdot0, qdot1, qdot2);
 
-    model.c_J[joint_id].set(
+    data.c_J[joint_id].set(
         -s2*c1*qdot2*qdot0 - c2*s1*qdot1*qdot0 + c2*qdot2*qdot1,
         -c2*c1*qdot2*qdot0 + s2*s1*qdot1*qdot0 - s2*qdot2*qdot1,
         c1*qdot1*qdot0,
         0., 0., 0.
         );
-    model.X_lambda[joint_id] = X_J * model.X_T[joint_id];
+    data.X_lambda[joint_id] = X_J * model.X_T[joint_id];
   } else if (model.mJoints[joint_id].mJointType == JointTypeEulerYXZ) {
     Scalar q0 = q[model.mJoints[joint_id].q_index];
     Scalar q1 = q[model.mJoints[joint_id].q_index + 1];
@@ -250,29 +269,29 @@ RBDL_DLLAPI void jcalc (
         c1 * s0,    - s1,                 c1 * c0),
         Vector3d::Zero());
 
-    model.multdof3_S[joint_id](0,0) = s2 * c1;
-    model.multdof3_S[joint_id](0,1) = c2;
+    data.multdof3_S[joint_id](0,0) = s2 * c1;
+    data.multdof3_S[joint_id](0,1) = c2;
 
-    model.multdof3_S[joint_id](1,0) = c2 * c1;
-    model.multdof3_S[joint_id](1,1) = -s2;
+    data.multdof3_S[joint_id](1,0) = c2 * c1;
+    data.multdof3_S[joint_id](1,1) = -s2;
 
-    model.multdof3_S[joint_id](2,0) = -s1;
-    model.multdof3_S[joint_id](2,2) = 1.;
+    data.multdof3_S[joint_id](2,0) = -s1;
+    data.multdof3_S[joint_id](2,2) = 1.;
 
     Scalar qdot0 = qdot[model.mJoints[joint_id].q_index];
     Scalar qdot1 = qdot[model.mJoints[joint_id].q_index + 1];
     Scalar qdot2 = qdot[model.mJoints[joint_id].q_index + 2];
 
-    model.v_J[joint_id] =
-      model.multdof3_S[joint_id] * Vector3d (qdot0, qdot1, qdot2);
+    data.v_J[joint_id] =
+      data.multdof3_S[joint_id] * Vector3d (qdot0, qdot1, qdot2);
 
-    model.c_J[joint_id].set(
+    data.c_J[joint_id].set(
         c2*c1*qdot2*qdot0 - s2*s1*qdot1*qdot0 - s2*qdot2*qdot1,
         -s2*c1*qdot2*qdot0 - c2*s1*qdot1*qdot0 - c2*qdot2*qdot1,
         -c1*qdot1*qdot0,
         0., 0., 0.
         );
-    model.X_lambda[joint_id] = X_J * model.X_T[joint_id];
+    data.X_lambda[joint_id] = X_J * model.X_T[joint_id];
   } else if (model.mJoints[joint_id].mJointType == JointTypeEulerZXY) {
     Scalar q0 = q[model.mJoints[joint_id].q_index];
     Scalar q1 = q[model.mJoints[joint_id].q_index + 1];
@@ -285,7 +304,7 @@ RBDL_DLLAPI void jcalc (
     Scalar s2 = sin (q2);
     Scalar c2 = cos (q2);
 
-    model.X_lambda[joint_id] = SpatialTransform (
+    data.X_lambda[joint_id] = SpatialTransform (
         Matrix3d(
           -s0 * s1 * s2 + c0 * c2, s0 * c2 + s1 * s2 * c0, -s2 * c1,
           -s0 * c1, c0 * c1, s1,
@@ -294,23 +313,23 @@ RBDL_DLLAPI void jcalc (
         Vector3d::Zero())
       * model.X_T[joint_id];
 
-    model.multdof3_S[joint_id](0,0) = -s2 * c1;
-    model.multdof3_S[joint_id](0,1) = c2;
+    data.multdof3_S[joint_id](0,0) = -s2 * c1;
+    data.multdof3_S[joint_id](0,1) = c2;
 
-    model.multdof3_S[joint_id](1,0) = s1;
-    model.multdof3_S[joint_id](1,2) = 1;
+    data.multdof3_S[joint_id](1,0) = s1;
+    data.multdof3_S[joint_id](1,2) = 1;
 
-    model.multdof3_S[joint_id](2,0) = c1 * c2;
-    model.multdof3_S[joint_id](2,1) = s2;
+    data.multdof3_S[joint_id](2,0) = c1 * c2;
+    data.multdof3_S[joint_id](2,1) = s2;
 
     Scalar qdot0 = qdot[model.mJoints[joint_id].q_index];
     Scalar qdot1 = qdot[model.mJoints[joint_id].q_index + 1];
     Scalar qdot2 = qdot[model.mJoints[joint_id].q_index + 2];
 
-    model.v_J[joint_id] =
-      model.multdof3_S[joint_id] * Vector3d (qdot0, qdot1, qdot2);
+    data.v_J[joint_id] =
+      data.multdof3_S[joint_id] * Vector3d (qdot0, qdot1, qdot2);
 
-    model.c_J[joint_id].set(
+    data.c_J[joint_id].set(
         (-c1 * c2 * qdot2 + s1 * s2 * qdot1) * qdot0 - s2 * qdot1 * qdot2,
         c1 * qdot1 * qdot0,
         (-s1 * c2 * qdot1 - c1 * s2 * qdot2) * qdot0 + c2 * qdot2 * qdot1,
@@ -321,25 +340,25 @@ RBDL_DLLAPI void jcalc (
     Scalar q1 = q[model.mJoints[joint_id].q_index + 1];
     Scalar q2 = q[model.mJoints[joint_id].q_index + 2];
 
-    model.multdof3_S[joint_id](3,0) = 1.;
-    model.multdof3_S[joint_id](4,1) = 1.;
-    model.multdof3_S[joint_id](5,2) = 1.;
+    data.multdof3_S[joint_id](3,0) = 1.;
+    data.multdof3_S[joint_id](4,1) = 1.;
+    data.multdof3_S[joint_id](5,2) = 1.;
 
     Scalar qdot0 = qdot[model.mJoints[joint_id].q_index];
     Scalar qdot1 = qdot[model.mJoints[joint_id].q_index + 1];
     Scalar qdot2 = qdot[model.mJoints[joint_id].q_index + 2];
 
-    model.v_J[joint_id] =
-      model.multdof3_S[joint_id] * Vector3d (qdot0, qdot1, qdot2);
+    data.v_J[joint_id] =
+      data.multdof3_S[joint_id] * Vector3d (qdot0, qdot1, qdot2);
 
-    model.c_J[joint_id].set(0., 0., 0., 0., 0., 0.);
-    model.X_lambda[joint_id].E = model.X_T[joint_id].E;
-    model.X_lambda[joint_id].r = model.X_T[joint_id].r + model.X_T[joint_id].E.transpose() * Vector3d (q0, q1, q2);
+    data.c_J[joint_id].set(0., 0., 0., 0., 0., 0.);
+    data.X_lambda[joint_id].E = model.X_T[joint_id].E;
+    data.X_lambda[joint_id].r = model.X_T[joint_id].r + model.X_T[joint_id].E.transpose() * Vector3d (q0, q1, q2);
   } else if (model.mJoints[joint_id].mJointType == JointTypeCustom) {
     const Joint &joint = model.mJoints[joint_id];
     CustomJoint *custom_joint =
       model.mCustomJoints[joint.custom_joint_index];
-    custom_joint->jcalc (model, joint_id, q, qdot);
+    custom_joint->jcalc (CustomJointModel (model, data), joint_id, q, qdot);
   } else {
     std::ostringstream errormsg;
     errormsg << "Error: invalid joint type " << model.mJoints[joint_id].mJointType << " at id " << joint_id << std::endl;
@@ -347,9 +366,18 @@ RBDL_DLLAPI void jcalc (
   }
 }
 
-RBDL_DLLAPI Math::SpatialTransform jcalc_XJ (
+RBDL_DLLAPI void jcalc (
     Model &model,
     unsigned int joint_id,
+    const VectorNd &q,
+    const VectorNd &qdot
+    ) {
+  jcalc (model, model, joint_id, q, qdot);
+}
+
+RBDL_DLLAPI Math::SpatialTransform jcalc_XJ (
+    const Model &model,
+    unsigned int joint_id,
     const Math::VectorNd &q) {
   // exception if we calculate it for the root body
   assert (joint_id > 0);
@@ -401,18 +429,21 @@ RBDL_DLLAPI Math::SpatialTransform jcalc_XJ (
 }
 
 RBDL_DLLAPI void jcalc_X_lambda_S (
-    Model &model,
+    const Model &model,
+    ModelData &data,
     unsigned int joint_id,
     const VectorNd &q
     ) {
   // exception if we calculate it for the root body
   assert (joint_id > 0);
 
+  data.InvalidateKinematicsCache();
+
   if (model.mJoints[joint_id].mJointType == JointTypeRevoluteX) {
     Scalar s, c;
     sincosp (q[model.mJoints[joint_id].q_index], &s, &c);
 
-    model.X_lambda[joint_id].E = Matrix3d (
+    data.X_lambda[joint_id].E = Matrix3d (
         model.X_T[joint_id].E(0, 0),
         model.X_T[joint_id].E(0, 1),
         model.X_T[joint_id].E(0, 2),
@@ -425,14 +456,14 @@ RBDL_DLLAPI void jcalc_X_lambda_S (
         -s * model.X_T[joint_id].E(1, 1) + c * model.X_T[joint_id].E(2, 1),
         -s * model.X_T[joint_id].E(1, 2) + c * model.X_T[joint_id].E(2, 2));
 
-    model.X_lambda[joint_id].r = model.X_T[joint_id].r;
+    data.X_lambda[joint_id].r = model.X_T[joint_id].r;
 
-    model.S[joint_id][0] = 1.0;
+    data.S[joint_id][0] = 1.0;
   } else if (model.mJoints[joint_id].mJointType == JointTypeRevoluteY) {
     Scalar s, c;
     sincosp (q[model.mJoints[joint_id].q_index], &s, &c);
 
-    model.X_lambda[joint_id].E = Matrix3d (
+    data.X_lambda[joint_id].E = Matrix3d (
         c * model.X_T[joint_id].E(0, 0) + -s * model.X_T[joint_id].E(2, 0),
         c * model.X_T[joint_id].E(0, 1) + -s * model.X_T[joint_id].E(2, 1),
         c * model.X_T[joint_id].E(0, 2) + -s * model.X_T[joint_id].E(2, 2),
@@ -445,14 +476,14 @@ RBDL_DLLAPI void jcalc_X_lambda_S (
         s * model.X_T[joint_id].E(0, 1) + c * model.X_T[joint_id].E(2, 1),
         s * model.X_T[joint_id].E(0, 2) + c * model.X_T[joint_id].E(2, 2));
 
-    model.X_lambda[joint_id].r = model.X_T[joint_id].r;
+    data.X_lambda[joint_id].r = model.X_T[joint_id].r;
 
-    model.S[joint_id][1] = 1.;
+    data.S[joint_id][1] = 1.;
   } else if (model.mJoints[joint_id].mJointType == JointTypeRevoluteZ) {
     Scalar s, c;
     sincosp (q[model.mJoints[joint_id].q_index], &s, &c);
 
-    model.X_lambda[joint_id].E = Matrix3d (
+    data.X_lambda[joint_id].E = Matrix3d (
          c * model.X_T[joint_id].E(0, 0) + s * model.X_T[joint_id].E(1, 0),
          c * model.X_T[joint_id].E(0, 1) + s * model.X_T[joint_id].E(1, 1),
          c * model.X_T[joint_id].E(0, 2) + s * model.X_T[joint_id].E(1, 2),
@@ -465,33 +496,33 @@ RBDL_DLLAPI void jcalc_X_lambda_S (
         model.X_T[joint_id].E(2, 1),
         model.X_T[joint_id].E(2, 2));
 
-    model.X_lambda[joint_id].r = model.X_T[joint_id].r;
+    data.X_lambda[joint_id].r = model.X_T[joint_id].r;
 
-    model.S[joint_id][2] = 1.;
+    data.S[joint_id][2] = 1.;
   } else if (model.mJoints[joint_id].mJointType == JointTypeHelical){
     SpatialTransform XJ = jcalc_XJ (model, joint_id, q);
-    model.X_lambda[joint_id] = XJ * model.X_T[joint_id];
+    data.X_lambda[joint_id] = XJ * model.X_T[joint_id];
     // Set the joint axis
     Vector3d trans = XJ.E * model.mJoints[joint_id].mJointAxes[0].block(3,0,3,1);
 
-    model.S[joint_id] = SpatialVector(model.mJoints[joint_id].mJointAxes[0][0],
+    data.S[joint_id] = SpatialVector(model.mJoints[joint_id].mJointAxes[0][0],
            model.mJoints[joint_id].mJointAxes[0][1],
            model.mJoints[joint_id].mJointAxes[0][2],
            trans[0], trans[1], trans[2]);
   } else if (model.mJoints[joint_id].mDoFCount == 1
       && model.mJoints[joint_id].mJointType != JointTypeCustom){
-    model.X_lambda[joint_id] =
+    data.X_lambda[joint_id] =
       jcalc_XJ (model, joint_id, q) * model.X_T[joint_id];
-    model.S[joint_id] = model.mJoints[joint_id].mJointAxes[0];
+    data.S[joint_id] = model.mJoints[joint_id].mJointAxes[0];
   } else if (model.mJoints[joint_id].mJointType == JointTypeSpherical) {
-    model.X_lambda[joint_id] = SpatialTransform (
+    data.X_lambda[joint_id] = SpatialTransform (
         model.GetQuaternion (joint_id, q).toMatrix(),
         Vector3d (0., 0., 0.))
       * model.X_T[joint_id];
 
-    model.multdof3_S[joint_id](0,0) = 1.;
-    model.multdof3_S[joint_id](1,1) = 1.;
-    model.multdof3_S[joint_id](2,2) = 1.;
+    data.multdof3_S[joint_id](0,0) = 1.;
+    data.multdof3_S[joint_id](1,1) = 1.;
+    data.multdof3_S[joint_id](2,2) = 1.;
   } else if (model.mJoints[joint_id].mJointType == JointTypeEulerZYX) {
     Scalar q0 = q[model.mJoints[joint_id].q_index];
     Scalar q1 = q[model.mJoints[joint_id].q_index + 1];
@@ -504,7 +535,7 @@ RBDL_DLLAPI void jcalc_X_lambda_S (
     Scalar s2 = sin (q2);
     Scalar c2 = cos (q2);
 
-    model.X_lambda[joint_id] = SpatialTransform (
+    data.X_lambda[joint_id] = SpatialTransform (
         Matrix3d(
           c0 * c1, s0 * c1, -s1,
           c0 * s1 * s2 - s0 * c2, s0 * s1 * s2 + c0 * c2, c1 * s2,
@@ -513,14 +544,14 @@ RBDL_DLLAPI void jcalc_X_lambda_S (
         Vector3d (0., 0., 0.))
       * model.X_T[joint_id];
 
-    model.multdof3_S[joint_id](0,0) = -s1;
-    model.multdof3_S[joint_id](0,2) = 1.;
+    data.multdof3_S[joint_id](0,0) = -s1;
+    data.multdof3_S[joint_id](0,2) = 1.;
 
-    model.multdof3_S[joint_id](1,0) = c1 * s2;
-    model.multdof3_S[joint_id](1,1) = c2;
+    data.multdof3_S[joint_id](1,0) = c1 * s2;
+    data.multdof3_S[joint_id](1,1) = c2;
 
-    model.multdof3_S[joint_id](2,0) = c1 * c2;
-    model.multdof3_S[joint_id](2,1) = - s2;
+    data.multdof3_S[joint_id](2,0) = c1 * c2;
+    data.multdof3_S[joint_id](2,1) = - s2;
   } else if (model.mJoints[joint_id].mJointType == JointTypeEulerXYZ) {
     Scalar q0 = q[model.mJoints[joint_id].q_index];
     Scalar q1 = q[model.mJoints[joint_id].q_index + 1];
@@ -533,7 +564,7 @@ RBDL_DLLAPI void jcalc_X_lambda_S (
     Scalar s2 = sin (q2);
     Scalar c2 = cos (q2);
 
-    model.X_lambda[joint_id] = SpatialTransform (
+    data.X_lambda[joint_id] = SpatialTransform (
         Matrix3d(
           c2 * c1, s2 * c0 + c2 * s1 * s0, s2 * s0 - c2 * s1 * c0,
           -s2 * c1, c2 * c0 - s2 * s1 * s0, c2 * s0 + s2 * s1 * c0,
@@ -542,14 +573,14 @@ RBDL_DLLAPI void jcalc_X_lambda_S (
         Vector3d (0., 0., 0.))
       * model.X_T[joint_id];
 
-    model.multdof3_S[joint_id](0,0) = c2 * c1;
-    model.multdof3_S[joint_id](0,1) = s2;
+    data.multdof3_S[joint_id](0,0) = c2 * c1;
+    data.multdof3_S[joint_id](0,1) = s2;
 
-    model.multdof3_S[joint_id](1,0) = -s2 * c1;
-    model.multdof3_S[joint_id](1,1) = c2;
+    data.multdof3_S[joint_id](1,0) = -s2 * c1;
+    data.multdof3_S[joint_id](1,1) = c2;
 
-    model.multdof3_S[joint_id](2,0) = s1;
-    model.multdof3_S[joint_id](2,2) = 1.;
+    data.multdof3_S[joint_id](2,0) = s1;
+    data.multdof3_S[joint_id](2,2) = 1.;
   } else if (model.mJoints[joint_id].mJointType == JointTypeEulerYXZ ) {
     Scalar q0 = q[model.mJoints[joint_id].q_index];
     Scalar q1 = q[model.mJoints[joint_id].q_index + 1];
@@ -562,7 +593,7 @@ RBDL_DLLAPI void jcalc_X_lambda_S (
     Scalar s2 = sin (q2);
     Scalar c2 = cos (q2);
 
-    model.X_lambda[joint_id] = SpatialTransform (
+    data.X_lambda[joint_id] = SpatialTransform (
         Matrix3d(
           c2 * c0 + s2 * s1 * s0, s2 * c1, -c2 * s0 + s2 * s1 * c0,
           -s2 * c0 + c2 * s1 * s0, c2 * c1, s2 * s0 + c2 * s1 * c0,
@@ -571,14 +602,14 @@ RBDL_DLLAPI void jcalc_X_lambda_S (
         Vector3d (0., 0., 0.))
       * model.X_T[joint_id];
 
-    model.multdof3_S[joint_id](0,0) = s2 * c1;
-    model.multdof3_S[joint_id](0,1) = c2;
+    data.multdof3_S[joint_id](0,0) = s2 * c1;
+    data.multdof3_S[joint_id](0,1) = c2;
 
-    model.multdof3_S[joint_id](1,0) = c2 * c1;
-    model.multdof3_S[joint_id](1,1) = -s2;
+    data.multdof3_S[joint_id](1,0) = c2 * c1;
+    data.multdof3_S[joint_id](1,1) = -s2;
 
-    model.multdof3_S[joint_id](2,0) = -s1;
-    model.multdof3_S[joint_id](2,2) = 1.;
+    data.multdof3_S[joint_id](2,0) = -s1;
+    data.multdof3_S[joint_id](2,2) = 1.;
   } else if (model.mJoints[joint_id].mJointType == JointTypeEulerZXY ) {
     Scalar q0 = q[model.mJoints[joint_id].q_index];
     Scalar q1 = q[model.mJoints[joint_id].q_index + 1];
@@ -591,7 +622,7 @@ RBDL_DLLAPI void jcalc_X_lambda_S (
     Scalar s2 = sin (q2);
     Scalar c2 = cos (q2);
 
-    model.X_lambda[joint_id] = SpatialTransform (
+    data.X_lambda[joint_id] = SpatialTransform (
         Matrix3d(
           -s0 * s1 * s2 + c0 * c2, s0 * c2 + s1 * s2 * c0, -s2 * c1,
           -s0 * c1, c0 * c1, s1,
@@ -600,35 +631,44 @@ RBDL_DLLAPI void jcalc_X_lambda_S (
         Vector3d::Zero())
       * model.X_T[joint_id];
 
-    model.multdof3_S[joint_id](0,0) = -s2 * c1;
-    model.multdof3_S[joint_id](0,1) = c2;
+    data.multdof3_S[joint_id](0,0) = -s2 * c1;
+    data.multdof3_S[joint_id](0,1) = c2;
 
-    model.multdof3_S[joint_id](1,0) = s1;
-    model.multdof3_S[joint_id](1,2) = 1;
+    data.multdof3_S[joint_id](1,0) = s1;
+    data.multdof3_S[joint_id](1,2) = 1;
 
-    model.multdof3_S[joint_id](2,0) = c1 * c2;
-    model.multdof3_S[joint_id](2,1) = s2;
+    data.multdof3_S[joint_id](2,0) = c1 * c2;
+    data.multdof3_S[joint_id](2,1) = s2;
   } else if (model.mJoints[joint_id].mJointType == JointTypeTranslationXYZ) {
     Scalar q0 = q[model.mJoints[joint_id].q_index];
     Scalar q1 = q[model.mJoints[joint_id].q_index + 1];
     Scalar q2 = q[model.mJoints[joint_id].q_index + 2];
 
-    model.X_lambda[joint_id] = SpatialTransform (
+    data.X_lambda[joint_id] = SpatialTransform (
         Matrix3d::Identity (),
         Vector3d (q0, q1, q2))
       * model.X_T[joint_id];
 
-    model.multdof3_S[joint_id](3,0) = 1.;
-    model.multdof3_S[joint_id](4,1) = 1.;
-    model.multdof3_S[joint_id](5,2) = 1.;
+    data.multdof3_S[joint_id](3,0) = 1.;
+    data.multdof3_S[joint_id](4,1) = 1.;
+    data.multdof3_S[joint_id](5,2) = 1.;
   } else if (model.mJoints[joint_id].mJointType == JointTypeCustom) {
     const Joint &joint = model.mJoints[joint_id];
     CustomJoint *custom_joint
       = model.mCustomJoints[joint.custom_joint_index];
 
-    custom_joint->jcalc_X_lambda_S (model, joint_id, q);
+    custom_joint->jcalc_X_lambda_S (CustomJointModel (model, data),
+        joint_id, q);
   } else {
     throw Errors::RBDLError("Error: invalid joint type!");
   }
 }
+
+RBDL_DLLAPI void jcalc_X_lambda_S (
+    Model &model,
+    unsigned int joint_id,
+    const VectorNd &q
+    ) {
+  jcalc_X_lambda_S (model, model, joint_id, q);
+}
 }
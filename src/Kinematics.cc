@@ -12,6 +12,7 @@
 
 #include "rbdl/rbdl_mathutils.h"
 #include "rbdl/Logging.h"
+#include "rbdl/PerformanceCounters.h"
 
 #include "rbdl/Model.h"
 #include "rbdl/Kinematics.h"
@@ -23,60 +24,71 @@ namespace RigidBodyDynamics {
 using namespace Math;
 
 RBDL_DLLAPI void UpdateKinematics(
-    Model &model,
+    const Model &model,
+    ModelData &data,
     const VectorNd &Q,
     const VectorNd &QDot,
     const VectorNd &QDDot) {
+  RBDL_TRACE_ALGORITHM ("UpdateKinematics");
   RBDL_LOG << "-------- " << __func__ << " --------" << std::endl;
 
   unsigned int i;
 
-  model.a[0].setZero();
+  data.a[0].setZero();
 
   for (i = 1; i < model.mBodies.size(); i++) {
     unsigned int q_index = model.mJoints[i].q_index;
     unsigned int lambda = model.lambda[i];
 
-    jcalc (model, i, Q, QDot);
+    jcalc (model, data, i, Q, QDot);
 
     if (lambda != 0) {
-      model.X_base[i] = model.X_lambda[i] * model.X_base[lambda];
-      model.v[i] = model.X_lambda[i].apply(model.v[lambda]) + model.v_J[i];
+      data.X_base[i] = data.X_lambda[i] * data.X_base[lambda];
+      data.v[i] = data.X_lambda[i].apply(data.v[lambda]) + data.v_J[i];
     } else {
-      model.X_base[i] = model.X_lambda[i];
-      model.v[i] = model.v_J[i];
+      data.X_base[i] = data.X_lambda[i];
+      data.v[i] = data.v_J[i];
     }
 
-    model.c[i] = model.c_J[i] + crossm(model.v[i],model.v_J[i]);
-    model.a[i] = model.X_lambda[i].apply(model.a[lambda]) + model.c[i];
+    data.c[i] = data.c_J[i] + crossm(data.v[i],data.v_J[i]);
+    data.a[i] = data.X_lambda[i].apply(data.a[lambda]) + data.c[i];
 
     if(model.mJoints[i].mJointType != JointTypeCustom){
       if (model.mJoints[i].mDoFCount == 1) {
-        model.a[i] = model.a[i] + model.S[i] * QDDot[q_index];
+        data.a[i] = data.a[i] + data.S[i] * QDDot[q_index];
       } else if (model.mJoints[i].mDoFCount == 3) {
         Vector3d omegadot_temp (QDDot[q_index], 
             QDDot[q_index + 1], 
             QDDot[q_index + 2]);
-        model.a[i] = model.a[i] + model.multdof3_S[i] * omegadot_temp;
+        data.a[i] = data.a[i] + data.multdof3_S[i] * omegadot_temp;
       }
     } else {
       unsigned int custom_index = model.mJoints[i].custom_joint_index;
       const CustomJoint* custom_joint = model.mCustomJoints[custom_index];
       unsigned int joint_dof_count = custom_joint->mDoFCount;
 
-      model.a[i] = model.a[i]
+      data.a[i] = data.a[i]
         + ( model.mCustomJoints[custom_index]->S 
             * QDDot.block(q_index, 0, joint_dof_count, 1));
     }
   }
 
   for (i = 1; i < model.mBodies.size(); i++) {
-    RBDL_LOG << "a[" << i << "] = " << model.a[i].transpose() << std::endl;
+    RBDL_LOG << "a[" << i << "] = " << data.a[i].transpose() << std::endl;
   }
 }
 
-RBDL_DLLAPI void UpdateKinematicsCustom(
+RBDL_DLLAPI void UpdateKinematics(
     Model &model,
+    const VectorNd &Q,
+    const VectorNd &QDot,
+    const VectorNd &QDDot) {
+  UpdateKinematics (model, model, Q, QDot, QDDot);
+}
+
+RBDL_DLLAPI void UpdateKinematicsCustom(
+    const Model &model,
+    ModelData &data,
     const VectorNd *Q,
     const VectorNd *QDot,
     const VectorNd *QDDot) {
@@ -84,18 +96,19 @@ RBDL_DLLAPI void UpdateKinematicsCustom(
 
   unsigned int i;
 
+  // jcalc() is not called if only QDDot is given, but a[] still changes
+  data.InvalidateKinematicsCache();
+
   if (Q) {
     for (i = 1; i < model.mBodies.size(); i++) {
       unsigned int lambda = model.lambda[i];
 
-      VectorNd QDot_zero (VectorNd::Zero (model.q_size));
-
-      jcalc (model, i, (*Q), QDot_zero);
+      jcalc_X_lambda_S (model, data, i, (*Q));
 
       if (lambda != 0) {
-        model.X_base[i] = model.X_lambda[i] * model.X_base[lambda];
+        data.X_base[i] = data.X_lambda[i] * data.X_base[lambda];
       } else {
-        model.X_base[i] = model.X_lambda[i];
+        data.X_base[i] = data.X_lambda[i];
       }
     }
   }
@@ -104,16 +117,16 @@ RBDL_DLLAPI void UpdateKinematicsCustom(
     for (i = 1; i < model.mBodies.size(); i++) {
       unsigned int lambda = model.lambda[i];
 
-      jcalc (model, i, *Q, *QDot);
+      jcalc (model, data, i, *Q, *QDot);
 
       if (lambda != 0) {
-        model.v[i] = model.X_lambda[i].apply(model.v[lambda]) + model.v_J[i];
-        model.c[i] = model.c_J[i] + crossm(model.v[i],model.v_J[i]);
+        data.v[i] = data.X_lambda[i].apply(data.v[lambda]) + data.v_J[i];
+        data.c[i] = data.c_J[i] + crossm(data.v[i],data.v_J[i]);
       } else {
-        model.v[i] = model.v_J[i];
-        model.c[i] = model.c_J[i] + crossm(model.v[i],model.v_J[i]);
+        data.v[i] = data.v_J[i];
+        data.c[i] = data.c_J[i] + crossm(data.v[i],data.v_J[i]);
       }
-      // RBDL_LOG << "v[" << i << "] = " << model.v[i].transpose() << std::endl;
+      // RBDL_LOG << "v[" << i << "] = " << data.v[i].transpose() << std::endl;
     }
   }
 
@@ -125,20 +138,20 @@ RBDL_DLLAPI void UpdateKinematicsCustom(
       unsigned int lambda = model.lambda[i];
 
       if (lambda != 0) {
-        model.a[i] = model.X_lambda[i].apply(model.a[lambda]) + model.c[i];
+        data.a[i] = data.X_lambda[i].apply(data.a[lambda]) + data.c[i];
       } else {
-        model.a[i] = model.c[i];
+        data.a[i] = data.c[i];
       }
 
       if( model.mJoints[i].mJointType != JointTypeCustom){
         if (model.mJoints[i].mDoFCount == 1) {
-          model.a[i] = model.a[i] + model.S[i] * (*QDDot)[q_index];
+          data.a[i] = data.a[i] + data.S[i] * (*QDDot)[q_index];
         } else if (model.mJoints[i].mDoFCount == 3) {
           Vector3d omegadot_temp ((*QDDot)[q_index], 
               (*QDDot)[q_index + 1], 
               (*QDDot)[q_index + 2]);
-          model.a[i] = model.a[i] 
-            + model.multdof3_S[i] * omegadot_temp;
+          data.a[i] = data.a[i] 
+            + data.multdof3_S[i] * omegadot_temp;
         }
       } else {
         unsigned int k = model.mJoints[i].custom_joint_index;
@@ -146,7 +159,7 @@ RBDL_DLLAPI void UpdateKinematicsCustom(
         const CustomJoint* custom_joint = model.mCustomJoints[k];
         unsigned int joint_dof_count = custom_joint->mDoFCount;
 
-        model.a[i] = model.a[i]
+        data.a[i] = data.a[i]
           + (  (model.mCustomJoints[k]->S)
               *(QDDot->block(q_index, 0, joint_dof_count, 1)));
       }
@@ -154,15 +167,184 @@ RBDL_DLLAPI void UpdateKinematicsCustom(
   }
 }
 
-RBDL_DLLAPI Vector3d CalcBodyToBaseCoordinates (
+RBDL_DLLAPI void UpdateKinematicsCustom(
     Model &model,
+    const VectorNd *Q,
+    const VectorNd *QDot,
+    const VectorNd *QDDot) {
+  UpdateKinematicsCustom (model, model, Q, QDot, QDDot);
+}
+
+/// Bits of ModelData::kinematics_cache_dirty
+static const unsigned char KinematicsDirtyPositions = 1;
+static const unsigned char KinematicsDirtyVelocities = 2;
+static const unsigned char KinematicsDirtyAccelerations = 4;
+
+/** Returns whether the entries of the generalized vector values that belong
+ * to joint joint_id differ from the entries in cached.
+ */
+static bool JointValuesChanged (
+    const Model &model,
+    unsigned int joint_id,
+    const VectorNd &values,
+    const VectorNd &cached,
+    bool is_position) {
+  const Joint &joint = model.mJoints[joint_id];
+
+  for (unsigned int k = 0; k < joint.mDoFCount; k++) {
+    if (values[joint.q_index + k] != cached[joint.q_index + k]) {
+      return true;
+    }
+  }
+
+  // the w component of the quaternion is stored at the end of Q
+  if (is_position && joint.mJointType == JointTypeSpherical) {
+    unsigned int w_index = model.multdof3_w_index[joint_id];
+    return values[w_index] != cached[w_index];
+  }
+
+  return false;
+}
+
+RBDL_DLLAPI void UpdateKinematicsIncremental(
+    const Model &model,
+    ModelData &data,
+    const VectorNd *Q,
+    const VectorNd *QDot,
+    const VectorNd *QDDot) {
+  RBDL_LOG << "-------- " << __func__ << " --------" << std::endl;
+
+  if ((QDot && !Q) || (QDDot && !QDot)) {
+    throw Errors::RBDLError("Error: UpdateKinematicsIncremental() requires Q "
+        "for QDot and QDot for QDDot!");
+  }
+
+  if (data.kinematics_cache_dirty.size() != model.mBodies.size()
+      || data.kinematics_cache_q.size() != model.q_size
+      || data.kinematics_cache_qdot.size() != model.qdot_size) {
+    data.kinematics_cache_dirty.assign (model.mBodies.size(), 0);
+    data.kinematics_cache_q = VectorNd::Zero (model.q_size);
+    data.kinematics_cache_qdot = VectorNd::Zero (model.qdot_size);
+    data.kinematics_cache_qddot = VectorNd::Zero (model.qdot_size);
+    data.kinematics_cache_level = 0;
+  }
+
+  // jcalc() invalidates the cache, therefore the level has to be read first
+  unsigned int cache_level = data.kinematics_cache_level;
+  unsigned int update_level = QDDot ? 3 : (QDot ? 2 : (Q ? 1 : 0));
+  bool changed = false;
+
+  data.kinematics_cache_dirty[0] = 0;
+
+  for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+    unsigned int lambda = model.lambda[i];
+    unsigned char parent_dirty = data.kinematics_cache_dirty[lambda];
+    unsigned char dirty = 0;
+
+    if (Q && (cache_level < 1
+          || (parent_dirty & KinematicsDirtyPositions)
+          || JointValuesChanged (model, i, *Q, data.kinematics_cache_q,
+            true))) {
+      dirty |= KinematicsDirtyPositions;
+
+      jcalc_X_lambda_S (model, data, i, *Q);
+
+      if (lambda != 0) {
+        data.X_base[i] = data.X_lambda[i] * data.X_base[lambda];
+      } else {
+        data.X_base[i] = data.X_lambda[i];
+      }
+    }
+
+    if (QDot && (cache_level < 2 || dirty
+          || (parent_dirty & KinematicsDirtyVelocities)
+          || JointValuesChanged (model, i, *QDot, data.kinematics_cache_qdot,
+            false))) {
+      dirty |= KinematicsDirtyVelocities;
+
+      jcalc (model, data, i, *Q, *QDot);
+
+      if (lambda != 0) {
+        data.v[i] = data.X_lambda[i].apply(data.v[lambda]) + data.v_J[i];
+      } else {
+        data.v[i] = data.v_J[i];
+      }
+      data.c[i] = data.c_J[i] + crossm(data.v[i],data.v_J[i]);
+    }
+
+    if (QDDot && (cache_level < 3 || dirty
+          || (parent_dirty & KinematicsDirtyAccelerations)
+          || JointValuesChanged (model, i, *QDDot,
+            data.kinematics_cache_qddot, false))) {
+      dirty |= KinematicsDirtyAccelerations;
+
+      unsigned int q_index = model.mJoints[i].q_index;
+
+      if (lambda != 0) {
+        data.a[i] = data.X_lambda[i].apply(data.a[lambda]) + data.c[i];
+      } else {
+        data.a[i] = data.c[i];
+      }
+
+      if (model.mJoints[i].mJointType != JointTypeCustom) {
+        if (model.mJoints[i].mDoFCount == 1) {
+          data.a[i] = data.a[i] + data.S[i] * (*QDDot)[q_index];
+        } else if (model.mJoints[i].mDoFCount == 3) {
+          Vector3d omegadot_temp ((*QDDot)[q_index],
+              (*QDDot)[q_index + 1],
+              (*QDDot)[q_index + 2]);
+          data.a[i] = data.a[i] + data.multdof3_S[i] * omegadot_temp;
+        }
+      } else {
+        unsigned int k = model.mJoints[i].custom_joint_index;
+        const CustomJoint* custom_joint = model.mCustomJoints[k];
+
+        data.a[i] = data.a[i]
+          + custom_joint->S
+          * QDDot->block(q_index, 0, custom_joint->mDoFCount, 1);
+      }
+    }
+
+    data.kinematics_cache_dirty[i] = dirty;
+    changed = changed || (dirty != 0);
+  }
+
+  if (Q) {
+    data.kinematics_cache_q = *Q;
+  }
+  if (QDot) {
+    data.kinematics_cache_qdot = *QDot;
+  }
+  if (QDDot) {
+    data.kinematics_cache_qddot = *QDDot;
+  }
+
+  // values of higher levels stay valid if nothing has changed
+  if (changed) {
+    data.kinematics_cache_level = update_level;
+  } else {
+    data.kinematics_cache_level = std::max (cache_level, update_level);
+  }
+}
+
+RBDL_DLLAPI void UpdateKinematicsIncremental(
+    Model &model,
+    const VectorNd *Q,
+    const VectorNd *QDot,
+    const VectorNd *QDDot) {
+  UpdateKinematicsIncremental (model, model, Q, QDot, QDDot);
+}
+
+RBDL_DLLAPI Vector3d CalcBodyToBaseCoordinates (
+    const Model &model,
+    ModelData &data,
     const VectorNd &Q,
     unsigned int body_id,
     const Vector3d &point_body_coordinates,
     bool update_kinematics) {
   // update the Kinematics if necessary
   if (update_kinematics) {
-    UpdateKinematicsCustom (model, &Q, NULL, NULL);
+    UpdateKinematicsCustom (model, data, &Q, NULL, NULL);
   }
 
   if (body_id >= model.fixed_body_discriminator) {
@@ -173,28 +355,39 @@ RBDL_DLLAPI Vector3d CalcBodyToBaseCoordinates (
       model.mFixedBodies[fbody_id].mParentTransform.E.transpose();
     Vector3d fixed_position = model.mFixedBodies[fbody_id].mParentTransform.r;
 
-    Matrix3d parent_body_rotation = model.X_base[parent_id].E.transpose();
-    Vector3d parent_body_position = model.X_base[parent_id].r;
+    Matrix3d parent_body_rotation = data.X_base[parent_id].E.transpose();
+    Vector3d parent_body_position = data.X_base[parent_id].r;
 
     return (parent_body_position 
         + (parent_body_rotation 
           * (fixed_position + fixed_rotation * (point_body_coordinates))) );
   }
 
-  Matrix3d body_rotation = model.X_base[body_id].E.transpose();
-  Vector3d body_position = model.X_base[body_id].r;
+  Matrix3d body_rotation = data.X_base[body_id].E.transpose();
+  Vector3d body_position = data.X_base[body_id].r;
 
   return body_position + body_rotation * point_body_coordinates;
 }
 
-RBDL_DLLAPI Vector3d CalcBaseToBodyCoordinates (
+RBDL_DLLAPI Vector3d CalcBodyToBaseCoordinates (
     Model &model,
     const VectorNd &Q,
     unsigned int body_id,
+    const Vector3d &point_body_coordinates,
+    bool update_kinematics) {
+  return CalcBodyToBaseCoordinates (model, model, Q, body_id,
+      point_body_coordinates, update_kinematics);
+}
+
+RBDL_DLLAPI Vector3d CalcBaseToBodyCoordinates (
+    const Model &model,
+    ModelData &data,
+    const VectorNd &Q,
+    unsigned int body_id,
     const Vector3d &point_base_coordinates,
     bool update_kinematics) {
   if (update_kinematics) {
-    UpdateKinematicsCustom (model, &Q, NULL, NULL);
+    UpdateKinematicsCustom (model, data, &Q, NULL, NULL);
   }
 
   if (body_id >= model.fixed_body_discriminator) {
@@ -204,8 +397,8 @@ RBDL_DLLAPI Vector3d CalcBaseToBodyCoordinates (
     Matrix3d fixed_rotation = model.mFixedBodies[fbody_id].mParentTransform.E;
     Vector3d fixed_position = model.mFixedBodies[fbody_id].mParentTransform.r;
 
-    Matrix3d parent_body_rotation = model.X_base[parent_id].E;
-    Vector3d parent_body_position = model.X_base[parent_id].r;
+    Matrix3d parent_body_rotation = data.X_base[parent_id].E;
+    Vector3d parent_body_position = data.X_base[parent_id].r;
 
     return (fixed_rotation 
         * ( - fixed_position 
@@ -213,51 +406,84 @@ RBDL_DLLAPI Vector3d CalcBaseToBodyCoordinates (
           * (parent_body_position - point_base_coordinates)));
   }
 
-  Matrix3d body_rotation = model.X_base[body_id].E;
-  Vector3d body_position = model.X_base[body_id].r;
+  Matrix3d body_rotation = data.X_base[body_id].E;
+  Vector3d body_position = data.X_base[body_id].r;
 
   return body_rotation * (point_base_coordinates - body_position);
 }
 
-RBDL_DLLAPI Matrix3d CalcBodyWorldOrientation(
+RBDL_DLLAPI Vector3d CalcBaseToBodyCoordinates (
     Model &model,
     const VectorNd &Q,
+    unsigned int body_id,
+    const Vector3d &point_base_coordinates,
+    bool update_kinematics) {
+  return CalcBaseToBodyCoordinates (model, model, Q, body_id,
+      point_base_coordinates, update_kinematics);
+}
+
+RBDL_DLLAPI Matrix3d CalcBodyWorldOrientation(
+    const Model &model,
+    ModelData &data,
+    const VectorNd &Q,
     const unsigned int body_id,
     bool update_kinematics) {
   // update the Kinematics if necessary
   if (update_kinematics) {
-    UpdateKinematicsCustom (model, &Q, NULL, NULL);
+    UpdateKinematicsCustom (model, data, &Q, NULL, NULL);
   }
 
+  if (body_id >= model.fixed_body_discriminator) {
+    unsigned int fbody_id = body_id - model.fixed_body_discriminator;
+    SpatialTransform base_transform =
+      model.mFixedBodies[fbody_id].mParentTransform 
+      * data.X_base[model.mFixedBodies[fbody_id].mMovableParent];
+
+    return base_transform.E;
+  }
+
+  return data.X_base[body_id].E;
+}
+
+RBDL_DLLAPI Matrix3d CalcBodyWorldOrientation(
+    Model &model,
+    const VectorNd &Q,
+    const unsigned int body_id,
+    bool update_kinematics) {
+  Matrix3d orientation = CalcBodyWorldOrientation (model, model, Q, body_id,
+      update_kinematics);
+
+  // keep the cached base transformation of fixed bodies up to date
   if (body_id >= model.fixed_body_discriminator) {
     unsigned int fbody_id = body_id - model.fixed_body_discriminator;
     model.mFixedBodies[fbody_id].mBaseTransform = 
       model.mFixedBodies[fbody_id].mParentTransform 
       * model.X_base[model.mFixedBodies[fbody_id].mMovableParent];
-
-    return model.mFixedBodies[fbody_id].mBaseTransform.E;
   }
 
-  return model.X_base[body_id].E;
+  return orientation;
 }
 
 RBDL_DLLAPI void CalcPointJacobian (
-    Model &model,
+    const Model &model,
+    ModelData &data,
     const VectorNd &Q,
     unsigned int body_id,
     const Vector3d &point_position,
     MatrixNd &G,
     bool update_kinematics) {
+  RBDL_TRACE_ALGORITHM ("CalcPointJacobian");
+  RBDL_PERF_COUNTER ("CalcPointJacobian");
   RBDL_LOG << "-------- " << __func__ << " --------" << std::endl;
 
   // update the Kinematics if necessary
   if (update_kinematics) {
-    UpdateKinematicsCustom (model, &Q, NULL, NULL);
+    UpdateKinematicsCustom (model, data, &Q, NULL, NULL);
   }
 
   SpatialTransform point_trans = 
     SpatialTransform (Matrix3d::Identity(), 
-        CalcBodyToBaseCoordinates ( model, 
+        CalcBodyToBaseCoordinates ( model, data, 
           Q, 
           body_id,
           point_position, 
@@ -283,20 +509,20 @@ RBDL_DLLAPI void CalcPointJacobian (
       if (model.mJoints[j].mDoFCount == 1) {
         G.block(0,q_index, 3, 1) =
           point_trans.apply(
-              model.X_base[j].inverse().apply(
-                model.S[j])).block<3, 1>(3,0);
+              data.X_base[j].inverse().apply(
+                data.S[j])).block<3, 1>(3,0);
       } else if (model.mJoints[j].mDoFCount == 3) {
         G.block(0, q_index, 3, 3) =
           ((point_trans
-            * model.X_base[j].inverse()).toMatrix()
-           * model.multdof3_S[j]).block<3, 3>(3,0);
+            * data.X_base[j].inverse()).toMatrix()
+           * data.multdof3_S[j]).block<3, 3>(3,0);
       }
     } else {
       unsigned int k = model.mJoints[j].custom_joint_index;
 
       G.block(0, q_index, 3, model.mCustomJoints[k]->mDoFCount) =
         ((point_trans
-          * model.X_base[j].inverse()).toMatrix()
+          * data.X_base[j].inverse()).toMatrix()
          * model.mCustomJoints[k]->S).block( 
            3,0,3,model.mCustomJoints[k]->mDoFCount);
     }
@@ -305,23 +531,35 @@ RBDL_DLLAPI void CalcPointJacobian (
   }
 }
 
-RBDL_DLLAPI void CalcPointJacobian6D (
+RBDL_DLLAPI void CalcPointJacobian (
     Model &model,
     const VectorNd &Q,
     unsigned int body_id,
     const Vector3d &point_position,
     MatrixNd &G,
     bool update_kinematics) {
+  CalcPointJacobian (model, model, Q, body_id, point_position, G,
+      update_kinematics);
+}
+
+RBDL_DLLAPI void CalcPointJacobian6D (
+    const Model &model,
+    ModelData &data,
+    const VectorNd &Q,
+    unsigned int body_id,
+    const Vector3d &point_position,
+    MatrixNd &G,
+    bool update_kinematics) {
   RBDL_LOG << "-------- " << __func__ << " --------" << std::endl;
 
   // update the Kinematics if necessary
   if (update_kinematics) {
-    UpdateKinematicsCustom (model, &Q, NULL, NULL);
+    UpdateKinematicsCustom (model, data, &Q, NULL, NULL);
   }
 
   SpatialTransform point_trans =
     SpatialTransform (Matrix3d::Identity(),
-        CalcBodyToBaseCoordinates (model,
+        CalcBodyToBaseCoordinates (model, data,
           Q,
           body_id,
           point_position,
@@ -345,20 +583,20 @@ RBDL_DLLAPI void CalcPointJacobian6D (
       if (model.mJoints[j].mDoFCount == 1) {
         G.block(0,q_index, 6, 1)
           = point_trans.apply(
-              model.X_base[j].inverse().apply(
-                model.S[j])).block<6, 1>(0,0);
+              data.X_base[j].inverse().apply(
+                data.S[j])).block<6, 1>(0,0);
       } else if (model.mJoints[j].mDoFCount == 3) {
         G.block(0, q_index, 6, 3)
           = ((point_trans
-                * model.X_base[j].inverse()).toMatrix()
-              * model.multdof3_S[j]).block<6, 3>(0,0);
+                * data.X_base[j].inverse()).toMatrix()
+              * data.multdof3_S[j]).block<6, 3>(0,0);
       }
     } else {
       unsigned int k = model.mJoints[j].custom_joint_index;
 
       G.block(0, q_index, 6, model.mCustomJoints[k]->mDoFCount)
         = ((point_trans
-              * model.X_base[j].inverse()).toMatrix()
+              * data.X_base[j].inverse()).toMatrix()
             * model.mCustomJoints[k]->S).block(
               0,0,6,model.mCustomJoints[k]->mDoFCount);
     }
@@ -367,17 +605,29 @@ RBDL_DLLAPI void CalcPointJacobian6D (
   }
 }
 
-RBDL_DLLAPI void CalcBodySpatialJacobian (
+RBDL_DLLAPI void CalcPointJacobian6D (
     Model &model,
     const VectorNd &Q,
     unsigned int body_id,
+    const Vector3d &point_position,
+    MatrixNd &G,
+    bool update_kinematics) {
+  CalcPointJacobian6D (model, model, Q, body_id, point_position, G,
+      update_kinematics);
+}
+
+RBDL_DLLAPI void CalcBodySpatialJacobian (
+    const Model &model,
+    ModelData &data,
+    const VectorNd &Q,
+    unsigned int body_id,
     MatrixNd &G,
     bool update_kinematics) {
   RBDL_LOG << "-------- " << __func__ << " --------" << std::endl;
 
   // update the Kinematics if necessary
   if (update_kinematics) {
-    UpdateKinematicsCustom (model, &Q, NULL, NULL);
+    UpdateKinematicsCustom (model, data, &Q, NULL, NULL);
   }
 
   assert (G.rows() == 6 && G.cols() == model.qdot_size );
@@ -396,9 +646,9 @@ RBDL_DLLAPI void CalcBodySpatialJacobian (
 
     base_to_body = model.mFixedBodies[fbody_id]
       .mParentTransform
-      * model.X_base[reference_body_id];
+      * data.X_base[reference_body_id];
   } else {
-    base_to_body = model.X_base[reference_body_id];
+    base_to_body = data.X_base[reference_body_id];
   }
 
   unsigned int j = reference_body_id;
@@ -410,20 +660,20 @@ RBDL_DLLAPI void CalcBodySpatialJacobian (
       if (model.mJoints[j].mDoFCount == 1) {
         G.block(0,q_index,6,1) =
           base_to_body.apply(
-              model.X_base[j]
+              data.X_base[j]
               .inverse()
-              .apply(model.S[j])
+              .apply(data.S[j])
               );
       } else if (model.mJoints[j].mDoFCount == 3) {
         G.block(0,q_index,6,3) =
-          (base_to_body * model.X_base[j].inverse()
-          ).toMatrix() * model.multdof3_S[j];
+          (base_to_body * data.X_base[j].inverse()
+          ).toMatrix() * data.multdof3_S[j];
       }
     }else if(model.mJoints[j].mJointType == JointTypeCustom) {
       unsigned int k = model.mJoints[j].custom_joint_index;
 
       G.block(0,q_index,6,model.mCustomJoints[k]->mDoFCount ) =
-        (base_to_body * model.X_base[j].inverse()
+        (base_to_body * data.X_base[j].inverse()
         ).toMatrix() * model.mCustomJoints[k]->S;
     }
 
@@ -431,9 +681,208 @@ RBDL_DLLAPI void CalcBodySpatialJacobian (
   }
 }
 
-RBDL_DLLAPI Vector3d CalcPointVelocity (
+RBDL_DLLAPI void CalcBodySpatialJacobian (
+    Model &model,
+    const VectorNd &Q,
+    unsigned int body_id,
+    MatrixNd &G,
+    bool update_kinematics) {
+  CalcBodySpatialJacobian (model, model, Q, body_id, G, update_kinematics);
+}
+
+#ifndef RBDL_USE_CASADI_MATH
+RBDL_DLLAPI void SparseJacobian::apply (
+    const VectorNd &qdot,
+    VectorNd &result) const {
+  assert (qdot.size() == cols);
+
+  result.resize (block.rows());
+  result.setZero();
+
+  for (unsigned int i = 0; i < column_index.size(); i++) {
+    result += block.col(i) * qdot[column_index[i]];
+  }
+}
+
+RBDL_DLLAPI void SparseJacobian::applyTranspose (
+    const VectorNd &f,
+    VectorNd &result,
+    bool accumulate) const {
+  assert (f.size() == block.rows());
+
+  if (!accumulate) {
+    result.resize (cols);
+    result.setZero();
+  }
+
+  assert (result.size() == cols);
+
+  for (unsigned int i = 0; i < column_index.size(); i++) {
+    result[column_index[i]] += block.col(i).dot(f);
+  }
+}
+
+RBDL_DLLAPI void SparseJacobian::toDense (MatrixNd &G) const {
+  G.resize (block.rows(), cols);
+  G.setZero();
+
+  for (unsigned int i = 0; i < column_index.size(); i++) {
+    G.col(column_index[i]) = block.col(i);
+  }
+}
+
+/** Writes the motion of the joint axis S (given in coordinates of a body
+ * with base orientation E) in base coordinates into column col of G. The
+ * linear part is referred to the point that is located at -point_offset
+ * relative to the body origin. For row_start == 3 only the linear part is
+ * written.
+ */
+static inline void SetPointJacobianColumnSparse (
+    const Matrix3d &E,
+    const Vector3d &point_offset,
+    const SpatialVector &S,
+    unsigned int col,
+    unsigned int row_start,
+    SparseJacobian &G) {
+  Vector3d omega = E.transpose() * S.block<3,1>(0,0);
+  Vector3d linear = E.transpose() * S.block<3,1>(3,0)
+    + point_offset.cross (omega);
+
+  if (row_start == 0) {
+    G.block.block<3,1>(0, col) = omega;
+    G.block.block<3,1>(3, col) = linear;
+  } else {
+    G.block.block<3,1>(0, col) = linear;
+  }
+}
+
+/** Computes the rows [row_start, 6) of the 6-D point Jacobian for the
+ * joints that support the body.
+ */
+static void CalcPointJacobianRowsSparse (
+    const Model &model,
+    ModelData &data,
+    const VectorNd &Q,
+    unsigned int body_id,
+    const Vector3d &point_position,
+    unsigned int row_start,
+    SparseJacobian &G,
+    bool update_kinematics) {
+  RBDL_LOG << "-------- " << __func__ << " --------" << std::endl;
+
+  // update the Kinematics if necessary
+  if (update_kinematics) {
+    UpdateKinematicsCustom (model, data, &Q, NULL, NULL);
+  }
+
+  Vector3d point_base = CalcBodyToBaseCoordinates (model, data, Q, body_id,
+      point_position, false);
+
+  unsigned int reference_body_id = body_id;
+
+  if (model.IsFixedBodyId(body_id)) {
+    unsigned int fbody_id = body_id - model.fixed_body_discriminator;
+    reference_body_id = model.mFixedBodies[fbody_id].mMovableParent;
+  }
+
+  unsigned int support_dof_count = 0;
+  unsigned int j = reference_body_id;
+
+  while (j != 0) {
+    support_dof_count += model.mJoints[j].mDoFCount;
+    j = model.lambda[j];
+  }
+
+  G.cols = model.qdot_size;
+  G.column_index.resize (support_dof_count);
+  G.block.resize (6 - row_start, support_dof_count);
+
+  // the supporting joints are visited from the body towards the root,
+  // therefore the columns get filled from the back
+  unsigned int col = support_dof_count;
+  j = reference_body_id;
+
+  while (j != 0) {
+    unsigned int q_index = model.mJoints[j].q_index;
+    unsigned int dof_count = model.mJoints[j].mDoFCount;
+    const Matrix3d &E = data.X_base[j].E;
+    Vector3d point_offset = data.X_base[j].r - point_base;
+
+    col -= dof_count;
+
+    for (unsigned int k = 0; k < dof_count; k++) {
+      G.column_index[col + k] = q_index + k;
+
+      if (model.mJoints[j].mJointType == JointTypeCustom) {
+        unsigned int ci = model.mJoints[j].custom_joint_index;
+        SetPointJacobianColumnSparse (E, point_offset,
+            SpatialVector (model.mCustomJoints[ci]->S.col(k)), col + k,
+            row_start, G);
+      } else if (dof_count == 1) {
+        SetPointJacobianColumnSparse (E, point_offset, data.S[j], col + k,
+            row_start, G);
+      } else {
+        SetPointJacobianColumnSparse (E, point_offset,
+            SpatialVector (data.multdof3_S[j].col(k)), col + k,
+            row_start, G);
+      }
+    }
+
+    j = model.lambda[j];
+  }
+}
+
+RBDL_DLLAPI void CalcPointJacobianSparse (
+    const Model &model,
+    ModelData &data,
+    const VectorNd &Q,
+    unsigned int body_id,
+    const Vector3d &point_position,
+    SparseJacobian &G,
+    bool update_kinematics) {
+  CalcPointJacobianRowsSparse (model, data, Q, body_id, point_position, 3, G,
+      update_kinematics);
+}
+
+RBDL_DLLAPI void CalcPointJacobianSparse (
     Model &model,
     const VectorNd &Q,
+    unsigned int body_id,
+    const Vector3d &point_position,
+    SparseJacobian &G,
+    bool update_kinematics) {
+  CalcPointJacobianSparse (model, model, Q, body_id, point_position, G,
+      update_kinematics);
+}
+
+RBDL_DLLAPI void CalcPointJacobian6DSparse (
+    const Model &model,
+    ModelData &data,
+    const VectorNd &Q,
+    unsigned int body_id,
+    const Vector3d &point_position,
+    SparseJacobian &G,
+    bool update_kinematics) {
+  CalcPointJacobianRowsSparse (model, data, Q, body_id, point_position, 0, G,
+      update_kinematics);
+}
+
+RBDL_DLLAPI void CalcPointJacobian6DSparse (
+    Model &model,
+    const VectorNd &Q,
+    unsigned int body_id,
+    const Vector3d &point_position,
+    SparseJacobian &G,
+    bool update_kinematics) {
+  CalcPointJacobian6DSparse (model, model, Q, body_id, point_position, G,
+      update_kinematics);
+}
+#endif
+
+RBDL_DLLAPI Vector3d CalcPointVelocity (
+    const Model &model,
+    ModelData &data,
+    const VectorNd &Q,
     const VectorNd &QDot,
     unsigned int body_id,
     const Vector3d &point_position,
@@ -444,11 +893,11 @@ RBDL_DLLAPI Vector3d CalcPointVelocity (
   assert (model.qdot_size == QDot.size());
 
   // Reset the velocity of the root body
-  model.v[0].setZero();
+  data.v[0].setZero();
 
   // update the Kinematics with zero acceleration
   if (update_kinematics) {
-    UpdateKinematicsCustom (model, &Q, &QDot, NULL);
+    UpdateKinematicsCustom (model, data, &Q, &QDot, NULL);
   }
 
   unsigned int reference_body_id = body_id;
@@ -458,15 +907,15 @@ RBDL_DLLAPI Vector3d CalcPointVelocity (
     unsigned int fbody_id = body_id - model.fixed_body_discriminator;
     reference_body_id = model.mFixedBodies[fbody_id].mMovableParent;
     Vector3d base_coords = 
-      CalcBodyToBaseCoordinates(model, Q, body_id, point_position, false);
+      CalcBodyToBaseCoordinates(model, data, Q, body_id, point_position, false);
     reference_point =
-      CalcBaseToBodyCoordinates(model, Q, reference_body_id, base_coords,false);
+      CalcBaseToBodyCoordinates(model, data, Q, reference_body_id, base_coords,false);
   }
 
   SpatialVector point_spatial_velocity = 
     SpatialTransform (
-        CalcBodyWorldOrientation (model, Q, reference_body_id, false).transpose(), 
-        reference_point).apply(model.v[reference_body_id]);
+        CalcBodyWorldOrientation (model, data, Q, reference_body_id, false).transpose(), 
+        reference_point).apply(data.v[reference_body_id]);
 
   return Vector3d (
       point_spatial_velocity[3],
@@ -475,8 +924,20 @@ RBDL_DLLAPI Vector3d CalcPointVelocity (
       );
 }
 
-RBDL_DLLAPI Math::SpatialVector CalcPointVelocity6D(
+RBDL_DLLAPI Vector3d CalcPointVelocity (
     Model &model,
+    const VectorNd &Q,
+    const VectorNd &QDot,
+    unsigned int body_id,
+    const Vector3d &point_position,
+    bool update_kinematics) {
+  return CalcPointVelocity (model, model, Q, QDot, body_id, point_position,
+      update_kinematics);
+}
+
+RBDL_DLLAPI Math::SpatialVector CalcPointVelocity6D(
+    const Model &model,
+    ModelData &data,
     const Math::VectorNd &Q,
     const Math::VectorNd &QDot,
     unsigned int body_id,
@@ -488,11 +949,11 @@ RBDL_DLLAPI Math::SpatialVector CalcPointVelocity6D(
   assert (model.qdot_size == QDot.size());
 
   // Reset the velocity of the root body
-  model.v[0].setZero();
+  data.v[0].setZero();
 
   // update the Kinematics with zero acceleration
   if (update_kinematics) {
-    UpdateKinematicsCustom (model, &Q, &QDot, NULL);
+    UpdateKinematicsCustom (model, data, &Q, &QDot, NULL);
   }
 
   unsigned int reference_body_id = body_id;
@@ -502,18 +963,30 @@ RBDL_DLLAPI Math::SpatialVector CalcPointVelocity6D(
     unsigned int fbody_id = body_id - model.fixed_body_discriminator;
     reference_body_id = model.mFixedBodies[fbody_id].mMovableParent;
     Vector3d base_coords = 
-      CalcBodyToBaseCoordinates(model, Q, body_id, point_position, false);
+      CalcBodyToBaseCoordinates(model, data, Q, body_id, point_position, false);
     reference_point = 
-      CalcBaseToBodyCoordinates(model, Q, reference_body_id, base_coords,false);
+      CalcBaseToBodyCoordinates(model, data, Q, reference_body_id, base_coords,false);
   }
 
   return SpatialTransform (
-      CalcBodyWorldOrientation (model, Q, reference_body_id, false).transpose(), 
-      reference_point).apply(model.v[reference_body_id]);
+      CalcBodyWorldOrientation (model, data, Q, reference_body_id, false).transpose(), 
+      reference_point).apply(data.v[reference_body_id]);
 }
 
-RBDL_DLLAPI Vector3d CalcPointAcceleration (
+RBDL_DLLAPI Math::SpatialVector CalcPointVelocity6D(
     Model &model,
+    const Math::VectorNd &Q,
+    const Math::VectorNd &QDot,
+    unsigned int body_id,
+    const Math::Vector3d &point_position,
+    bool update_kinematics) {
+  return CalcPointVelocity6D (model, model, Q, QDot, body_id, point_position,
+      update_kinematics);
+}
+
+RBDL_DLLAPI Vector3d CalcPointAcceleration (
+    const Model &model,
+    ModelData &data,
     const VectorNd &Q,
     const VectorNd &QDot,
     const VectorNd &QDDot,
@@ -523,11 +996,11 @@ RBDL_DLLAPI Vector3d CalcPointAcceleration (
   RBDL_LOG << "-------- " << __func__ << " --------" << std::endl;
 
   // Reset the velocity of the root body
-  model.v[0].setZero();
-  model.a[0].setZero();
+  data.v[0].setZero();
+  data.a[0].setZero();
 
   if (update_kinematics)
-    UpdateKinematics (model, Q, QDot, QDDot);
+    UpdateKinematics (model, data, Q, QDot, QDDot);
 
   RBDL_LOG << std::endl;
 
@@ -538,19 +1011,19 @@ RBDL_DLLAPI Vector3d CalcPointAcceleration (
     unsigned int fbody_id = body_id - model.fixed_body_discriminator;
     reference_body_id = model.mFixedBodies[fbody_id].mMovableParent;
     Vector3d base_coords = 
-      CalcBodyToBaseCoordinates (model, Q, body_id, point_position, false);
+      CalcBodyToBaseCoordinates (model, data, Q, body_id, point_position, false);
     reference_point = 
-      CalcBaseToBodyCoordinates (model, Q, reference_body_id,base_coords,false);
+      CalcBaseToBodyCoordinates (model, data, Q, reference_body_id,base_coords,false);
   }
 
   SpatialTransform p_X_i (
-      CalcBodyWorldOrientation (model, Q, reference_body_id, false).transpose(),
+      CalcBodyWorldOrientation (model, data, Q, reference_body_id, false).transpose(),
       reference_point);
 
-  SpatialVector p_v_i = p_X_i.apply(model.v[reference_body_id]);
+  SpatialVector p_v_i = p_X_i.apply(data.v[reference_body_id]);
   Vector3d a_dash = Vector3d (p_v_i[0], p_v_i[1], p_v_i[2]
       ).cross(Vector3d (p_v_i[3], p_v_i[4], p_v_i[5]));
-  SpatialVector p_a_i = p_X_i.apply(model.a[reference_body_id]);
+  SpatialVector p_a_i = p_X_i.apply(data.a[reference_body_id]);
 
   return Vector3d (
       p_a_i[3] + a_dash[0],
@@ -559,7 +1032,7 @@ RBDL_DLLAPI Vector3d CalcPointAcceleration (
       );
 }
 
-RBDL_DLLAPI SpatialVector CalcPointAcceleration6D(
+RBDL_DLLAPI Vector3d CalcPointAcceleration (
     Model &model,
     const VectorNd &Q,
     const VectorNd &QDot,
@@ -567,14 +1040,27 @@ RBDL_DLLAPI SpatialVector CalcPointAcceleration6D(
     unsigned int body_id,
     const Vector3d &point_position,
     bool update_kinematics) {
+  return CalcPointAcceleration (model, model, Q, QDot, QDDot, body_id,
+      point_position, update_kinematics);
+}
+
+RBDL_DLLAPI SpatialVector CalcPointAcceleration6D(
+    const Model &model,
+    ModelData &data,
+    const VectorNd &Q,
+    const VectorNd &QDot,
+    const VectorNd &QDDot,
+    unsigned int body_id,
+    const Vector3d &point_position,
+    bool update_kinematics) {
   RBDL_LOG << "-------- " << __func__ << " --------" << std::endl;
 
   // Reset the velocity of the root body
-  model.v[0].setZero();
-  model.a[0].setZero();
+  data.v[0].setZero();
+  data.a[0].setZero();
 
   if (update_kinematics)
-    UpdateKinematics (model, Q, QDot, QDDot);
+    UpdateKinematics (model, data, Q, QDot, QDDot);
 
   RBDL_LOG << std::endl;
 
@@ -585,62 +1071,110 @@ RBDL_DLLAPI SpatialVector CalcPointAcceleration6D(
     unsigned int fbody_id = body_id - model.fixed_body_discriminator;
     reference_body_id = model.mFixedBodies[fbody_id].mMovableParent;
     Vector3d base_coords = 
-      CalcBodyToBaseCoordinates (model, Q, body_id, point_position, false);
+      CalcBodyToBaseCoordinates (model, data, Q, body_id, point_position, false);
     reference_point = 
-      CalcBaseToBodyCoordinates (model, Q, reference_body_id,base_coords,false);
+      CalcBaseToBodyCoordinates (model, data, Q, reference_body_id,base_coords,false);
   }
 
   SpatialTransform p_X_i (
-      CalcBodyWorldOrientation (model, Q, reference_body_id, false).transpose(),
+      CalcBodyWorldOrientation (model, data, Q, reference_body_id, false).transpose(),
       reference_point);
 
-  SpatialVector p_v_i = p_X_i.apply(model.v[reference_body_id]);
+  SpatialVector p_v_i = p_X_i.apply(data.v[reference_body_id]);
   Vector3d a_dash = Vector3d (p_v_i[0], p_v_i[1], p_v_i[2]
       ).cross(Vector3d (p_v_i[3], p_v_i[4], p_v_i[5]));
-  return (p_X_i.apply(model.a[reference_body_id]) 
+  return (p_X_i.apply(data.a[reference_body_id]) 
       + SpatialVector (0, 0, 0, a_dash[0], a_dash[1], a_dash[2]));
 }
 
+RBDL_DLLAPI SpatialVector CalcPointAcceleration6D(
+    Model &model,
+    const VectorNd &Q,
+    const VectorNd &QDot,
+    const VectorNd &QDDot,
+    unsigned int body_id,
+    const Vector3d &point_position,
+    bool update_kinematics) {
+  return CalcPointAcceleration6D (model, model, Q, QDot, QDDot, body_id,
+      point_position, update_kinematics);
+}
+
 #ifndef RBDL_USE_CASADI_MATH
+RBDL_DLLAPI
+InverseKinematicsWorkspace::InverseKinematicsWorkspace() {
+}
+
+RBDL_DLLAPI
+InverseKinematicsWorkspace::InverseKinematicsWorkspace (
+    const Model &model,
+    unsigned int point_count) {
+  resize (model, point_count);
+}
+
+RBDL_DLLAPI
+void InverseKinematicsWorkspace::resize (
+    const Model &model,
+    unsigned int point_count) {
+  unsigned int row_count = 3 * point_count;
+
+  J = MatrixNd::Zero (row_count, model.qdot_size);
+  G = MatrixNd::Zero (3, model.qdot_size);
+  e = VectorNd::Zero (row_count);
+  JJT_lambda2_I = MatrixNd::Zero (row_count, row_count);
+  z = VectorNd::Zero (row_count);
+  delta_theta = VectorNd::Zero (model.qdot_size);
+  JJT_lambda2_I_llt = Eigen::LLT<MatrixNd> (row_count);
+}
+
 RBDL_DLLAPI bool InverseKinematics (
-    Model &model,
+    const Model &model,
+    ModelData &data,
     const VectorNd &Qinit,
     const std::vector<unsigned int>& body_id,
     const std::vector<Vector3d>& body_point,
     const std::vector<Vector3d>& target_pos,
     VectorNd &Qres,
+    InverseKinematicsWorkspace &workspace,
     double step_tol,
     double lambda,
     unsigned int max_iter) {
+  RBDL_TRACE_ALGORITHM ("InverseKinematics");
+  RBDL_PERF_COUNTER ("InverseKinematics");
   assert (Qinit.size() == model.q_size);
   assert (body_id.size() == body_point.size());
   assert (body_id.size() == target_pos.size());
 
-  MatrixNd J = MatrixNd::Zero(3 * body_id.size(), model.qdot_size);
-  VectorNd e = VectorNd::Zero(3 * body_id.size());
+  unsigned int point_count = static_cast<unsigned int>(body_id.size());
+
+  if (workspace.J.rows() != 3 * point_count
+      || workspace.J.cols() != model.qdot_size) {
+    workspace.resize (model, point_count);
+  }
+
+  MatrixNd &J = workspace.J;
+  MatrixNd &G = workspace.G;
+  VectorNd &e = workspace.e;
+  MatrixNd &JJT_lambda2_I = workspace.JJT_lambda2_I;
+  VectorNd &z = workspace.z;
+  VectorNd &delta_theta = workspace.delta_theta;
 
   Qres = Qinit;
 
   for (unsigned int ik_iter = 0; ik_iter < max_iter; ik_iter++) {
-    UpdateKinematicsCustom (model, &Qres, NULL, NULL);
+    RBDL_PERF_COUNT_ITERATIONS (1);
 
-    for (unsigned int k = 0; k < body_id.size(); k++) {
-      MatrixNd G (MatrixNd::Zero(3, model.qdot_size));
-      CalcPointJacobian (model, Qres, body_id[k], body_point[k], G, false);
-      Vector3d point_base = 
-        CalcBodyToBaseCoordinates (model, Qres, body_id[k], body_point[k], false);
-      RBDL_LOG << "current_pos = " << point_base.transpose() << std::endl;
+    UpdateKinematicsCustom (model, data, &Qres, NULL, NULL);
 
-      for (unsigned int i = 0; i < 3; i++) {
-        for (unsigned int j = 0; j < model.qdot_size; j++) {
-          unsigned int row = k * 3 + i;
-          RBDL_LOG << "i = " << i << " j = " << j << " k = " << k << " row = " 
-            << row << " col = " << j << std::endl;
-          J(row, j) = G (i,j);
-        }
+    for (unsigned int k = 0; k < point_count; k++) {
+      G.setZero();
+      CalcPointJacobian (model, data, Qres, body_id[k], body_point[k], G,
+          false);
+      Vector3d point_base = CalcBodyToBaseCoordinates (model, data, Qres,
+          body_id[k], body_point[k], false);
+      RBDL_LOG << "current_pos = " << point_base.transpose() << std::endl;
 
-        e[k * 3 + i] = target_pos[k][i] - point_base[i];
-      }
+      J.block(k * 3, 0, 3, model.qdot_size) = G;
+      e.segment<3>(k * 3) = target_pos[k] - point_base;
     }
 
     RBDL_LOG << "J = " << J << std::endl;
@@ -652,49 +1186,50 @@ RBDL_DLLAPI bool InverseKinematics (
       return true;
     }
 
-    MatrixNd JJTe_lambda2_I = 
-      J * J.transpose() 
-      + lambda*lambda * MatrixNd::Identity(e.size(), e.size());
+    // only the lower triangular part is used by the Cholesky decomposition
+    JJT_lambda2_I.setZero();
+    JJT_lambda2_I.selfadjointView<Eigen::Lower>().rankUpdate (J);
+    JJT_lambda2_I.diagonal().array() += lambda * lambda;
 
-    VectorNd z (body_id.size() * 3);
+    workspace.JJT_lambda2_I_llt.compute (JJT_lambda2_I);
+    assert (workspace.JJT_lambda2_I_llt.info() == Eigen::Success);
 
-    bool solve_successful = LinSolveGaussElimPivot (JJTe_lambda2_I, e, z);
-    assert (solve_successful);
+    z = e;
+    workspace.JJT_lambda2_I_llt.solveInPlace (z);
 
     RBDL_LOG << "z = " << z << std::endl;
 
-    VectorNd delta_theta = J.transpose() * z;
+    delta_theta.noalias() = J.transpose() * z;
     RBDL_LOG << "change = " << delta_theta << std::endl;
 
-    Qres = Qres + delta_theta;
+    Qres += delta_theta;
     RBDL_LOG << "Qres = " << Qres.transpose() << std::endl;
 
     if (delta_theta.norm() < step_tol) {
       RBDL_LOG << "reached convergence after " << ik_iter << " steps" << std::endl;
       return true;
     }
-
-    VectorNd test_1 (z.size());
-    VectorNd test_res (z.size());
-
-    test_1.setZero();
-
-    for (unsigned int i = 0; i < z.size(); i++) {
-      test_1[i] = 1.;
-
-      VectorNd test_delta = J.transpose() * test_1;
-
-      test_res[i] = test_delta.squaredNorm();
-
-      test_1[i] = 0.;
-    }
-
-    RBDL_LOG << "test_res = " << test_res.transpose() << std::endl;
   }
 
   return false;
 }
 
+RBDL_DLLAPI bool InverseKinematics (
+    Model &model,
+    const VectorNd &Qinit,
+    const std::vector<unsigned int>& body_id,
+    const std::vector<Vector3d>& body_point,
+    const std::vector<Vector3d>& target_pos,
+    VectorNd &Qres,
+    double step_tol,
+    double lambda,
+    unsigned int max_iter) {
+  InverseKinematicsWorkspace workspace (model, body_id.size());
+
+  return InverseKinematics (model, model, Qinit, body_id, body_point,
+      target_pos, Qres, workspace, step_tol, lambda, max_iter);
+}
+
 RBDL_DLLAPI
 Vector3d CalcAngularVelocityfromMatrix (
     const Matrix3d &RotMat
@@ -858,16 +1393,20 @@ bool InverseKinematics (
     InverseKinematicsConstraintSet &CS,
     Math::VectorNd &Qres
     ) {
+  RBDL_TRACE_ALGORITHM ("InverseKinematics");
+  RBDL_PERF_COUNTER ("InverseKinematics");
   assert (Qinit.size() == model.q_size);
   assert (Qres.size() == Qinit.size());
 
   CS.J = MatrixNd::Zero(CS.num_constraints, model.qdot_size);
   CS.e = VectorNd::Zero(CS.num_constraints);
-  double mass;
+  Scalar mass;
 
   Qres = Qinit;
 
   for (CS.num_steps = 0; CS.num_steps < CS.max_steps; CS.num_steps++) {
+    RBDL_PERF_COUNT_ITERATIONS (1);
+
     UpdateKinematicsCustom (model, &Qres, NULL, NULL);
 
     for (unsigned int k = 0; k < CS.body_ids.size(); k++) {
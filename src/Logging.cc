@@ -5,6 +5,11 @@
  * Licensed under the zlib license. See LICENSE for more details.
  */
 
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+
 #include "rbdl/Logging.h"
 
 RBDL_DLLAPI std::ostringstream LogOutput;
@@ -12,3 +17,197 @@ RBDL_DLLAPI std::ostringstream LogOutput;
 RBDL_DLLAPI void ClearLogOutput() {
   LogOutput.str("");
 }
+
+namespace RigidBodyDynamics {
+
+RBDL_DLLAPI std::atomic<int> TraceLevelRuntime (TraceLevelOff);
+
+namespace {
+
+/** Ring buffer of a single thread.
+ *
+ * Only the owning thread writes to the buffer. Every slot is guarded by a
+ * sequence number which is odd while the slot is written. Readers use it to
+ * skip events that got overwritten while they were copied.
+ */
+struct TraceBuffer {
+  explicit TraceBuffer (unsigned int index) :
+    thread_index (index),
+    count (0),
+    cleared (0),
+    in_use (true) {
+    for (unsigned int i = 0; i < TraceBufferSize; i++) {
+      sequence[i].store (0, std::memory_order_relaxed);
+    }
+  }
+
+  unsigned int thread_index;
+  /// Number of events that were written to the buffer
+  std::atomic<uint64_t> count;
+  /// Events with a smaller index were discarded by ClearTrace()
+  std::atomic<uint64_t> cleared;
+  /// Cleared when the owning thread exits so that the buffer can be reused
+  std::atomic<bool> in_use;
+  std::atomic<uint64_t> sequence[TraceBufferSize];
+  TraceEvent events[TraceBufferSize];
+};
+
+std::mutex trace_registry_mutex;
+std::vector<std::unique_ptr<TraceBuffer> > trace_registry;
+
+struct TraceBufferHandle {
+  TraceBufferHandle() : buffer (NULL) {}
+  ~TraceBufferHandle() {
+    if (buffer) {
+      buffer->in_use.store (false, std::memory_order_release);
+    }
+  }
+
+  TraceBuffer *buffer;
+};
+
+thread_local TraceBufferHandle trace_buffer_handle;
+
+TraceBuffer* GetThreadTraceBuffer () {
+  if (trace_buffer_handle.buffer != NULL) {
+    return trace_buffer_handle.buffer;
+  }
+
+  std::lock_guard<std::mutex> lock (trace_registry_mutex);
+
+  // reuse the buffer of a thread that has exited to bound the memory
+  // when threads are created and destroyed frequently
+  for (size_t i = 0; i < trace_registry.size(); i++) {
+    if (!trace_registry[i]->in_use.load (std::memory_order_acquire)) {
+      trace_registry[i]->in_use.store (true, std::memory_order_relaxed);
+      trace_buffer_handle.buffer = trace_registry[i].get();
+      return trace_buffer_handle.buffer;
+    }
+  }
+
+  trace_registry.push_back (std::unique_ptr<TraceBuffer> (
+        new TraceBuffer (trace_registry.size())));
+  trace_buffer_handle.buffer = trace_registry.back().get();
+
+  return trace_buffer_handle.buffer;
+}
+
+bool TraceEventTimeLess (const TraceEvent &a, const TraceEvent &b) {
+  return a.time_ns < b.time_ns;
+}
+
+const char* TraceEventTypeName (TraceEventType type) {
+  switch (type) {
+    case TraceEventEnter: return "enter";
+    case TraceEventExit: return "exit";
+    case TraceEventBody: return "body";
+  }
+  return "unknown";
+}
+
+}
+
+RBDL_DLLAPI void SetTraceLevel (TraceLevel level) {
+  TraceLevelRuntime.store (level, std::memory_order_relaxed);
+}
+
+RBDL_DLLAPI TraceLevel GetTraceLevel () {
+  return static_cast<TraceLevel>(
+      TraceLevelRuntime.load (std::memory_order_relaxed));
+}
+
+RBDL_DLLAPI uint64_t TraceTime () {
+  return std::chrono::duration_cast<std::chrono::nanoseconds> (
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+RBDL_DLLAPI void TraceRecord (TraceEventType type, const char *name,
+    unsigned int body_id, uint64_t duration_ns) {
+  TraceBuffer *buffer = GetThreadTraceBuffer();
+
+  uint64_t index = buffer->count.load (std::memory_order_relaxed);
+  unsigned int slot = index % TraceBufferSize;
+
+  buffer->sequence[slot].store (2 * index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence (std::memory_order_release);
+
+  TraceEvent &event = buffer->events[slot];
+  event.time_ns = TraceTime();
+  event.duration_ns = duration_ns;
+  event.name = name;
+  event.body_id = body_id;
+  event.thread_index = buffer->thread_index;
+  event.type = type;
+
+  buffer->sequence[slot].store (2 * index + 2, std::memory_order_release);
+  buffer->count.store (index + 1, std::memory_order_release);
+}
+
+RBDL_DLLAPI std::vector<TraceEvent> GetTraceEvents () {
+  std::vector<TraceEvent> result;
+  std::lock_guard<std::mutex> lock (trace_registry_mutex);
+
+  for (size_t i = 0; i < trace_registry.size(); i++) {
+    const TraceBuffer &buffer = *trace_registry[i];
+    uint64_t count = buffer.count.load (std::memory_order_acquire);
+    uint64_t first = std::max (
+        buffer.cleared.load (std::memory_order_relaxed),
+        count > TraceBufferSize ? count - TraceBufferSize : 0);
+
+    for (uint64_t index = first; index < count; index++) {
+      unsigned int slot = index % TraceBufferSize;
+      uint64_t sequence =
+        buffer.sequence[slot].load (std::memory_order_acquire);
+      if (sequence != 2 * index + 2) {
+        continue;
+      }
+
+      TraceEvent event = buffer.events[slot];
+      std::atomic_thread_fence (std::memory_order_acquire);
+
+      if (buffer.sequence[slot].load (std::memory_order_relaxed)
+          == sequence) {
+        result.push_back (event);
+      }
+    }
+  }
+
+  std::stable_sort (result.begin(), result.end(), TraceEventTimeLess);
+
+  return result;
+}
+
+RBDL_DLLAPI void DumpTrace (std::ostream &stream) {
+  std::vector<TraceEvent> events = GetTraceEvents();
+  if (events.size() == 0) {
+    return;
+  }
+
+  uint64_t time_start = events[0].time_ns;
+  for (size_t i = 0; i < events.size(); i++) {
+    const TraceEvent &event = events[i];
+    stream << "t = " << event.time_ns - time_start << " ns"
+      << " thread " << event.thread_index
+      << " " << TraceEventTypeName (event.type)
+      << " " << event.name;
+    if (event.body_id != TraceNoBody) {
+      stream << " body " << event.body_id;
+    }
+    if (event.type == TraceEventExit) {
+      stream << " duration " << event.duration_ns << " ns";
+    }
+    stream << std::endl;
+  }
+}
+
+RBDL_DLLAPI void ClearTrace () {
+  std::lock_guard<std::mutex> lock (trace_registry_mutex);
+
+  for (size_t i = 0; i < trace_registry.size(); i++) {
+    trace_registry[i]->cleared.store (
+        trace_registry[i]->count.load (std::memory_order_acquire),
+        std::memory_order_relaxed);
+  }
+}
+
+}
@@ -20,6 +20,10 @@
 using namespace RigidBodyDynamics;
 using namespace RigidBodyDynamics::Math;
 
+ModelData::ModelData (const Model &model) :
+  ModelData (static_cast<const ModelData&>(model))
+{ }
+
 Model::Model()
 {
   Body root_body;
@@ -61,6 +65,7 @@ Model::Model()
   // Dynamic variables
   c.push_back(zero_spatial);
   IA.push_back(SpatialMatrix::Identity());
+  IA_compact.push_back(SpatialArticulatedBodyInertia());
   pA.push_back(zero_spatial);
   U.push_back(zero_spatial);
 
@@ -75,6 +80,8 @@ Model::Model()
   I.push_back(rbi);
   hc.push_back (zero_spatial);
   hdotc.push_back (zero_spatial);
+  Omega.push_back (SpatialMatrix::Zero());
+  Chi.push_back (SpatialMatrix::Zero());
 
   // Bodies
   X_lambda.push_back(SpatialTransform());
@@ -330,8 +337,20 @@ unsigned int Model::AddBody(
                     + mCustomJoints[mCustomJoints.size() - 1]->mDoFCount;
   }
 
+  // the first degree of freedom of the joint is supported by the last one
+  // of the movable parent which preserves the branch-induced sparsity
+  unsigned int lambda_q_parent = 0;
+  if (movable_parent_id != 0) {
+    lambda_q_parent = mJoints[movable_parent_id].q_index
+                      + mJoints[movable_parent_id].mDoFCount;
+  }
+
   for (unsigned int i = 0; i < joint.mDoFCount; i++) {
-    lambda_q.push_back(lambda_q_last + i);
+    if (i == 0) {
+      lambda_q.push_back(lambda_q_parent);
+    } else {
+      lambda_q.push_back(lambda_q_last + i);
+    }
   }
   mu.push_back(std::vector<unsigned int>());
   mu.at(movable_parent_id).push_back(mBodies.size());
@@ -407,6 +426,7 @@ unsigned int Model::AddBody(
   // Dynamic variables
   c.push_back(SpatialVector(0., 0., 0., 0., 0., 0.));
   IA.push_back(SpatialMatrix::Zero());
+  IA_compact.push_back(SpatialArticulatedBodyInertia());
   pA.push_back(SpatialVector(0., 0., 0., 0., 0., 0.));
   U.push_back(SpatialVector(0., 0., 0., 0., 0., 0.));
 
@@ -424,6 +444,8 @@ unsigned int Model::AddBody(
   I.push_back (rbi);
   hc.push_back (SpatialVector(0., 0., 0., 0., 0., 0.));
   hdotc.push_back (SpatialVector(0., 0., 0., 0., 0., 0.));
+  Omega.push_back (SpatialMatrix::Zero());
+  Chi.push_back (SpatialMatrix::Zero());
 
   if (mBodies.size() == fixed_body_discriminator) {
     std::ostringstream errormsg;
@@ -0,0 +1,103 @@
+/*
+ * RBDL - Rigid Body Dynamics Library
+ * Copyright (c) 2011-2018 Martin Felis <martin@fysx.org>
+ *
+ * Licensed under the zlib license. See LICENSE for more details.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+
+#include "rbdl/PerformanceCounters.h"
+
+namespace RigidBodyDynamics {
+
+namespace {
+
+std::mutex performance_counters_mutex;
+std::vector<std::unique_ptr<PerformanceCounter> > performance_counters;
+
+bool PerformanceCounterStatsNameLess (const PerformanceCounterStats &a,
+    const PerformanceCounterStats &b) {
+  return a.name < b.name;
+}
+
+}
+
+PerformanceCounter::PerformanceCounter (const std::string &name) :
+  name (name),
+  call_count (0),
+  total_time_ns (0),
+  max_time_ns (0),
+  iteration_count (0)
+{}
+
+void PerformanceCounter::reset () {
+  call_count.store (0, std::memory_order_relaxed);
+  total_time_ns.store (0, std::memory_order_relaxed);
+  max_time_ns.store (0, std::memory_order_relaxed);
+  iteration_count.store (0, std::memory_order_relaxed);
+}
+
+RBDL_DLLAPI PerformanceCounter& GetPerformanceCounter (const char *name) {
+  std::lock_guard<std::mutex> lock (performance_counters_mutex);
+
+  for (size_t i = 0; i < performance_counters.size(); i++) {
+    if (performance_counters[i]->name == name) {
+      return *performance_counters[i];
+    }
+  }
+
+  performance_counters.push_back (std::unique_ptr<PerformanceCounter> (
+        new PerformanceCounter (name)));
+
+  return *performance_counters.back();
+}
+
+RBDL_DLLAPI std::vector<PerformanceCounterStats> GetPerformanceCounterStats () {
+  std::vector<PerformanceCounterStats> result;
+  std::lock_guard<std::mutex> lock (performance_counters_mutex);
+
+  for (size_t i = 0; i < performance_counters.size(); i++) {
+    const PerformanceCounter &counter = *performance_counters[i];
+    PerformanceCounterStats stats;
+    stats.name = counter.name;
+    stats.call_count = counter.call_count.load (std::memory_order_relaxed);
+    stats.total_time_ns =
+      counter.total_time_ns.load (std::memory_order_relaxed);
+    stats.max_time_ns = counter.max_time_ns.load (std::memory_order_relaxed);
+    stats.iteration_count =
+      counter.iteration_count.load (std::memory_order_relaxed);
+    result.push_back (stats);
+  }
+
+  std::sort (result.begin(), result.end(), PerformanceCounterStatsNameLess);
+
+  return result;
+}
+
+RBDL_DLLAPI void ResetPerformanceCounters () {
+  std::lock_guard<std::mutex> lock (performance_counters_mutex);
+
+  for (size_t i = 0; i < performance_counters.size(); i++) {
+    performance_counters[i]->reset();
+  }
+}
+
+RBDL_DLLAPI void WritePerformanceCountersJSON (std::ostream &stream) {
+  std::vector<PerformanceCounterStats> stats = GetPerformanceCounterStats();
+
+  stream << "{" << std::endl;
+  for (size_t i = 0; i < stats.size(); i++) {
+    stream << "  \"" << stats[i].name << "\": {"
+      << " \"calls\": " << stats[i].call_count << ","
+      << " \"total_ns\": " << stats[i].total_time_ns << ","
+      << " \"max_ns\": " << stats[i].max_time_ns << ","
+      << " \"iterations\": " << stats[i].iteration_count
+      << " }" << (i + 1 < stats.size() ? "," : "") << std::endl;
+  }
+  stream << "}" << std::endl;
+}
+
+}
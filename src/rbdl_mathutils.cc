@@ -258,7 +258,7 @@ RBDL_DLLAPI SpatialMatrix XtransRotZYXEuler (
   return Xrotz_mat(zyx_euler[0]) * Xroty_mat(zyx_euler[1]) * Xrotx_mat(zyx_euler[2]) * Xtrans_mat(displacement);
 }
 
-RBDL_DLLAPI void SparseFactorizeLTL (Model &model, Math::MatrixNd &H) {
+RBDL_DLLAPI void SparseFactorizeLTL (const Model &model, Math::MatrixNd &H) {
   for (unsigned int i = 0; i < model.qdot_size; i++) {
     for (unsigned int j = i + 1; j < model.qdot_size; j++) {
       H(i,j) = 0.;
@@ -297,7 +297,8 @@ RBDL_DLLAPI void SparseMultiplyLTx (Model &model, Math::MatrixNd &L) {
   assert (0 && !"Not yet implemented!");
 }
 
-RBDL_DLLAPI void SparseSolveLx (Model &model, Math::MatrixNd &L, Math::VectorNd &x) {
+RBDL_DLLAPI void SparseSolveLx (const Model &model,
+    const Math::MatrixNd &L, Math::VectorNd &x) {
   for (unsigned int i = 1; i <= model.qdot_size; i++) {
     unsigned int j = model.lambda_q[i];
     while (j != 0) {
@@ -308,7 +309,8 @@ RBDL_DLLAPI void SparseSolveLx (Model &model, Math::MatrixNd &L, Math::VectorNd
   }
 }
 
-RBDL_DLLAPI void SparseSolveLTx (Model &model, Math::MatrixNd &L, Math::VectorNd &x) {
+RBDL_DLLAPI void SparseSolveLTx (const Model &model,
+    const Math::MatrixNd &L, Math::VectorNd &x) {
   for (unsigned int i = model.qdot_size; i > 0; i--) {
     x[i - 1] = x[i - 1] / L(i - 1,i - 1);
     unsigned int j = model.lambda_q[i];
@@ -11,6 +11,7 @@
 #include "rbdl/rbdl_math.h"
 #include "rbdl/Model.h"
 #include "rbdl/Kinematics.h"
+#include "rbdl/Dynamics.h"
 
 #include <sstream>
 #include <iomanip>
@@ -279,6 +280,117 @@ RBDL_DLLAPI void CalcCenterOfMass (
   }
 }
 
+#ifndef RBDL_USE_CASADI_MATH
+// Computes the columns of the centroidal momentum matrix at the origin of
+// the base frame and returns the COM. Requires X_base and the composite
+// inertias Ic of all bodies.
+Vector3d calc_base_momentum_matrix (const Model &model, MatrixNd &A_0)
+{
+  SpatialRigidBodyInertia I_tot (0., Vector3d (0., 0., 0.), Matrix3d::Zero());
+
+  for (size_t i = 1; i < model.mBodies.size(); i++) {
+    unsigned int q_index = model.mJoints[i].q_index;
+
+    if (model.mJoints[i].mJointType == JointTypeCustom) {
+      const CustomJoint *custom_joint =
+        model.mCustomJoints[model.mJoints[i].custom_joint_index];
+
+      for (unsigned int j = 0; j < custom_joint->mDoFCount; j++) {
+        A_0.col(q_index + j) = model.X_base[i].applyTranspose (
+            model.Ic[i] * SpatialVector (custom_joint->S.col(j)));
+      }
+    } else if (model.mJoints[i].mDoFCount == 1) {
+      A_0.col(q_index) = model.X_base[i].applyTranspose (
+          model.Ic[i] * model.S[i]);
+    } else if (model.mJoints[i].mDoFCount == 3) {
+      for (unsigned int j = 0; j < 3; j++) {
+        A_0.col(q_index + j) = model.X_base[i].applyTranspose (
+            model.Ic[i] * SpatialVector (model.multdof3_S[i].col(j)));
+      }
+    }
+
+    if (model.lambda[i] == 0) {
+      I_tot = I_tot + model.X_lambda[i].applyTranspose (model.Ic[i]);
+    }
+  }
+
+  return I_tot.h / I_tot.m;
+}
+
+// Moves the reference point of the momentum columns from the base origin
+// to the COM, i.e. applies Xtrans (com).applyAdjoint() to every column
+void shift_momentum_matrix_to_com (const Vector3d &com, MatrixNd &A_G)
+{
+  A_G.topRows<3>() -= VectorCrossMatrix (com) * A_G.bottomRows<3>();
+}
+
+RBDL_DLLAPI void CalcCentroidalMomentumMatrix (
+  Model &model,
+  const Math::VectorNd &q,
+  Math::MatrixNd &A_G,
+  bool update_kinematics)
+{
+  if (update_kinematics) {
+    UpdateKinematicsCustom (model, &q, NULL, NULL);
+  }
+
+  CalcCompositeRigidBodyInertias (model, q, false);
+
+  if (A_G.rows() != 6 || A_G.cols() != model.qdot_size) {
+    A_G.resize (6, model.qdot_size);
+  }
+
+  Vector3d com = calc_base_momentum_matrix (model, A_G);
+  shift_momentum_matrix_to_com (com, A_G);
+}
+
+RBDL_DLLAPI void CalcCentroidalMomentumBias (
+  Model &model,
+  const Math::VectorNd &q,
+  const Math::VectorNd &qdot,
+  Math::SpatialVector &A_G_dot_qdot,
+  Math::MatrixNd *A_G,
+  bool update_kinematics)
+{
+  if (update_kinematics) {
+    UpdateKinematicsCustom (model, &q, &qdot, NULL);
+  }
+
+  CalcCompositeRigidBodyInertias (model, q, false);
+
+  // The velocity product acceleration c_i of joint i accelerates the whole
+  // subtree of body i, therefore the rate of change of momentum for
+  // qddot = 0 only requires the composite inertias and no forward pass over
+  // the body accelerations.
+  SpatialVector hdot_tot (SpatialVector::Zero());
+  SpatialRigidBodyInertia I_tot (0., Vector3d (0., 0., 0.), Matrix3d::Zero());
+
+  for (size_t i = 1; i < model.mBodies.size(); i++) {
+    hdot_tot += model.X_base[i].applyTranspose (model.Ic[i] * model.c[i]
+        + crossf (model.v[i], model.I[i] * model.v[i]));
+
+    if (model.lambda[i] == 0) {
+      I_tot = I_tot + model.X_lambda[i].applyTranspose (model.Ic[i]);
+    }
+  }
+
+  Vector3d com = I_tot.h / I_tot.m;
+
+  // The COM moves parallel to the linear momentum, therefore shifting the
+  // reference point does not add a term to the rate of change.
+  A_G_dot_qdot = Xtrans (com).applyAdjoint (hdot_tot);
+
+  if (A_G) {
+    if (A_G->rows() != 6 || A_G->cols() != model.qdot_size) {
+      A_G->resize (6, model.qdot_size);
+    }
+
+    calc_base_momentum_matrix (model, *A_G);
+    shift_momentum_matrix_to_com (com, *A_G);
+  }
+}
+#endif
+
 RBDL_DLLAPI void CalcZeroMomentPoint (
   Model &model,
   const Math::VectorNd &q,
@@ -0,0 +1,116 @@
+#include <iostream>
+#include <stdexcept>
+
+#include "rbdl/Logging.h"
+#include "rbdl/Model.h"
+#include "rbdl/Dynamics.h"
+#include "rbdl/BatchExecutor.h"
+
+#include "rbdl_tests.h"
+
+#include "Fixtures.h"
+#include "Human36Fixture.h"
+
+using namespace std;
+using namespace RigidBodyDynamics;
+using namespace RigidBodyDynamics::Math;
+
+const unsigned int BATCH_SAMPLE_COUNT = 37;
+
+void FillBatchStates (const Model &model, MatrixNd &Q, MatrixNd &QDot,
+    MatrixNd &U) {
+  Q.resize (model.q_size, BATCH_SAMPLE_COUNT);
+  QDot.resize (model.qdot_size, BATCH_SAMPLE_COUNT);
+  U.resize (model.qdot_size, BATCH_SAMPLE_COUNT);
+
+  for (unsigned int j = 0; j < BATCH_SAMPLE_COUNT; j++) {
+    for (unsigned int i = 0; i < model.q_size; i++) {
+      Q(i,j) = 0.3 * sin (static_cast<double>(i + 2 * j));
+    }
+    for (unsigned int i = 0; i < model.qdot_size; i++) {
+      QDot(i,j) = 0.7 * cos (static_cast<double>(3 * i + j));
+      U(i,j) = 1.1 * sin (static_cast<double>(i * j) + 0.5);
+    }
+  }
+}
+
+TEST_CASE_METHOD (Human36, __FILE__"_BatchExecutorMatchesSerial", "") {
+  MatrixNd Q, QDot, U;
+  FillBatchStates (*model_3dof, Q, QDot, U);
+
+  MatrixNd QDDot_serial (model_3dof->qdot_size, BATCH_SAMPLE_COUNT);
+  MatrixNd Tau_serial (model_3dof->qdot_size, BATCH_SAMPLE_COUNT);
+  MatrixNd N_serial (model_3dof->qdot_size, BATCH_SAMPLE_COUNT);
+  std::vector<MatrixNd> H_serial (BATCH_SAMPLE_COUNT);
+
+  for (unsigned int j = 0; j < BATCH_SAMPLE_COUNT; j++) {
+    VectorNd q = Q.col(j);
+    VectorNd qdot = QDot.col(j);
+    VectorNd u = U.col(j);
+    VectorNd result (VectorNd::Zero (model_3dof->qdot_size));
+
+    ForwardDynamics (*model_3dof, q, qdot, u, result);
+    QDDot_serial.col(j) = result;
+
+    InverseDynamics (*model_3dof, q, qdot, u, result);
+    Tau_serial.col(j) = result;
+
+    NonlinearEffects (*model_3dof, q, qdot, result);
+    N_serial.col(j) = result;
+
+    H_serial[j] = MatrixNd::Zero (model_3dof->qdot_size,
+        model_3dof->qdot_size);
+    CompositeRigidBodyAlgorithm (*model_3dof, q, H_serial[j]);
+  }
+
+  for (unsigned int thread_count = 1; thread_count <= 3; thread_count++) {
+    BatchExecutor executor (*model_3dof, thread_count);
+    REQUIRE (executor.GetThreadCount() == thread_count);
+
+    MatrixNd QDDot_batch, Tau_batch, N_batch;
+    std::vector<MatrixNd> H_batch;
+
+    executor.ForwardDynamics (Q, QDot, U, QDDot_batch);
+    executor.InverseDynamics (Q, QDot, U, Tau_batch);
+    executor.NonlinearEffects (Q, QDot, N_batch);
+    executor.CompositeRigidBodyAlgorithm (Q, H_batch);
+
+    CHECK_THAT (QDDot_serial, AllCloseMatrix(QDDot_batch, 0., 0.));
+    CHECK_THAT (Tau_serial, AllCloseMatrix(Tau_batch, 0., 0.));
+    CHECK_THAT (N_serial, AllCloseMatrix(N_batch, 0., 0.));
+
+    REQUIRE (H_batch.size() == BATCH_SAMPLE_COUNT);
+    for (unsigned int j = 0; j < BATCH_SAMPLE_COUNT; j++) {
+      CHECK_THAT (H_serial[j], AllCloseMatrix(H_batch[j], 0., 0.));
+    }
+  }
+}
+
+TEST_CASE_METHOD (FloatingBase12DoF, __FILE__"_BatchExecutorRun", "") {
+  BatchExecutor executor (*model, 4);
+
+  std::vector<unsigned int> visit_count (100, 0);
+  executor.Run (visit_count.size(), [&] (unsigned int i, ModelData &data) {
+      visit_count[i]++;
+      });
+
+  for (unsigned int i = 0; i < visit_count.size(); i++) {
+    CHECK (visit_count[i] == 1);
+  }
+
+  CHECK_THROWS_AS (executor.Run (10, [] (unsigned int i, ModelData &data) {
+        if (i == 7) {
+          throw std::runtime_error ("sample failed");
+        }
+        }), std::runtime_error);
+
+  // the executor can still be used after an exception
+  executor.Run (visit_count.size(), [&] (unsigned int i, ModelData &data) {
+      visit_count[i]++;
+      });
+  CHECK (visit_count[99] == 2);
+
+  MatrixNd Q (model->q_size, 2), QDot (model->qdot_size, 3), QDDot;
+  CHECK_THROWS_AS (executor.NonlinearEffects (Q, QDot, QDDot),
+      Errors::RBDLSizeMismatchError);
+}
@@ -1124,3 +1124,374 @@ TEST_CASE_METHOD (Human36,
               AllCloseVector(heel_right_velocity, TEST_PREC, TEST_PREC)
   );
 }
+
+TEST_CASE_METHOD (Human36,
+                  __FILE__"_ConstraintCacheSharedBodyPoints", "") {
+  for (unsigned int i = 0; i < q.size(); i++) {
+    q[i] = 0.3 * sin (static_cast<double>(i));
+    qdot[i] = 0.5 * cos (static_cast<double>(2 * i));
+    tau[i] = 0.2 * sin (static_cast<double>(3 * i) + 0.5);
+  }
+
+  unsigned int feet[2] = { body_id_3dof[BodyFootLeft],
+                           body_id_3dof[BodyFootRight] };
+  Vector3d normals[2] = { Vector3d (0., 0., 1.), Vector3d (1., 0., 0.) };
+
+  // four corners per foot, each corner is used by two separate constraints
+  ConstraintSet constraint_set;
+  std::vector<unsigned int> row_body;
+  std::vector<Vector3d> row_point;
+  std::vector<Vector3d> row_normal;
+  unsigned int user_id = 0;
+  for (unsigned int f = 0; f < 2; f++) {
+    for (unsigned int i = 0; i < 4; i++) {
+      Vector3d corner ((i % 2) ? 0.1 : -0.03, (i / 2) ? 0.04 : -0.04, -0.03);
+      for (unsigned int n = 0; n < 2; n++) {
+        constraint_set.AddContactConstraint (feet[f], corner, normals[n],
+                                             NULL, user_id++);
+        row_body.push_back (feet[f]);
+        row_point.push_back (corner);
+        row_normal.push_back (normals[n]);
+      }
+    }
+  }
+  constraint_set.Bind (*model_3dof);
+
+  CalcConstrainedSystemVariables (*model_3dof, q, qdot, tau, constraint_set);
+
+  CHECK (constraint_set.constraints.size() == 16);
+  CHECK (constraint_set.cache.bodyKinematicsCount == 2);
+  CHECK (constraint_set.cache.pointKinematicsCount == 8);
+  CHECK_FALSE (constraint_set.cache.pointCacheActive);
+
+  MatrixNd point_jacobian (MatrixNd::Zero (3, model_3dof->qdot_size));
+  VectorNd zero (VectorNd::Zero (model_3dof->qdot_size));
+  for (unsigned int i = 0; i < constraint_set.size(); i++) {
+    point_jacobian.setZero();
+    CalcPointJacobian (*model_3dof, q, row_body[i], row_point[i],
+                       point_jacobian);
+    VectorNd G_row = point_jacobian.transpose() * row_normal[i];
+    VectorNd G_row_cached = constraint_set.G.row(i).transpose();
+    CHECK_THAT (G_row, AllCloseVector (G_row_cached, TEST_PREC, TEST_PREC));
+
+    double gamma = -row_normal[i].dot (CalcPointAcceleration (*model_3dof, q,
+                                       qdot, zero, row_body[i],
+                                       row_point[i]));
+    CHECK_THAT (gamma, IsClose (constraint_set.gamma[i], TEST_PREC,
+                                TEST_PREC));
+
+    double errd = row_normal[i].dot (CalcPointVelocity (*model_3dof, q, qdot,
+                                     row_body[i], row_point[i]));
+    CHECK_THAT (errd, IsClose (constraint_set.errd[i], TEST_PREC,
+                               TEST_PREC));
+  }
+}
+
+TEST_CASE (__FILE__"_ConstrainedSystemVariablesRootJointBias", "") {
+  // the velocity product acceleration c_J of this joint does not vanish
+  Model model;
+  unsigned int body_id = model.AddBody (0, Xtrans (Vector3d (0., 0., 0.)),
+      Joint (JointTypeEulerZYX),
+      Body (1., Vector3d (0.2, 0.1, 0.3), Vector3d (1., 2., 3.)));
+
+  Vector3d point (0.4, -0.3, 0.5);
+  ConstraintSet constraint_set;
+  constraint_set.AddContactConstraint (body_id, point, Vector3d (1., 0., 0.));
+  constraint_set.AddContactConstraint (body_id, point, Vector3d (0., 1., 0.));
+  constraint_set.AddContactConstraint (body_id, point, Vector3d (0., 0., 1.));
+  constraint_set.Bind (model);
+
+  VectorNd q (VectorNd::Zero (model.q_size));
+  VectorNd qdot (VectorNd::Zero (model.qdot_size));
+  VectorNd tau (VectorNd::Zero (model.qdot_size));
+  for (unsigned int i = 0; i < q.size(); i++) {
+    q[i] = 0.4 * sin (static_cast<double>(i + 1));
+    qdot[i] = 1.3 * cos (static_cast<double>(2 * i));
+  }
+
+  CalcConstrainedSystemVariables (model, q, qdot, tau, constraint_set);
+
+  Vector3d gamma = -CalcPointAcceleration (model, q, qdot,
+      VectorNd::Zero (model.qdot_size), body_id, point);
+  CHECK_THAT (gamma, AllCloseVector (constraint_set.gamma, TEST_PREC,
+      TEST_PREC));
+}
+
+// 
+// ForwardDynamicsContactsPGS
+// 
+struct ContactBox {
+  ContactBox () {
+    ClearLogOutput();
+    model = new Model;
+    model->gravity = Vector3d (0., -9.81, 0.);
+
+    mass = 2.;
+    Body box_body (mass, Vector3d (0., 0., 0.), Vector3d (0.1, 0.2, 0.3));
+    Joint free_flyer (
+        SpatialVector (0., 0., 0., 1., 0., 0.),
+        SpatialVector (0., 0., 0., 0., 1., 0.),
+        SpatialVector (0., 0., 0., 0., 0., 1.),
+        SpatialVector (0., 0., 1., 0., 0., 0.),
+        SpatialVector (0., 1., 0., 0., 0., 0.),
+        SpatialVector (1., 0., 0., 0., 0., 0.));
+    box_id = model->AddBody (0, SpatialTransform(), free_flyer, box_body);
+
+    // four corners with the normal as first and the friction directions as
+    // further axes
+    for (int i = 0; i < 4; i++) {
+      Vector3d corner ((i % 2) ? 0.5 : -0.5, -0.25, (i / 2) ? 0.3 : -0.3);
+      constraint_set.AddContactConstraint (box_id, corner,
+                                           Vector3d (0., 1., 0.));
+      constraint_set.AddContactConstraint (box_id, corner,
+                                           Vector3d (1., 0., 0.));
+      constraint_set.AddContactConstraint (box_id, corner,
+                                           Vector3d (0., 0., 1.));
+    }
+
+    Q = VectorNd::Zero (model->q_size);
+    Q[1] = 0.25;
+    QDot = VectorNd::Zero (model->qdot_size);
+    QDDot = VectorNd::Zero (model->qdot_size);
+    Tau = VectorNd::Zero (model->qdot_size);
+  }
+  ~ContactBox () {
+    delete model;
+  }
+
+  void SetFrictionCoefficient (double mu) {
+    for (unsigned int i = 0; i < constraint_set.constraints.size(); i++) {
+      constraint_set.setContactFrictionCoefficient (i, mu);
+    }
+  }
+
+  Model *model;
+  unsigned int box_id;
+  double mass;
+  ConstraintSet constraint_set;
+
+  VectorNd Q;
+  VectorNd QDot;
+  VectorNd QDDot;
+  VectorNd Tau;
+};
+
+TEST_CASE_METHOD (FixedBase6DoF,
+                  __FILE__"_ForwardDynamicsContactsPGSSingleContact", "") {
+  Q[0] = 0.6;
+  Q[3] = M_PI * 0.6;
+  Q[4] = 0.1;
+
+  contact_normal.set (0., 1., 0.);
+  constraint_set.AddContactConstraint (contact_body_id, contact_point,
+                                       contact_normal);
+  ConstraintSet constraint_set_kokkevis = constraint_set.Copy();
+
+  constraint_set_kokkevis.Bind (*model);
+  constraint_set.Bind (*model);
+
+  VectorNd QDDot_kokkevis = VectorNd::Zero (model->qdot_size);
+  VectorNd QDDot_pgs = VectorNd::Zero (model->qdot_size);
+
+  ForwardDynamicsContactsKokkevis (*model, Q, QDot, Tau,
+                                   constraint_set_kokkevis, QDDot_kokkevis);
+  ForwardDynamicsContactsPGS (*model, Q, QDot, Tau, constraint_set,
+                              QDDot_pgs);
+
+  // a single pushing contact is solved exactly
+  REQUIRE (constraint_set_kokkevis.force[0] > 0.);
+  CHECK_THAT (constraint_set_kokkevis.force[0],
+              IsClose(constraint_set.force[0], TEST_PREC, TEST_PREC));
+  CHECK_THAT (QDDot_kokkevis,
+              AllCloseVector(QDDot_pgs, TEST_PREC, TEST_PREC));
+  CHECK (constraint_set.pgs_iterations <= 2);
+}
+
+TEST_CASE_METHOD (ContactBox,
+                  __FILE__"_ForwardDynamicsContactsPGSResting", "") {
+  constraint_set.Bind (*model);
+
+  ForwardDynamicsContactsPGS (*model, Q, QDot, Tau, constraint_set, QDDot);
+
+  double normal_force = 0.;
+  for (unsigned int i = 0; i < constraint_set.contactConstraints.size(); i++) {
+    unsigned int ci = constraint_set.contactConstraints[i]
+      ->getConstraintIndex();
+    CHECK (constraint_set.force[ci] >= 0.);
+    normal_force += constraint_set.force[ci];
+  }
+
+  CHECK (constraint_set.pgs_iterations < constraint_set.pgs_max_iterations);
+  CHECK_THAT (normal_force, IsClose(mass * 9.81, 1.0e-8, 1.0e-8));
+  CHECK_THAT (VectorNd::Zero (model->qdot_size),
+              AllCloseVector(QDDot, 1.0e-8, 1.0e-8));
+}
+
+TEST_CASE_METHOD (ContactBox,
+                  __FILE__"_ForwardDynamicsContactsPGSSeparating", "") {
+  model->gravity = Vector3d (0., 9.81, 0.);
+  constraint_set.Bind (*model);
+
+  VectorNd QDDot_free = VectorNd::Zero (model->qdot_size);
+  ForwardDynamics (*model, Q, QDot, Tau, QDDot_free);
+
+  ForwardDynamicsContactsPGS (*model, Q, QDot, Tau, constraint_set, QDDot);
+
+  CHECK_THAT (VectorNd::Zero (constraint_set.size()),
+              AllCloseVector(constraint_set.force, TEST_PREC, TEST_PREC));
+  CHECK_THAT (QDDot_free, AllCloseVector(QDDot, TEST_PREC, TEST_PREC));
+}
+
+TEST_CASE_METHOD (ContactBox,
+                  __FILE__"_ForwardDynamicsContactsPGSFriction", "") {
+  // gravity of an inclined plane with slope tan (0.3) = 0.309
+  double angle = 0.3;
+  model->gravity = Vector3d (9.81 * sin(angle), -9.81 * cos(angle), 0.);
+  constraint_set.Bind (*model);
+
+  SetFrictionCoefficient (0.5);
+  ForwardDynamicsContactsPGS (*model, Q, QDot, Tau, constraint_set, QDDot);
+
+  CHECK (constraint_set.pgs_iterations < constraint_set.pgs_max_iterations);
+  CHECK_THAT (VectorNd::Zero (model->qdot_size),
+              AllCloseVector(QDDot, 1.0e-8, 1.0e-8));
+
+  double mu = 0.1;
+  SetFrictionCoefficient (mu);
+  ForwardDynamicsContactsPGS (*model, Q, QDot, Tau, constraint_set, QDDot);
+
+  CHECK (constraint_set.pgs_iterations < constraint_set.pgs_max_iterations);
+  for (unsigned int i = 0; i < constraint_set.contactConstraints.size(); i++) {
+    unsigned int ci = constraint_set.contactConstraints[i]
+      ->getConstraintIndex();
+    CHECK_THAT (-mu * constraint_set.force[ci],
+                IsClose(constraint_set.force[ci + 1], 1.0e-8, 1.0e-8));
+  }
+
+  // the box slides down without rotating
+  CHECK_THAT (9.81 * (sin(angle) - mu * cos(angle)),
+              IsClose(QDDot[0], 1.0e-8, 1.0e-8));
+  CHECK_THAT (0., IsClose(QDDot[1], 1.0e-8, 1.0e-8));
+  CHECK_THAT (Vector3d::Zero(),
+              AllCloseVector(Vector3d (QDDot.segment<3>(3)), 1.0e-8, 1.0e-8));
+}
+
+TEST_CASE_METHOD (ContactBox,
+                  __FILE__"_ForwardDynamicsContactsPGSWarmStart", "") {
+  constraint_set.Bind (*model);
+
+  ForwardDynamicsContactsPGS (*model, Q, QDot, Tau, constraint_set, QDDot);
+  unsigned int cold_iterations = constraint_set.pgs_iterations;
+  VectorNd force = constraint_set.force;
+
+  ForwardDynamicsContactsPGS (*model, Q, QDot, Tau, constraint_set, QDDot);
+
+  CHECK (cold_iterations > 2);
+  CHECK (constraint_set.pgs_iterations <= 2);
+  CHECK_THAT (force,
+              AllCloseVector(constraint_set.force, 1.0e-8, 1.0e-8));
+
+  ConstraintSet loop_set;
+  loop_set.AddLoopConstraint (box_id, 0, SpatialTransform(),
+                              SpatialTransform(),
+                              SpatialVector (0., 0., 0., 1., 0., 0.));
+  CHECK_THROWS_AS (loop_set.setContactFrictionCoefficient (0, 1.),
+                   Errors::RBDLError);
+}
+
+// A free flyer with two legs whose feet touch the ground
+struct ContactBiped {
+  ContactBiped () {
+    ClearLogOutput();
+    model = new Model;
+    model->gravity = Vector3d (0., -9.81, 0.);
+
+    Joint free_flyer (
+        SpatialVector (0., 0., 0., 1., 0., 0.),
+        SpatialVector (0., 0., 0., 0., 1., 0.),
+        SpatialVector (0., 0., 0., 0., 0., 1.),
+        SpatialVector (0., 0., 1., 0., 0., 0.),
+        SpatialVector (0., 1., 0., 0., 0., 0.),
+        SpatialVector (1., 0., 0., 0., 0., 0.));
+    base_id = model->AddBody (0, SpatialTransform(), free_flyer,
+        Body (2., Vector3d (0., 0., 0.), Vector3d (0.1, 0.2, 0.3)));
+
+    Body leg (1., Vector3d (0., -0.25, 0.), Vector3d (0.05, 0.01, 0.05));
+    left_id = model->AddBody (base_id, Xtrans (Vector3d (0., 0., 0.2)),
+        Joint (JointTypeRevoluteZ), leg);
+    right_id = model->AddBody (base_id, Xtrans (Vector3d (0., 0., -0.2)),
+        Joint (JointTypeRevoluteZ), leg);
+
+    // the contact of the body with the higher id comes first
+    Vector3d foot (0., -0.5, 0.);
+    constraint_set.AddContactConstraint (right_id, foot,
+        Vector3d (0., 1., 0.));
+    constraint_set.AddContactConstraint (right_id, foot,
+        Vector3d (1., 0., 0.));
+    constraint_set.AddContactConstraint (left_id, foot,
+        Vector3d (0., 1., 0.));
+    constraint_set.AddContactConstraint (left_id, foot,
+        Vector3d (1., 0., 0.));
+
+    Q = VectorNd::Zero (model->q_size);
+    Q[1] = 0.5;
+    QDot = VectorNd::Zero (model->qdot_size);
+    QDDot = VectorNd::Zero (model->qdot_size);
+    Tau = VectorNd::Zero (model->qdot_size);
+  }
+  ~ContactBiped () {
+    delete model;
+  }
+
+  Model *model;
+  unsigned int base_id, left_id, right_id;
+  ConstraintSet constraint_set;
+
+  VectorNd Q;
+  VectorNd QDot;
+  VectorNd QDDot;
+  VectorNd Tau;
+};
+
+TEST_CASE_METHOD (ContactBiped,
+                  __FILE__"_ForwardDynamicsContactsKokkevisRepeated", "") {
+  for (unsigned int i = 0; i < Q.size(); i++) {
+    Q[i] += 0.1 * sin (static_cast<double>(i + 1));
+    QDot[i] = 0.5 * cos (static_cast<double>(2 * i));
+    Tau[i] = 0.3 * sin (static_cast<double>(3 * i) + 0.5);
+  }
+
+  ConstraintSet constraint_set_direct = constraint_set.Copy();
+  constraint_set_direct.Bind (*model);
+  constraint_set.Bind (*model);
+
+  VectorNd QDDot_direct = VectorNd::Zero (model->qdot_size);
+  ForwardDynamicsConstraintsDirect (*model, Q, QDot, Tau,
+                                    constraint_set_direct, QDDot_direct);
+
+  // the forces applied by a call must not affect the following ones
+  for (unsigned int i = 0; i < 3; i++) {
+    ForwardDynamicsContactsKokkevis (*model, Q, QDot, Tau, constraint_set,
+                                     QDDot);
+    CHECK_THAT (QDDot_direct, AllCloseVector(QDDot, 1.0e-10, 1.0e-10));
+  }
+}
+
+TEST_CASE_METHOD (ContactBiped,
+                  __FILE__"_ForwardDynamicsContactsPGSRepeated", "") {
+  constraint_set.Bind (*model);
+
+  ForwardDynamicsContactsPGS (*model, Q, QDot, Tau, constraint_set, QDDot);
+  VectorNd force = constraint_set.force;
+
+  // the symmetric pose is held by equal normal forces
+  CHECK (force[0] > 0.);
+  CHECK_THAT (force[0], IsClose(force[2], 1.0e-8, 1.0e-8));
+
+  for (unsigned int i = 0; i < 3; i++) {
+    ForwardDynamicsContactsPGS (*model, Q, QDot, Tau, constraint_set, QDDot);
+    CHECK_THAT (force, AllCloseVector(constraint_set.force, 1.0e-8, 1.0e-8));
+    CHECK_THAT (VectorNd::Zero (model->qdot_size),
+                AllCloseVector(QDDot, 1.0e-8, 1.0e-8));
+  }
+}
@@ -721,3 +721,28 @@ TEST_CASE(__FILE__"_CustomConstraintCorrectnessTest", "") {
     CHECK_THAT(a030[i],IsClose(a030c[i],TEST_PREC, TEST_PREC));
   }
 }
+
+TEST_CASE(__FILE__"_CustomConstraintKokkevis", "") {
+  DoublePerpendicularPendulumCustomConstraint dbcc;
+
+  // the custom constraints do not provide spatial test forces and their
+  // rows of G are used as generalized test forces instead
+  for (unsigned int i = 0; i < dbcc.q.rows(); i++) {
+    dbcc.q[i] = 0.4 * sin (static_cast<double>(i) + 0.3);
+    dbcc.qd[i] = 0.7 * cos (static_cast<double>(2 * i));
+    dbcc.tau[i] = 0.5 * sin (static_cast<double>(3 * i) + 1.);
+  }
+
+  VectorNd qddDirect (VectorNd::Zero (dbcc.model.dof_count));
+  VectorNd qddKokkevis (VectorNd::Zero (dbcc.model.dof_count));
+
+  ForwardDynamicsConstraintsDirect (dbcc.model, dbcc.q, dbcc.qd, dbcc.tau,
+                                    dbcc.cs, qddDirect);
+  VectorNd forceDirect = dbcc.cs.force;
+
+  ForwardDynamicsContactsKokkevis (dbcc.model, dbcc.q, dbcc.qd, dbcc.tau,
+                                   dbcc.cs, qddKokkevis);
+
+  CHECK_THAT (qddDirect, AllCloseVector (qddKokkevis, 1.0e-9, 1.0e-9));
+  CHECK_THAT (forceDirect, AllCloseVector (dbcc.cs.force, 1.0e-9, 1.0e-9));
+}
@@ -0,0 +1,164 @@
+#include <iostream>
+
+#include "rbdl/Logging.h"
+#include "rbdl/Model.h"
+#include "rbdl/Dynamics.h"
+
+#include "rbdl_tests.h"
+
+#include "Fixtures.h"
+#include "Human36Fixture.h"
+
+using namespace std;
+using namespace RigidBodyDynamics;
+using namespace RigidBodyDynamics::Math;
+
+const double DIFF_STEP = 1.0e-6;
+const double TEST_PREC = 1.0e-6;
+
+void CalcInverseDynamicsFiniteDifferences (Model &model,
+    const VectorNd &q, const VectorNd &qdot, const VectorNd &qddot,
+    MatrixNd &dtau_dq, MatrixNd &dtau_dqdot) {
+  VectorNd tau_plus (model.qdot_size), tau_minus (model.qdot_size);
+  dtau_dq.resize (model.qdot_size, model.qdot_size);
+  dtau_dqdot.resize (model.qdot_size, model.qdot_size);
+
+  for (unsigned int k = 0; k < model.qdot_size; k++) {
+    VectorNd h (VectorNd::Zero (model.qdot_size));
+    h[k] = DIFF_STEP;
+
+    InverseDynamics (model, q + h, qdot, qddot, tau_plus);
+    InverseDynamics (model, q - h, qdot, qddot, tau_minus);
+    dtau_dq.col(k) = (tau_plus - tau_minus) / (2. * DIFF_STEP);
+
+    InverseDynamics (model, q, qdot + h, qddot, tau_plus);
+    InverseDynamics (model, q, qdot - h, qddot, tau_minus);
+    dtau_dqdot.col(k) = (tau_plus - tau_minus) / (2. * DIFF_STEP);
+  }
+}
+
+void CalcForwardDynamicsFiniteDifferences (Model &model,
+    const VectorNd &q, const VectorNd &qdot, const VectorNd &tau,
+    MatrixNd &dqddot_dq, MatrixNd &dqddot_dqdot, MatrixNd &dqddot_dtau) {
+  VectorNd qddot_plus (model.qdot_size), qddot_minus (model.qdot_size);
+  dqddot_dq.resize (model.qdot_size, model.qdot_size);
+  dqddot_dqdot.resize (model.qdot_size, model.qdot_size);
+  dqddot_dtau.resize (model.qdot_size, model.qdot_size);
+
+  for (unsigned int k = 0; k < model.qdot_size; k++) {
+    VectorNd h (VectorNd::Zero (model.qdot_size));
+    h[k] = DIFF_STEP;
+
+    ForwardDynamics (model, q + h, qdot, tau, qddot_plus);
+    ForwardDynamics (model, q - h, qdot, tau, qddot_minus);
+    dqddot_dq.col(k) = (qddot_plus - qddot_minus) / (2. * DIFF_STEP);
+
+    ForwardDynamics (model, q, qdot + h, tau, qddot_plus);
+    ForwardDynamics (model, q, qdot - h, tau, qddot_minus);
+    dqddot_dqdot.col(k) = (qddot_plus - qddot_minus) / (2. * DIFF_STEP);
+
+    ForwardDynamics (model, q, qdot, tau + h, qddot_plus);
+    ForwardDynamics (model, q, qdot, tau - h, qddot_minus);
+    dqddot_dtau.col(k) = (qddot_plus - qddot_minus) / (2. * DIFF_STEP);
+  }
+}
+
+void CheckDynamicsDerivatives (Model &model, const VectorNd &q,
+    const VectorNd &qdot, const VectorNd &u, double prec = TEST_PREC) {
+  VectorNd tau (model.qdot_size), tau_id (model.qdot_size);
+  VectorNd qddot (model.qdot_size), qddot_fd (model.qdot_size);
+  MatrixNd dtau_dq, dtau_dqdot, dtau_dq_fd, dtau_dqdot_fd;
+  MatrixNd dqddot_dq, dqddot_dqdot, dqddot_dtau;
+  MatrixNd dqddot_dq_fd, dqddot_dqdot_fd, dqddot_dtau_fd;
+
+  // u is used as acceleration for the inverse dynamics
+  InverseDynamicsDerivatives (model, q, qdot, u, tau, dtau_dq, dtau_dqdot);
+  InverseDynamics (model, q, qdot, u, tau_id);
+  CalcInverseDynamicsFiniteDifferences (model, q, qdot, u, dtau_dq_fd,
+      dtau_dqdot_fd);
+
+  CHECK_THAT (tau_id, AllCloseVector(tau, 1.0e-12, 1.0e-12));
+  CHECK_THAT (dtau_dq_fd, AllCloseMatrix(dtau_dq, prec, prec));
+  CHECK_THAT (dtau_dqdot_fd, AllCloseMatrix(dtau_dqdot, prec, prec));
+
+  // and as actuation for the forward dynamics
+  ForwardDynamicsDerivatives (model, q, qdot, u, qddot, dqddot_dq,
+      dqddot_dqdot, dqddot_dtau);
+  ForwardDynamics (model, q, qdot, u, qddot_fd);
+  CalcForwardDynamicsFiniteDifferences (model, q, qdot, u, dqddot_dq_fd,
+      dqddot_dqdot_fd, dqddot_dtau_fd);
+
+  MatrixNd H (MatrixNd::Zero (model.qdot_size, model.qdot_size));
+  MatrixNd identity (MatrixNd::Identity (model.qdot_size, model.qdot_size));
+  CompositeRigidBodyAlgorithm (model, q, H);
+
+  CHECK_THAT (qddot_fd, AllCloseVector(qddot, 1.0e-12, 1.0e-12));
+  CHECK_THAT (dqddot_dq_fd, AllCloseMatrix(dqddot_dq, prec, prec));
+  CHECK_THAT (dqddot_dqdot_fd,
+      AllCloseMatrix(dqddot_dqdot, prec, prec));
+  CHECK_THAT (dqddot_dtau_fd, AllCloseMatrix(dqddot_dtau, prec, prec));
+  CHECK_THAT (MatrixNd (H * dqddot_dtau),
+      AllCloseMatrix(identity, 1.0e-10, 1.0e-10));
+
+  // a workspace that is reused for repeated calls gives the same results
+  ModelData data (model);
+  ForwardDynamicsDerivativesWorkspace workspace (model);
+  MatrixNd dqddot_dq_ws, dqddot_dqdot_ws, dqddot_dtau_ws;
+  for (unsigned int i = 0; i < 2; i++) {
+    ForwardDynamicsDerivatives (model, data, q, qdot, u, qddot_fd,
+        dqddot_dq_ws, dqddot_dqdot_ws, dqddot_dtau_ws, workspace);
+  }
+
+  CHECK_THAT (dqddot_dq_ws, AllCloseMatrix(dqddot_dq, 0., 0.));
+  CHECK_THAT (dqddot_dqdot_ws, AllCloseMatrix(dqddot_dqdot, 0., 0.));
+  CHECK_THAT (dqddot_dtau_ws, AllCloseMatrix(dqddot_dtau, 0., 0.));
+}
+
+TEST_CASE_METHOD (FixedBase3DoF, __FILE__"_DynamicsDerivativesFixedBase", "") {
+  Q << 0.3, -0.4, 1.1;
+  QDot << 1.2, -0.7, 0.5;
+  Tau << 0.5, 1.3, -2.2;
+
+  CheckDynamicsDerivatives (*model, Q, QDot, Tau);
+}
+
+TEST_CASE (__FILE__"_DynamicsDerivativesPrismaticAndGeneralAxes", "") {
+  Model model;
+  model.gravity = Vector3d (0.1, -9.81, 0.3);
+
+  Body body (1.3, Vector3d (0.1, 0.5, -0.2), Vector3d (1.1, 0.9, 1.4));
+
+  unsigned int body_id = model.AddBody (0, Xtrans (Vector3d (0.1, 0., 0.)),
+      Joint (JointTypeRevolute, Vector3d (1., 1., 0.).normalized()), body);
+  unsigned int branch_id = model.AddBody (body_id,
+      Xrotz (0.3) * Xtrans (Vector3d (0., 0.7, 0.)),
+      Joint (JointTypePrismatic, Vector3d (0., 0.6, 0.8)), body);
+  model.AddBody (branch_id, Xtrans (Vector3d (0.3, 0.7, 0.)),
+      Joint (JointTypeRevoluteX), body);
+  model.AddBody (body_id, Xtrans (Vector3d (0., 0., 0.5)),
+      Joint (SpatialVector (0., 0., 1., 0., 0., 0.),
+        SpatialVector (0., 1., 0., 0., 0., 0.)), body);
+
+  VectorNd q (model.q_size), qdot (model.qdot_size), u (model.qdot_size);
+  q << 0.4, -0.3, 1.2, 0.7, -0.2;
+  qdot << -1.1, 0.5, 2.3, 0.4, -0.9;
+  u << 0.3, 2.1, -0.8, 1.5, -0.4;
+
+  CheckDynamicsDerivatives (model, q, qdot, u);
+}
+
+TEST_CASE_METHOD (Human36, __FILE__"_DynamicsDerivativesHuman36", "") {
+  setDeterministicStates();
+
+  // the accelerations of the model are large which limits the accuracy of
+  // the finite differences
+  CheckDynamicsDerivatives (*model_emulated, q, qdot, tau, 1.0e-4);
+}
+
+TEST_CASE_METHOD (Human36, __FILE__"_DynamicsDerivativesUnsupportedJoints",
+    "") {
+  MatrixNd dtau_dq, dtau_dqdot;
+
+  CHECK_THROWS_AS (InverseDynamicsDerivatives (*model_3dof, q, qdot, qddot,
+        tau, dtau_dq, dtau_dqdot), Errors::RBDLError);
+}
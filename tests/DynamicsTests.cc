@@ -11,6 +11,7 @@
 #include "rbdl_tests.h"
 
 #include "Fixtures.h"
+#include "Human36Fixture.h"
 
 using namespace std;
 using namespace RigidBodyDynamics;
@@ -797,3 +798,344 @@ TEST_CASE_METHOD ( FixedBase3DoF,
               AllCloseVector(qddot_minv, TEST_PREC, TEST_PREC)
   );
 }
+
+TEST_CASE_METHOD ( FloatingBase12DoF,
+                   __FILE__"_TestModelDataMatchesModel", "") {
+  for (unsigned int i = 0; i < model->dof_count; i++) {
+    Q[i] = static_cast<double>(i + 1) * 0.1;
+    QDot[i] = static_cast<double>(i + 1) * 1.1;
+    QDDot[i] = static_cast<double>(i + 1) * 0.3;
+    Tau[i] = static_cast<double>(i + 1) * -1.2;
+  }
+
+  const Model &const_model = *model;
+  ModelData data (*model);
+
+  VectorNd QDDot_model (VectorNd::Zero (model->dof_count));
+  VectorNd QDDot_data (VectorNd::Zero (model->dof_count));
+  ForwardDynamics (*model, Q, QDot, Tau, QDDot_model);
+  ForwardDynamics (const_model, data, Q, QDot, Tau, QDDot_data);
+  CHECK_THAT (QDDot_model, AllCloseVector(QDDot_data, 0., 0.));
+
+  VectorNd Tau_model (VectorNd::Zero (model->dof_count));
+  VectorNd Tau_data (VectorNd::Zero (model->dof_count));
+  InverseDynamics (*model, Q, QDot, QDDot, Tau_model);
+  InverseDynamics (const_model, data, Q, QDot, QDDot, Tau_data);
+  CHECK_THAT (Tau_model, AllCloseVector(Tau_data, 0., 0.));
+
+  NonlinearEffects (*model, Q, QDot, Tau_model);
+  NonlinearEffects (const_model, data, Q, QDot, Tau_data);
+  CHECK_THAT (Tau_model, AllCloseVector(Tau_data, 0., 0.));
+
+  MatrixNd H_model (MatrixNd::Zero (model->dof_count, model->dof_count));
+  MatrixNd H_data (MatrixNd::Zero (model->dof_count, model->dof_count));
+  CompositeRigidBodyAlgorithm (*model, Q, H_model);
+  CompositeRigidBodyAlgorithm (const_model, data, Q, H_data);
+  CHECK_THAT (H_model, AllCloseMatrix(H_data, 0., 0.));
+
+  CalcMInvTimesTau (*model, Q, Tau, QDDot_model);
+  CalcMInvTimesTau (const_model, data, Q, Tau, QDDot_data);
+  CHECK_THAT (QDDot_model, AllCloseVector(QDDot_data, 0., 0.));
+}
+
+TEST_CASE_METHOD ( FloatingBase12DoF,
+                   __FILE__"_TestModelDataLeavesModelUntouched", "") {
+  for (unsigned int i = 0; i < model->dof_count; i++) {
+    Q[i] = static_cast<double>(i + 1) * 0.1;
+    QDot[i] = static_cast<double>(i + 1) * 1.1;
+    Tau[i] = static_cast<double>(i + 1) * -1.2;
+  }
+
+  ModelData data (*model);
+  ForwardDynamics (*model, data, Q, QDot, Tau, QDDot);
+
+  for (unsigned int i = 1; i < model->mBodies.size(); i++) {
+    CHECK_THAT (model->v[i],
+                AllCloseVector(SpatialVector (SpatialVector::Zero()), 0., 0.));
+    CHECK_THAT (data.v[i],
+                !AllCloseVector(SpatialVector (SpatialVector::Zero()), 0., 0.));
+  }
+}
+
+void CheckForwardDynamicsBatch (Model &model, unsigned int sample_count) {
+  MatrixNd Q_batch (model.q_size, sample_count);
+  MatrixNd QDot_batch (model.qdot_size, sample_count);
+  MatrixNd Tau_batch (model.qdot_size, sample_count);
+  MatrixNd QDDot_batch;
+
+  for (unsigned int j = 0; j < sample_count; j++) {
+    for (unsigned int i = 0; i < model.q_size; i++) {
+      Q_batch(i,j) = static_cast<double>(i + j + 1) * 0.1;
+    }
+    for (unsigned int i = 0; i < model.qdot_size; i++) {
+      QDot_batch(i,j) = static_cast<double>(i + 1) * 1.1 - j;
+      Tau_batch(i,j) = static_cast<double>(i + 1) * -1.2 + 0.3 * j;
+    }
+  }
+
+  ForwardDynamicsBatch (model, Q_batch, QDot_batch, Tau_batch, QDDot_batch);
+
+  REQUIRE (QDDot_batch.rows() == model.qdot_size);
+  REQUIRE (QDDot_batch.cols() == sample_count);
+
+  VectorNd Q (model.q_size);
+  VectorNd QDot (model.qdot_size);
+  VectorNd Tau (model.qdot_size);
+  VectorNd QDDot (model.qdot_size);
+
+  for (unsigned int j = 0; j < sample_count; j++) {
+    Q = Q_batch.col(j);
+    QDot = QDot_batch.col(j);
+    Tau = Tau_batch.col(j);
+    ForwardDynamics (model, Q, QDot, Tau, QDDot);
+
+    VectorNd QDDot_column = QDDot_batch.col(j);
+    CHECK_THAT (QDDot, AllCloseVector(QDDot_column, 1.0e-10, 1.0e-10));
+  }
+
+  // repeated evaluations with a workspace reuse its lane buffers
+  ModelData data (model);
+  MatrixNd QDDot_data;
+  ForwardDynamicsBatch (model, data, Q_batch, QDot_batch, Tau_batch,
+      QDDot_data);
+  const BatchBody *batch_bodies = data.batch_bodies.data();
+  ForwardDynamicsBatch (model, data, Q_batch, QDot_batch, Tau_batch,
+      QDDot_data);
+  CHECK (data.batch_bodies.data() == batch_bodies);
+  CHECK_THAT (QDDot_data, AllCloseMatrix(QDDot_batch, 0., 0.));
+
+  MatrixNd Tau_invalid (model.qdot_size, sample_count - 1);
+  CHECK_THROWS_AS (ForwardDynamicsBatch (model, Q_batch, QDot_batch,
+        Tau_invalid, QDDot_batch), Errors::RBDLSizeMismatchError);
+}
+
+TEST_CASE_METHOD ( FloatingBase12DoF,
+                   __FILE__"_TestForwardDynamicsBatch", "") {
+  // fewer samples than evaluated together by the batched recursion
+  CheckForwardDynamicsBatch (*model, 5);
+}
+
+TEST_CASE_METHOD ( TwoArms12DoF,
+                   __FILE__"_TestForwardDynamicsBatchBranched", "") {
+  // several full groups of samples and a partial one
+  CheckForwardDynamicsBatch (*model, 19);
+}
+
+TEST_CASE_METHOD ( FixedBase6DoF12DoFFloatingBase,
+                   __FILE__"_TestForwardDynamicsBatchMultiDofJoints", "") {
+  // the floating base joint is evaluated sample by sample
+  CheckForwardDynamicsBatch (*model, 3);
+}
+
+TEST_CASE (__FILE__"_TestForwardDynamicsBatchJointTypes", "") {
+  Model model;
+  model.gravity = Vector3d (0., 0., -9.81);
+
+  Body body (1.3, Vector3d (0.1, 0.2, -0.3), Vector3d (0.2, 0.3, 0.4));
+  SpatialVector oblique_axis (Vector3d (1., 2., -1.).normalized()[0],
+      Vector3d (1., 2., -1.).normalized()[1],
+      Vector3d (1., 2., -1.).normalized()[2], 0., 0., 0.);
+
+  unsigned int slider = model.AddBody (0, Xrotz (0.3),
+      Joint (SpatialVector (0., 0., 0., 0.6, 0., 0.8)), body);
+  unsigned int arm = model.AddBody (slider, Xrotx (0.4) * Xtrans (
+        Vector3d (0.2, 0., 0.1)), Joint (JointTypeRevoluteX), body);
+  model.AddBody (arm, Xroty (-0.2) * Xtrans (Vector3d (0., 0.5, 0.)),
+      Joint (JointTypeRevoluteY), body);
+  model.AddBody (arm, Xtrans (Vector3d (0., -0.5, 0.)),
+      Joint (oblique_axis), body);
+  model.AddBody (slider, Xrotz (1.1), Joint (JointTypeRevoluteZ), body);
+
+  CheckForwardDynamicsBatch (model, 11);
+}
+
+void CheckMassMatrixFactorization (Model &model, const VectorNd &q) {
+  unsigned int n = model.qdot_size;
+
+  MatrixNd M (MatrixNd::Zero (n, n));
+  CompositeRigidBodyAlgorithm (model, q, M);
+
+  MatrixNd tau_columns (n, 5);
+  for (unsigned int j = 0; j < tau_columns.cols(); j++) {
+    for (unsigned int i = 0; i < n; i++) {
+      tau_columns(i,j) = cos (static_cast<double>(i * (j + 1)) + 0.3);
+    }
+  }
+  MatrixNd qddot_llt = M.llt().solve (tau_columns);
+
+  ModelData data (model);
+  MassMatrixFactorization factorization;
+  FactorizeMassMatrix (model, data, q, factorization);
+
+  MatrixNd qddot_columns;
+  CalcMInvTimesTau (model, factorization, tau_columns, qddot_columns);
+  CHECK_THAT (qddot_llt, AllCloseMatrix(qddot_columns, 1.0e-10, 1.0e-10));
+
+  // the factorization does not depend on the state stored in data
+  VectorNd q_other (VectorNd::Constant (model.q_size, 0.2));
+  VectorNd qdot_other (VectorNd::Constant (n, -0.3));
+  VectorNd qddot_other (VectorNd::Zero (n));
+  MassMatrixFactorization factorization_other;
+  FactorizeMassMatrix (model, data, q_other, factorization_other);
+  ForwardDynamics (model, data, q_other, qdot_other, qdot_other,
+                   qddot_other);
+
+  VectorNd tau (tau_columns.col(2));
+  VectorNd qddot (VectorNd::Zero (n));
+  CalcMInvTimesTau (model, factorization, tau, qddot);
+  VectorNd qddot_expected (qddot_llt.col(2));
+  CHECK_THAT (qddot_expected, AllCloseVector(qddot, 1.0e-10, 1.0e-10));
+
+  MatrixNd tau_invalid (n + 1, 2);
+  CHECK_THROWS_AS (CalcMInvTimesTau (model, factorization, tau_invalid,
+                   qddot_columns), Errors::RBDLDofMismatchError);
+}
+
+TEST_CASE_METHOD (Human36, __FILE__"_MassMatrixFactorization", "") {
+  setDeterministicStates();
+
+  CheckMassMatrixFactorization (*model_emulated, q);
+  CheckMassMatrixFactorization (*model_3dof, q);
+}
+
+void CheckForwardDynamicsLagrangianSparseLTL (Model &model, const VectorNd &q,
+    const VectorNd &qdot, const VectorNd &tau) {
+  unsigned int n = model.qdot_size;
+
+  MatrixNd H (MatrixNd::Zero (n, n));
+  CompositeRigidBodyAlgorithm (model, q, H);
+
+  MatrixNd H_lower (MatrixNd::Zero (n, n));
+  H_lower.triangularView<Eigen::StrictlyUpper>().setConstant (123.);
+  CompositeRigidBodyAlgorithm (model, q, H_lower, true, true);
+
+  MatrixNd H_lower_expected (H.triangularView<Eigen::Lower>());
+  MatrixNd H_lower_result (H_lower.triangularView<Eigen::Lower>());
+  CHECK_THAT (H_lower_expected,
+      AllCloseMatrix(H_lower_result, TEST_PREC, TEST_PREC));
+  // the upper triangle is not touched
+  CHECK (H_lower (0, n - 1) == 123.);
+
+  VectorNd qddot_aba (VectorNd::Zero (n));
+  ForwardDynamics (model, q, qdot, tau, qddot_aba);
+
+  VectorNd qddot_ltl (VectorNd::Zero (n));
+  MatrixNd L (MatrixNd::Zero (n, n));
+  ForwardDynamicsLagrangian (model, q, qdot, tau, qddot_ltl,
+      LinearSolverSparseLTL, NULL, &L);
+
+  CHECK_THAT (qddot_aba, AllCloseVector(qddot_ltl, 1.0e-10, 1.0e-10));
+
+  MatrixNd LTL (L.transpose() * L);
+  CHECK_THAT (H, AllCloseMatrix(LTL, 1.0e-10, 1.0e-10));
+}
+
+TEST_CASE_METHOD (Human36, __FILE__"_ForwardDynamicsLagrangianSparseLTL",
+    "") {
+  setDeterministicStates();
+
+  CheckForwardDynamicsLagrangianSparseLTL (*model_emulated, q, qdot, tau);
+  CheckForwardDynamicsLagrangianSparseLTL (*model_3dof, q, qdot, tau);
+}
+
+void CheckOperationalSpaceInertia (Model &model, const VectorNd &q,
+    const std::vector<unsigned int> &body_ids,
+    const std::vector<Vector3d> &body_points, bool full_rank = true) {
+  unsigned int n = model.qdot_size;
+  unsigned int m = body_ids.size();
+
+  MatrixNd H (MatrixNd::Zero (n, n));
+  CompositeRigidBodyAlgorithm (model, q, H);
+
+  MatrixNd G (MatrixNd::Zero (3 * m, n));
+  for (unsigned int k = 0; k < m; k++) {
+    MatrixNd G_point (MatrixNd::Zero (3, n));
+    CalcPointJacobian (model, q, body_ids[k], body_points[k], G_point);
+    G.block(3 * k, 0, 3, n) = G_point;
+  }
+
+  MatrixNd LambdaInv_ref (G * H.llt().solve (G.transpose()));
+
+  MatrixNd LambdaInv;
+  CalcOperationalSpaceInertiaInverse (model, q, body_ids, body_points,
+      LambdaInv);
+  CHECK_THAT (LambdaInv_ref,
+      AllCloseMatrix(LambdaInv, 1.0e-10, 1.0e-10));
+
+  ModelData data (model);
+  MatrixNd LambdaInv_data;
+  CalcOperationalSpaceInertiaInverse (model, data, q, body_ids, body_points,
+      LambdaInv_data);
+  CHECK_THAT (LambdaInv_ref,
+      AllCloseMatrix(LambdaInv_data, 1.0e-10, 1.0e-10));
+
+  if (!full_rank) {
+    return;
+  }
+
+  MatrixNd Lambda;
+  CalcOperationalSpaceInertia (model, q, body_ids, body_points, Lambda);
+  MatrixNd identity (MatrixNd::Identity (3 * m, 3 * m));
+  MatrixNd product (Lambda * LambdaInv_ref);
+  CHECK_THAT (identity, AllCloseMatrix(product, 1.0e-8, 1.0e-8));
+}
+
+TEST_CASE_METHOD (Human36, __FILE__"_OperationalSpaceInertia", "") {
+  setDeterministicStates();
+
+  std::vector<Vector3d> body_points;
+  body_points.push_back (Vector3d (0.1, 0., -0.05));
+  body_points.push_back (Vector3d (-0.05, 0.02, -0.1));
+  body_points.push_back (Vector3d (0.1, 0.05, 0.));
+  body_points.push_back (Vector3d (0., -0.1, 0.2));
+  body_points.push_back (Vector3d (0.05, 0.05, 0.05));
+
+  BodyName bodies[5] = { BodyHandLeft, BodyHandRight, BodyFootLeft,
+    BodyFootRight, BodyHead };
+
+  std::vector<unsigned int> body_ids_emulated;
+  std::vector<unsigned int> body_ids_3dof;
+  for (unsigned int k = 0; k < 5; k++) {
+    body_ids_emulated.push_back (body_id_emulated[bodies[k]]);
+    body_ids_3dof.push_back (body_id_3dof[bodies[k]]);
+  }
+
+  CheckOperationalSpaceInertia (*model_emulated, q, body_ids_emulated,
+      body_points);
+  CheckOperationalSpaceInertia (*model_3dof, q, body_ids_3dof,
+      body_points);
+}
+
+TEST_CASE_METHOD (Human36, __FILE__"_OperationalSpaceInertiaReuseABA", "") {
+  setDeterministicStates();
+
+  std::vector<unsigned int> body_ids (2, body_id_3dof[BodyHandLeft]);
+  body_ids[1] = body_id_3dof[BodyFootRight];
+  std::vector<Vector3d> body_points (2, Vector3d (0.1, 0., -0.05));
+
+  MatrixNd LambdaInv_ref;
+  CalcOperationalSpaceInertiaInverse (*model_3dof, q, body_ids, body_points,
+      LambdaInv_ref);
+
+  // the articulated body inertias of ForwardDynamics() are reused
+  ForwardDynamics (*model_3dof, q, qdot, tau, qddot);
+  MatrixNd LambdaInv;
+  CalcOperationalSpaceInertiaInverse (*model_3dof, q, body_ids, body_points,
+      LambdaInv, false);
+
+  CHECK_THAT (LambdaInv_ref, AllCloseMatrix(LambdaInv, 1.0e-10, 1.0e-10));
+}
+
+TEST_CASE_METHOD (FixedAndMovableJoint,
+    __FILE__"_OperationalSpaceInertiaFixedBody", "") {
+  Q_fixed[0] = 0.3;
+  Q_fixed[1] = -0.7;
+
+  std::vector<unsigned int> body_ids (2, body_b_fixed_id);
+  body_ids[1] = body_c_fixed_id;
+  std::vector<Vector3d> body_points (2, Vector3d (0.2, 0.4, -0.1));
+
+  // two points on a model with two degrees of freedom
+  CheckOperationalSpaceInertia (*model_fixed, Q_fixed, body_ids,
+      body_points, false);
+}
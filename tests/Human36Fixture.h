@@ -441,6 +441,18 @@ struct Human36 {
     qddot_3dof = qddot;
   }
 
+  /// Sets a fixed, non-trivial state such that failures are reproducible
+  void setDeterministicStates () {
+    for (int i = 0; i < q.size(); i++) {
+      q[i] = 0.4 * M_PI * cos (static_cast<double>(i));
+      qdot[i] = 0.5 * M_PI * sin (static_cast<double>(i));
+      qddot[i] = 0.3 * M_PI * cos (static_cast<double>(i) + 0.5);
+      tau[i] = 0.7 * cos (static_cast<double>(i) + 1.5);
+    }
+    qddot_emulated = qddot;
+    qddot_3dof = qddot;
+  }
+
   Human36 () {
     ClearLogOutput();
     using namespace RigidBodyDynamics;
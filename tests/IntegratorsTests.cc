@@ -0,0 +1,245 @@
+#include <iostream>
+#include <cmath>
+
+#include "rbdl/rbdl.h"
+
+#include "rbdl_tests.h"
+
+#include "Fixtures.h"
+
+using namespace std;
+using namespace RigidBodyDynamics;
+using namespace RigidBodyDynamics::Math;
+
+const double TEST_PREC = 1.0e-12;
+
+struct SphericalBody {
+  SphericalBody() {
+    model.gravity = Vector3d::Zero();
+
+    body = Body (1.,
+        Vector3d (0., 0., 0.),
+        Vector3d (1., 2., 3.));
+    body_id = model.AddBody (0, Xtrans (Vector3d (0., 0., 0.)),
+        Joint (JointTypeSpherical), body);
+
+    q = VectorNd::Zero (model.q_size);
+    qdot = VectorNd::Zero (model.qdot_size);
+    tau = VectorNd::Zero (model.qdot_size);
+
+    model.SetQuaternion (body_id,
+        Quaternion::fromZYXAngles (Vector3d (0.3, -0.2, 0.9)), q);
+    qdot[0] = 0.4;
+    qdot[1] = -1.2;
+    qdot[2] = 0.7;
+  }
+
+  Model model;
+  Body body;
+  unsigned int body_id;
+
+  VectorNd q;
+  VectorNd qdot;
+  VectorNd tau;
+};
+
+TEST_CASE_METHOD (SphericalBody, __FILE__"_IntegrateQSphericalJoint", "") {
+  VectorNd q_next (VectorNd::Zero (model.q_size));
+
+  // zero angular velocity does not change the orientation
+  IntegrateQ (model, q, VectorNd::Zero (model.qdot_size), 0.1, q_next);
+  CHECK_THAT (q, AllCloseVector (q_next, TEST_PREC, TEST_PREC));
+
+  IntegrateQ (model, q, qdot, 0.1, q_next);
+  CHECK (fabs (model.GetQuaternion (body_id, q_next).norm() - 1.)
+      < TEST_PREC);
+
+  // the change of a body point has to match its velocity
+  double dt = 1.0e-7;
+  Vector3d point (0.3, -0.5, 0.2);
+  IntegrateQ (model, q, qdot, dt, q_next);
+
+  Vector3d point_velocity = CalcPointVelocity (model, q, qdot, body_id,
+      point);
+  Vector3d point_difference = (
+      CalcBodyToBaseCoordinates (model, q_next, body_id, point)
+      - CalcBodyToBaseCoordinates (model, q, body_id, point)) / dt;
+
+  CHECK_THAT (point_velocity,
+      AllCloseVector (point_difference, 1.0e-6, 1.0e-6));
+}
+
+TEST_CASE_METHOD (SphericalBody, __FILE__"_IntegratorSphericalEnergy", "") {
+  Integrator integrator (model, IntegratorRungeKutta4);
+
+  double energy_start = Utils::CalcKineticEnergy (model, q, qdot);
+
+  for (unsigned int i = 0; i < 1000; i++) {
+    integrator.Step (model, q, qdot, tau, 1.0e-3);
+  }
+
+  double energy_end = Utils::CalcKineticEnergy (model, q, qdot);
+
+  CHECK (fabs (energy_end - energy_start) < 1.0e-8 * energy_start);
+  CHECK (fabs (model.GetQuaternion (body_id, q).norm() - 1.) < TEST_PREC);
+}
+
+void IntegratePendulum (Model &model, IntegratorMethod method, double dt,
+    unsigned int step_count, VectorNd &Q, VectorNd &QDot) {
+  Integrator integrator (model, method);
+  VectorNd Tau (VectorNd::Zero (model.qdot_size));
+
+  Q = VectorNd::Zero (model.q_size);
+  QDot = VectorNd::Zero (model.qdot_size);
+  Q[0] = 0.3;
+  Q[1] = -0.2;
+  QDot[2] = 1.1;
+
+  for (unsigned int i = 0; i < step_count; i++) {
+    integrator.Step (model, Q, QDot, Tau, dt);
+  }
+}
+
+TEST_CASE_METHOD (FixedBase3DoF, __FILE__"_IntegratorConvergenceOrder", "") {
+  VectorNd Q_ref, QDot_ref, Q_coarse, QDot_coarse, Q_fine, QDot_fine;
+
+  IntegratePendulum (*model, IntegratorRungeKutta4, 2.5e-4, 2000, Q_ref,
+      QDot_ref);
+
+  // expected error ratio when the step size is halved
+  double min_ratio[IntegratorMethodLast];
+  min_ratio[IntegratorSemiImplicitEuler] = 1.8;
+  min_ratio[IntegratorStoermerVerlet] = 3.5;
+  min_ratio[IntegratorRungeKutta4] = 12.;
+
+  for (unsigned int m = 0; m < IntegratorMethodLast; m++) {
+    IntegratorMethod method = static_cast<IntegratorMethod>(m);
+
+    IntegratePendulum (*model, method, 1.0e-2, 50, Q_coarse, QDot_coarse);
+    IntegratePendulum (*model, method, 5.0e-3, 100, Q_fine, QDot_fine);
+
+    double error_coarse = (Q_coarse - Q_ref).norm()
+      + (QDot_coarse - QDot_ref).norm();
+    double error_fine = (Q_fine - Q_ref).norm()
+      + (QDot_fine - QDot_ref).norm();
+
+    INFO ("method " << m << " error ratio " << error_coarse / error_fine);
+    CHECK (error_coarse / error_fine > min_ratio[m]);
+  }
+}
+
+TEST_CASE_METHOD (FixedBase3DoF, __FILE__"_IntegratorStepWithModelData", "") {
+  ModelData data (*model);
+  Integrator integrator (*model, IntegratorStoermerVerlet);
+  VectorNd Tau (VectorNd::Constant (model->qdot_size, 0.2));
+
+  VectorNd Q_model (VectorNd::Constant (model->q_size, 0.1));
+  VectorNd QDot_model (VectorNd::Constant (model->qdot_size, -0.3));
+  VectorNd Q_data (Q_model);
+  VectorNd QDot_data (QDot_model);
+
+  for (unsigned int i = 0; i < 10; i++) {
+    integrator.Step (*model, Q_model, QDot_model, Tau, 1.0e-3);
+    integrator.Step (*model, data, Q_data, QDot_data, Tau, 1.0e-3);
+  }
+
+  CHECK_THAT (Q_model, AllCloseVector (Q_data, TEST_PREC, TEST_PREC));
+  CHECK_THAT (QDot_model, AllCloseVector (QDot_data, TEST_PREC, TEST_PREC));
+}
+
+TEST_CASE_METHOD (FixedBase3DoF, __FILE__"_IntegratorDimensionMismatch", "") {
+  Integrator integrator (*model);
+  VectorNd Q (VectorNd::Zero (model->q_size + 1));
+  VectorNd QDot (VectorNd::Zero (model->qdot_size));
+  VectorNd Tau (VectorNd::Zero (model->qdot_size));
+
+  CHECK_THROWS_AS (integrator.Step (*model, Q, QDot, Tau, 1.0e-3),
+      Errors::RBDLDofMismatchError);
+
+  Integrator unsized;
+  Q = VectorNd::Zero (model->q_size);
+  CHECK_THROWS_AS (unsized.Step (*model, Q, QDot, Tau, 1.0e-3),
+      Errors::RBDLSizeMismatchError);
+}
+
+TEST_CASE_METHOD (FixedBase3DoF, __FILE__"_BatchExecutorIntegrate", "") {
+  const unsigned int sample_count = 9;
+  const unsigned int step_count = 20;
+  const double dt = 1.0e-3;
+
+  MatrixNd Q (model->q_size, sample_count);
+  MatrixNd QDot (model->qdot_size, sample_count);
+  MatrixNd Tau (model->qdot_size, sample_count);
+
+  for (unsigned int j = 0; j < sample_count; j++) {
+    for (unsigned int i = 0; i < model->q_size; i++) {
+      Q(i,j) = 0.3 * sin (static_cast<double>(i + 2 * j));
+      QDot(i,j) = 0.7 * cos (static_cast<double>(3 * i + j));
+      Tau(i,j) = 1.1 * sin (static_cast<double>(i * j) + 0.5);
+    }
+  }
+
+  MatrixNd Q_batch (Q);
+  MatrixNd QDot_batch (QDot);
+
+  BatchExecutor executor (*model, 3);
+  executor.Integrate (IntegratorRungeKutta4, dt, step_count, Q_batch,
+      QDot_batch, Tau);
+
+  Integrator integrator (*model, IntegratorRungeKutta4);
+  for (unsigned int j = 0; j < sample_count; j++) {
+    VectorNd q_serial = Q.col(j);
+    VectorNd qdot_serial = QDot.col(j);
+    VectorNd tau_serial = Tau.col(j);
+
+    for (unsigned int i = 0; i < step_count; i++) {
+      integrator.Step (*model, q_serial, qdot_serial, tau_serial, dt);
+    }
+
+    VectorNd q_batch = Q_batch.col(j);
+    VectorNd qdot_batch = QDot_batch.col(j);
+    CHECK_THAT (q_serial, AllCloseVector (q_batch, TEST_PREC, TEST_PREC));
+    CHECK_THAT (qdot_serial,
+        AllCloseVector (qdot_batch, TEST_PREC, TEST_PREC));
+  }
+}
+
+TEST_CASE_METHOD (FixedBase3DoF, __FILE__"_IntegratorProjectionFailure", "") {
+  ConstraintSet cs;
+  // keeps the tip of body_a on the x-axis of the base
+  cs.AddLoopConstraint (0, body_a_id, Xtrans (Vector3d (1., 0., 0.)),
+      Xtrans (Vector3d (1., 0., 0.)), SpatialVector (0., 0., 0., 0., 1., 0.));
+  cs.Bind (*model);
+
+  VectorNd Q_start (VectorNd::Zero (model->q_size));
+  VectorNd QDot_start (VectorNd::Zero (model->qdot_size));
+  Q_start[0] = 0.3;
+  Q_start[1] = -0.2;
+  QDot_start[2] = 1.1;
+
+  // reference step without projection
+  Integrator unprojected (*model);
+  unprojected.project_constraints = false;
+  VectorNd Q_ref (Q_start);
+  VectorNd QDot_ref (QDot_start);
+  CHECK (unprojected.Step (*model, Q_ref, QDot_ref, Tau, 1.0e-3, &cs));
+
+  // a projection that cannot converge keeps the unprojected positions
+  Integrator integrator (*model);
+  integrator.projection_max_iterations = 0;
+  Q = Q_start;
+  QDot = QDot_start;
+  CHECK_FALSE (integrator.Step (*model, Q, QDot, Tau, 1.0e-3, &cs));
+  CHECK_THAT (Q, AllCloseVector (Q_ref, TEST_PREC, TEST_PREC));
+
+  integrator.projection_max_iterations = 100;
+  Q = Q_start;
+  QDot = QDot_start;
+  CHECK (integrator.Step (*model, Q, QDot, Tau, 1.0e-3, &cs));
+  // the projection does not change the setting of the constraint set
+  CHECK_FALSE (cs.assembly_warm_start);
+
+  VectorNd err (VectorNd::Zero (cs.size()));
+  CalcConstraintsPositionError (*model, Q, cs, err);
+  CHECK (err.norm() < 1.0e-10);
+}
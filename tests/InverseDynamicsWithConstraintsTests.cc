@@ -1157,3 +1157,63 @@ TEST_CASE(__FILE__"_CorrectnessTestWithUnderactuatedCartPendulum", ""){
 
 }
 
+
+TEST_CASE_METHOD(SpatialBipedFloatingBase,
+                 __FILE__"_TestActuationIndexLists", "") {
+  unsigned int n  = unsigned( int( q.rows()));
+
+  std::vector<bool> dofActuated(n, true);
+  for(unsigned int i=0; i<6; ++i){
+    dofActuated[i] = false;
+  }
+  cs.SetActuationMap(model, dofActuated);
+
+  REQUIRE(cs.actuated_dof_indices.size() == n - 6);
+  REQUIRE(cs.unactuated_dof_indices.size() == 6);
+  for(unsigned int i=0; i<cs.actuated_dof_indices.size(); ++i){
+    CHECK(cs.S(i, cs.actuated_dof_indices[i]) == 1.);
+  }
+  for(unsigned int i=0; i<cs.unactuated_dof_indices.size(); ++i){
+    CHECK(cs.P(i, cs.unactuated_dof_indices[i]) == 1.);
+  }
+
+  VectorNd q0(VectorNd::Zero(n));
+  VectorNd qd0(VectorNd::Zero(n));
+  VectorNd weights(VectorNd::Constant(n, 1.));
+  VectorNd qddTarget(VectorNd::Zero(n));
+
+  q0[2]  = 0.75;
+  q0[7]  =  M_PI*0.25;
+  q0[9]  = -M_PI*0.25;
+  q0[13] = -M_PI*0.25;
+  q0[15] =  M_PI*0.25;
+  REQUIRE(CalcAssemblyQ(model,q0,cs,q,weights));
+  for(unsigned int i=6; i<n; ++i){
+    qd0[i] = 0.1*double(i % 4) - 0.15;
+    qddTarget[i] = 0.2*double(i % 3) - 0.2;
+  }
+  CalcAssemblyQDot(model,q,qd0,cs,qd,weights);
+
+  VectorNd tauIDC(VectorNd::Zero(n));
+  VectorNd qddIDC(VectorNd::Zero(n));
+  InverseDynamicsConstraints(model,q,qd,qddTarget,cs,qddIDC,tauIDC);
+
+  // Reference: the projected KKT system formed with the selection matrices
+  MatrixNd S = cs.S;
+  MatrixNd P = cs.P;
+  MatrixNd H = cs.H;
+  MatrixNd G = cs.G;
+  VectorNd u = S*qddTarget;
+  VectorNd v = (G*P.transpose()).colPivHouseholderQr().solve(
+                 cs.gamma - G*S.transpose()*u);
+  VectorNd lambda = -(P*G.transpose()).colPivHouseholderQr().solve(
+                      -P*cs.C - P*H*S.transpose()*u - P*H*P.transpose()*v);
+  VectorNd qddRef = S.transpose()*u + P.transpose()*v;
+  VectorNd tauRef = S.transpose()*( S*cs.C + S*H*S.transpose()*u
+                                    + S*H*P.transpose()*v
+                                    - S*G.transpose()*lambda);
+
+  CHECK_THAT(qddRef, AllCloseVector(qddIDC, TEST_PREC, TEST_PREC));
+  CHECK_THAT(tauRef, AllCloseVector(tauIDC, TEST_PREC, TEST_PREC));
+  CHECK_THAT(lambda, AllCloseVector(cs.force, TEST_PREC, TEST_PREC));
+}
@@ -645,6 +645,53 @@ TEST_CASE_METHOD(KinematicsFixture6DoF,
   CHECK_THAT (target_pos[1], AllCloseVector(effector, 1.0e-1, 1.0e-1));
 }
 
+TEST_CASE_METHOD(KinematicsFixture6DoF,
+                 __FILE__"TestInverseKinematicWorkspace", "") {
+  std::vector<unsigned int> body_ids;
+  std::vector<Vector3d> body_points;
+  std::vector<Vector3d> target_pos;
+
+  Q[0] = 0.2;
+  Q[1] = 0.1;
+  Q[2] = 0.1;
+
+  body_ids.push_back (child_id);
+  body_points.push_back (Vector3d (1., 0., 0.));
+  target_pos.push_back (Vector3d (1.5, 0.4, 0.1));
+
+  body_ids.push_back (base_id);
+  body_points.push_back (Vector3d (0.6, 1.0, 0.));
+  target_pos.push_back (Vector3d (0.5, 1.1, 0.));
+
+  VectorNd Qres = VectorNd::Zero ((size_t) model->dof_count);
+  VectorNd Qres_workspace = VectorNd::Zero ((size_t) model->dof_count);
+
+  bool res = InverseKinematics (*model, Q, body_ids, body_points,
+                                target_pos, Qres, 1.0e-8, 0.1, 200);
+
+  ModelData data (*model);
+  InverseKinematicsWorkspace workspace (*model, body_ids.size());
+
+  // the results must not depend on previous uses of the workspace
+  for (int i = 0; i < 2; i++) {
+    bool res_workspace = InverseKinematics (*model, data, Q, body_ids,
+                                            body_points, target_pos,
+                                            Qres_workspace, workspace,
+                                            1.0e-8, 0.1, 200);
+
+    CHECK (res == res_workspace);
+    CHECK_THAT (Qres, AllCloseVector(Qres_workspace, TEST_PREC, TEST_PREC));
+  }
+
+  // a workspace of the wrong size gets resized
+  InverseKinematicsWorkspace small_workspace (*model, 1);
+  InverseKinematics (*model, data, Q, body_ids, body_points, target_pos,
+                     Qres_workspace, small_workspace, 1.0e-8, 0.1, 200);
+
+  CHECK (small_workspace.J.rows() == 6);
+  CHECK_THAT (Qres, AllCloseVector(Qres_workspace, TEST_PREC, TEST_PREC));
+}
+
 TEST_CASE ( __FILE__"_FixedJointBodyCalcBodyToBase", "" ) {
   // the standard modeling using a null body
   Body null_body;
@@ -918,3 +965,184 @@ TEST_CASE_METHOD ( Human36,
 
   CHECK_THAT (a_foot_0_ref, AllCloseVector(a_foot_0, TEST_PREC, TEST_PREC));
 }
+
+TEST_CASE_METHOD ( Human36,
+                   __FILE__"_ModelDataMatchesModel", "" ) {
+  setDeterministicStates();
+
+  const Model &const_model = *model_3dof;
+  ModelData data (*model_3dof);
+
+  unsigned int hand_r_id = model_3dof->GetBodyId ("hand_r");
+  unsigned int uppertrunk_id = model_3dof->GetBodyId ("uppertrunk");
+  Vector3d point_local (1.1, 2.2, 3.3);
+
+  for (unsigned int body_id : { hand_r_id, uppertrunk_id }) {
+    CHECK_THAT (
+        CalcBodyToBaseCoordinates (*model_3dof, q, body_id, point_local),
+        AllCloseVector(CalcBodyToBaseCoordinates (const_model, data, q, 
+            body_id, point_local), 0., 0.));
+
+    CHECK_THAT (
+        CalcBodyWorldOrientation (*model_3dof, q, body_id),
+        AllCloseMatrix(CalcBodyWorldOrientation (const_model, data, q, 
+            body_id), 0., 0.));
+
+    MatrixNd G_model (MatrixNd::Zero (6, model_3dof->qdot_size));
+    MatrixNd G_data (MatrixNd::Zero (6, model_3dof->qdot_size));
+    CalcPointJacobian6D (*model_3dof, q, body_id, point_local, G_model);
+    CalcPointJacobian6D (const_model, data, q, body_id, point_local, G_data);
+    CHECK_THAT (G_model, AllCloseMatrix(G_data, 0., 0.));
+
+    CHECK_THAT (
+        CalcPointVelocity6D (*model_3dof, q, qdot, body_id, point_local),
+        AllCloseVector(CalcPointVelocity6D (const_model, data, q, qdot,
+            body_id, point_local), 0., 0.));
+
+    CHECK_THAT (
+        CalcPointAcceleration6D (*model_3dof, q, qdot, qddot, body_id,
+          point_local),
+        AllCloseVector(CalcPointAcceleration6D (const_model, data, q, qdot,
+            qddot, body_id, point_local), 0., 0.));
+  }
+
+  VectorNd qddot_model (VectorNd::Zero (model_3dof->qdot_size));
+  VectorNd qddot_data (VectorNd::Zero (model_3dof->qdot_size));
+  ForwardDynamics (*model_3dof, q, qdot, tau, qddot_model);
+  ForwardDynamics (const_model, data, q, qdot, tau, qddot_data);
+  CHECK_THAT (qddot_model, AllCloseVector(qddot_data, 0., 0.));
+}
+
+void CheckPointJacobianSparse (Model &model, const VectorNd &q,
+                               const VectorNd &qdot, unsigned int body_id) {
+  Vector3d point_local (0.3, -0.2, 0.4);
+
+  MatrixNd G (MatrixNd::Zero (3, model.qdot_size));
+  MatrixNd G6D (MatrixNd::Zero (6, model.qdot_size));
+  CalcPointJacobian (model, q, body_id, point_local, G);
+  CalcPointJacobian6D (model, q, body_id, point_local, G6D, false);
+
+  ModelData data (model);
+  SparseJacobian G_sparse;
+  SparseJacobian G6D_sparse;
+  CalcPointJacobianSparse (model, data, q, body_id, point_local, G_sparse);
+  CalcPointJacobian6DSparse (model, data, q, body_id, point_local,
+                             G6D_sparse, false);
+
+  MatrixNd G_dense, G6D_dense;
+  G_sparse.toDense (G_dense);
+  G6D_sparse.toDense (G6D_dense);
+
+  CHECK_THAT (G, AllCloseMatrix(G_dense, TEST_PREC, TEST_PREC));
+  CHECK_THAT (G6D, AllCloseMatrix(G6D_dense, TEST_PREC, TEST_PREC));
+
+  for (unsigned int i = 1; i < G6D_sparse.column_index.size(); i++) {
+    CHECK (G6D_sparse.column_index[i - 1] < G6D_sparse.column_index[i]);
+  }
+
+  VectorNd v;
+  G6D_sparse.apply (qdot, v);
+  CHECK_THAT (VectorNd (G6D * qdot), AllCloseVector(v, TEST_PREC, TEST_PREC));
+
+  VectorNd f (3);
+  f << 1.3, -0.7, 2.1;
+  VectorNd tau;
+  G_sparse.applyTranspose (f, tau);
+  CHECK_THAT (VectorNd (G.transpose() * f),
+              AllCloseVector(tau, TEST_PREC, TEST_PREC));
+
+  G_sparse.applyTranspose (f, tau, true);
+  CHECK_THAT (VectorNd (2. * G.transpose() * f),
+              AllCloseVector(tau, TEST_PREC, TEST_PREC));
+}
+
+TEST_CASE_METHOD ( Human36,
+                   __FILE__"_CalcPointJacobianSparse", "" ) {
+  setDeterministicStates();
+
+  for (unsigned int i = 0; i < BodyNameLast; i++) {
+    CheckPointJacobianSparse (*model_emulated, q, qdot, body_id_emulated[i]);
+    CheckPointJacobianSparse (*model_3dof, q, qdot, body_id_3dof[i]);
+  }
+}
+
+void CheckKinematicsMatch (const Model &model, const ModelData &data,
+                           const ModelData &reference) {
+  for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+    CHECK_THAT (reference.X_base[i].E,
+                AllCloseMatrix(data.X_base[i].E, TEST_PREC, TEST_PREC));
+    CHECK_THAT (reference.X_base[i].r,
+                AllCloseVector(data.X_base[i].r, TEST_PREC, TEST_PREC));
+    CHECK_THAT (reference.v[i],
+                AllCloseVector(data.v[i], TEST_PREC, TEST_PREC));
+    CHECK_THAT (reference.a[i],
+                AllCloseVector(data.a[i], TEST_PREC, TEST_PREC));
+  }
+}
+
+bool IsInSubtree (const Model &model, unsigned int body_id,
+                  unsigned int root_id) {
+  while (body_id != 0 && body_id != root_id) {
+    body_id = model.lambda[body_id];
+  }
+  return body_id == root_id;
+}
+
+TEST_CASE_METHOD ( Human36,
+                   __FILE__"_UpdateKinematicsIncremental", "" ) {
+  Model &model = *model_emulated;
+  setDeterministicStates();
+
+  ModelData data (model);
+  ModelData reference (model);
+
+  UpdateKinematicsIncremental (model, data, &q, &qdot, &qddot);
+  UpdateKinematicsCustom (model, reference, &q, &qdot, &qddot);
+  CheckKinematicsMatch (model, data, reference);
+  CHECK (data.kinematics_cache_level == 3);
+
+  // unchanged values do not trigger any recomputation
+  UpdateKinematicsIncremental (model, data, &q, &qdot, &qddot);
+  for (unsigned int i = 0; i < model.mBodies.size(); i++) {
+    CHECK (data.kinematics_cache_dirty[i] == 0);
+  }
+
+  // only the subtree of a modified joint gets updated
+  unsigned int lower_arm_id = body_id_emulated[BodyLowerArmRight];
+  q[model.mJoints[lower_arm_id].q_index] += 0.3;
+  UpdateKinematicsIncremental (model, data, &q, &qdot, &qddot);
+  UpdateKinematicsCustom (model, reference, &q, &qdot, &qddot);
+  CheckKinematicsMatch (model, data, reference);
+  for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+    CHECK ((data.kinematics_cache_dirty[i] != 0)
+           == IsInSubtree (model, i, lower_arm_id));
+  }
+
+  // a position-only update invalidates the velocities and accelerations
+  q[model.mJoints[lower_arm_id].q_index] -= 0.1;
+  UpdateKinematicsIncremental (model, data, &q, NULL, NULL);
+  CHECK (data.kinematics_cache_level == 1);
+  UpdateKinematicsIncremental (model, data, &q, &qdot, &qddot);
+  UpdateKinematicsCustom (model, reference, &q, &qdot, &qddot);
+  CheckKinematicsMatch (model, data, reference);
+
+  // other algorithms operating on the data invalidate the cache
+  ForwardDynamics (model, data, q, qdot, tau, qddot);
+  CHECK (data.kinematics_cache_level == 0);
+  UpdateKinematicsIncremental (model, data, &q, &qdot, &qddot);
+  UpdateKinematicsCustom (model, reference, &q, &qdot, &qddot);
+  CheckKinematicsMatch (model, data, reference);
+  for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+    CHECK (data.kinematics_cache_dirty[i] != 0);
+  }
+
+  // an acceleration-only update overwrites a[] and invalidates the cache
+  VectorNd qddot_other = 2. * qddot - VectorNd::Ones (qddot.size());
+  UpdateKinematicsCustom (model, data, NULL, NULL, &qddot_other);
+  CHECK (data.kinematics_cache_level == 0);
+  UpdateKinematicsIncremental (model, data, &q, &qdot, &qddot);
+  CheckKinematicsMatch (model, data, reference);
+
+  CHECK_THROWS_AS (UpdateKinematicsIncremental (model, data, NULL, &qdot,
+                   NULL), Errors::RBDLError);
+}
@@ -2286,6 +2286,108 @@ TEST_CASE_METHOD(FloatingFourBarLinkage,
   );
 }
 
+TEST_CASE_METHOD(SliderCrank3D,
+                 __FILE__"_TestSliderCrank3DIntegratorProjection", "") {
+  VectorNd weights(VectorNd::Constant(q.size(), 1.));
+  VectorNd qInit(q.size());
+  VectorNd qdInit(VectorNd::Zero(q.size()));
+  VectorNd err(VectorNd::Zero(cs.size()));
+
+  qInit[0] = 0.4;
+  qInit[1] = 0.25 * M_PI;
+  qInit[2] = -0.25 * M_PI;
+  qInit[3] = 0.1;
+  qInit[4] = 0.1;
+  REQUIRE(CalcAssemblyQ(model, qInit, cs, q, weights, TEST_PREC));
+
+  qdInit[0] = -0.2;
+  qdInit[1] = 0.1 * M_PI;
+  qdInit[2] = -0.1 * M_PI;
+  CalcAssemblyQDot(model, q, qdInit, cs, qd, weights);
+
+  VectorNd qDrift(q);
+  VectorNd qdDrift(qd);
+
+  Integrator integrator(model, IntegratorSemiImplicitEuler);
+  Integrator integratorDrift(model, IntegratorSemiImplicitEuler);
+  integratorDrift.project_constraints = false;
+
+  for (unsigned int i = 0; i < 200; i++) {
+    integrator.Step(model, q, qd, tau, 1.0e-3, &cs);
+    integratorDrift.Step(model, qDrift, qdDrift, tau, 1.0e-3, &cs);
+  }
+
+  CalcConstraintsPositionError(model, q, cs, err);
+  double errProjected = err.norm();
+  CalcConstraintsVelocityError(model, q, qd, cs, err);
+  double errdProjected = err.norm();
+
+  CalcConstraintsPositionError(model, qDrift, cs, err);
+  double errDrift = err.norm();
+
+  INFO("errProjected " << errProjected << " errDrift " << errDrift);
+  CHECK(errProjected < 1.0e-10);
+  CHECK(errdProjected < 1.0e-10);
+  CHECK(errDrift > 100. * errProjected);
+}
+
+TEST_CASE_METHOD(SliderCrank3D,
+                 __FILE__"_TestSliderCrank3DAssemblyWarmStart", "") {
+  VectorNd weights(VectorNd::Constant(q.size(), 1.));
+  VectorNd qInit(q.size());
+  VectorNd qdInit(VectorNd::Zero(q.size()));
+  VectorNd err(VectorNd::Zero(cs.size()));
+  MatrixNd G(MatrixNd::Zero(cs.size(), model.dof_count));
+
+  qInit[0] = 0.4;
+  qInit[1] = 0.25 * M_PI;
+  qInit[2] = -0.25 * M_PI;
+  qInit[3] = 0.1;
+  qInit[4] = 0.1;
+  REQUIRE(CalcAssemblyQ(model, qInit, cs, q, weights, TEST_PREC));
+  CHECK(cs.assembly_factorization_count > 0);
+
+  // The Schur complement solution has to match the weighted least-squares
+  // solution of the KKT system.
+  weights[1] = 2.;
+  weights[3] = 0.5;
+  qdInit[0] = -0.2;
+  qdInit[1] = 0.1 * M_PI;
+  qdInit[2] = -0.1 * M_PI;
+  CalcAssemblyQDot(model, q, qdInit, cs, qd, weights);
+  CHECK(cs.assembly_factorization_count == 1);
+
+  CalcConstraintsJacobian(model, q, cs, G);
+  unsigned int n = model.dof_count;
+  unsigned int nc = cs.size();
+  MatrixNd A(MatrixNd::Zero(n + nc, n + nc));
+  VectorNd b(VectorNd::Zero(n + nc));
+  A.block(0, 0, n, n) = weights.asDiagonal();
+  A.block(n, 0, nc, n) = G;
+  A.block(0, n, n, nc) = G.transpose();
+  b.head(n) = weights.cwiseProduct(qdInit);
+  VectorNd qdRef = A.colPivHouseholderQr().solve(b).head(n);
+  CHECK_THAT(qdRef, AllCloseVector(qd, TEST_PREC, TEST_PREC));
+
+  // Consecutive small corrections reuse the factorization of the previous
+  // call.
+  cs.assembly_warm_start = true;
+  unsigned int factorization_count = 0;
+  for (unsigned int i = 0; i < 20; i++) {
+    IntegrateQ(model, q, qd, 1.0e-3, q);
+    REQUIRE(CalcAssemblyQ(model, q, cs, q, weights, TEST_PREC));
+    factorization_count += cs.assembly_factorization_count;
+
+    CalcConstraintsPositionError(model, q, cs, err);
+    CHECK(err.norm() < TEST_PREC);
+
+    CalcAssemblyQDot(model, q, qd, cs, qd, weights);
+    CalcConstraintsVelocityError(model, q, qd, cs, err);
+    CHECK(err.norm() < TEST_PREC);
+  }
+  CHECK(factorization_count < 20);
+}
+
 TEST_CASE_METHOD(SliderCrank3DSphericalJoint,
                  __FILE__"_TestSliderCrank3DSphericalJointConstraintErrors", "")
 {
@@ -2825,3 +2927,61 @@ TEST_CASE(__FILE__"_ConstraintCorrectnessTest", "") {
   }
   
 }
+
+void SetKokkevisTestState (VectorNd &q, VectorNd &qd, VectorNd &tau) {
+  for (unsigned int i = 0; i < q.size(); i++) {
+    q[i] = 0.4 * sin (static_cast<double>(i) + 0.3);
+  }
+  for (unsigned int i = 0; i < qd.size(); i++) {
+    qd[i] = 0.7 * cos (static_cast<double>(2 * i));
+    tau[i] = 0.5 * sin (static_cast<double>(3 * i) + 1.);
+  }
+}
+
+void CheckKokkevisAgainstDirect (Model &model, ConstraintSet &cs,
+    const VectorNd &q, const VectorNd &qd, const VectorNd &tau) {
+  VectorNd qddDirect (VectorNd::Zero (model.dof_count));
+  VectorNd qddKokkevis (VectorNd::Zero (model.dof_count));
+
+  ForwardDynamicsConstraintsDirect (model, q, qd, tau, cs, qddDirect);
+  VectorNd forceDirect = cs.force;
+
+  ForwardDynamicsContactsKokkevis (model, q, qd, tau, cs, qddKokkevis);
+
+  CHECK_THAT (qddDirect, AllCloseVector (qddKokkevis, 1.0e-9, 1.0e-9));
+  CHECK_THAT (forceDirect, AllCloseVector (cs.force, 1.0e-9, 1.0e-9));
+}
+
+TEST_CASE(__FILE__"_ForwardDynamicsKokkevisLoopConstraints", "") {
+  FourBarLinkage fourBar;
+  SetKokkevisTestState (fourBar.q, fourBar.qd, fourBar.tau);
+  CheckKokkevisAgainstDirect (fourBar.model, fourBar.cs, fourBar.q,
+                              fourBar.qd, fourBar.tau);
+
+  FloatingFourBarLinkage floatingFourBar;
+  SetKokkevisTestState (floatingFourBar.q, floatingFourBar.qd,
+                        floatingFourBar.tau);
+  CheckKokkevisAgainstDirect (floatingFourBar.model, floatingFourBar.cs,
+                              floatingFourBar.q, floatingFourBar.qd,
+                              floatingFourBar.tau);
+
+  SliderCrank3D sliderCrank;
+  SetKokkevisTestState (sliderCrank.q, sliderCrank.qd, sliderCrank.tau);
+  CheckKokkevisAgainstDirect (sliderCrank.model, sliderCrank.cs,
+                              sliderCrank.q, sliderCrank.qd, sliderCrank.tau);
+
+  SliderCrank3DSphericalJoint sphericalCrank;
+  SetKokkevisTestState (sphericalCrank.q, sphericalCrank.qd,
+                        sphericalCrank.tau);
+  sphericalCrank.model.SetQuaternion (sphericalCrank.id_s,
+      Quaternion::fromZYXAngles (Vector3d (0.3, -0.2, 0.5)),
+      sphericalCrank.q);
+  CheckKokkevisAgainstDirect (sphericalCrank.model, sphericalCrank.cs,
+                              sphericalCrank.q, sphericalCrank.qd,
+                              sphericalCrank.tau);
+
+  // the first loop constraint connects a body with the ground
+  DoublePerpendicularPendulumAbsoluteCoordinates dba;
+  SetKokkevisTestState (dba.q, dba.qd, dba.tau);
+  CheckKokkevisAgainstDirect (dba.model, dba.cs, dba.q, dba.qd, dba.tau);
+}
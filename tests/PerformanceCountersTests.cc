@@ -0,0 +1,132 @@
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "rbdl/PerformanceCounters.h"
+#include "rbdl/Model.h"
+#include "rbdl/Dynamics.h"
+#include "rbdl/Kinematics.h"
+
+#include "rbdl_tests.h"
+
+#include "Fixtures.h"
+
+using namespace std;
+using namespace RigidBodyDynamics;
+using namespace RigidBodyDynamics::Math;
+
+PerformanceCounterStats FindPerformanceCounterStats (const string &name) {
+  vector<PerformanceCounterStats> stats = GetPerformanceCounterStats();
+  for (size_t i = 0; i < stats.size(); i++) {
+    if (stats[i].name == name) {
+      return stats[i];
+    }
+  }
+  return PerformanceCounterStats();
+}
+
+TEST_CASE (__FILE__"_PerformanceCounterScope", "") {
+  PerformanceCounter &counter = GetPerformanceCounter ("TestCounterScope");
+  CHECK (&counter == &GetPerformanceCounter ("TestCounterScope"));
+
+  counter.reset();
+  {
+    PerformanceCounterScope scope (counter);
+    this_thread::sleep_for (chrono::milliseconds (2));
+  }
+  {
+    PerformanceCounterScope scope (counter);
+  }
+  counter.AddIterations (7);
+
+  PerformanceCounterStats stats =
+    FindPerformanceCounterStats ("TestCounterScope");
+  CHECK (stats.name == "TestCounterScope");
+  CHECK (stats.call_count == 2);
+  CHECK (stats.max_time_ns >= 2000000);
+  CHECK (stats.total_time_ns >= stats.max_time_ns);
+  CHECK (stats.iteration_count == 7);
+
+  ostringstream json;
+  WritePerformanceCountersJSON (json);
+  CHECK (json.str().find ("\"TestCounterScope\": { \"calls\": 2,")
+      != string::npos);
+
+  ResetPerformanceCounters();
+  stats = FindPerformanceCounterStats ("TestCounterScope");
+  CHECK (stats.call_count == 0);
+  CHECK (stats.total_time_ns == 0);
+  CHECK (stats.max_time_ns == 0);
+  CHECK (stats.iteration_count == 0);
+}
+
+TEST_CASE (__FILE__"_PerformanceCounterMultipleThreads", "") {
+  const unsigned int thread_count = 4;
+  const unsigned int call_count = 1000;
+
+  PerformanceCounter &counter = GetPerformanceCounter ("TestCounterThreads");
+  counter.reset();
+
+  vector<thread> threads;
+  for (unsigned int t = 0; t < thread_count; t++) {
+    threads.push_back (thread ([&counter, call_count]() {
+          for (unsigned int i = 0; i < call_count; i++) {
+            PerformanceCounterScope scope (counter);
+            counter.AddIterations (1);
+          }
+        }));
+  }
+  for (unsigned int t = 0; t < thread_count; t++) {
+    threads[t].join();
+  }
+
+  CHECK (counter.call_count.load() == thread_count * call_count);
+  CHECK (counter.iteration_count.load() == thread_count * call_count);
+}
+
+#ifdef RBDL_ENABLE_PERF_COUNTERS
+
+TEST_CASE_METHOD (FixedBase3DoF, __FILE__"_PerformanceCountersAlgorithms",
+    "") {
+  ResetPerformanceCounters();
+
+  for (unsigned int i = 0; i < 3; i++) {
+    ForwardDynamics (*model, Q, QDot, Tau, QDDot);
+  }
+  InverseDynamics (*model, Q, QDot, QDDot, Tau);
+
+  CHECK (FindPerformanceCounterStats ("ForwardDynamics").call_count == 3);
+  CHECK (FindPerformanceCounterStats ("InverseDynamics").call_count == 1);
+  CHECK (FindPerformanceCounterStats ("ForwardDynamics").total_time_ns > 0);
+
+  // the target is the point at a different configuration such that the
+  // inverse kinematics needs several iterations
+  VectorNd QTarget (VectorNd::Constant (model->q_size, 0.4));
+  vector<unsigned int> body_ids (1, body_c_id);
+  vector<Vector3d> body_points (1, Vector3d (0.1, 0.2, 0.3));
+  vector<Vector3d> target_positions (1, CalcBodyToBaseCoordinates (*model,
+        QTarget, body_c_id, body_points[0]));
+  VectorNd QRes (model->q_size);
+  InverseKinematics (*model, Q, body_ids, body_points, target_positions,
+      QRes);
+
+  PerformanceCounterStats ik_stats =
+    FindPerformanceCounterStats ("InverseKinematics");
+  CHECK (ik_stats.call_count == 1);
+  CHECK (ik_stats.iteration_count > 1);
+}
+
+#else
+
+TEST_CASE_METHOD (FixedBase3DoF, __FILE__"_PerformanceCountersDisabled",
+    "") {
+  ResetPerformanceCounters();
+
+  ForwardDynamics (*model, Q, QDot, Tau, QDDot);
+  InverseDynamics (*model, Q, QDot, QDDot, Tau);
+
+  CHECK (FindPerformanceCounterStats ("ForwardDynamics").name.empty());
+  CHECK (FindPerformanceCounterStats ("InverseDynamics").name.empty());
+}
+
+#endif
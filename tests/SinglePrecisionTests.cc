@@ -0,0 +1,163 @@
+/*
+ * Accuracy tests of the single precision build (rbdl-float). The results
+ * are compared against reference values that were computed with the double
+ * precision library for the same model and state.
+ */
+
+#include <iostream>
+
+#include "rbdl/rbdl.h"
+
+#include "rbdl_tests.h"
+
+#include "Human36Fixture.h"
+
+using namespace std;
+using namespace RigidBodyDynamics;
+using namespace RigidBodyDynamics::Math;
+
+// normwise relative error that is expected for float on the Human36 model
+const double TEST_PREC_FLOAT = 1.0e-5;
+
+static const double ForwardDynamicsReference[36] = {
+  3.0676921884072565, -1.4197059352972767, -7.9975430148546369,
+  -29.140632268049725, -13.224676117956077, 36.347593617720648,
+  67.242450209576916, 3.6853522132965559, -41.219857559972837,
+  -57.088923466788572, 48.215875841411815, 20.812991150167377,
+  38.180734790054004, 6.7965602749024612, -34.550527980329143,
+  -15.38909916653115, 12.22245210532842, -1.6942440535154903,
+  27.990363220763317, 9.7404607026961365, -20.282046542648438,
+  7.1561787947232407, -18.301299671818231, -120.27973011550671,
+  -57.607476834692399, 208.51514942343192, 50591.492365869053,
+  -6.8937415163702376, -11.294205939394354, -64.743091535591105,
+  -21.68519284828086, 59.448041589029799, 25285.588291975022,
+  -10.605998004811402, 9.6442229375948418, -974.83291465408161
+};
+
+static const double InverseDynamicsReference[36] = {
+  10.090023209068136, 14.909155084220515, 712.0234549092105,
+  17.357857435560216, -1.0164787248643528, 2.3472827563790282,
+  -25.086081589782889, -14.906244653291497, -0.63527388167087229,
+  -7.8330351052085074, -1.3127751870507429, -0.24630984155320312,
+  -18.194934400826266, -8.2140260937388145, -0.19045604609150141,
+  -4.6106718715306227, -1.4031127227112743, -0.2737067521716019,
+  36.178514180803788, 8.5454317378828257, -2.7691645955767994,
+  0.65994917783840812, 1.9349134862332624, -0.19487305927879417,
+  0.75393004477035486, 0.1636857901659072, -4.424439035642203e-07,
+  2.6400583354133431, 3.1440579514769027, -0.59402677862363573,
+  1.3057599409691698, 0.23497896056875928, -4.3584180606694012e-08,
+  0.7979109282801623, 1.6176858309722313, 7.3802253505326142e-06
+};
+
+static const double NonlinearEffectsReference[36] = {
+  -5.3272530346262101, 1.4915943333971882, 699.95322380069229,
+  13.438000957179099, -2.5474587985156814, 1.3463034247266159,
+  -24.732501264337586, -16.522019804127346, -0.77567200053911045,
+  -7.8930829777540232, -1.3112551689017273, -0.30850462819771496,
+  -18.011735893258916, -9.667254487050613, -0.23202005866862416,
+  -4.6403881597629635, -1.3939526287500361, -0.32689466705358167,
+  33.324678190705114, 10.094925890434848, -2.3681596252050223,
+  0.8946764354436576, 1.7429158078422891, -0.1823251400167768,
+  0.80910819773653531, 0.1660345559445538, -9.1144547957908634e-07,
+  2.7382146151783431, 2.9326308588010237, -0.5726304710562854,
+  1.3239813370361708, 0.23216928722700458, 4.7115770244461566e-08,
+  0.83113040276902772, 1.5341667928884026, 1.5192868278754634e-05
+};
+
+// H * QDDot where H is the joint space inertia matrix
+static const double CompositeRigidBodyReference[36] = {
+  15.417276243694339, 13.417560750823386, 12.070231108518312,
+  3.919856478381138, 1.5309800736513279, 1.0009793316524125,
+  -0.35358032544530643, 1.61577515083585, 0.14039811886823814,
+  0.060047872545516232, -0.0015200181490160425, 0.062194786644511835,
+  -0.18319850756735717, 1.4532283933117989, 0.04156401257712275,
+  0.029716288232339169, -0.0091600939612384927, 0.053187914881979735,
+  2.8538359900986841, -1.5494941525520267, -0.40100497037177751,
+  -0.23472725760525004, 0.19199767839097509, -0.012547919262017506,
+  -0.05517815296618038, -0.0023487657786465423, 4.6900157601486615e-07,
+  -0.098156279765001991, 0.21142709267588089, -0.021396307567350246,
+  -0.018221396067002443, 0.0028096733417545899, -9.0699950851155048e-08,
+  -0.033219474488865232, 0.083519038083828767, -7.8126429282220262e-06
+};
+
+static const double BodyToBaseReference[3] = {
+  -0.74168551521108494, 0.13744759887080021, -0.31377465563246087
+};
+
+struct Human36SinglePrecision : public Human36 {
+  Human36SinglePrecision() {
+    for (unsigned int i = 0; i < model_emulated->q_size; i++) {
+      q[i] = -0.4 + 0.03 * i;
+    }
+    for (unsigned int i = 0; i < model_emulated->qdot_size; i++) {
+      qdot[i] = 0.5 - 0.02 * i;
+      qddot[i] = 0.2 - 0.01 * i;
+      tau[i] = 0.1 * (i % 7) - 0.3;
+    }
+  }
+};
+
+double CalcRelativeError (const VectorNd &result, const double *reference) {
+  Eigen::VectorXd ref = Eigen::Map<const Eigen::VectorXd> (reference,
+      result.size());
+  return (result.cast<double>() - ref).norm() / ref.norm();
+}
+
+TEST_CASE (__FILE__"_ScalarIsFloat", "") {
+  CHECK (sizeof (Scalar) == sizeof (float));
+  CHECK (sizeof (VectorNd::Scalar) == sizeof (float));
+  CHECK (sizeof (SpatialMatrix::Scalar) == sizeof (float));
+}
+
+TEST_CASE_METHOD (Human36SinglePrecision,
+    __FILE__"_ForwardDynamicsAccuracy", "") {
+  VectorNd result (VectorNd::Zero (model_emulated->qdot_size));
+  ForwardDynamics (*model_emulated, q, qdot, tau, result);
+
+  double error = CalcRelativeError (result, ForwardDynamicsReference);
+  INFO ("relative error: " << error);
+  CHECK (error < TEST_PREC_FLOAT);
+}
+
+TEST_CASE_METHOD (Human36SinglePrecision,
+    __FILE__"_InverseDynamicsAccuracy", "") {
+  VectorNd result (VectorNd::Zero (model_emulated->qdot_size));
+  InverseDynamics (*model_emulated, q, qdot, qddot, result);
+
+  double error = CalcRelativeError (result, InverseDynamicsReference);
+  INFO ("relative error: " << error);
+  CHECK (error < TEST_PREC_FLOAT);
+}
+
+TEST_CASE_METHOD (Human36SinglePrecision,
+    __FILE__"_NonlinearEffectsAccuracy", "") {
+  VectorNd result (VectorNd::Zero (model_emulated->qdot_size));
+  NonlinearEffects (*model_emulated, q, qdot, result);
+
+  double error = CalcRelativeError (result, NonlinearEffectsReference);
+  INFO ("relative error: " << error);
+  CHECK (error < TEST_PREC_FLOAT);
+}
+
+TEST_CASE_METHOD (Human36SinglePrecision,
+    __FILE__"_CompositeRigidBodyAccuracy", "") {
+  MatrixNd H (MatrixNd::Zero (model_emulated->qdot_size,
+        model_emulated->qdot_size));
+  CompositeRigidBodyAlgorithm (*model_emulated, q, H);
+  VectorNd result = H * qddot;
+
+  double error = CalcRelativeError (result, CompositeRigidBodyReference);
+  INFO ("relative error: " << error);
+  CHECK (error < TEST_PREC_FLOAT);
+}
+
+TEST_CASE_METHOD (Human36SinglePrecision,
+    __FILE__"_CalcBodyToBaseCoordinatesAccuracy", "") {
+  Vector3d point = CalcBodyToBaseCoordinates (*model_emulated, q,
+      body_id_emulated[BodyHandLeft], Vector3d (0.1, 0., -0.05));
+
+  VectorNd result (point);
+  double error = CalcRelativeError (result, BodyToBaseReference);
+  INFO ("relative error: " << error);
+  CHECK (error < TEST_PREC_FLOAT);
+}
@@ -9,6 +9,7 @@
 #include "rbdl/Kinematics.h"
 #include "rbdl/Dynamics.h"
 
+#include "Human36Fixture.h"
 #include "rbdl_tests.h"
 
 using namespace std;
@@ -313,3 +314,123 @@ TEST_CASE ( __FILE__"_TestSparseFactorizationMultiDofAndFixed", "") {
               AllCloseVector(x_3dof, 1.0e-9, 1.0e-9)
   );
 }
+
+void CheckSparseLTLSolver (Model &model, ConstraintSet &constraint_set,
+                           const VectorNd &q, const VectorNd &qdot,
+                           const VectorNd &tau) {
+  ConstraintSet constraint_set_ltl = constraint_set.Copy();
+  constraint_set_ltl.SetSolver (LinearSolverSparseLTL);
+  constraint_set_ltl.Bind (model);
+
+  VectorNd qddot (VectorNd::Zero (model.qdot_size));
+  VectorNd qddot_ltl (VectorNd::Zero (model.qdot_size));
+
+  ForwardDynamicsConstraintsRangeSpaceSparse (model, q, qdot, tau,
+                                              constraint_set, qddot);
+  ForwardDynamicsConstraintsRangeSpaceSparse (model, q, qdot, tau,
+                                              constraint_set_ltl, qddot_ltl);
+
+  double prec = 1.0e-10 * qddot.norm();
+  CHECK_THAT (qddot, AllCloseVector(qddot_ltl, prec, prec));
+  CHECK_THAT (constraint_set.force, AllCloseVector(constraint_set_ltl.force,
+              prec, prec));
+
+  VectorNd qdot_plus (VectorNd::Zero (model.qdot_size));
+  VectorNd qdot_plus_ltl (VectorNd::Zero (model.qdot_size));
+
+  ComputeConstraintImpulsesRangeSpaceSparse (model, q, qdot, constraint_set,
+                                             qdot_plus);
+  ComputeConstraintImpulsesRangeSpaceSparse (model, q, qdot,
+                                             constraint_set_ltl, qdot_plus_ltl);
+
+  CHECK_THAT (qdot_plus, AllCloseVector(qdot_plus_ltl, 1.0e-10, 1.0e-10));
+  CHECK_THAT (constraint_set.impulse,
+              AllCloseVector(constraint_set_ltl.impulse, 1.0e-10, 1.0e-10));
+}
+
+TEST_CASE_METHOD (Human36, __FILE__"_TestBranchInducedLambdaQ", "") {
+  Model &model = *model_emulated;
+
+  for (unsigned int i = 1; i < model.mBodies.size(); i++) {
+    unsigned int lambda = model.lambda[i];
+    unsigned int lambda_q_parent = 0;
+    if (lambda != 0) {
+      lambda_q_parent = model.mJoints[lambda].q_index
+                        + model.mJoints[lambda].mDoFCount;
+    }
+    CHECK (model.lambda_q[model.mJoints[i].q_index + 1] == lambda_q_parent);
+  }
+}
+
+TEST_CASE_METHOD (Human36, __FILE__"_TestSparseLTLSolver", "") {
+  setDeterministicStates();
+
+  CheckSparseLTLSolver (*model_emulated, constraints_1B1C_emulated, q, qdot,
+                        tau);
+  CheckSparseLTLSolver (*model_emulated, constraints_1B4C_emulated, q, qdot,
+                        tau);
+  CheckSparseLTLSolver (*model_emulated, constraints_4B4C_emulated, q, qdot,
+                        tau);
+
+  // the cached sparsity pattern has to remain valid for other states. The
+  // constraints are redundant in these states, which the Cholesky
+  // decomposition of ForwardDynamicsConstraintsRangeSpaceSparse() does not
+  // handle, therefore the direct method is used as reference.
+  ConstraintSet constraint_set_ltl = constraints_4B4C_emulated.Copy();
+  constraint_set_ltl.SetSolver (LinearSolverSparseLTL);
+  constraint_set_ltl.Bind (*model_emulated);
+
+  VectorNd qddot_ltl (VectorNd::Zero (model_emulated->qdot_size));
+  for (unsigned int j = 0; j < 3; j++) {
+    q.setZero();
+    q[j] = 0.3 * (j + 1);
+    ForwardDynamicsConstraintsDirect (*model_emulated, q, qdot, tau,
+        constraints_4B4C_emulated, qddot);
+    ForwardDynamicsConstraintsRangeSpaceSparse (*model_emulated, q, qdot, tau,
+        constraint_set_ltl, qddot_ltl);
+
+    double prec = 1.0e-10 * qddot.norm();
+    CHECK_THAT (qddot, AllCloseVector(qddot_ltl, prec, prec));
+  }
+}
+
+TEST_CASE_METHOD (Human36, __FILE__"_TestSparseLTLSolverRedundantConstraints",
+                  "") {
+  Model &model = *model_emulated;
+  setDeterministicStates();
+
+  unsigned int foot_r = model.GetBodyId ("foot_r");
+
+  // the last row is the sum of the first two rows
+  ConstraintSet constraint_set_ltl;
+  constraint_set_ltl.AddContactConstraint (foot_r,
+      Vector3d (0.1, 0., -0.05), Vector3d (1., 0., 0.));
+  constraint_set_ltl.AddContactConstraint (foot_r,
+      Vector3d (0.1, 0., -0.05), Vector3d (0., 1., 0.));
+  constraint_set_ltl.AddContactConstraint (foot_r,
+      Vector3d (0.1, 0., -0.05), Vector3d (1., 1., 0.));
+  constraint_set_ltl.SetSolver (LinearSolverSparseLTL);
+  constraint_set_ltl.Bind (model);
+
+  ConstraintSet constraint_set;
+  constraint_set.AddContactConstraint (foot_r,
+      Vector3d (0.1, 0., -0.05), Vector3d (1., 0., 0.));
+  constraint_set.AddContactConstraint (foot_r,
+      Vector3d (0.1, 0., -0.05), Vector3d (0., 1., 0.));
+  constraint_set.Bind (model);
+
+  VectorNd qddot_ltl (VectorNd::Zero (model.qdot_size));
+  ForwardDynamicsConstraintsRangeSpaceSparse (model, q, qdot, tau,
+                                              constraint_set, qddot);
+  ForwardDynamicsConstraintsRangeSpaceSparse (model, q, qdot, tau,
+                                              constraint_set_ltl, qddot_ltl);
+
+  double prec = 1.0e-10 * qddot.norm();
+  CHECK_THAT (qddot, AllCloseVector(qddot_ltl, prec, prec));
+
+  // the generalized constraint forces are unique
+  VectorNd tau_constraint = constraint_set.G.transpose() * constraint_set.force;
+  VectorNd tau_constraint_ltl = constraint_set_ltl.G.transpose()
+                                * constraint_set_ltl.force;
+  CHECK_THAT (tau_constraint, AllCloseVector(tau_constraint_ltl, prec, prec));
+}
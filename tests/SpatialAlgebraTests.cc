@@ -573,6 +573,80 @@ TEST_CASE(__FILE__"_TestSpatialRigidBodyInertiaCreateFromMatrix", "") {
   CHECK_THAT (inertia, AllCloseMatrix(rbi_I_matrix, 0., 0.));
 }
 
+TEST_CASE(__FILE__"_TestSpatialArticulatedBodyInertiaCreateFromMatrix", "") {
+  SpatialRigidBodyInertia rbi (
+      1.1,
+      Vector3d (1.2, 1.3, 1.4),
+      Matrix3d (
+        1.1, 0.5, 0.3,
+        0.5, 1.2, 0.4,
+        0.3, 0.4, 1.3
+        ));
+  SpatialVector U (0.3, -0.2, 0.5, 1.1, 0.4, -0.7);
+
+  // articulated body inertia of the body after removing a joint with
+  // motion subspace U
+  SpatialMatrix IA = rbi.toMatrix() - U * U.transpose() / 2.3;
+  SpatialArticulatedBodyInertia abi (IA);
+
+  CHECK_THAT (IA, AllCloseMatrix(abi.toMatrix(), 0., 0.));
+  CHECK_THAT (rbi.toMatrix(),
+              AllCloseMatrix(SpatialArticulatedBodyInertia(rbi).toMatrix(),
+                0., 0.));
+
+  SpatialVector v (1.1, -2.1, 0.3, 0.8, -1.4, 2.2);
+  CHECK_THAT (SpatialVector (IA * v),
+              AllCloseVector(abi * v, TEST_PREC, TEST_PREC));
+  CHECK_THAT (SpatialMatrix (IA + IA),
+              AllCloseMatrix((abi + abi).toMatrix(), TEST_PREC, TEST_PREC));
+
+  SpatialArticulatedBodyInertia abi_sum (abi);
+  abi_sum += SpatialArticulatedBodyInertia (rbi);
+  CHECK_THAT (SpatialMatrix (IA + rbi.toMatrix()),
+              AllCloseMatrix(abi_sum.toMatrix(), TEST_PREC, TEST_PREC));
+  CHECK_THAT (SpatialMatrix (IA - rbi.toMatrix()),
+              AllCloseMatrix((abi - SpatialArticulatedBodyInertia (rbi))
+                .toMatrix(), TEST_PREC, TEST_PREC));
+
+  SpatialArticulatedBodyInertia abi_removed (rbi);
+  abi_removed.subtractOuterProduct (U, U / 2.3);
+  CHECK_THAT (IA, AllCloseMatrix(abi_removed.toMatrix(), TEST_PREC,
+                                 TEST_PREC));
+}
+
+TEST_CASE(__FILE__"_TestSpatialTransformApplyTransposeSpatialArticulatedBodyInertia", "") {
+  SpatialRigidBodyInertia rbi (
+      1.1,
+      Vector3d (1.2, 1.3, 1.4),
+      Matrix3d (
+        1.1, 0.5, 0.3,
+        0.5, 1.2, 0.4,
+        0.3, 0.4, 1.3
+        ));
+  SpatialVector U (0.3, -0.2, 0.5, 1.1, 0.4, -0.7);
+  SpatialMatrix IA = rbi.toMatrix() - U * U.transpose() / 2.3;
+
+  SpatialTransform X (
+      Xrotz (0.5) *
+      Xroty (0.9) *
+      Xrotx (0.2) *
+      Xtrans (Vector3d (1.1, 1.2, 1.3))
+      );
+
+  SpatialArticulatedBodyInertia abi_transformed =
+    X.applyTranspose (SpatialArticulatedBodyInertia (IA));
+  SpatialMatrix IA_transformed = X.toMatrixTranspose() * IA * X.toMatrix();
+
+  CHECK_THAT (IA_transformed,
+              AllCloseMatrix(abi_transformed.toMatrix(), 1.0e-13, 1.0e-13));
+
+  // rigid body inertias are a special case of articulated body inertias
+  CHECK_THAT (X.applyTranspose (rbi).toMatrix(),
+              AllCloseMatrix(X.applyTranspose (
+                  SpatialArticulatedBodyInertia (rbi)).toMatrix(),
+                1.0e-13, 1.0e-13));
+}
+
 #ifdef USE_SLOW_SPATIAL_ALGEBRA
 TEST_CASE(__FILE__"_TestSpatialLinSolve", "") {
   SpatialVector b (1, 2, 0, 1, 1, 1);
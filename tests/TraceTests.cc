@@ -0,0 +1,139 @@
+#include <iostream>
+#include <set>
+#include <string>
+#include <thread>
+
+#include "rbdl/Logging.h"
+#include "rbdl/Model.h"
+#include "rbdl/Dynamics.h"
+
+#include "rbdl_tests.h"
+
+#include "Fixtures.h"
+
+using namespace std;
+using namespace RigidBodyDynamics;
+using namespace RigidBodyDynamics::Math;
+
+#if RBDL_TRACE_LEVEL >= 1
+
+TEST_CASE_METHOD (FixedBase3DoF, __FILE__"_TraceAlgorithmEnterExit", "") {
+  ClearTrace();
+  REQUIRE (GetTraceLevel() == TraceLevelOff);
+
+  ForwardDynamics (*model, Q, QDot, Tau, QDDot);
+  CHECK (GetTraceEvents().size() == 0);
+
+  SetTraceLevel (TraceLevelAlgorithms);
+  ForwardDynamics (*model, Q, QDot, Tau, QDDot);
+  SetTraceLevel (TraceLevelOff);
+
+  vector<TraceEvent> events = GetTraceEvents();
+  REQUIRE (events.size() >= 2);
+
+  CHECK (events.front().type == TraceEventEnter);
+  CHECK (string (events.front().name) == "ForwardDynamics");
+  CHECK (events.back().type == TraceEventExit);
+  CHECK (string (events.back().name) == "ForwardDynamics");
+  CHECK (events.back().duration_ns > 0);
+  CHECK (events.back().duration_ns
+      <= events.back().time_ns - events.front().time_ns);
+
+  for (size_t i = 0; i < events.size(); i++) {
+    CHECK (events[i].type != TraceEventBody);
+    CHECK (events[i].body_id == TraceNoBody);
+  }
+
+  ostringstream dump;
+  DumpTrace (dump);
+  CHECK (dump.str().find ("enter ForwardDynamics") != string::npos);
+  CHECK (dump.str().find ("exit ForwardDynamics") != string::npos);
+
+  ClearTrace();
+  CHECK (GetTraceEvents().size() == 0);
+}
+
+TEST_CASE_METHOD (FixedBase3DoF, __FILE__"_TraceRingBufferOverwritesOldest",
+    "") {
+  ClearTrace();
+
+  SetTraceLevel (TraceLevelAlgorithms);
+  for (unsigned int i = 0; i < TraceBufferSize; i++) {
+    InverseDynamics (*model, Q, QDot, QDDot, Tau);
+  }
+  NonlinearEffects (*model, Q, QDot, Tau);
+  SetTraceLevel (TraceLevelOff);
+
+  vector<TraceEvent> events = GetTraceEvents();
+  REQUIRE (events.size() == TraceBufferSize);
+  CHECK (string (events.back().name) == "NonlinearEffects");
+  CHECK (string (events.front().name) == "InverseDynamics");
+
+  ClearTrace();
+}
+
+TEST_CASE_METHOD (FixedBase3DoF, __FILE__"_TraceMultipleThreads", "") {
+  const unsigned int thread_count = 4;
+  const unsigned int call_count = 25;
+
+  ClearTrace();
+  SetTraceLevel (TraceLevelAlgorithms);
+
+  vector<thread> threads;
+  for (unsigned int t = 0; t < thread_count; t++) {
+    threads.push_back (thread ([this, call_count]() {
+          ModelData data (*model);
+          VectorNd tau (model->qdot_size);
+          for (unsigned int i = 0; i < call_count; i++) {
+            InverseDynamics (*model, data, Q, QDot, QDDot, tau);
+          }
+        }));
+  }
+  for (unsigned int t = 0; t < thread_count; t++) {
+    threads[t].join();
+  }
+
+  SetTraceLevel (TraceLevelOff);
+
+  vector<TraceEvent> events = GetTraceEvents();
+  CHECK (events.size() == 2 * thread_count * call_count);
+
+  // on every thread the calls must not be interleaved
+  set<unsigned int> open_calls;
+  for (size_t i = 0; i < events.size(); i++) {
+    CHECK (string (events[i].name) == "InverseDynamics");
+    if (events[i].type == TraceEventEnter) {
+      CHECK (open_calls.insert (events[i].thread_index).second);
+    } else {
+      CHECK (open_calls.erase (events[i].thread_index) == 1);
+    }
+  }
+  CHECK (open_calls.empty());
+
+  ClearTrace();
+}
+
+#endif
+
+#if RBDL_TRACE_LEVEL >= 2
+
+TEST_CASE_METHOD (FixedBase3DoF, __FILE__"_TraceBodies", "") {
+  ClearTrace();
+
+  SetTraceLevel (TraceLevelBodies);
+  ForwardDynamics (*model, Q, QDot, Tau, QDDot);
+  SetTraceLevel (TraceLevelOff);
+
+  vector<TraceEvent> events = GetTraceEvents();
+  set<unsigned int> bodies;
+  for (size_t i = 0; i < events.size(); i++) {
+    if (events[i].type == TraceEventBody) {
+      bodies.insert (events[i].body_id);
+    }
+  }
+  CHECK (bodies.size() == model->mBodies.size() - 1);
+
+  ClearTrace();
+}
+
+#endif
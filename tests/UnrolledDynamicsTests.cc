@@ -0,0 +1,118 @@
+#include <iostream>
+
+#include "rbdl/Logging.h"
+#include "rbdl/Model.h"
+#include "rbdl/Dynamics.h"
+#include "rbdl/UnrolledDynamics.h"
+
+#include "rbdl_tests.h"
+
+#include "Fixtures.h"
+#include "Human36Fixture.h"
+
+using namespace std;
+using namespace RigidBodyDynamics;
+using namespace RigidBodyDynamics::Math;
+
+const double TEST_PREC = 1.0e-12;
+
+typedef UnrolledJoints<
+  JointTypeRevoluteZ,
+  JointTypeRevoluteY,
+  JointTypeRevoluteZ
+  > FixedBase3DoFJoints;
+
+typedef UnrolledJoints<
+  // pelvis
+  JointTypeTranslationXYZ, JointTypeEulerYXZ,
+  // right leg
+  JointTypeEulerYXZ, JointTypeRevoluteY, JointTypeRevoluteY, JointTypeRevoluteZ,
+  // left leg
+  JointTypeEulerYXZ, JointTypeRevoluteY, JointTypeRevoluteY, JointTypeRevoluteZ,
+  // middle trunk
+  JointTypeEulerYXZ,
+  // right arm
+  JointTypeEulerYXZ, JointTypeRevoluteY, JointTypeRevoluteY, JointTypeRevoluteZ,
+  // left arm
+  JointTypeEulerYXZ, JointTypeRevoluteY, JointTypeRevoluteY, JointTypeRevoluteZ,
+  // head
+  JointTypeEulerYXZ
+  > Human36Joints3DoF;
+
+TEST_CASE_METHOD (FixedBase3DoF, __FILE__"_UnrolledJointsMatches", "") {
+  CHECK (FixedBase3DoFJoints::Matches (*model));
+  CHECK_FALSE ((UnrolledJoints<JointTypeRevoluteZ, JointTypeRevoluteY>
+        ::Matches (*model)));
+  CHECK_FALSE ((UnrolledJoints<JointTypeRevoluteZ, JointTypeRevoluteZ,
+        JointTypeRevoluteZ>::Matches (*model)));
+}
+
+TEST_CASE_METHOD (FixedBase3DoF, __FILE__"_ForwardDynamicsUnrolledAxes", "") {
+  Q[0] = 0.3;
+  Q[1] = -1.1;
+  Q[2] = 0.4;
+  QDot[0] = 1.2;
+  QDot[1] = 0.7;
+  QDot[2] = -2.1;
+  Tau[0] = 0.5;
+  Tau[1] = -1.3;
+  Tau[2] = 2.2;
+
+  VectorNd QDDot_unrolled (VectorNd::Zero (model->qdot_size));
+
+  ForwardDynamics (*model, Q, QDot, Tau, QDDot);
+  ForwardDynamicsUnrolled<FixedBase3DoFJoints> (*model, Q, QDot, Tau,
+      QDDot_unrolled);
+
+  CHECK_THAT (QDDot, AllCloseVector(QDDot_unrolled, TEST_PREC, TEST_PREC));
+}
+
+TEST_CASE (__FILE__"_ForwardDynamicsUnrolledGeneralAxes", "") {
+  Model model;
+  model.gravity = Vector3d (0., -9.81, 0.);
+
+  Body body (1.3, Vector3d (0.1, 0.5, -0.2), Vector3d (1.1, 0.9, 1.4));
+
+  unsigned int body_id = model.AddBody (0, Xtrans (Vector3d (0.1, 0., 0.)),
+      Joint (JointTypeRevolute, Vector3d (1., 1., 0.).normalized()), body);
+  body_id = model.AddBody (body_id, Xtrans (Vector3d (0., 0.7, 0.)),
+      Joint (JointTypePrismatic, Vector3d (0., 0.6, 0.8)), body);
+  model.AddBody (body_id, Xtrans (Vector3d (0.3, 0.7, 0.)),
+      Joint (JointTypeRevoluteX), body);
+
+  typedef UnrolledJoints<JointTypeRevolute, JointTypePrismatic,
+          JointTypeRevoluteX> GeneralAxesJoints;
+  REQUIRE (GeneralAxesJoints::Matches (model));
+
+  VectorNd Q (VectorNd::Zero (model.q_size));
+  VectorNd QDot (VectorNd::Zero (model.qdot_size));
+  VectorNd Tau (VectorNd::Zero (model.qdot_size));
+  VectorNd QDDot (VectorNd::Zero (model.qdot_size));
+  VectorNd QDDot_unrolled (VectorNd::Zero (model.qdot_size));
+
+  Q << 0.4, -0.3, 1.2;
+  QDot << -1.1, 0.5, 2.3;
+  Tau << 0.3, 2.1, -0.8;
+
+  ForwardDynamics (model, Q, QDot, Tau, QDDot);
+  ForwardDynamicsUnrolled<GeneralAxesJoints> (model, Q, QDot, Tau,
+      QDDot_unrolled);
+
+  CHECK_THAT (QDDot, AllCloseVector(QDDot_unrolled, TEST_PREC, TEST_PREC));
+}
+
+TEST_CASE_METHOD (Human36, __FILE__"_ForwardDynamicsUnrolledHuman36", "") {
+  REQUIRE (Human36Joints3DoF::Matches (*model_3dof));
+
+  setDeterministicStates();
+
+  ModelData data (*model_3dof);
+  VectorNd qddot_unrolled (VectorNd::Zero (model_3dof->qdot_size));
+
+  ForwardDynamics (*model_3dof, q, qdot, tau, qddot_3dof);
+  ForwardDynamicsUnrolled<Human36Joints3DoF> (*model_3dof, data, q, qdot,
+      tau, qddot_unrolled);
+
+  CHECK_THAT (qddot_3dof,
+      AllCloseVector(qddot_unrolled, TEST_PREC, TEST_PREC));
+}
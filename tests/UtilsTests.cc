@@ -381,3 +381,62 @@ TEST_CASE_METHOD(LinearInvertedPendulumModel,
 {
   TestZMPComputationAgainstTableCartModel (*this, 1e-8);
 }
+
+void TestCentroidalMomentumMatrix (Model &model) {
+  VectorNd q (VectorNd::Zero (model.q_size));
+  VectorNd qdot (VectorNd::Zero (model.qdot_size));
+  VectorNd qddot (VectorNd::Zero (model.qdot_size));
+
+  for (unsigned int i = 0; i < model.qdot_size; i++) {
+    q[i] = 0.4 * sin (1.3 * i + 0.2);
+    qdot[i] = 0.7 * cos (0.9 * i + 0.5);
+    qddot[i] = 1.1 * sin (0.7 * i + 1.1);
+  }
+
+  MatrixNd A_G;
+  Utils::CalcCentroidalMomentumMatrix (model, q, A_G);
+
+  REQUIRE (A_G.rows() == 6);
+  REQUIRE (A_G.cols() == model.qdot_size);
+
+  // column by column from the momentum of unit joint velocities
+  double mass;
+  Vector3d com, com_velocity, angular_momentum;
+  for (unsigned int i = 0; i < model.qdot_size; i++) {
+    VectorNd qdot_unit (VectorNd::Zero (model.qdot_size));
+    qdot_unit[i] = 1.;
+
+    Utils::CalcCenterOfMass (model, q, qdot_unit, NULL, mass, com,
+        &com_velocity, NULL, &angular_momentum);
+
+    SpatialVector column_ref;
+    column_ref << angular_momentum, mass * com_velocity;
+    CHECK_THAT (column_ref,
+        AllCloseVector (SpatialVector (A_G.col(i)), 1.0e-10, 1.0e-10));
+  }
+
+  // rate of change of the centroidal momentum
+  Vector3d com_acceleration, change_of_angular_momentum;
+  Utils::CalcCenterOfMass (model, q, qdot, &qddot, mass, com,
+      &com_velocity, &com_acceleration, &angular_momentum,
+      &change_of_angular_momentum);
+
+  SpatialVector hdot_ref;
+  hdot_ref << change_of_angular_momentum, mass * com_acceleration;
+
+  SpatialVector A_G_dot_qdot;
+  MatrixNd A_G_bias;
+  Utils::CalcCentroidalMomentumBias (model, q, qdot, A_G_dot_qdot,
+      &A_G_bias);
+
+  CHECK_THAT (A_G, AllCloseMatrix (A_G_bias, 1.0e-10, 1.0e-10));
+  CHECK_THAT (hdot_ref, AllCloseVector (
+        SpatialVector (A_G * qddot + A_G_dot_qdot), 1.0e-10, 1.0e-10));
+}
+
+TEST_CASE_METHOD(Human36,
+                 __FILE__"_TestCentroidalMomentumMatrixHuman36", "")
+{
+  TestCentroidalMomentumMatrix (*model_emulated);
+  TestCentroidalMomentumMatrix (*model_3dof);
+}